@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+
+#include <engine/engine.h>
+#include <engine/render/frontend/gfx_frontend.h>
+
+// The scene is capped at MAX_SDF_NODES, its nodes are cycled to reach thousands of dispatches
+#define CMD_RECORDING_DISPATCHES  4096
+#define CMD_RECORDING_SCENE_PRIMS 128
+#define CMD_RECORDING_RUNS        64
+
+static const uint32_t cmd_recording_threads[] = {1, 2, 4, 8, 16};
+
+SDF_Scene* create_cmd_recording_scene(void)
+{
+    SDF_Scene* scene = malloc(sizeof(SDF_Scene));
+    sdf_scene_init(scene);
+
+    for (uint32_t i = 0; i < CMD_RECORDING_SCENE_PRIMS; i++) {
+        SDF_Primitive sphere = {
+            .type      = SDF_PRIM_Sphere,
+            .transform = {
+                .position = {{(float) (i % 16) - 8.0f, (float) (i / 16) - 4.0f, 0.0f}},
+                .rotation = {0.0f, 0.0f, 0.0f, 0.0f},
+                .scale    = 1.0f},
+            .material.diffuse = {1.0f, 1.0f, 1.0f, 1.0f},
+            .props.sphere     = {.radius = 0.25f}};
+        sdf_scene_add_primitive(scene, sphere);
+    }
+
+    return scene;
+}
+
+void benchmark_cmd_recording(void)
+{
+    // No window needed, only the CPU side of recording is measured
+    g_gfxConfig.headless = true;
+    if (gfx_init(Vulkan) != Success) {
+        LOG_ERROR("[Benchmark] cmd recording needs a Vulkan device, skipping");
+        gfx_destroy();
+        return;
+    }
+
+    job_system_init(thread_hardware_concurrency() - 1);
+
+    renderer_desc desc = {.width = 800, .height = 600, .window = NULL};
+    if (!renderer_sdf_init(desc)) {
+        LOG_ERROR("[Benchmark] failed to init the SDF renderer, skipping cmd recording");
+        renderer_sdf_destroy();
+        gfx_destroy();
+        job_system_destroy();
+        return;
+    }
+
+    SDF_Scene* scene = create_cmd_recording_scene();
+    renderer_sdf_set_scene(scene);
+
+    printf(COLOR_PINK "[Benchmark] Starting: [Scene draw pass recording] %u dispatches, %u job system workers\n" COLOR_RESET, CMD_RECORDING_DISPATCHES, job_system_get_worker_count());
+
+    double single_thread_ms = 0.0;
+    for (size_t t = 0; t < ARRAY_SIZE(cmd_recording_threads); t++) {
+        uint32_t threads = cmd_recording_threads[t];
+
+        // warm up the pools, the first recording allocates their memory
+        if (renderer_sdf_measure_scene_recording(CMD_RECORDING_DISPATCHES, threads) < 0.0) {
+            LOG_WARN("[Benchmark] %u record threads not supported by the backend", threads);
+            continue;
+        }
+
+        double total_ms = 0.0;
+        for (size_t i = 0; i < CMD_RECORDING_RUNS; i++)
+            total_ms += renderer_sdf_measure_scene_recording(CMD_RECORDING_DISPATCHES, threads);
+
+        double avg_ms = total_ms / CMD_RECORDING_RUNS;
+        if (threads == 1)
+            single_thread_ms = avg_ms;
+
+        printf(COLOR_GREEN "[Benchmark] Average: [Record %u dispatches on %2u threads] for [%d] runs: %4.4f ms (%.2fx)\n" COLOR_RESET,
+            CMD_RECORDING_DISPATCHES,
+            threads,
+            CMD_RECORDING_RUNS,
+            avg_ms,
+            avg_ms > 0.0 ? single_thread_ms / avg_ms : 0.0);
+    }
+
+    renderer_sdf_set_scene(NULL);
+    renderer_sdf_destroy();
+    gfx_destroy();
+    job_system_destroy();
+
+    // frees the scene too
+    sdf_scene_destroy(scene);
+}
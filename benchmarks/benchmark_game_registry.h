@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+
+#include <engine/core/containers/hash_map.h>
+#include <engine/core/game_registry.h>
+#include <engine/core/gameobject.h>
+#include <engine/core/memory/heap_stats.h>
+#include <engine/core/memory/pool_allocator.h>
+#include <engine/core/rng/rng.h>
+#include <engine/core/time/timer.h>
+#include <engine/core/uuid/uuid.h>
+#include <engine/scripting/scripting.h>
+
+//---------------------------------------
+// Per-frame update loop: walking every hash map slot like gameobjects_update used to vs the
+// registry's dense object array.
+// The registry holds MAX_OBJECTS (it sizes the SDF node uniform buffer too), so the 10k object
+// part is a synthetic model: both loops re-implemented over locally allocated objects and maps.
+// The registry part then runs the real gameobjects_update over a full registry.
+
+#define REGISTRY_OBJECTS 10000
+#define REGISTRY_FRAMES  1000
+
+static float s_RegistryUpdateSink;
+
+static void benchmark_registry_update(random_uuid_t* uuid, float dt)
+{
+    (void) uuid;
+    s_RegistryUpdateSink += dt;
+}
+
+static void benchmark_registry_touch(GameObject* go, float dt)
+{
+    if (go->updateFn)
+        go->updateFn(&go->uuid, dt);
+    s_RegistryUpdateSink += go->transform.scale;
+}
+
+void benchmark_game_registry(void)
+{
+    GameObject** objects = malloc(REGISTRY_OBJECTS * sizeof(GameObject*));
+    for (uint32_t i = 0; i < REGISTRY_OBJECTS; i++) {
+        objects[i] = calloc(1, sizeof(GameObject));
+        uuid_generate(&objects[i]->uuid);
+        objects[i]->transform.scale = 1.0f;
+        objects[i]->updateFn        = benchmark_registry_update;
+        objects[i]->registryIdx     = i;
+    }
+
+    printf(COLOR_PINK "[Benchmark] update loop model (not the registry), %d objects, %d frames\n" COLOR_RESET, REGISTRY_OBJECTS, REGISTRY_FRAMES);
+
+    // removes only shrink the map below 1/8 load, a session that once spawned a lot iterates mostly empty slots
+    size_t capacities[] = {16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024};
+    for (size_t c = 0; c < ARRAY_SIZE(capacities); c++) {
+        hash_map_t* map = hash_map_create(capacities[c]);
+        for (uint32_t i = 0; i < REGISTRY_OBJECTS; i++)
+            hash_map_set_key_value(map, objects[i]->uuid, objects[i]);
+
+        uint64_t start = timer_now_ns();
+        for (uint32_t frame = 0; frame < REGISTRY_FRAMES; frame++) {
+            for (size_t i = 0; i < map->capacity; i++) {
+                hash_map_pair_t pair = map->entries[i];
+                if (!uuid_is_null(&pair.key) && pair.value)
+                    benchmark_registry_touch((GameObject*) pair.value, 0.016f);
+            }
+        }
+        double slots_us = (double) (timer_now_ns() - start) / 1e3 / REGISTRY_FRAMES;
+
+        start = timer_now_ns();
+        for (uint32_t frame = 0; frame < REGISTRY_FRAMES; frame++)
+            for (uint32_t i = 0; i < REGISTRY_OBJECTS; i++)
+                benchmark_registry_touch(objects[i], 0.016f);
+        double dense_us = (double) (timer_now_ns() - start) / 1e3 / REGISTRY_FRAMES;
+
+        printf(COLOR_GREEN "[Benchmark] %7zu slots (%5.1f%% load): hash map slots %8.2f us/frame | dense array %6.2f us/frame | %.1fx\n" COLOR_RESET,
+            map->capacity,
+            100.0 * REGISTRY_OBJECTS / (double) map->capacity,
+            slots_us,
+            dense_us,
+            slots_us / dense_us);
+
+        hash_map_destroy(map);
+    }
+
+    for (uint32_t i = 0; i < REGISTRY_OBJECTS; i++)
+        free(objects[i]);
+    free(objects);
+
+    // real path: gameobjects_update over a full registry vs the old slot walk over its uuid map
+    game_registry_init();
+    for (uint32_t i = 0; i < MAX_OBJECTS; i++)
+        game_registry_register_gameobject_type(0, NULL, benchmark_registry_update);
+
+    printf(COLOR_PINK "[Benchmark] registry update loop, %d objects, %d frames\n" COLOR_RESET, MAX_OBJECTS, REGISTRY_FRAMES * 10);
+
+    hash_map_t* registry = game_registry_get_instance();
+    uint64_t    start    = timer_now_ns();
+    for (uint32_t frame = 0; frame < REGISTRY_FRAMES * 10; frame++) {
+        for (size_t i = 0; i < registry->capacity; i++) {
+            hash_map_pair_t pair = registry->entries[i];
+            if (!uuid_is_null(&pair.key) && pair.value)
+                benchmark_registry_touch((GameObject*) pair.value, 0.016f);
+        }
+    }
+    double slots_us = (double) (timer_now_ns() - start) / 1e3 / (REGISTRY_FRAMES * 10);
+
+    start = timer_now_ns();
+    for (uint32_t frame = 0; frame < REGISTRY_FRAMES * 10; frame++)
+        gameobjects_update(0.016f);
+    double update_us = (double) (timer_now_ns() - start) / 1e3 / (REGISTRY_FRAMES * 10);
+
+    printf(COLOR_GREEN "[Benchmark] %7zu slots (%5.1f%% load): hash map slots %8.2f us/frame | gameobjects_update %6.2f us/frame | %.1fx\n" COLOR_RESET,
+        registry->capacity,
+        100.0 * MAX_OBJECTS / (double) registry->capacity,
+        slots_us,
+        update_us,
+        slots_us / update_us);
+
+    game_registry_destroy();
+}
+
+//---------------------------------------
+// 1M spawn/despawn ops around 10k live objects with 64 bytes of data each: malloc for the
+// object and its data vs one pool block for both, then a pass over the survivors
+
+#define SPAWN_LIVE_OBJECTS REGISTRY_OBJECTS
+#define SPAWN_OPS          (1000 * 1000)
+#define SPAWN_DATA_SIZE    64
+
+static GameObject* benchmark_spawn_object(pool_allocator* pool)
+{
+    GameObject* go = NULL;
+    if (pool) {
+        go                 = pool_allocator_alloc(pool);
+        go->gameObjectData = (uint8_t*) go + sizeof(GameObject);
+    } else {
+        go                 = malloc(sizeof(GameObject));
+        go->gameObjectData = malloc(SPAWN_DATA_SIZE);
+    }
+    go->transform.scale          = 1.0f;
+    *(float*) go->gameObjectData = 1.0f;
+    return go;
+}
+
+static void benchmark_despawn_object(pool_allocator* pool, GameObject* go)
+{
+    if (pool) {
+        pool_allocator_free(pool, go);
+    } else {
+        free(go->gameObjectData);
+        free(go);
+    }
+}
+
+void benchmark_game_registry_spawn(void)
+{
+    GameObject** live = malloc(SPAWN_LIVE_OBJECTS * sizeof(GameObject*));
+
+    printf(COLOR_PINK "[Benchmark] spawn/despawn, %d ops around %d live objects with %d bytes of data\n" COLOR_RESET, SPAWN_OPS, SPAWN_LIVE_OBJECTS, SPAWN_DATA_SIZE);
+
+    for (uint32_t variant = 0; variant < 2; variant++) {
+        pool_allocator  pool_storage;
+        pool_allocator* pool = NULL;
+        if (variant == 1) {
+            pool = &pool_storage;
+            pool_allocator_init(pool, sizeof(GameObject) + SPAWN_DATA_SIZE, 1024);
+        }
+
+        uint64_t start = timer_now_ns();
+        for (uint32_t i = 0; i < SPAWN_LIVE_OBJECTS; i++)
+            live[i] = benchmark_spawn_object(pool);
+        // despawn a random object and spawn a new one in its place, half the ops each
+        for (uint32_t op = SPAWN_LIVE_OBJECTS; op < SPAWN_OPS; op += 2) {
+            uint32_t victim = rng_range(0, SPAWN_LIVE_OBJECTS - 1);
+            benchmark_despawn_object(pool, live[victim]);
+            live[victim] = benchmark_spawn_object(pool);
+        }
+        double spawn_ns = (double) (timer_now_ns() - start) / SPAWN_OPS;
+
+        // what the update loop sees afterwards: every object and its data
+        float sum = 0.0f;
+        start     = timer_now_ns();
+        for (uint32_t frame = 0; frame < REGISTRY_FRAMES; frame++)
+            for (uint32_t i = 0; i < SPAWN_LIVE_OBJECTS; i++)
+                sum += live[i]->transform.scale + *(const float*) live[i]->gameObjectData;
+        double update_us = (double) (timer_now_ns() - start) / 1e3 / REGISTRY_FRAMES;
+
+        // malloc variant: object + data per spawn
+        uint32_t spawns      = SPAWN_LIVE_OBJECTS + (SPAWN_OPS - SPAWN_LIVE_OBJECTS) / 2;
+        uint32_t heap_allocs = pool ? pool->slab_count : 2 * spawns;
+        printf(COLOR_GREEN "[Benchmark] %-6s: %6.1f ns/op | update pass %6.2f us/frame | %7u heap allocations (sum %.0f)\n" COLOR_RESET,
+            pool ? "pool" : "malloc",
+            spawn_ns,
+            update_us,
+            heap_allocs,
+            (double) sum);
+
+        for (uint32_t i = 0; i < SPAWN_LIVE_OBJECTS; i++)
+            benchmark_despawn_object(pool, live[i]);
+        if (pool)
+            pool_allocator_destroy(pool);
+    }
+
+    free(live);
+
+    // the real path: game_registry spawns and uuid despawns around half a registry of live
+    // objects, heap calls counted in BYOE_COUNT_HEAP_ALLOCS builds once the pools are warm.
+    // Neither the objects nor the pre-sized uuid map should hit the heap here
+    game_registry_init();
+    random_uuid_t live_uuids[MAX_OBJECTS / 2];
+    for (uint32_t i = 0; i < MAX_OBJECTS / 2; i++)
+        live_uuids[i] = game_registry_register_gameobject_type(SPAWN_DATA_SIZE, NULL, NULL);
+
+    uint32_t heap_before = heap_stats_get_alloc_count();
+    uint64_t start       = timer_now_ns();
+    for (uint32_t op = 0; op < SPAWN_OPS; op += 2) {
+        uint32_t victim = rng_range(0, MAX_OBJECTS / 2 - 1);
+        UNREGISTER_GAME_OBJECT(live_uuids[victim]);
+        live_uuids[victim] = game_registry_register_gameobject_type(SPAWN_DATA_SIZE, NULL, NULL);
+    }
+    double   registry_ns = (double) (timer_now_ns() - start) / SPAWN_OPS;
+    uint32_t heap_allocs = heap_stats_get_alloc_count() - heap_before;
+
+    if (heap_stats_is_enabled())
+        printf(COLOR_GREEN "[Benchmark] registry: %6.1f ns/op around %d live objects | %7u heap allocations\n" COLOR_RESET, registry_ns, MAX_OBJECTS / 2, heap_allocs);
+    else
+        printf(COLOR_GREEN "[Benchmark] registry: %6.1f ns/op around %d live objects | heap allocations not counted, build with BYOE_COUNT_HEAP_ALLOCS\n" COLOR_RESET, registry_ns, MAX_OBJECTS / 2);
+
+    game_registry_destroy();
+}
+
+//---------------------------------------
+// 10M get/set position pairs spread over a full registry: uuid accessors (hash + probe per
+// call) vs handle accessors (slot index + generation check)
+
+#define HANDLE_CALLS (10 * 1000 * 1000)
+
+void benchmark_game_registry_handles(void)
+{
+    game_registry_init();
+
+    random_uuid_t*     uuids   = malloc(MAX_OBJECTS * sizeof(random_uuid_t));
+    gameobject_handle* handles = malloc(MAX_OBJECTS * sizeof(gameobject_handle));
+    for (uint32_t i = 0; i < MAX_OBJECTS; i++) {
+        handles[i] = game_registry_spawn_gameobject(0, NULL, NULL);
+        uuids[i]   = gameobject_handle_get_uuid(handles[i]);
+    }
+
+    printf(COLOR_PINK "[Benchmark] get + set position, %d calls over %d objects\n" COLOR_RESET, HANDLE_CALLS, MAX_OBJECTS);
+
+    uint64_t start = timer_now_ns();
+    for (uint32_t i = 0; i < HANDLE_CALLS / 2; i++) {
+        vec3 position;
+        gameobject_get_position(uuids[i % MAX_OBJECTS], &position);
+        position[0] += 1.0f;
+        gameobject_set_position(uuids[i % MAX_OBJECTS], position);
+    }
+    double uuid_ns = (double) (timer_now_ns() - start) / HANDLE_CALLS;
+
+    start = timer_now_ns();
+    for (uint32_t i = 0; i < HANDLE_CALLS / 2; i++) {
+        vec3 position;
+        gameobject_handle_get_position(handles[i % MAX_OBJECTS], &position);
+        position[0] += 1.0f;
+        gameobject_handle_set_position(handles[i % MAX_OBJECTS], position);
+    }
+    double handle_ns = (double) (timer_now_ns() - start) / HANDLE_CALLS;
+
+    // keeps the writes observable
+    vec3 position;
+    gameobject_handle_get_position(handles[0], &position);
+    printf(COLOR_GREEN "[Benchmark] uuid %6.2f ns/call | handle %6.2f ns/call | %.1fx (position.x %.0f)\n" COLOR_RESET,
+        uuid_ns,
+        handle_ns,
+        uuid_ns / handle_ns,
+        (double) position[0]);
+
+    free(handles);
+    free(uuids);
+    game_registry_destroy();
+}
@@ -1,10 +1,16 @@
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "benchmark.h"
 
+#include <engine/core/containers/concurrent_hash_map.h>
 #include <engine/core/containers/hash_map.h>
+#include <engine/core/containers/typed_hash_map.h>
 #include <engine/core/logging/log.h>
+#include <engine/core/rng/rng.h>
+#include <engine/core/threads/threads.h>
+#include <engine/core/time/timer.h>
 #include <engine/core/uuid/uuid.h>
 
 char* words[] = {
@@ -53,6 +59,504 @@ void avg_runs_benchmark(void)
     hash_map_destroy(map);
 }
 
+//---------------------------------------
+// Lookups at 90% load factor, 1M slots so the table is well outside the caches
+
+#define LOAD_FACTOR_SLOTS   (1024 * 1024)
+#define LOAD_FACTOR_ENTRIES (LOAD_FACTOR_SLOTS / 10 * 9)
+#define LOAD_FACTOR_LOOKUPS (1024 * 1024)
+
+static double hash_map_lookup_run(const hash_map_t* map, const random_uuid_t* keys, size_t count, size_t* found)
+{
+    uint64_t start = benchmark_get_time();
+    *found         = 0;
+    for (size_t i = 0; i < count; i++)
+        *found += hash_map_get_value(map, keys[i]) != NULL;
+    uint64_t end = benchmark_get_time();
+
+    return (double) (end - start) * 1e9 / (double) benchmark_get_frequency() / (double) count;
+}
+
+// hash_map_stats plus how long taking them took
+static void benchmark_hash_map_print_stats(const char* label, const hash_map_t* map)
+{
+    hash_map_stats_t stats;
+    uint64_t         start = timer_now_ns();
+    hash_map_stats(map, &stats);
+    double stats_ms = timer_elapsed_ms(start);
+
+    printf(COLOR_YELLOW "[Benchmark] %s stats (%.3f ms): %zu/%zu slots, load %.3f | %zu tombstones | probe avg %.3f max %zu | %zu resizes, %.2f ms rehashing\n" COLOR_RESET,
+        label,
+        stats_ms,
+        stats.length,
+        stats.capacity,
+        (double) stats.load_factor,
+        stats.tombstones,
+        (double) stats.avg_probe_length,
+        stats.max_probe_length,
+        stats.resize_count,
+        (double) stats.rehash_ns / 1e6);
+
+    printf(COLOR_YELLOW "[Benchmark] %s probe histogram:", label);
+    for (size_t i = 0; i < HASH_MAP_PROBE_HISTOGRAM_BUCKETS; i++)
+        printf(" %zu%s: %zu", i + 1, i + 1 == HASH_MAP_PROBE_HISTOGRAM_BUCKETS ? "+" : "", stats.probe_histogram[i]);
+    printf("\n" COLOR_RESET);
+}
+
+void benchmark_hash_map_load_factor(void)
+{
+    random_uuid_t* inserted = malloc(LOAD_FACTOR_ENTRIES * sizeof(random_uuid_t));
+    random_uuid_t* hits     = malloc(LOAD_FACTOR_LOOKUPS * sizeof(random_uuid_t));
+    random_uuid_t* misses   = malloc(LOAD_FACTOR_LOOKUPS * sizeof(random_uuid_t));
+    random_uuid_t* mixed    = malloc(LOAD_FACTOR_LOOKUPS * sizeof(random_uuid_t));
+
+    for (size_t i = 0; i < LOAD_FACTOR_ENTRIES; i++)
+        uuid_generate(&inserted[i]);
+    for (size_t i = 0; i < LOAD_FACTOR_LOOKUPS; i++) {
+        hits[i] = inserted[(size_t) rand() % LOAD_FACTOR_ENTRIES];
+        uuid_generate(&misses[i]);
+        mixed[i] = (i & 1) ? hits[i] : misses[i];
+    }
+
+    hash_map_t* grouped = hash_map_create_with_mode(LOAD_FACTOR_SLOTS, HASH_MAP_MODE_GROUPED);
+    for (size_t i = 0; i < LOAD_FACTOR_ENTRIES; i++)
+        hash_map_set_key_value(grouped, inserted[i], &inserted[i]);
+
+    // quadratic mode grows at half load and misses walk the whole table, only hits are comparable
+    hash_map_t* quadratic = hash_map_create_with_mode(LOAD_FACTOR_SLOTS, HASH_MAP_MODE_QUADRATIC);
+    for (size_t i = 0; i < LOAD_FACTOR_ENTRIES; i++)
+        hash_map_set_key_value(quadratic, inserted[i], &inserted[i]);
+
+    printf(COLOR_PINK "[Benchmark] hash_map_get_value, %d entries in %zu grouped slots (%.1f%% load)\n" COLOR_RESET, LOAD_FACTOR_ENTRIES, grouped->capacity, 100.0 * (double) hash_map_get_length(grouped) / (double) grouped->capacity);
+
+    // first touch of the freshly allocated tables would dominate the first run
+    size_t found = 0;
+    hash_map_lookup_run(grouped, hits, LOAD_FACTOR_LOOKUPS, &found);
+    hash_map_lookup_run(quadratic, hits, LOAD_FACTOR_LOOKUPS, &found);
+
+    double ns = hash_map_lookup_run(grouped, hits, LOAD_FACTOR_LOOKUPS, &found);
+    printf(COLOR_GREEN "[Benchmark] grouped   hit:   %6.2f ns/lookup (%zu found)\n" COLOR_RESET, ns, found);
+    ns = hash_map_lookup_run(grouped, misses, LOAD_FACTOR_LOOKUPS, &found);
+    printf(COLOR_GREEN "[Benchmark] grouped   miss:  %6.2f ns/lookup (%zu found)\n" COLOR_RESET, ns, found);
+    ns = hash_map_lookup_run(grouped, mixed, LOAD_FACTOR_LOOKUPS, &found);
+    printf(COLOR_GREEN "[Benchmark] grouped   mixed: %6.2f ns/lookup (%zu found)\n" COLOR_RESET, ns, found);
+    ns = hash_map_lookup_run(quadratic, hits, LOAD_FACTOR_LOOKUPS, &found);
+    printf(COLOR_GREEN "[Benchmark] quadratic hit:   %6.2f ns/lookup (%zu found, %zu slots)\n" COLOR_RESET, ns, found, quadratic->capacity);
+
+    benchmark_hash_map_print_stats("grouped", grouped);
+    benchmark_hash_map_print_stats("quadratic", quadratic);
+
+    hash_map_destroy(grouped);
+    hash_map_destroy(quadratic);
+    free(inserted);
+    free(hits);
+    free(misses);
+    free(mixed);
+}
+
+//---------------------------------------
+// Batched vs single lookups on a table far bigger than the last level cache (~130 MB of entries)
+
+#define BATCH_SLOTS   (4 * 1024 * 1024)
+#define BATCH_ENTRIES (BATCH_SLOTS / 4 * 3)
+#define BATCH_LOOKUPS (1024 * 1024)
+#define BATCH_MAX     256
+
+void benchmark_hash_map_batch(void)
+{
+    random_uuid_t* inserted = malloc(BATCH_ENTRIES * sizeof(random_uuid_t));
+    random_uuid_t* lookups  = malloc(BATCH_LOOKUPS * sizeof(random_uuid_t));
+    void**         values   = malloc(BATCH_LOOKUPS * sizeof(void*));
+
+    hash_map_t* map = hash_map_create(BATCH_SLOTS);
+    for (size_t i = 0; i < BATCH_ENTRIES; i++) {
+        uuid_generate(&inserted[i]);
+        hash_map_set_key_value(map, inserted[i], &inserted[i]);
+    }
+    for (size_t i = 0; i < BATCH_LOOKUPS; i++)
+        lookups[i] = inserted[(size_t) rand() % BATCH_ENTRIES];
+
+    // page in the table once so the first batch size isn't charged for it
+    hash_map_get_values_batch(map, lookups, BATCH_LOOKUPS, values);
+
+    printf(COLOR_PINK "[Benchmark] hash_map_get_values_batch, %d random hits in %zu slots\n" COLOR_RESET, BATCH_LOOKUPS, map->capacity);
+
+    for (size_t batch = 1; batch <= BATCH_MAX; batch *= 2) {
+        uint64_t start = benchmark_get_time();
+        for (size_t i = 0; i + batch <= BATCH_LOOKUPS; i += batch)
+            for (size_t k = 0; k < batch; k++)
+                values[i + k] = hash_map_get_value(map, lookups[i + k]);
+        uint64_t single = benchmark_get_time() - start;
+
+        start = benchmark_get_time();
+        for (size_t i = 0; i + batch <= BATCH_LOOKUPS; i += batch)
+            hash_map_get_values_batch(map, &lookups[i], batch, &values[i]);
+        uint64_t batched = benchmark_get_time() - start;
+
+        double to_ns = 1e9 / (double) benchmark_get_frequency() / (double) BATCH_LOOKUPS;
+        printf(COLOR_GREEN "[Benchmark] batch %3zu: single %6.2f ns/key | batched %6.2f ns/key | %.2fx\n" COLOR_RESET,
+            batch,
+            (double) single * to_ns,
+            (double) batched * to_ns,
+            batched ? (double) single / (double) batched : 0.0);
+    }
+
+    hash_map_destroy(map);
+    free(inserted);
+    free(lookups);
+    free(values);
+}
+
+//---------------------------------------
+// Single insert latency while growing to 1M entries, the inserts that trigger a resize are the tail
+
+#define INSERT_LATENCY_ENTRIES (1024 * 1024)
+
+static int insert_latency_compare(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+void benchmark_hash_map_insert_latency(void)
+{
+    random_uuid_t* keys      = malloc(INSERT_LATENCY_ENTRIES * sizeof(random_uuid_t));
+    uint64_t*      latencies = malloc(INSERT_LATENCY_ENTRIES * sizeof(uint64_t));
+    for (size_t i = 0; i < INSERT_LATENCY_ENTRIES; i++)
+        uuid_generate(&keys[i]);
+
+    printf(COLOR_PINK "[Benchmark] hash_map_set_key_value latency, %d inserts from 16 slots\n" COLOR_RESET, INSERT_LATENCY_ENTRIES);
+
+    for (int incremental = 0; incremental < 2; incremental++) {
+        hash_map_t* map = hash_map_create(16);
+        hash_map_set_incremental_resize(map, incremental);
+
+        uint64_t total_start = timer_now_ns();
+        for (size_t i = 0; i < INSERT_LATENCY_ENTRIES; i++) {
+            uint64_t start = timer_now_ns();
+            hash_map_set_key_value(map, keys[i], &keys[i]);
+            latencies[i] = timer_now_ns() - start;
+        }
+        double total_ms = timer_elapsed_ms(total_start);
+
+        qsort(latencies, INSERT_LATENCY_ENTRIES, sizeof(uint64_t), insert_latency_compare);
+        // a full rehash only hits ~16 inserts, below p99.9 on 1M. Incremental spreads the copy and the
+        // first touch of the new table's pages over many inserts instead
+        printf(COLOR_GREEN "[Benchmark] %-11s p50 %6" PRIu64 " ns | p99 %6" PRIu64 " ns | p99.9 %7" PRIu64 " ns | p99.99 %8" PRIu64 " ns | max %9" PRIu64 " ns | total %.2f ms\n" COLOR_RESET,
+            incremental ? "incremental" : "rehash",
+            latencies[INSERT_LATENCY_ENTRIES / 2],
+            latencies[(size_t) INSERT_LATENCY_ENTRIES * 99 / 100],
+            latencies[(size_t) INSERT_LATENCY_ENTRIES * 999 / 1000],
+            latencies[(size_t) INSERT_LATENCY_ENTRIES * 9999 / 10000],
+            latencies[INSERT_LATENCY_ENTRIES - 1],
+            total_ms);
+
+        hash_map_destroy(map);
+    }
+
+    free(keys);
+    free(latencies);
+}
+
+//---------------------------------------
+// Spawn/despawn churn: a steady 100k live keys, every op removes a random one and inserts a fresh one.
+// Probe lengths and throughput should stay flat instead of degrading with the removes
+
+#define CHURN_LIVE_KEYS     (100 * 1000)
+#define CHURN_EPOCHS        20
+#define CHURN_OPS_PER_EPOCH (200 * 1000)
+#define CHURN_PROBE_SAMPLES 4096
+
+void benchmark_hash_map_churn(void)
+{
+    random_uuid_t* live = malloc(CHURN_LIVE_KEYS * sizeof(random_uuid_t));
+
+    hash_map_mode modes[] = {HASH_MAP_MODE_GROUPED, HASH_MAP_MODE_QUADRATIC};
+    for (size_t m = 0; m < ARRAY_SIZE(modes); m++) {
+        hash_map_t* map = hash_map_create_with_mode(16, modes[m]);
+        for (size_t i = 0; i < CHURN_LIVE_KEYS; i++) {
+            uuid_generate(&live[i]);
+            hash_map_set_key_value(map, live[i], &live[i]);
+        }
+
+        printf(COLOR_PINK "[Benchmark] %s churn, %d live keys, %d remove+insert pairs per epoch\n" COLOR_RESET, modes[m] == HASH_MAP_MODE_GROUPED ? "grouped" : "quadratic", CHURN_LIVE_KEYS, CHURN_OPS_PER_EPOCH);
+
+        for (size_t epoch = 0; epoch < CHURN_EPOCHS; epoch++) {
+            uint64_t start = timer_now_ns();
+            for (size_t op = 0; op < CHURN_OPS_PER_EPOCH; op++) {
+                size_t victim = (size_t) rng_range(0, CHURN_LIVE_KEYS - 1);
+                hash_map_remove_entry(map, live[victim]);
+                uuid_generate(&live[victim]);
+                hash_map_set_key_value(map, live[victim], &live[victim]);
+            }
+            double ns_per_op = (double) (timer_now_ns() - start) / (double) (2 * CHURN_OPS_PER_EPOCH);
+
+            size_t probes = 0;
+            for (size_t i = 0; i < CHURN_PROBE_SAMPLES; i++)
+                probes += hash_map_get_probe_length(map, live[(size_t) rng_range(0, CHURN_LIVE_KEYS - 1)]);
+
+            // only print a few epochs, the point is that they look the same
+            if (epoch % 4 == 0 || epoch == CHURN_EPOCHS - 1)
+                printf(COLOR_GREEN "[Benchmark] epoch %2zu: %6.1f ns/op | avg probe %.3f | length %zu | tombstones %6zu | capacity %zu\n" COLOR_RESET,
+                    epoch,
+                    ns_per_op,
+                    (double) probes / CHURN_PROBE_SAMPLES,
+                    hash_map_get_length(map),
+                    map->deleted,
+                    map->capacity);
+        }
+
+        benchmark_hash_map_print_stats(modes[m] == HASH_MAP_MODE_GROUPED ? "grouped churn" : "quadratic churn", map);
+        hash_map_destroy(map);
+    }
+
+    free(live);
+}
+
+//---------------------------------------
+// u64 -> struct: hash_map_t with heap values vs TYPED_HASH_MAP holding pointers vs values inline
+
+#define TYPED_ENTRIES (1024 * 1024)
+#define TYPED_LOOKUPS (4 * 1024 * 1024)
+
+typedef struct benchmark_typed_value
+{
+    float    position[4];
+    float    rotation[4];
+    uint64_t id;
+    uint64_t flags;
+} benchmark_typed_value;
+
+TYPED_HASH_MAP(benchmark_u64_ptr_map, uint64_t, benchmark_typed_value*, hash_map_hash_u64, hash_map_equal_u64)
+TYPED_HASH_MAP(benchmark_u64_value_map, uint64_t, benchmark_typed_value, hash_map_hash_u64, hash_map_equal_u64)
+
+void benchmark_hash_map_typed(void)
+{
+    random_uuid_t*         uuids   = malloc(TYPED_ENTRIES * sizeof(random_uuid_t));
+    uint64_t*              keys    = malloc(TYPED_ENTRIES * sizeof(uint64_t));
+    benchmark_typed_value* heap    = malloc(TYPED_ENTRIES * sizeof(benchmark_typed_value));
+    uint32_t*              lookups = malloc(TYPED_LOOKUPS * sizeof(uint32_t));
+
+    hash_map_t*             uuid_map = hash_map_create(16);
+    benchmark_u64_ptr_map   ptr_map;
+    benchmark_u64_value_map value_map;
+    benchmark_u64_ptr_map_init(&ptr_map, 16);
+    benchmark_u64_value_map_init(&value_map, 16);
+
+    printf(COLOR_PINK "[Benchmark] u64 -> %zu byte struct, %d entries, %d random lookups\n" COLOR_RESET, sizeof(benchmark_typed_value), TYPED_ENTRIES, TYPED_LOOKUPS);
+
+    // heap values are allocated in insert order like they would be at runtime, then shuffled so
+    // neighbouring keys don't share cache lines by accident
+    benchmark_typed_value** values = malloc(TYPED_ENTRIES * sizeof(benchmark_typed_value*));
+    for (size_t i = 0; i < TYPED_ENTRIES; i++) {
+        uuid_generate(&uuids[i]);
+        keys[i]   = ((uint64_t) rng_generate() << 32) | rng_generate();
+        heap[i]   = (benchmark_typed_value){.id = i};
+        values[i] = &heap[i];
+    }
+    for (size_t i = TYPED_ENTRIES - 1; i > 0; i--) {
+        size_t                 j   = (size_t) rng_range(0, (uint32_t) i);
+        benchmark_typed_value* tmp = values[i];
+        values[i]                  = values[j];
+        values[j]                  = tmp;
+    }
+    for (size_t i = 0; i < TYPED_LOOKUPS; i++)
+        lookups[i] = rng_range(0, TYPED_ENTRIES - 1);
+
+    uint64_t start = timer_now_ns();
+    for (size_t i = 0; i < TYPED_ENTRIES; i++)
+        hash_map_set_key_value(uuid_map, uuids[i], values[i]);
+    uint64_t uuid_insert = timer_now_ns() - start;
+
+    start = timer_now_ns();
+    for (size_t i = 0; i < TYPED_ENTRIES; i++)
+        benchmark_u64_ptr_map_set(&ptr_map, keys[i], values[i]);
+    uint64_t ptr_insert = timer_now_ns() - start;
+
+    start = timer_now_ns();
+    for (size_t i = 0; i < TYPED_ENTRIES; i++)
+        benchmark_u64_value_map_set(&value_map, keys[i], *values[i]);
+    uint64_t value_insert = timer_now_ns() - start;
+
+    // every lookup reads the value so the pointer chase is paid for
+    uint64_t checksum = 0;
+
+    start = timer_now_ns();
+    for (size_t i = 0; i < TYPED_LOOKUPS; i++)
+        checksum += ((const benchmark_typed_value*) hash_map_get_value(uuid_map, uuids[lookups[i]]))->id;
+    uint64_t uuid_lookup = timer_now_ns() - start;
+
+    start = timer_now_ns();
+    for (size_t i = 0; i < TYPED_LOOKUPS; i++)
+        checksum += (*benchmark_u64_ptr_map_get(&ptr_map, keys[lookups[i]]))->id;
+    uint64_t ptr_lookup = timer_now_ns() - start;
+
+    start = timer_now_ns();
+    for (size_t i = 0; i < TYPED_LOOKUPS; i++)
+        checksum += benchmark_u64_value_map_get(&value_map, keys[lookups[i]])->id;
+    uint64_t value_lookup = timer_now_ns() - start;
+
+    printf(COLOR_GREEN "[Benchmark] hash_map_t uuid -> void*  : insert %6.1f ns/op | lookup %6.1f ns/op\n" COLOR_RESET, (double) uuid_insert / TYPED_ENTRIES, (double) uuid_lookup / TYPED_LOOKUPS);
+    printf(COLOR_GREEN "[Benchmark] typed u64 -> pointer     : insert %6.1f ns/op | lookup %6.1f ns/op\n" COLOR_RESET, (double) ptr_insert / TYPED_ENTRIES, (double) ptr_lookup / TYPED_LOOKUPS);
+    printf(COLOR_GREEN "[Benchmark] typed u64 -> inline value: insert %6.1f ns/op | lookup %6.1f ns/op (checksum %" PRIu64 ")\n" COLOR_RESET, (double) value_insert / TYPED_ENTRIES, (double) value_lookup / TYPED_LOOKUPS, checksum);
+
+    hash_map_destroy(uuid_map);
+    benchmark_u64_ptr_map_destroy(&ptr_map);
+    benchmark_u64_value_map_destroy(&value_map);
+    free(values);
+    free(uuids);
+    free(keys);
+    free(heap);
+    free(lookups);
+}
+
+//---------------------------------------
+// Readers and writers on 1..32 threads: concurrent_hash_map_t vs hash_map_t behind one mutex.
+// Writers insert a fresh key and remove their previous one so the map stays at the same size
+
+#define CONCURRENT_ENTRIES     (256 * 1024)
+#define CONCURRENT_TOTAL_OPS   (4 * 1024 * 1024)
+#define CONCURRENT_MAX_THREADS 32
+
+typedef struct benchmark_concurrent_worker
+{
+    concurrent_hash_map_t* concurrent;
+    hash_map_t*            locked;
+    mutex_t*               lock;
+    const random_uuid_t*   keys;
+    const uint32_t*        lookups;
+    random_uuid_t*         own_keys;
+    size_t                 ops;
+    size_t                 first_lookup;
+    uint32_t               write_percent;
+    uint32_t               _pad0;
+    size_t                 found;
+} benchmark_concurrent_worker;
+
+static void benchmark_concurrent_worker_proc(void* arg)
+{
+    benchmark_concurrent_worker* worker = arg;
+    size_t                       writes = 0;
+
+    for (size_t i = 0; i < worker->ops; i++) {
+        uint32_t pick = worker->lookups[(worker->first_lookup + i) % CONCURRENT_TOTAL_OPS];
+        if (pick % 100 < worker->write_percent) {
+            random_uuid_t* key = &worker->own_keys[writes % 2];
+            if (writes >= 2) {
+                if (worker->concurrent)
+                    concurrent_hash_map_remove_entry(worker->concurrent, *key);
+                else {
+                    mutex_lock(worker->lock);
+                    hash_map_remove_entry(worker->locked, *key);
+                    mutex_unlock(worker->lock);
+                }
+            }
+            // the two own keys start one apart, stepping by 2 gives a key the map has never seen
+            key->data[0] += 2;
+            if (worker->concurrent)
+                concurrent_hash_map_set_key_value(worker->concurrent, *key, key);
+            else {
+                mutex_lock(worker->lock);
+                hash_map_set_key_value(worker->locked, *key, key);
+                mutex_unlock(worker->lock);
+            }
+            writes++;
+            continue;
+        }
+
+        const random_uuid_t* key = &worker->keys[pick % CONCURRENT_ENTRIES];
+        if (worker->concurrent)
+            worker->found += concurrent_hash_map_get_value(worker->concurrent, *key) != NULL;
+        else {
+            mutex_lock(worker->lock);
+            worker->found += hash_map_get_value(worker->locked, *key) != NULL;
+            mutex_unlock(worker->lock);
+        }
+    }
+}
+
+void benchmark_hash_map_concurrent(void)
+{
+    random_uuid_t* keys     = malloc(CONCURRENT_ENTRIES * sizeof(random_uuid_t));
+    uint32_t*      lookups  = malloc(CONCURRENT_TOTAL_OPS * sizeof(uint32_t));
+    random_uuid_t* own_keys = malloc(2 * CONCURRENT_MAX_THREADS * sizeof(random_uuid_t));
+    for (size_t i = 0; i < CONCURRENT_ENTRIES; i++)
+        uuid_generate(&keys[i]);
+    for (size_t i = 0; i < CONCURRENT_TOTAL_OPS; i++)
+        lookups[i] = rng_generate();
+
+    printf(COLOR_PINK "[Benchmark] concurrent readers/writers, %d keys, %d ops split over the threads (%u hardware threads)\n" COLOR_RESET, CONCURRENT_ENTRIES, CONCURRENT_TOTAL_OPS, thread_hardware_concurrency());
+
+    uint32_t write_percents[] = {1, 20};
+    for (size_t w = 0; w < ARRAY_SIZE(write_percents); w++) {
+        for (uint32_t thread_count = 1; thread_count <= CONCURRENT_MAX_THREADS; thread_count *= 2) {
+            double mops[2] = {0};
+            for (uint32_t variant = 0; variant < 2; variant++) {
+                concurrent_hash_map_t* concurrent = NULL;
+                hash_map_t*            locked     = NULL;
+                mutex_t                lock       = {0};
+                if (variant == 0) {
+                    concurrent = concurrent_hash_map_create(CONCURRENT_ENTRIES * 2);
+                    for (size_t i = 0; i < CONCURRENT_ENTRIES; i++)
+                        concurrent_hash_map_set_key_value(concurrent, keys[i], &keys[i]);
+                } else {
+                    locked = hash_map_create(CONCURRENT_ENTRIES * 2);
+                    mutex_init(&lock);
+                    for (size_t i = 0; i < CONCURRENT_ENTRIES; i++)
+                        hash_map_set_key_value(locked, keys[i], &keys[i]);
+                }
+
+                benchmark_concurrent_worker workers[CONCURRENT_MAX_THREADS];
+                thread_t                    threads[CONCURRENT_MAX_THREADS];
+                for (uint32_t t = 0; t < thread_count; t++) {
+                    uuid_generate(&own_keys[2 * t]);
+                    uuid_generate(&own_keys[2 * t + 1]);
+                    own_keys[2 * t + 1].data[0] = own_keys[2 * t].data[0] + 1;
+
+                    workers[t] = (benchmark_concurrent_worker){
+                        .concurrent    = concurrent,
+                        .locked        = locked,
+                        .lock          = &lock,
+                        .keys          = keys,
+                        .lookups       = lookups,
+                        .own_keys      = &own_keys[2 * t],
+                        .ops           = CONCURRENT_TOTAL_OPS / thread_count,
+                        .first_lookup  = (size_t) t * (CONCURRENT_TOTAL_OPS / thread_count),
+                        .write_percent = write_percents[w],
+                    };
+                }
+
+                uint64_t start = timer_now_ns();
+                for (uint32_t t = 0; t < thread_count; t++)
+                    thread_create(&threads[t], benchmark_concurrent_worker_proc, &workers[t]);
+                for (uint32_t t = 0; t < thread_count; t++)
+                    thread_join(&threads[t]);
+                mops[variant] = (double) CONCURRENT_TOTAL_OPS * 1e3 / (double) (timer_now_ns() - start);
+
+                if (variant == 0) {
+                    concurrent_hash_map_reclaim(concurrent);
+                    concurrent_hash_map_destroy(concurrent);
+                } else {
+                    hash_map_destroy(locked);
+                    mutex_destroy(&lock);
+                }
+            }
+
+            printf(COLOR_GREEN "[Benchmark] %2u/%2u read/write, %2u threads: concurrent %7.2f Mops/s | mutex + hash_map_t %7.2f Mops/s\n" COLOR_RESET,
+                100 - write_percents[w],
+                write_percents[w],
+                thread_count,
+                mops[0],
+                mops[1]);
+        }
+    }
+
+    free(keys);
+    free(lookups);
+    free(own_keys);
+}
+
 void benchmark_hash_map(void)
 {
     setvbuf(stdout, NULL, _IOFBF, 1024);    // Fully buffered with a 1KB buffer
@@ -100,4 +604,11 @@ void benchmark_hash_map(void)
     // Calculate the average time and average success rate
     size_t avg_found_count = total_found_count / num_runs;
     LOG_SUCCESS("Average UUIDs found: %zu out of %zu\n", avg_found_count, num_runs);
+
+    benchmark_hash_map_load_factor();
+    benchmark_hash_map_batch();
+    benchmark_hash_map_insert_latency();
+    benchmark_hash_map_churn();
+    benchmark_hash_map_typed();
+    benchmark_hash_map_concurrent();
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "benchmark.h"
+#include "benchmark_cmd_recording.h"
+#include "benchmark_game_registry.h"
 #include "benchmark_hash_map.h"
 
 #include <engine/core/simd/platform_caps.h>
@@ -13,6 +15,10 @@ int main(int argc, char** argv) {
 
     // Benchmarks
     benchmark_hash_map();
+    benchmark_game_registry();
+    benchmark_game_registry_spawn();
+    benchmark_game_registry_handles();
+    benchmark_cmd_recording();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,258 @@
+#include "concurrent_hash_map.h"
+
+#include <stdlib.h>
+
+#include "hash_map_group.h"
+
+#include "logging/log.h"
+
+////////////////////////////////////////////////////////////
+// Private API
+
+#define CONCURRENT_HASH_MAP_TAG_EMPTY   0
+#define CONCURRENT_HASH_MAP_TAG_BUSY    1
+#define CONCURRENT_HASH_MAP_TAG_REMOVED 2
+
+static uint32_t concurrent_hash_map_tag(uint64_t hash)
+{
+    uint32_t tag = (uint32_t) (hash >> 32);
+    return tag > CONCURRENT_HASH_MAP_TAG_REMOVED ? tag : tag + CONCURRENT_HASH_MAP_TAG_REMOVED + 1;
+}
+
+static mutex_t* concurrent_hash_map_stripe(concurrent_hash_map_t* map, uint64_t hash)
+{
+    return &map->stripes[hash % CONCURRENT_HASH_MAP_STRIPES];
+}
+
+static concurrent_hash_map_table* concurrent_hash_map_table_create(size_t capacity)
+{
+    concurrent_hash_map_table* table = calloc(1, sizeof(concurrent_hash_map_table));
+    if (table)
+        table->slots = calloc(capacity, sizeof(concurrent_hash_map_slot));
+    if (table == NULL || table->slots == NULL) {
+        LOG_ERROR("[Concurrent Hash Map] Failed to allocate %zu slots!\n", capacity);
+        free(table);
+        return NULL;
+    }
+    table->capacity = capacity;
+    return table;
+}
+
+static void concurrent_hash_map_table_destroy(concurrent_hash_map_table* table)
+{
+    free(table->slots);
+    free(table);
+}
+
+static void concurrent_hash_map_destroy_retired(concurrent_hash_map_t* map)
+{
+    concurrent_hash_map_table* table = map->retired;
+    map->retired                     = NULL;
+
+    while (table) {
+        concurrent_hash_map_table* next = table->next_retired;
+        concurrent_hash_map_table_destroy(table);
+        table = next;
+    }
+}
+
+// Every stripe has to be locked and the current table published. The counts are read with an RMW
+// so they are ordered after that store: a lookup counted after a zero loads the current table
+static void concurrent_hash_map_try_reclaim(concurrent_hash_map_t* map)
+{
+    if (map->retired == NULL)
+        return;
+
+    for (uint32_t i = 0; i < CONCURRENT_HASH_MAP_STRIPES; i++) {
+        if (atomic_add_u32(&map->readers[i].count, 0) != 0)
+            return;
+    }
+    concurrent_hash_map_destroy_retired(map);
+}
+
+// Published slot holding key, NULL when it isn't in the table. Busy slots belong to other
+// keys being inserted, the key's own stripe can't be inserting it while we look
+static concurrent_hash_map_slot* concurrent_hash_map_find(concurrent_hash_map_table* table, const random_uuid_t* key, uint64_t hash)
+{
+    size_t   mask = table->capacity - 1;
+    uint32_t tag  = concurrent_hash_map_tag(hash);
+
+    for (size_t i = 0, slot = (size_t) hash & mask; i < table->capacity; i++, slot = (slot + 1) & mask) {
+        concurrent_hash_map_slot* entry     = &table->slots[slot];
+        uint32_t                  entry_tag = atomic_load_u32(&entry->tag);
+        if (entry_tag == CONCURRENT_HASH_MAP_TAG_EMPTY)
+            return NULL;
+        // the tag was stored after the key, so the key is complete here and never changes again
+        if (entry_tag == tag && memcmp(key->data, entry->key.data, sizeof(random_uuid_t)) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+// Claims the first empty slot along the probe, other stripes may be claiming at the same time
+static concurrent_hash_map_slot* concurrent_hash_map_claim(concurrent_hash_map_table* table, uint64_t hash)
+{
+    size_t mask = table->capacity - 1;
+
+    for (size_t slot = (size_t) hash & mask;; slot = (slot + 1) & mask) {
+        concurrent_hash_map_slot* entry = &table->slots[slot];
+        if (atomic_load_u32(&entry->tag) == CONCURRENT_HASH_MAP_TAG_EMPTY && atomic_cas_u32(&entry->tag, CONCURRENT_HASH_MAP_TAG_EMPTY, CONCURRENT_HASH_MAP_TAG_BUSY) == CONCURRENT_HASH_MAP_TAG_EMPTY) {
+            atomic_add_u32(&table->used, 1);
+            return entry;
+        }
+    }
+}
+
+static void concurrent_hash_map_publish(concurrent_hash_map_slot* entry, const random_uuid_t* key, void* value, uint64_t hash)
+{
+    entry->key = *key;
+    atomic_store_ptr(&entry->value, value);
+    atomic_store_u32(&entry->tag, concurrent_hash_map_tag(hash));
+}
+
+// Every stripe has to be locked, no writer can touch the table meanwhile
+static void concurrent_hash_map_resize(concurrent_hash_map_t* map, size_t new_capacity)
+{
+    concurrent_hash_map_table* old_table = map->table;
+    concurrent_hash_map_table* new_table = concurrent_hash_map_table_create(new_capacity);
+    if (new_table == NULL)
+        return;
+
+    for (size_t i = 0; i < old_table->capacity; i++) {
+        concurrent_hash_map_slot* entry = &old_table->slots[i];
+        if (entry->tag <= CONCURRENT_HASH_MAP_TAG_REMOVED)
+            continue;
+
+        uint64_t                  hash = hash_map_hash_uuid(&entry->key);
+        concurrent_hash_map_slot* slot = concurrent_hash_map_claim(new_table, hash);
+        concurrent_hash_map_publish(slot, &entry->key, entry->value, hash);
+    }
+
+    // readers that loaded the old table keep using it, it is only freed once none is left
+    atomic_store_ptr((void* volatile*) &map->table, new_table);
+    old_table->next_retired = map->retired;
+    map->retired            = old_table;
+    concurrent_hash_map_try_reclaim(map);
+}
+
+// Called without any stripe held, rechecks once everything is locked since another writer may have resized already
+static void concurrent_hash_map_grow(concurrent_hash_map_t* map)
+{
+    for (uint32_t i = 0; i < CONCURRENT_HASH_MAP_STRIPES; i++)
+        mutex_lock(&map->stripes[i]);
+
+    concurrent_hash_map_table* table = map->table;
+    if ((table->used + CONCURRENT_HASH_MAP_STRIPES) * 2 > table->capacity) {
+        // mostly tombstones, a cleanup at the same size is enough
+        size_t new_capacity = (size_t) map->length * 4 > table->capacity ? table->capacity * 2 : table->capacity;
+        concurrent_hash_map_resize(map, new_capacity);
+    }
+
+    for (uint32_t i = CONCURRENT_HASH_MAP_STRIPES; i > 0; i--)
+        mutex_unlock(&map->stripes[i - 1]);
+}
+
+////////////////////////////////////////////////////////////
+// Public API
+
+concurrent_hash_map_t* concurrent_hash_map_create(size_t initial_capacity)
+{
+    concurrent_hash_map_t* map = calloc(1, sizeof(concurrent_hash_map_t));
+    if (map == NULL)
+        return NULL;
+
+    size_t capacity = CONCURRENT_HASH_MAP_MIN_CAPACITY;
+    while (capacity < initial_capacity)
+        capacity *= 2;
+
+    map->table = concurrent_hash_map_table_create(capacity);
+    if (map->table == NULL) {
+        free(map);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < CONCURRENT_HASH_MAP_STRIPES; i++)
+        mutex_init(&map->stripes[i]);
+    return map;
+}
+
+void concurrent_hash_map_destroy(concurrent_hash_map_t* map)
+{
+    concurrent_hash_map_destroy_retired(map);
+    concurrent_hash_map_table_destroy(map->table);
+    for (uint32_t i = 0; i < CONCURRENT_HASH_MAP_STRIPES; i++)
+        mutex_destroy(&map->stripes[i]);
+    free(map);
+}
+
+void* concurrent_hash_map_get_value(concurrent_hash_map_t* map, random_uuid_t key)
+{
+    uint64_t           hash    = hash_map_hash_uuid(&key);
+    volatile uint32_t* readers = &map->readers[hash % CONCURRENT_HASH_MAP_STRIPES].count;
+
+    // counted before the table is loaded, a resize can't free it until we're done
+    atomic_add_u32(readers, 1);
+    concurrent_hash_map_slot* entry = concurrent_hash_map_find(atomic_load_ptr((void* volatile*) &map->table), &key, hash);
+    // a remove clears the value before the tag, either one reads as missing
+    void* value = entry ? atomic_load_ptr(&entry->value) : NULL;
+    atomic_add_u32(readers, (uint32_t) -1);
+    return value;
+}
+
+void concurrent_hash_map_set_key_value(concurrent_hash_map_t* map, random_uuid_t key, void* value)
+{
+    uint64_t hash   = hash_map_hash_uuid(&key);
+    mutex_t* stripe = concurrent_hash_map_stripe(map, hash);
+
+    for (;;) {
+        mutex_lock(stripe);
+        concurrent_hash_map_table* table = map->table;
+
+        concurrent_hash_map_slot* entry = concurrent_hash_map_find(table, &key, hash);
+        if (entry) {
+            atomic_store_ptr(&entry->value, value);
+            mutex_unlock(stripe);
+            return;
+        }
+
+        // every other stripe may claim one more slot before it sees the table is full
+        if ((atomic_load_u32(&table->used) + CONCURRENT_HASH_MAP_STRIPES) * 2 <= table->capacity) {
+            concurrent_hash_map_publish(concurrent_hash_map_claim(table, hash), &key, value, hash);
+            atomic_add_u32(&map->length, 1);
+            mutex_unlock(stripe);
+            return;
+        }
+
+        mutex_unlock(stripe);
+        concurrent_hash_map_grow(map);
+    }
+}
+
+bool concurrent_hash_map_remove_entry(concurrent_hash_map_t* map, random_uuid_t key)
+{
+    uint64_t hash   = hash_map_hash_uuid(&key);
+    mutex_t* stripe = concurrent_hash_map_stripe(map, hash);
+
+    mutex_lock(stripe);
+    concurrent_hash_map_slot* entry = concurrent_hash_map_find(map->table, &key, hash);
+    if (entry) {
+        // the slot keeps its key until the next resize, readers that already matched it just see NULL
+        atomic_store_ptr(&entry->value, NULL);
+        atomic_store_u32(&entry->tag, CONCURRENT_HASH_MAP_TAG_REMOVED);
+        atomic_add_u32(&map->length, (uint32_t) -1);
+    }
+    mutex_unlock(stripe);
+    return entry != NULL;
+}
+
+void concurrent_hash_map_reclaim(concurrent_hash_map_t* map)
+{
+    // retired is only written with every stripe locked
+    for (uint32_t i = 0; i < CONCURRENT_HASH_MAP_STRIPES; i++)
+        mutex_lock(&map->stripes[i]);
+
+    concurrent_hash_map_try_reclaim(map);
+
+    for (uint32_t i = CONCURRENT_HASH_MAP_STRIPES; i > 0; i--)
+        mutex_unlock(&map->stripes[i - 1]);
+}
@@ -0,0 +1,87 @@
+#ifndef CONCURRENT_HASH_MAP_H
+#define CONCURRENT_HASH_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "threads/threads.h"
+#include "uuid/uuid.h"
+
+/*******************************/
+// Concurrent HashMap
+/*******************************/
+
+// uuid -> void* map that any number of threads can read while others insert and remove.
+//
+// Reads take no lock: slots are published by storing their tag last, and a published slot keeps
+// its key for the lifetime of the table (removes leave a tombstone, only a resize reuses the
+// memory). Writers lock one of CONCURRENT_HASH_MAP_STRIPES mutexes picked by the key hash, so the
+// same key is never written by two threads at once, and claim free slots with a CAS. Resizing
+// locks every stripe, copies into a new table and publishes it with a single pointer store.
+//
+// Readers still on the old table finish there, so old tables are retired instead of freed. Each
+// lookup counts itself in the reader count of its key's stripe, one cache line per stripe so
+// lookups of different keys don't contend. Resizes free the retired tables whenever every count
+// reads zero: a lookup that starts after that loads the new table.
+
+#define CONCURRENT_HASH_MAP_STRIPES 64
+// Linear probing, grows once used + removed slots pass half the capacity
+#define CONCURRENT_HASH_MAP_MIN_CAPACITY (4 * CONCURRENT_HASH_MAP_STRIPES)
+
+typedef struct concurrent_hash_map_slot
+{
+    volatile uint32_t tag;    // 0 empty, 1 being written, 2 removed, otherwise the high bits of the hash
+    uint32_t          _pad0;
+    random_uuid_t     key;
+    void* volatile    value;
+} concurrent_hash_map_slot;
+
+typedef struct concurrent_hash_map_table concurrent_hash_map_table;
+
+struct concurrent_hash_map_table
+{
+    concurrent_hash_map_slot*  slots;
+    size_t                     capacity;
+    volatile uint32_t          used;    // claimed slots, tombstones included
+    uint32_t                   _pad0;
+    concurrent_hash_map_table* next_retired;
+};
+
+typedef struct concurrent_hash_map_readers
+{
+    volatile uint32_t count;    // lookups in flight for keys of this stripe
+    uint32_t          _pad0[15];
+} concurrent_hash_map_readers;
+
+typedef struct concurrent_hash_map_t
+{
+    concurrent_hash_map_table* volatile table;
+    volatile uint32_t                   length;
+    uint32_t                            _pad0;
+    mutex_t                             stripes[CONCURRENT_HASH_MAP_STRIPES];
+    concurrent_hash_map_readers         readers[CONCURRENT_HASH_MAP_STRIPES];
+    concurrent_hash_map_table*          retired;    // replaced while readers may still be walking them, freed once no lookup is in flight
+} concurrent_hash_map_t;
+
+concurrent_hash_map_t* concurrent_hash_map_create(size_t initial_capacity);
+// No other thread may use the map anymore
+void concurrent_hash_map_destroy(concurrent_hash_map_t* map);
+
+// Lock free, NULL when key isn't in the map
+void* concurrent_hash_map_get_value(concurrent_hash_map_t* map, random_uuid_t key);
+// value must not be NULL, a NULL value reads as missing
+void concurrent_hash_map_set_key_value(concurrent_hash_map_t* map, random_uuid_t key, void* value);
+bool concurrent_hash_map_remove_entry(concurrent_hash_map_t* map, random_uuid_t key);
+
+// Frees the tables retired by resizes if no lookup is in flight, safe to call from any thread.
+// Every resize already does this, only a map that stopped resizing while lookups were running
+// keeps its retired tables until the next resize, a call or destroy
+void concurrent_hash_map_reclaim(concurrent_hash_map_t* map);
+
+static inline uint32_t concurrent_hash_map_get_length(const concurrent_hash_map_t* map)
+{
+    return map->length;
+}
+
+#endif    // CONCURRENT_HASH_MAP_H
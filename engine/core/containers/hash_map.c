@@ -3,11 +3,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "hash_map_group.h"
+
 #include "common.h"
 
 #include "simd/intrinsics.h"
 
 #include "logging/log.h"
+#include "time/timer.h"
 #include "uuid/uuid.h"
 
 // [source]: Hash hash_map Hash Function: FNV-1a
@@ -16,85 +19,65 @@
 ////////////////////////////////////////////////////////////
 // Private API
 
-// Hash function
-static uint64_t murmur_hash_uuid(const random_uuid_t* uuid)
-{
-    const uint64_t seed = 0xc70f6907UL;            // Seed for hashing
-    const uint64_t m    = 0xc6a4a7935bd1e995UL;    // Multiplier constant
-    const int      r    = 47;                      // Right shift for mixing
-
-    uint64_t hash = seed ^ (16 * m);    // UUID is 16 bytes (128 bits)
-
-    const uint64_t* data = (const uint64_t*) uuid;
-
-    // Hash the first 64 bits
-    uint64_t k1 = data[0];
-    k1 *= m;
-    k1 ^= k1 >> r;
-    k1 *= m;
-    hash ^= k1;
-    hash *= m;
-
-    // Hash the second 64 bits
-    uint64_t k2 = data[1];
-    k2 *= m;
-    k2 ^= k2 >> r;
-    k2 *= m;
-    hash ^= k2;
-    hash *= m;
+//-----------------------------------------------------------------
+// Internal methods
 
-    // Final mixing of the hash to reduce entropy
-    hash ^= hash >> r;
-    hash *= m;
-    hash ^= hash >> r;
+// Removed slots keep a null key so entry walkers skip them, the hash tells them apart from never used ones
+#define HASH_MAP_QUADRATIC_TOMBSTONE UINT64_MAX
 
-    return hash;
+static size_t hash_map_quadratic_probe(size_t home, size_t i, size_t capacity)
+{
+    // triangular offsets visit every slot once when capacity is a power of two
+    return (home + i * (i + 1) / 2) & (capacity - 1);
 }
 
-//-----------------------------------------------------------------
-// Internal methods
-static size_t hash_map_quadratic_probe(size_t index, size_t i, size_t capacity)
+static bool hash_map_quadratic_is_tombstone(const hash_map_pair_t* entry)
 {
-    return (index + i * i) % capacity;
+    return uuid_is_null(&entry->key) && entry->hash == HASH_MAP_QUADRATIC_TOMBSTONE;
 }
 
-static void hash_map_set_entry(hash_map_pair_t* hash_map_entries, size_t capacity, random_uuid_t key, void* value, size_t* plength)
+// Slot holding key, capacity when it isn't in the map. Stops at the first never used slot
+static size_t hash_map_quadratic_find(const hash_map_pair_t* entries, size_t capacity, const random_uuid_t* key, uint64_t hash)
 {
-    // first compute the hash for the key
-    hash_map_entries->hash = murmur_hash_uuid((const random_uuid_t*) &key);
-    // wrap it around capacity
-    size_t index = (size_t) (hash_map_entries->hash & (uint64_t) (capacity - 1));
-    size_t i     = 0;
+    size_t home = (size_t) (hash & (uint64_t) (capacity - 1));
 
-    while (!uuid_is_null(&hash_map_entries[index].key)) {
-        if (memcmp(key.data, &hash_map_entries[index].key.data, sizeof(random_uuid_t)) == 0) {
-            // entry found update it (empty/existing)
-            hash_map_entries[index].value = value;
-            return;
+    for (size_t i = 0; i < capacity; i++) {
+        size_t index = hash_map_quadratic_probe(home, i, capacity);
+        // Prefetch the next entry
+        prefetch(&entries[hash_map_quadratic_probe(home, i + 1, capacity)]);
+
+        const hash_map_pair_t* entry = &entries[index];
+        if (uuid_is_null(&entry->key)) {
+            if (!hash_map_quadratic_is_tombstone(entry))
+                return capacity;
+            continue;
         }
 
-        // Quadratic probing
-        i++;
-        index = hash_map_quadratic_probe(index, i, capacity);
+        if (memcmp(key->data, entry->key.data, sizeof(random_uuid_t)) == 0)
+            return index;
     }
+    return capacity;
+}
 
-    if (plength != NULL) {
-        (*plength)++;
+// Places a key known to be absent in the first free or removed slot, true if it reused a tombstone
+static bool hash_map_quadratic_place(hash_map_pair_t* entries, size_t capacity, const hash_map_pair_t* pair)
+{
+    size_t home = (size_t) (pair->hash & (uint64_t) (capacity - 1));
+
+    for (size_t i = 0;; i++) {
+        hash_map_pair_t* entry = &entries[hash_map_quadratic_probe(home, i, capacity)];
+        if (uuid_is_null(&entry->key)) {
+            bool tombstone = hash_map_quadratic_is_tombstone(entry);
+            *entry         = *pair;
+            return tombstone;
+        }
     }
-
-    uuid_copy(&key, &hash_map_entries[index].key);
-    hash_map_entries[index].value = value;
 }
 
-static bool hash_map_expand(hash_map_t* hash_map)
+// Rehashes into new_capacity slots, also drops the tombstones when the capacity stays the same
+static bool hash_map_quadratic_resize(hash_map_t* hash_map, size_t new_capacity)
 {
-    //LOG_INFO("[Hash Map] Expanding hash map... previous size: %zu, new size: %zu\n", hash_map->capacity, hash_map->capacity * 2);
-    // Allocate new entries array
-    size_t new_capacity = hash_map->capacity * 2;
-    if (new_capacity < hash_map->capacity) {
-        LOG_ERROR("[Hash Map] Failed to expand, overflow!\n");
-        return false;    // overflow (capacity would be too big)
-    }
+    uint64_t start = timer_now_ns();
 
     hash_map_pair_t* new_entries = calloc(new_capacity, sizeof(hash_map_pair_t));
     if (new_entries == NULL) {
@@ -104,32 +87,369 @@ static bool hash_map_expand(hash_map_t* hash_map)
 
     // Iterate entries, move all non-empty ones to new hash_map's entries.
     for (size_t i = 0; i < hash_map->capacity; i++) {
-        hash_map_pair_t entry = hash_map->entries[i];
-        prefetch(&entry);
-        if (!uuid_is_null(&entry.key)) {
-            hash_map_set_entry(new_entries, new_capacity, entry.key, entry.value, NULL);
-        }
+        if (!uuid_is_null(&hash_map->entries[i].key))
+            hash_map_quadratic_place(new_entries, new_capacity, &hash_map->entries[i]);
     }
 
     // Free old entries array and update this hash_map's details.
     free(hash_map->entries);
     hash_map->entries  = new_entries;
     hash_map->capacity = new_capacity;
+    hash_map->deleted  = 0;
 
-    //print_map(hash_map);
+    hash_map->resize_count++;
+    hash_map->rehash_ns += timer_now_ns() - start;
+    return true;
+}
+
+static void hash_map_quadratic_set(hash_map_t* hash_map, random_uuid_t key, void* value)
+{
+    uint64_t hash = hash_map_hash_uuid(&key);
+    size_t   slot = hash_map_quadratic_find(hash_map->entries, hash_map->capacity, &key, hash);
+    if (slot != hash_map->capacity) {
+        // entry found update it
+        hash_map->entries[slot].value = value;
+        return;
+    }
 
+    // Keep used + removed slots under half the capacity, mostly tombstones only need a cleanup
+    if ((hash_map->length + hash_map->deleted + 1) * 2 > hash_map->capacity) {
+        size_t new_capacity = hash_map->capacity;
+        if ((hash_map->length + 1) * 4 > hash_map->capacity) {
+            new_capacity = hash_map->capacity * 2;
+            if (new_capacity < hash_map->capacity) {
+                LOG_ERROR("[Hash Map] Failed to expand, overflow!\n");
+                return;    // overflow (capacity would be too big)
+            }
+        }
+        if (!hash_map_quadratic_resize(hash_map, new_capacity))
+            return;
+    }
+
+    hash_map_pair_t pair = {.value = value, .hash = hash};
+    uuid_copy(&key, &pair.key);
+    if (hash_map_quadratic_place(hash_map->entries, hash_map->capacity, &pair))
+        hash_map->deleted--;
+    hash_map->length++;
+}
+
+static bool hash_map_quadratic_remove(hash_map_t* hash_map, random_uuid_t key)
+{
+    size_t slot = hash_map_quadratic_find(hash_map->entries, hash_map->capacity, &key, hash_map_hash_uuid(&key));
+    if (slot == hash_map->capacity)
+        return false;
+
+    hash_map->entries[slot] = (hash_map_pair_t){.hash = HASH_MAP_QUADRATIC_TOMBSTONE};
+    hash_map->length--;
+    hash_map->deleted++;
     return true;
 }
 
+//-----------------------------------------------------------------
+// Grouped (Swiss table) mode, the probing core lives in hash_map_group.h
+
+static bool hash_map_keys_equal(const random_uuid_t* a, const random_uuid_t* b)
+{
+    return memcmp(a->data, b->data, sizeof(random_uuid_t)) == 0;
+}
+
+// Slot holding key, capacity when it isn't in the table
+static size_t hash_map_grouped_find_in(const hash_map_pair_t* entries, const uint8_t* ctrl, size_t capacity, const random_uuid_t* key, uint64_t hash)
+{
+    size_t  group_mask = capacity / HASH_MAP_GROUP_WIDTH - 1;
+    size_t  group      = hash_map_h1(hash) & group_mask;
+    uint8_t h2         = hash_map_h2(hash);
+
+    for (size_t probe = 0; probe <= group_mask; probe++) {
+        const uint8_t* group_ctrl = &ctrl[group * HASH_MAP_GROUP_WIDTH];
+
+        hash_map_group_mask match = hash_map_group_match(group_ctrl, h2);
+        while (match) {
+            size_t slot = group * HASH_MAP_GROUP_WIDTH + hash_map_group_lowest(match);
+            if (hash_map_keys_equal(key, &entries[slot].key))
+                return slot;
+            match &= match - 1;
+        }
+
+        // a key is never placed past a group that still had an empty slot
+        if (hash_map_group_match(group_ctrl, HASH_MAP_CTRL_EMPTY))
+            return capacity;
+
+        group = (group + probe + 1) & group_mask;
+    }
+    return capacity;
+}
+
+static size_t hash_map_grouped_find(const hash_map_t* hash_map, const random_uuid_t* key, uint64_t hash)
+{
+    return hash_map_grouped_find_in(hash_map->entries, hash_map->ctrl, hash_map->capacity, key, hash);
+}
+
+// Same as above while a resize is in flight, keys not moved yet are still in the old table
+static hash_map_pair_t* hash_map_grouped_lookup(const hash_map_t* hash_map, const random_uuid_t* key, uint64_t hash)
+{
+    size_t slot = hash_map_grouped_find(hash_map, key, hash);
+    if (slot != hash_map->capacity)
+        return &hash_map->entries[slot];
+
+    if (hash_map->old_ctrl) {
+        slot = hash_map_grouped_find_in(hash_map->old_entries, hash_map->old_ctrl, hash_map->old_capacity, key, hash);
+        if (slot != hash_map->old_capacity)
+            return &hash_map->old_entries[slot];
+    }
+    return NULL;
+}
+
+static bool hash_map_grouped_alloc(size_t capacity, hash_map_pair_t** entries, uint8_t** ctrl)
+{
+    *entries = calloc(capacity, sizeof(hash_map_pair_t));
+    *ctrl    = malloc(capacity);
+    if (*entries == NULL || *ctrl == NULL) {
+        LOG_ERROR("[Hash Map] Failed to allocate %zu slots!\n", capacity);
+        free(*entries);
+        free(*ctrl);
+        return false;
+    }
+    memset(*ctrl, HASH_MAP_CTRL_EMPTY, capacity);
+    return true;
+}
+
+// Places an entry known to be absent, no duplicate check and no growth
+static void hash_map_grouped_place(hash_map_t* hash_map, const hash_map_pair_t* entry)
+{
+    size_t slot = hash_map_group_find_free(hash_map->ctrl, hash_map->capacity, entry->hash);
+    if (hash_map->ctrl[slot] == HASH_MAP_CTRL_DELETED)
+        hash_map->deleted--;
+
+    hash_map->ctrl[slot]    = hash_map_h2(entry->hash);
+    hash_map->entries[slot] = *entry;
+}
+
+// Moves up to slot_count slots of the old table over, frees it once the last one is done
+static void hash_map_grouped_migrate(hash_map_t* hash_map, size_t slot_count)
+{
+    size_t end = hash_map->migrate_slot + slot_count < hash_map->old_capacity ? hash_map->migrate_slot + slot_count : hash_map->old_capacity;
+
+    for (size_t slot = hash_map->migrate_slot; slot < end; slot++) {
+        if (hash_map->old_ctrl[slot] & HASH_MAP_CTRL_EMPTY)
+            continue;
+
+        hash_map_grouped_place(hash_map, &hash_map->old_entries[slot]);
+        // not EMPTY, lookups for keys further down the old table still have to probe past it
+        hash_map->old_ctrl[slot] = HASH_MAP_CTRL_DELETED;
+    }
+    hash_map->migrate_slot = end;
+
+    if (hash_map->migrate_slot == hash_map->old_capacity) {
+        free(hash_map->old_entries);
+        free(hash_map->old_ctrl);
+        hash_map->old_entries  = NULL;
+        hash_map->old_ctrl     = NULL;
+        hash_map->old_capacity = 0;
+        hash_map->migrate_slot = 0;
+    }
+}
+
+// Drops the tombstones without a second table. Full slots are marked DELETED first, then each
+// one moves to the first free slot of its probe sequence, swapping with an entry not placed yet
+static void hash_map_grouped_rehash_in_place(hash_map_t* hash_map)
+{
+    hash_map_pair_t* entries  = hash_map->entries;
+    uint8_t*         ctrl     = hash_map->ctrl;
+    size_t           capacity = hash_map->capacity;
+
+    for (size_t slot = 0; slot < capacity; slot++)
+        ctrl[slot] = (ctrl[slot] & HASH_MAP_CTRL_EMPTY) ? HASH_MAP_CTRL_EMPTY : HASH_MAP_CTRL_DELETED;
+
+    for (size_t slot = 0; slot < capacity; slot++) {
+        while (ctrl[slot] == HASH_MAP_CTRL_DELETED) {
+            uint64_t hash   = entries[slot].hash;
+            size_t   target = hash_map_group_find_free(ctrl, capacity, hash);
+
+            // every group before this one on the probe sequence is full, the entry stays
+            if (target / HASH_MAP_GROUP_WIDTH == slot / HASH_MAP_GROUP_WIDTH) {
+                ctrl[slot] = hash_map_h2(hash);
+                break;
+            }
+
+            if (ctrl[target] == HASH_MAP_CTRL_EMPTY) {
+                entries[target] = entries[slot];
+                entries[slot]   = (hash_map_pair_t){0};
+                ctrl[target]    = hash_map_h2(hash);
+                ctrl[slot]      = HASH_MAP_CTRL_EMPTY;
+                break;
+            }
+
+            // target holds an entry not placed yet, it comes back here and is placed next
+            hash_map_pair_t displaced = entries[target];
+            entries[target]           = entries[slot];
+            entries[slot]             = displaced;
+            ctrl[target]              = hash_map_h2(hash);
+        }
+    }
+
+    hash_map->deleted = 0;
+}
+
+// Rehashes into new_capacity slots, the tombstone only cleanup at the same capacity is done in place.
+// With incremental resize the current table only becomes the old one, inserts move it over
+static bool hash_map_grouped_resize(hash_map_t* hash_map, size_t new_capacity)
+{
+    uint64_t start = timer_now_ns();
+
+    // one resize at a time, only happens when the old table was left with very few inserts
+    if (hash_map->old_ctrl)
+        hash_map_grouped_migrate(hash_map, hash_map->old_capacity);
+
+    if (new_capacity == hash_map->capacity) {
+        hash_map_grouped_rehash_in_place(hash_map);
+        hash_map->resize_count++;
+        hash_map->rehash_ns += timer_now_ns() - start;
+        return true;
+    }
+
+    hash_map_pair_t* new_entries = NULL;
+    uint8_t*         new_ctrl    = NULL;
+    if (!hash_map_grouped_alloc(new_capacity, &new_entries, &new_ctrl))
+        return false;
+
+    hash_map->old_entries   = hash_map->entries;
+    hash_map->old_ctrl      = hash_map->ctrl;
+    hash_map->old_capacity  = hash_map->capacity;
+    hash_map->migrate_slot  = 0;
+    hash_map->entries       = new_entries;
+    hash_map->ctrl          = new_ctrl;
+    hash_map->capacity      = new_capacity;
+    hash_map->deleted       = 0;
+
+    if (!hash_map->incremental_resize)
+        hash_map_grouped_migrate(hash_map, hash_map->old_capacity);
+
+    hash_map->resize_count++;
+    hash_map->rehash_ns += timer_now_ns() - start;
+    return true;
+}
+
+// EMPTY when the group still has an empty slot, see hash_map_grouped_find_in, true if it left a tombstone
+static bool hash_map_grouped_clear_slot(hash_map_pair_t* entries, uint8_t* ctrl, size_t slot)
+{
+    ctrl[slot]    = hash_map_group_cleared_ctrl(ctrl, slot);
+    entries[slot] = (hash_map_pair_t){0};
+    return ctrl[slot] == HASH_MAP_CTRL_DELETED;
+}
+
+static void hash_map_grouped_set(hash_map_t* hash_map, random_uuid_t key, void* value)
+{
+    if (hash_map->old_ctrl)
+        hash_map_grouped_migrate(hash_map, HASH_MAP_MIGRATE_SLOTS);
+
+    uint64_t hash = hash_map_hash_uuid(&key);
+    size_t   slot = hash_map_grouped_find(hash_map, &key, hash);
+    if (slot != hash_map->capacity) {
+        hash_map->entries[slot].value = value;
+        return;
+    }
+
+    // not moved yet, take it out of the old table and insert it like a new key
+    if (hash_map->old_ctrl) {
+        slot = hash_map_grouped_find_in(hash_map->old_entries, hash_map->old_ctrl, hash_map->old_capacity, &key, hash);
+        if (slot != hash_map->old_capacity) {
+            hash_map_grouped_clear_slot(hash_map->old_entries, hash_map->old_ctrl, slot);
+            hash_map->length--;
+        }
+    }
+
+    if ((hash_map->length + hash_map->deleted + 1) * HASH_MAP_GROUP_MAX_LOAD_DEN > hash_map->capacity * HASH_MAP_GROUP_MAX_LOAD_NUM) {
+        // mostly tombstones, cleaning them up in place is enough
+        size_t new_capacity = hash_map->capacity;
+        if ((hash_map->length + 1) * 2 > hash_map->capacity) {
+            new_capacity = hash_map->capacity * 2;
+            if (new_capacity < hash_map->capacity) {
+                LOG_ERROR("[Hash Map] Failed to expand, overflow!\n");
+                return;
+            }
+        }
+        if (!hash_map_grouped_resize(hash_map, new_capacity))
+            return;
+    }
+
+    hash_map_pair_t entry = {.value = value, .hash = hash};
+    uuid_copy(&key, &entry.key);
+    hash_map_grouped_place(hash_map, &entry);
+    hash_map->length++;
+}
+
+static bool hash_map_grouped_remove(hash_map_t* hash_map, random_uuid_t key)
+{
+    // a shrink only makes progress here when nothing gets inserted
+    if (hash_map->old_ctrl)
+        hash_map_grouped_migrate(hash_map, HASH_MAP_MIGRATE_SLOTS);
+
+    uint64_t hash = hash_map_hash_uuid(&key);
+    size_t   slot = hash_map_grouped_find(hash_map, &key, hash);
+    if (slot != hash_map->capacity) {
+        if (hash_map_grouped_clear_slot(hash_map->entries, hash_map->ctrl, slot))
+            hash_map->deleted++;
+        hash_map->length--;
+        return true;
+    }
+
+    // old table tombstones go away with it, they aren't counted
+    if (hash_map->old_ctrl) {
+        slot = hash_map_grouped_find_in(hash_map->old_entries, hash_map->old_ctrl, hash_map->old_capacity, &key, hash);
+        if (slot != hash_map->old_capacity) {
+            hash_map_grouped_clear_slot(hash_map->old_entries, hash_map->old_ctrl, slot);
+            hash_map->length--;
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------
+
+static void hash_map_destroy_keys(hash_map_pair_t* entries, size_t capacity)
+{
+    for (size_t i = 0; i < capacity; i++) {
+        if (!uuid_is_null(&entries[i].key)) {
+            uuid_destroy(&entries[i].key);
+        }
+    }
+}
+
+static bool hash_map_resize(hash_map_t* hash_map, size_t new_capacity)
+{
+    if (hash_map->mode == HASH_MAP_MODE_GROUPED)
+        return hash_map_grouped_resize(hash_map, new_capacity);
+    return hash_map_quadratic_resize(hash_map, new_capacity);
+}
+
 ////////////////////////////////////////////////////////////
 // Public API
 
 hash_map_t* hash_map_create(size_t initial_capacity)
+{
+    return hash_map_create_with_mode(initial_capacity, HASH_MAP_MODE_GROUPED);
+}
+
+hash_map_t* hash_map_create_with_mode(size_t initial_capacity, hash_map_mode mode)
 {
     // key_value_pair will be allocated/freed on demand
     hash_map_t* hash_map = calloc(1, sizeof(hash_map_t));
-    hash_map->capacity   = initial_capacity;
-    hash_map->length     = 0;
+    hash_map->mode       = mode;
+
+    hash_map->capacity     = hash_map_round_capacity(initial_capacity);
+    hash_map->min_capacity = hash_map->capacity;
+    hash_map->length       = 0;
+
+    if (mode == HASH_MAP_MODE_GROUPED) {
+        if (!hash_map_grouped_alloc(hash_map->capacity, &hash_map->entries, &hash_map->ctrl)) {
+            free(hash_map);
+            return NULL;
+        }
+        return hash_map;
+    }
+
     // create memory for all entries and init them to 0
     hash_map->entries = (hash_map_pair_t*) calloc(hash_map->capacity, sizeof(hash_map_pair_t));
 
@@ -138,13 +458,17 @@ hash_map_t* hash_map_create(size_t initial_capacity)
 
 void hash_map_destroy(hash_map_t* hash_map)
 {
-    for (size_t i = 0; i < hash_map->capacity; i++) {
-        if (!uuid_is_null(&hash_map->entries[i].key)) {
-            uuid_destroy(&hash_map->entries[i].key);
-        }
-    }
+    hash_map_destroy_keys(hash_map->entries, hash_map->capacity);
+    // mid incremental resize the keys not moved over yet are only in the old table
+    if (hash_map->old_entries)
+        hash_map_destroy_keys(hash_map->old_entries, hash_map->old_capacity);
+
     free(hash_map->entries);
     hash_map->entries = NULL;
+    free(hash_map->ctrl);
+    hash_map->ctrl = NULL;
+    free(hash_map->old_entries);
+    free(hash_map->old_ctrl);
     free(hash_map);
     hash_map = NULL;
 }
@@ -165,47 +489,68 @@ void hash_map_print(hash_map_t* map)
 
 void* hash_map_get_value(const hash_map_t* hash_map, random_uuid_t key)
 {
-    // Compute the hash for the key
-    uint64_t hash  = murmur_hash_uuid((const random_uuid_t*) &key);
-    size_t   index = (size_t) (hash & (uint64_t) (hash_map->capacity - 1));
-    size_t   i     = 0;
-
-    // Prefetch memory ahead of the lookup
-    prefetch(&hash_map->entries[index]);
-
-    while (i < hash_map->capacity)    // Optimized loop to reduce condition checks
-    {
-        // If key is not NULL, compare it
-        if (!uuid_is_null(&hash_map->entries[index].key)) {
-            // Compare the key using memcmp for faster comparison
-            if (memcmp(key.data, hash_map->entries[index].key.data, sizeof(random_uuid_t)) == 0) {
-                return hash_map->entries[index].value;
-            }
+    if (hash_map->mode == HASH_MAP_MODE_GROUPED) {
+        const hash_map_pair_t* entry = hash_map_grouped_lookup(hash_map, &key, hash_map_hash_uuid(&key));
+        return entry ? entry->value : NULL;
+    }
+
+    size_t slot = hash_map_quadratic_find(hash_map->entries, hash_map->capacity, &key, hash_map_hash_uuid(&key));
+    return slot != hash_map->capacity ? hash_map->entries[slot].value : NULL;
+}
+
+void hash_map_get_values_batch(const hash_map_t* hash_map, const random_uuid_t* keys, size_t count, void** out_values)
+{
+    uint64_t hashes[HASH_MAP_BATCH_WINDOW];
+
+    for (size_t first = 0; first < count; first += HASH_MAP_BATCH_WINDOW) {
+        size_t window = count - first < HASH_MAP_BATCH_WINDOW ? count - first : HASH_MAP_BATCH_WINDOW;
+
+        // nothing to overlap a single lookup with
+        if (window == 1) {
+            out_values[first] = hash_map_get_value(hash_map, keys[first]);
+            continue;
         }
 
-        i++;
-        index = hash_map_quadratic_probe(index, i, hash_map->capacity);
+        if (hash_map->mode != HASH_MAP_MODE_GROUPED) {
+            for (size_t i = 0; i < window; i++)
+                prefetch(&hash_map->entries[hash_map_hash_uuid(&keys[first + i]) & (uint64_t) (hash_map->capacity - 1)]);
+            for (size_t i = 0; i < window; i++)
+                out_values[first + i] = hash_map_get_value(hash_map, keys[first + i]);
+            continue;
+        }
 
-        // Prefetch the next entry
-        prefetch(&hash_map->entries[index]);
-    }
+        size_t group_mask = hash_map->capacity / HASH_MAP_GROUP_WIDTH - 1;
 
-    LOG_ERROR("-----------------------------\n");
-    LOG_ERROR("hash_map value not found! INDEX : %zu KEY: %s\n", index, uuid_to_string(&key));
-    LOG_ERROR("-----------------------------\n");
-    return NULL;
+        // 1. control bytes of every home group
+        for (size_t i = 0; i < window; i++) {
+            hashes[i] = hash_map_hash_uuid(&keys[first + i]);
+            prefetch(&hash_map->ctrl[(hash_map_h1(hashes[i]) & group_mask) * HASH_MAP_GROUP_WIDTH]);
+        }
+
+        // 2. the first candidate slot, almost always the only one
+        for (size_t i = 0; i < window; i++) {
+            size_t              group = hash_map_h1(hashes[i]) & group_mask;
+            hash_map_group_mask match = hash_map_group_match(&hash_map->ctrl[group * HASH_MAP_GROUP_WIDTH], hash_map_h2(hashes[i]));
+            if (match)
+                prefetch(&hash_map->entries[group * HASH_MAP_GROUP_WIDTH + hash_map_group_lowest(match)]);
+        }
+
+        // 3. resolve, the lines above should have landed by now
+        for (size_t i = 0; i < window; i++) {
+            const hash_map_pair_t* entry = hash_map_grouped_lookup(hash_map, &keys[first + i], hashes[i]);
+            out_values[first + i]        = entry ? entry->value : NULL;
+        }
+    }
 }
 
 void hash_map_set_key_value(hash_map_t* hash_map, random_uuid_t key, void* value)
 {
-    // If length will exceed half of current capacity, expand it.
-    if (hash_map->length > hash_map->capacity / 2) {
-        if (!hash_map_expand(hash_map)) {
-            return;
-        }
+    if (hash_map->mode == HASH_MAP_MODE_GROUPED) {
+        hash_map_grouped_set(hash_map, key, value);
+        return;
     }
 
-    hash_map_set_entry(hash_map->entries, hash_map->capacity, key, value, &hash_map->length);
+    hash_map_quadratic_set(hash_map, key, value);
 }
 
 void hash_map_set_key_value_pair(hash_map_t* hash_map, hash_map_pair_t* pair)
@@ -215,15 +560,23 @@ void hash_map_set_key_value_pair(hash_map_t* hash_map, hash_map_pair_t* pair)
 
 void hash_map_remove_entry(hash_map_t* hash_map, random_uuid_t key)
 {
-    hash_map_iterator_t it = hash_map_iterator(hash_map, key);
-    if (!uuid_is_null(&it.current_pair.key)) {
-        uuid_destroy(&it.current_pair.key);
-        uuid_destroy(&hash_map->entries[it.index].key);
-    }
-    if (it.current_pair.value != NULL) {
-        it.current_pair.value             = NULL;
-        hash_map->entries[it.index].value = NULL;
-    }
+    bool removed = hash_map->mode == HASH_MAP_MODE_GROUPED ? hash_map_grouped_remove(hash_map, key) : hash_map_quadratic_remove(hash_map, key);
+
+    // halve once occupancy drops below 1/HASH_MAP_SHRINK_RATIO, growing again needs a lot more inserts than that
+    if (removed && hash_map->capacity > hash_map->min_capacity && hash_map->length * HASH_MAP_SHRINK_RATIO < hash_map->capacity)
+        hash_map_resize(hash_map, hash_map->capacity / 2);
+}
+
+void hash_map_shrink_to_fit(hash_map_t* hash_map)
+{
+    // the smallest table that stays at most half full
+    size_t capacity = hash_map_round_capacity(hash_map->length * 2);
+    if (capacity > hash_map->capacity)
+        return;
+
+    hash_map_resize(hash_map, capacity);
+    if (hash_map->old_ctrl)
+        hash_map_grouped_migrate(hash_map, hash_map->old_capacity);
 }
 
 hash_map_iterator_t hash_map_iterator_begin(hash_map_t* hash_map)
@@ -239,35 +592,27 @@ hash_map_iterator_t hash_map_iterator(hash_map_t* hash_map, random_uuid_t key)
     hash_map_iterator_t it;
     it.hash_map_ref = hash_map;
 
-    // First compute the hash for the key
-    uint64_t hash = murmur_hash_uuid((const random_uuid_t*) &key);
-    // Wrap it around capacity
-    it.index = (size_t) (hash & (uint64_t) (hash_map->capacity - 1));
-    size_t i = 0;
-
-    prefetch(&hash_map->entries[it.index]);
-
-    // Start probing for the key
-    while (it.index < hash_map->capacity) {
-        // If we find an empty entry (NULL key), the key is not present
-        if (!uuid_is_null(&hash_map->entries[it.index].key)) {
-            // If the key matches, set the iterator's current pair and return
-            if (memcmp(key.data, hash_map->entries[it.index].key.data, sizeof(random_uuid_t)) == 0) {
-                it.current_pair.key   = hash_map->entries[it.index].key;
-                it.current_pair.value = hash_map->entries[it.index].value;
-                hash_map->length--;
-                return it;
-            }
+    if (hash_map->mode == HASH_MAP_MODE_GROUPED) {
+        const hash_map_pair_t* entry = hash_map_grouped_lookup(hash_map, &key, hash_map_hash_uuid(&key));
+        if (entry == NULL) {
+            it.index        = hash_map->capacity + hash_map->old_capacity;
+            it.current_pair = (hash_map_pair_t){0};
+        } else {
+            // same numbering as hash_map_parse_next, the old table follows the current one
+            bool in_old     = entry < hash_map->entries || entry >= hash_map->entries + hash_map->capacity;
+            it.index        = in_old ? hash_map->capacity + (size_t) (entry - hash_map->old_entries) : (size_t) (entry - hash_map->entries);
+            it.current_pair = *entry;
         }
-
-        i++;
-        it.index = hash_map_quadratic_probe(it.index, i, hash_map->capacity);
-
-        prefetch(&hash_map->entries[it.index]);
+        return it;
     }
 
-    // If not found, return an invalid iterator
-    it.current_pair.value = NULL;
+    it.index = hash_map_quadratic_find(hash_map->entries, hash_map->capacity, &key, hash_map_hash_uuid(&key));
+    if (it.index != hash_map->capacity) {
+        it.current_pair = hash_map->entries[it.index];
+    } else {
+        // If not found, return an invalid iterator
+        it.current_pair = (hash_map_pair_t){0};
+    }
     return it;
 }
 
@@ -286,5 +631,113 @@ bool hash_map_parse_next(hash_map_iterator_t* iterator)
             return true;
         }
     }
+
+    // then whatever a resize in flight hasn't moved yet, moved slots are DELETED
+    while (iterator->index < hash_map->capacity + hash_map->old_capacity) {
+        size_t i = iterator->index - hash_map->capacity;
+        iterator->index++;
+        if (!(hash_map->old_ctrl[i] & HASH_MAP_CTRL_EMPTY)) {
+            iterator->current_pair.key   = hash_map->old_entries[i].key;
+            iterator->current_pair.value = hash_map->old_entries[i].value;
+            return true;
+        }
+    }
     return false;
-}
\ No newline at end of file
+}
+
+size_t hash_map_get_probe_length(const hash_map_t* hash_map, random_uuid_t key)
+{
+    uint64_t hash = hash_map_hash_uuid(&key);
+
+    if (hash_map->mode == HASH_MAP_MODE_QUADRATIC) {
+        size_t home = (size_t) (hash & (uint64_t) (hash_map->capacity - 1));
+        for (size_t i = 0; i < hash_map->capacity; i++) {
+            const hash_map_pair_t* entry = &hash_map->entries[hash_map_quadratic_probe(home, i, hash_map->capacity)];
+            if (uuid_is_null(&entry->key) ? !hash_map_quadratic_is_tombstone(entry) : hash_map_keys_equal(&key, &entry->key))
+                return i + 1;
+        }
+        return hash_map->capacity;
+    }
+
+    // same walk as hash_map_grouped_find_in, current table only
+    size_t group_mask = hash_map->capacity / HASH_MAP_GROUP_WIDTH - 1;
+    size_t group      = hash_map_h1(hash) & group_mask;
+    for (size_t probe = 0; probe <= group_mask; probe++) {
+        const uint8_t*      ctrl  = &hash_map->ctrl[group * HASH_MAP_GROUP_WIDTH];
+        hash_map_group_mask match = hash_map_group_match(ctrl, hash_map_h2(hash));
+        for (; match; match &= match - 1)
+            if (hash_map_keys_equal(&key, &hash_map->entries[group * HASH_MAP_GROUP_WIDTH + hash_map_group_lowest(match)].key))
+                return probe + 1;
+        if (hash_map_group_match(ctrl, HASH_MAP_CTRL_EMPTY))
+            return probe + 1;
+
+        group = (group + probe + 1) & group_mask;
+    }
+    return group_mask + 1;
+}
+
+void hash_map_set_incremental_resize(hash_map_t* hash_map, bool enable)
+{
+    if (hash_map->mode != HASH_MAP_MODE_GROUPED)
+        return;
+
+    hash_map->incremental_resize = enable;
+    if (!enable && hash_map->old_ctrl)
+        hash_map_grouped_migrate(hash_map, hash_map->old_capacity);
+}
+
+bool hash_map_is_resizing(const hash_map_t* hash_map)
+{
+    return hash_map->old_ctrl != NULL;
+}
+
+// Probes from the home position of hash until slot, the same walk a lookup of that entry does
+static size_t hash_map_probe_distance(const hash_map_t* hash_map, uint64_t hash, size_t slot)
+{
+    if (hash_map->mode == HASH_MAP_MODE_QUADRATIC) {
+        size_t home = (size_t) (hash & (uint64_t) (hash_map->capacity - 1));
+        for (size_t i = 0; i < hash_map->capacity; i++)
+            if (hash_map_quadratic_probe(home, i, hash_map->capacity) == slot)
+                return i + 1;
+        return hash_map->capacity;
+    }
+
+    size_t group_mask = hash_map->capacity / HASH_MAP_GROUP_WIDTH - 1;
+    size_t group      = hash_map_h1(hash) & group_mask;
+    for (size_t probe = 0; probe <= group_mask; probe++) {
+        if (group == slot / HASH_MAP_GROUP_WIDTH)
+            return probe + 1;
+        group = (group + probe + 1) & group_mask;
+    }
+    return group_mask + 1;
+}
+
+void hash_map_stats(const hash_map_t* hash_map, hash_map_stats_t* out)
+{
+    *out = (hash_map_stats_t){
+        .length       = hash_map->length,
+        .capacity     = hash_map->capacity,
+        .tombstones   = hash_map->deleted,
+        .load_factor  = (float) hash_map->length / (float) hash_map->capacity,
+        .resize_count = hash_map->resize_count,
+        .rehash_ns    = hash_map->rehash_ns,
+    };
+
+    size_t entries = 0, total_probes = 0;
+    for (size_t slot = 0; slot < hash_map->capacity; slot++) {
+        bool full = hash_map->ctrl ? !(hash_map->ctrl[slot] & HASH_MAP_CTRL_EMPTY) : !uuid_is_null(&hash_map->entries[slot].key);
+        if (!full)
+            continue;
+
+        size_t probes = hash_map_probe_distance(hash_map, hash_map->entries[slot].hash, slot);
+        total_probes += probes;
+        entries++;
+        if (probes > out->max_probe_length)
+            out->max_probe_length = probes;
+        out->probe_histogram[probes < HASH_MAP_PROBE_HISTOGRAM_BUCKETS ? probes - 1 : HASH_MAP_PROBE_HISTOGRAM_BUCKETS - 1]++;
+    }
+    out->avg_probe_length = entries ? (float) total_probes / (float) entries : 0.0f;
+
+    for (size_t slot = 0; slot < hash_map->old_capacity; slot++)
+        out->migrating += !(hash_map->old_ctrl[slot] & HASH_MAP_CTRL_EMPTY);
+}
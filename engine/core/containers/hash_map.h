@@ -18,13 +18,68 @@ typedef struct hash_map_pair_t
     uint64_t      hash;
 } hash_map_pair_t;
 
+typedef enum hash_map_mode
+{
+    // Swiss table: one control byte per slot holds 7 bits of the hash, lookups match
+    // HASH_MAP_GROUP_WIDTH control bytes at once (SSE2/NEON) and only compare keys on a match
+    HASH_MAP_MODE_GROUPED,
+    // Quadratic probing over the pairs themselves, a null key marks a free slot and removed
+    // slots also keep a tombstone hash so probes carry on past them
+    HASH_MAP_MODE_QUADRATIC,
+} hash_map_mode;
+
+#define HASH_MAP_GROUP_WIDTH 16
+// Grouped mode grows once full + deleted slots exceed capacity * 15/16, quadratic mode at half capacity.
+// When the live slots alone don't need a bigger table only the tombstones are cleaned up, in place
+// in grouped mode and into a new table of the same capacity in quadratic mode
+#define HASH_MAP_GROUP_MAX_LOAD_NUM 15
+#define HASH_MAP_GROUP_MAX_LOAD_DEN 16
+// Removes halve the table once fewer than 1 in HASH_MAP_SHRINK_RATIO slots are used
+#define HASH_MAP_SHRINK_RATIO 8
+// Keys in flight per hash_map_get_values_batch window, enough to cover a DRAM miss without
+// prefetching so far ahead that the first lines are evicted again
+#define HASH_MAP_BATCH_WINDOW 32
+// Old slots moved per insert while an incremental resize is in flight. A grow leaves the new
+// table under half full, so the move is done long before the new table needs to grow again
+#define HASH_MAP_MIGRATE_SLOTS 4
+
 typedef struct hash_map_t
 {
-    hash_map_pair_t* entries;
+    hash_map_pair_t* entries;    // empty slots always have a null key, in both modes
     size_t           capacity;
     size_t           length;
+    uint8_t*         ctrl;            // grouped mode, capacity bytes, NULL otherwise
+    size_t           deleted;         // tombstones left by hash_map_remove_entry, cleared by the next resize or cleanup
+    size_t           min_capacity;    // removes never shrink below the initial capacity
+    // grouped mode incremental resize: the previous table until all of its groups were moved over
+    hash_map_pair_t* old_entries;
+    uint8_t*         old_ctrl;
+    size_t           old_capacity;
+    size_t           migrate_slot;    // next old slot to move
+    size_t           resize_count;    // grows, shrinks and tombstone cleanups
+    uint64_t         rehash_ns;       // spent in those, incremental migration steps aren't timed
+    hash_map_mode    mode;
+    bool             incremental_resize;
+    bool             _pad0[3];
 } hash_map_t;
 
+// Probe lengths 1 .. N-1 get their own bucket, the last one holds N and longer
+#define HASH_MAP_PROBE_HISTOGRAM_BUCKETS 8
+
+typedef struct hash_map_stats_t
+{
+    size_t   length;
+    size_t   capacity;
+    size_t   tombstones;
+    size_t   migrating;           // entries still in the old table of an incremental resize
+    float    load_factor;         // length / capacity
+    float    avg_probe_length;    // groups (grouped mode) or slots (quadratic mode) a hit visits
+    size_t   max_probe_length;
+    size_t   probe_histogram[HASH_MAP_PROBE_HISTOGRAM_BUCKETS];
+    size_t   resize_count;
+    uint64_t rehash_ns;
+} hash_map_stats_t;
+
 typedef struct hash_map_iterator_t
 {
     hash_map_t*     hash_map_ref;
@@ -32,16 +87,30 @@ typedef struct hash_map_iterator_t
     hash_map_pair_t current_pair;
 } hash_map_iterator_t;
 
+// Grouped mode, capacity is rounded up to a power of two of at least HASH_MAP_GROUP_WIDTH
 hash_map_t* hash_map_create(size_t initial_capacity);
+hash_map_t* hash_map_create_with_mode(size_t initial_capacity, hash_map_mode mode);
 void        hash_map_destroy(hash_map_t* hash_map);
 
 void hash_map_print(hash_map_t* hash_map);
 
 void* hash_map_get_value(const hash_map_t* hash_map, random_uuid_t key);
+// Hashes every key of a window first and prefetches the home groups, then resolves them, so the
+// cache misses of independent lookups overlap. out_values[i] is NULL when keys[i] isn't in the map
+void hash_map_get_values_batch(const hash_map_t* hash_map, const random_uuid_t* keys, size_t count, void** out_values);
 void  hash_map_set_key_value(hash_map_t* hash_map, random_uuid_t key, void* value);
 void  hash_map_set_key_value_pair(hash_map_t* hash_map, hash_map_pair_t* pair);
 
+// Leaves a tombstone unless the probe chains allow an empty slot (grouped mode), the next resize drops them
 void hash_map_remove_entry(hash_map_t* hash_map, random_uuid_t key);
+// Resizes to the smallest power of two that is at most half full, min_capacity doesn't apply
+void hash_map_shrink_to_fit(hash_map_t* hash_map);
+
+// Groups (grouped mode) or slots (quadratic mode) a lookup of key visits, diagnostics only
+size_t hash_map_get_probe_length(const hash_map_t* hash_map, random_uuid_t key);
+// One pass over the slots using the stored hashes, nothing is rehashed or compared, cheap
+// enough to sample every frame on registry sized maps. Probe lengths cover the current table
+void hash_map_stats(const hash_map_t* hash_map, hash_map_stats_t* out);
 
 hash_map_iterator_t hash_map_iterator_begin(hash_map_t* hash_map);
 hash_map_iterator_t hash_map_iterator(hash_map_t* hash_map, random_uuid_t key);
@@ -50,6 +119,13 @@ hash_map_iterator_t hash_map_iterator(hash_map_t* hash_map, random_uuid_t key);
 // Use array like accessing while iterating over the entire list.
 bool hash_map_parse_next(hash_map_iterator_t* iterator);
 
+// Grouped mode: instead of rehashing everything in the insert that crosses the max load, keep
+// the old table next to the new one and move HASH_MAP_MIGRATE_SLOTS slots per insert. Lookups
+// check both tables until the move is done. Walking entries[] directly only sees the new table
+// meanwhile, hash_map_parse_next sees both. Disabling it finishes a resize in flight
+void hash_map_set_incremental_resize(hash_map_t* hash_map, bool enable);
+bool hash_map_is_resizing(const hash_map_t* hash_map);
+
 // utils
 static inline size_t hash_map_get_length(const hash_map_t* hash_map)
 {
@@ -58,7 +134,7 @@ static inline size_t hash_map_get_length(const hash_map_t* hash_map)
 
 static inline size_t hash_map_get_capacity(const hash_map_t* hash_map)
 {
-    return hash_map->length;
+    return hash_map->capacity;
 }
 
 #endif
\ No newline at end of file
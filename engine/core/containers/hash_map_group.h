@@ -0,0 +1,224 @@
+#ifndef HASH_MAP_GROUP_H
+#define HASH_MAP_GROUP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define HASH_MAP_SSE2 1
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    #include <arm_neon.h>
+    #define HASH_MAP_NEON 1
+#endif
+
+#include "hash_map.h"
+
+/*******************************/
+// Swiss table probing core
+/*******************************/
+
+// Shared by the grouped hash_map_t and TYPED_HASH_MAP.
+// Control bytes: EMPTY and DELETED have the top bit set, full slots store the low 7 bits of
+// the hash (H2). The rest of the hash (H1) picks the first group, groups are probed
+// triangularly so every group is visited once when the group count is a power of two.
+
+#define HASH_MAP_CTRL_EMPTY   0x80
+#define HASH_MAP_CTRL_DELETED 0xFE
+
+typedef uint32_t hash_map_group_mask;    // bit i set when slot i of the group matches
+
+static inline size_t hash_map_h1(uint64_t hash)
+{
+    return (size_t) (hash >> 7);
+}
+
+static inline uint8_t hash_map_h2(uint64_t hash)
+{
+    return (uint8_t) (hash & 0x7F);
+}
+
+#if defined(HASH_MAP_SSE2)
+static inline hash_map_group_mask hash_map_group_match(const uint8_t* group, uint8_t value)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    return (hash_map_group_mask) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char) value)));
+}
+
+// EMPTY or DELETED, the only control bytes with the sign bit set
+static inline hash_map_group_mask hash_map_group_match_free(const uint8_t* group)
+{
+    return (hash_map_group_mask) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+}
+#elif defined(HASH_MAP_NEON)
+// NEON has no movemask, weight each lane by its bit and add the halves up
+static inline hash_map_group_mask hash_map_group_movemask(uint8x16_t lanes)
+{
+    static const uint8_t bits[HASH_MAP_GROUP_WIDTH] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+    uint8x16_t weighted = vandq_u8(lanes, vld1q_u8(bits));
+    return (hash_map_group_mask) vaddv_u8(vget_low_u8(weighted)) | ((hash_map_group_mask) vaddv_u8(vget_high_u8(weighted)) << 8);
+}
+
+static inline hash_map_group_mask hash_map_group_match(const uint8_t* group, uint8_t value)
+{
+    return hash_map_group_movemask(vceqq_u8(vld1q_u8(group), vdupq_n_u8(value)));
+}
+
+static inline hash_map_group_mask hash_map_group_match_free(const uint8_t* group)
+{
+    return hash_map_group_movemask(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(group)), vdupq_n_s8(0)));
+}
+#else
+static inline hash_map_group_mask hash_map_group_match(const uint8_t* group, uint8_t value)
+{
+    hash_map_group_mask mask = 0;
+    for (uint32_t i = 0; i < HASH_MAP_GROUP_WIDTH; i++)
+        mask |= (hash_map_group_mask) (group[i] == value) << i;
+    return mask;
+}
+
+static inline hash_map_group_mask hash_map_group_match_free(const uint8_t* group)
+{
+    hash_map_group_mask mask = 0;
+    for (uint32_t i = 0; i < HASH_MAP_GROUP_WIDTH; i++)
+        mask |= (hash_map_group_mask) (group[i] >> 7) << i;
+    return mask;
+}
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+static inline uint32_t hash_map_group_lowest(hash_map_group_mask mask)
+{
+    return (uint32_t) __builtin_ctz(mask);
+}
+#else
+static inline uint32_t hash_map_group_lowest(hash_map_group_mask mask)
+{
+    uint32_t bit = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+}
+#endif
+
+// First EMPTY or DELETED slot along the probe sequence, there always is one below the max load
+static inline size_t hash_map_group_find_free(const uint8_t* ctrl, size_t capacity, uint64_t hash)
+{
+    size_t group_mask = capacity / HASH_MAP_GROUP_WIDTH - 1;
+    size_t group      = hash_map_h1(hash) & group_mask;
+
+    for (size_t probe = 0;; probe++) {
+        hash_map_group_mask free_slots = hash_map_group_match_free(&ctrl[group * HASH_MAP_GROUP_WIDTH]);
+        if (free_slots)
+            return group * HASH_MAP_GROUP_WIDTH + hash_map_group_lowest(free_slots);
+
+        group = (group + probe + 1) & group_mask;
+    }
+}
+
+// EMPTY is only safe when the group still has an empty slot, probes stop at such groups
+static inline uint8_t hash_map_group_cleared_ctrl(const uint8_t* ctrl, size_t slot)
+{
+    bool group_has_empty = hash_map_group_match(&ctrl[slot / HASH_MAP_GROUP_WIDTH * HASH_MAP_GROUP_WIDTH], HASH_MAP_CTRL_EMPTY) != 0;
+    return group_has_empty ? HASH_MAP_CTRL_EMPTY : HASH_MAP_CTRL_DELETED;
+}
+
+// Power of two of at least HASH_MAP_GROUP_WIDTH
+static inline size_t hash_map_round_capacity(size_t capacity)
+{
+    size_t rounded = HASH_MAP_GROUP_WIDTH;
+    while (rounded < capacity)
+        rounded *= 2;
+    return rounded;
+}
+
+//-----------------------------------------------------------------
+// Hash functions for common keys, H2 takes the low bits so they all finish with a full mix
+
+// MurmurHash64A over the 16 uuid bytes, already fully mixed
+static inline uint64_t hash_map_hash_uuid(const random_uuid_t* uuid)
+{
+    const uint64_t seed = 0xc70f6907UL;            // Seed for hashing
+    const uint64_t m    = 0xc6a4a7935bd1e995UL;    // Multiplier constant
+    const int      r    = 47;                      // Right shift for mixing
+
+    uint64_t hash = seed ^ (16 * m);    // UUID is 16 bytes (128 bits)
+
+    const uint64_t* data = (const uint64_t*) uuid;
+
+    // Hash the first 64 bits
+    uint64_t k1 = data[0];
+    k1 *= m;
+    k1 ^= k1 >> r;
+    k1 *= m;
+    hash ^= k1;
+    hash *= m;
+
+    // Hash the second 64 bits
+    uint64_t k2 = data[1];
+    k2 *= m;
+    k2 ^= k2 >> r;
+    k2 *= m;
+    hash ^= k2;
+    hash *= m;
+
+    // Final mixing of the hash to reduce entropy
+    hash ^= hash >> r;
+    hash *= m;
+    hash ^= hash >> r;
+
+    return hash;
+}
+
+// [source]: splitmix64 finalizer
+// https://prng.di.unimi.it/splitmix64.c
+static inline uint64_t hash_map_mix_u64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// [source]: FNV-1a
+// https://en.wikipedia.org/wiki/Fowler–Noll–Vo_hash_function#FNV-1a_hash
+static inline uint64_t hash_map_hash_bytes(const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*) data;
+    uint64_t       hash  = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash_map_mix_u64(hash);
+}
+
+static inline uint64_t hash_map_hash_u64(const uint64_t* key)
+{
+    return hash_map_mix_u64(*key);
+}
+
+static inline bool hash_map_equal_u64(const uint64_t* a, const uint64_t* b)
+{
+    return *a == *b;
+}
+
+// Hashes the characters, not the pointer, the map doesn't copy them so they have to outlive it
+static inline uint64_t hash_map_hash_cstring(const char* const* key)
+{
+    return hash_map_hash_bytes(*key, strlen(*key));
+}
+
+static inline bool hash_map_equal_cstring(const char* const* a, const char* const* b)
+{
+    return *a == *b || strcmp(*a, *b) == 0;
+}
+
+#endif    // HASH_MAP_GROUP_H
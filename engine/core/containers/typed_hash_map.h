@@ -0,0 +1,204 @@
+#ifndef TYPED_HASH_MAP_H
+#define TYPED_HASH_MAP_H
+
+#include "../logging/log.h"
+
+#include "hash_map_group.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************/
+// Typed HashMap
+/*******************************/
+
+// hash_map_t only maps uuids to pointers, so every value is its own allocation and a lookup
+// chases one more pointer. TYPED_HASH_MAP generates a grouped (Swiss table) map for any key
+// and value type on the same probing core, keys and values are stored inline in the slots.
+//
+//     TYPED_HASH_MAP(pipeline_cache, uint64_t, gfx_pipeline, hash_map_hash_u64, hash_map_equal_u64)
+//
+//     pipeline_cache cache;
+//     pipeline_cache_init(&cache, 64);
+//     gfx_pipeline* pipeline = pipeline_cache_get(&cache, content_hash);
+//
+// Hash is uint64_t (*)(const Key*), Equal is bool (*)(const Key*, const Key*), see
+// hash_map_group.h for u64, byte and C string keys. Key and Value are copied with =.
+//
+// Value pointers stay valid until the next insert or clear, inserts may grow and move the
+// table. Tables grow at the same max load as hash_map_t and never shrink.
+// Everything is static inline, the macro can be used in headers shared by several files.
+
+#define TYPED_HASH_MAP(Name, Key, Value, Hash, Equal)                                                                   \
+typedef struct Name##_entry                                                                                             \
+{                                                                                                                       \
+    Key   key;                                                                                                          \
+    Value value;                                                                                                        \
+} Name##_entry;                                                                                                         \
+                                                                                                                        \
+typedef struct Name                                                                                                     \
+{                                                                                                                       \
+    Name##_entry* entries; /* only slots whose ctrl byte is full hold a key */                                          \
+    uint8_t*      ctrl;                                                                                                 \
+    size_t        capacity;                                                                                             \
+    size_t        length;                                                                                               \
+    size_t        deleted;                                                                                              \
+} Name;                                                                                                                 \
+                                                                                                                        \
+static inline bool Name##_alloc(size_t capacity, Name##_entry** entries, uint8_t** ctrl)                                \
+{                                                                                                                       \
+    *entries = malloc(capacity * sizeof(Name##_entry));                                                                 \
+    *ctrl    = malloc(capacity);                                                                                        \
+    if (*entries == NULL || *ctrl == NULL) {                                                                            \
+        LOG_ERROR("[Hash Map] Failed to allocate %zu slots for " #Name "!\n", capacity);                                \
+        free(*entries);                                                                                                 \
+        free(*ctrl);                                                                                                    \
+        return false;                                                                                                   \
+    }                                                                                                                   \
+    memset(*ctrl, HASH_MAP_CTRL_EMPTY, capacity);                                                                       \
+    return true;                                                                                                        \
+}                                                                                                                       \
+                                                                                                                        \
+static inline bool Name##_init(Name* map, size_t initial_capacity)                                                      \
+{                                                                                                                       \
+    *map          = (Name){0};                                                                                          \
+    map->capacity = hash_map_round_capacity(initial_capacity);                                                          \
+    return Name##_alloc(map->capacity, &map->entries, &map->ctrl);                                                      \
+}                                                                                                                       \
+                                                                                                                        \
+static inline void Name##_destroy(Name* map)                                                                            \
+{                                                                                                                       \
+    free(map->entries);                                                                                                 \
+    free(map->ctrl);                                                                                                    \
+    *map = (Name){0};                                                                                                   \
+}                                                                                                                       \
+                                                                                                                        \
+static inline void Name##_clear(Name* map)                                                                              \
+{                                                                                                                       \
+    memset(map->ctrl, HASH_MAP_CTRL_EMPTY, map->capacity);                                                              \
+    map->length  = 0;                                                                                                   \
+    map->deleted = 0;                                                                                                   \
+}                                                                                                                       \
+                                                                                                                        \
+/* Slot holding key, capacity when it isn't in the map */                                                               \
+static inline size_t Name##_find(const Name* map, const Key* key, uint64_t hash)                                        \
+{                                                                                                                       \
+    size_t  group_mask = map->capacity / HASH_MAP_GROUP_WIDTH - 1;                                                      \
+    size_t  group      = hash_map_h1(hash) & group_mask;                                                                \
+    uint8_t h2         = hash_map_h2(hash);                                                                             \
+                                                                                                                        \
+    for (size_t probe = 0; probe <= group_mask; probe++) {                                                              \
+        const uint8_t* group_ctrl = &map->ctrl[group * HASH_MAP_GROUP_WIDTH];                                           \
+                                                                                                                        \
+        hash_map_group_mask match = hash_map_group_match(group_ctrl, h2);                                               \
+        while (match) {                                                                                                 \
+            size_t slot = group * HASH_MAP_GROUP_WIDTH + hash_map_group_lowest(match);                                  \
+            if (Equal(&map->entries[slot].key, key))                                                                    \
+                return slot;                                                                                            \
+            match &= match - 1;                                                                                         \
+        }                                                                                                               \
+                                                                                                                        \
+        if (hash_map_group_match(group_ctrl, HASH_MAP_CTRL_EMPTY))                                                      \
+            return map->capacity;                                                                                       \
+                                                                                                                        \
+        group = (group + probe + 1) & group_mask;                                                                       \
+    }                                                                                                                   \
+    return map->capacity;                                                                                               \
+}                                                                                                                       \
+                                                                                                                        \
+/* Rehashes into new_capacity slots, also drops the tombstones when the capacity stays the same */                      \
+static inline bool Name##_resize(Name* map, size_t new_capacity)                                                        \
+{                                                                                                                       \
+    Name##_entry* entries = NULL;                                                                                       \
+    uint8_t*      ctrl    = NULL;                                                                                       \
+    if (!Name##_alloc(new_capacity, &entries, &ctrl))                                                                   \
+        return false;                                                                                                   \
+                                                                                                                        \
+    for (size_t i = 0; i < map->capacity; i++) {                                                                        \
+        if (map->ctrl[i] & HASH_MAP_CTRL_EMPTY)                                                                         \
+            continue;                                                                                                   \
+                                                                                                                        \
+        uint64_t hash = Hash(&map->entries[i].key);                                                                     \
+        size_t   slot = hash_map_group_find_free(ctrl, new_capacity, hash);                                             \
+        ctrl[slot]    = hash_map_h2(hash);                                                                              \
+        entries[slot] = map->entries[i];                                                                                \
+    }                                                                                                                   \
+                                                                                                                        \
+    free(map->entries);                                                                                                 \
+    free(map->ctrl);                                                                                                    \
+    map->entries  = entries;                                                                                            \
+    map->ctrl     = ctrl;                                                                                               \
+    map->capacity = new_capacity;                                                                                       \
+    map->deleted  = 0;                                                                                                  \
+    return true;                                                                                                        \
+}                                                                                                                       \
+                                                                                                                        \
+/* Pointer to the value stored inline, NULL when key isn't in the map */                                                \
+static inline Value* Name##_get(const Name* map, Key key)                                                               \
+{                                                                                                                       \
+    size_t slot = Name##_find(map, &key, Hash(&key));                                                                   \
+    return slot != map->capacity ? &map->entries[slot].value : NULL;                                                    \
+}                                                                                                                       \
+                                                                                                                        \
+/* Value slot for key, a new one is zeroed and sets *inserted. NULL if growing failed */                                \
+static inline Value* Name##_get_or_insert(Name* map, Key key, bool* inserted)                                           \
+{                                                                                                                       \
+    uint64_t hash = Hash(&key);                                                                                         \
+    size_t   slot = Name##_find(map, &key, hash);                                                                       \
+    if (inserted)                                                                                                       \
+        *inserted = slot == map->capacity;                                                                              \
+    if (slot != map->capacity)                                                                                          \
+        return &map->entries[slot].value;                                                                               \
+                                                                                                                        \
+    if ((map->length + map->deleted + 1) * HASH_MAP_GROUP_MAX_LOAD_DEN > map->capacity * HASH_MAP_GROUP_MAX_LOAD_NUM) { \
+        /* mostly tombstones, cleaning them up in place is enough */                                                    \
+        size_t new_capacity = (map->length + 1) * 2 > map->capacity ? map->capacity * 2 : map->capacity;                \
+        if (!Name##_resize(map, new_capacity))                                                                          \
+            return NULL;                                                                                                \
+    }                                                                                                                   \
+                                                                                                                        \
+    slot = hash_map_group_find_free(map->ctrl, map->capacity, hash);                                                    \
+    if (map->ctrl[slot] == HASH_MAP_CTRL_DELETED)                                                                       \
+        map->deleted--;                                                                                                 \
+    map->ctrl[slot] = hash_map_h2(hash);                                                                                \
+    map->length++;                                                                                                      \
+                                                                                                                        \
+    Name##_entry* entry = &map->entries[slot];                                                                          \
+    memset(entry, 0, sizeof(Name##_entry));                                                                             \
+    entry->key = key;                                                                                                   \
+    return &entry->value;                                                                                               \
+}                                                                                                                       \
+                                                                                                                        \
+/* Inserts or overwrites, NULL if growing failed */                                                                     \
+static inline Value* Name##_set(Name* map, Key key, Value value)                                                        \
+{                                                                                                                       \
+    Value* slot = Name##_get_or_insert(map, key, NULL);                                                                 \
+    if (slot)                                                                                                           \
+        *slot = value;                                                                                                  \
+    return slot;                                                                                                        \
+}                                                                                                                       \
+                                                                                                                        \
+static inline bool Name##_remove(Name* map, Key key)                                                                    \
+{                                                                                                                       \
+    size_t slot = Name##_find(map, &key, Hash(&key));                                                                   \
+    if (slot == map->capacity)                                                                                          \
+        return false;                                                                                                   \
+                                                                                                                        \
+    map->ctrl[slot] = hash_map_group_cleared_ctrl(map->ctrl, slot);                                                     \
+    if (map->ctrl[slot] == HASH_MAP_CTRL_DELETED)                                                                       \
+        map->deleted++;                                                                                                 \
+    map->length--;                                                                                                      \
+    return true;                                                                                                        \
+}                                                                                                                       \
+                                                                                                                        \
+/* First full slot at or after slot, capacity when there is none, walks the map in slot order */                        \
+static inline size_t Name##_next(const Name* map, size_t slot)                                                          \
+{                                                                                                                       \
+    while (slot < map->capacity && (map->ctrl[slot] & HASH_MAP_CTRL_EMPTY))                                             \
+        slot++;                                                                                                         \
+    return slot;                                                                                                        \
+}
+
+#endif    // TYPED_HASH_MAP_H
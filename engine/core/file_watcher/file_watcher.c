@@ -0,0 +1,92 @@
+#if defined(__linux__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "file_watcher.h"
+
+#include "../logging/log.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <errno.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+bool file_watcher_init(file_watcher* watcher, const char* dir)
+{
+    watcher->handle = -1;
+    watcher->watch  = -1;
+
+#if defined(_WIN32)
+    HANDLE handle = FindFirstChangeNotificationA(dir, FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+    if (handle == INVALID_HANDLE_VALUE) {
+        LOG_WARN("[FileWatcher] Cannot watch %s (%lu)", dir, GetLastError());
+        return false;
+    }
+    watcher->handle = (intptr_t) handle;
+    return true;
+#elif defined(__linux__)
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        LOG_WARN("[FileWatcher] inotify_init1 failed (%d)", errno);
+        return false;
+    }
+
+    // close-write instead of modify, so half written files are never reported
+    int wd = inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        LOG_WARN("[FileWatcher] Cannot watch %s (%d)", dir, errno);
+        close(fd);
+        return false;
+    }
+    watcher->handle = fd;
+    watcher->watch  = wd;
+    return true;
+#else
+    LOG_WARN("[FileWatcher] Not supported on this platform, %s is not watched", dir);
+    return false;
+#endif
+}
+
+void file_watcher_destroy(file_watcher* watcher)
+{
+    if (watcher->handle == -1)
+        return;
+
+#if defined(_WIN32)
+    FindCloseChangeNotification((HANDLE) watcher->handle);
+#elif defined(__linux__)
+    inotify_rm_watch((int) watcher->handle, (int) watcher->watch);
+    close((int) watcher->handle);
+#endif
+    watcher->handle = -1;
+    watcher->watch  = -1;
+}
+
+bool file_watcher_poll(file_watcher* watcher)
+{
+    if (watcher->handle == -1)
+        return false;
+
+    bool changed = false;
+#if defined(_WIN32)
+    HANDLE handle = (HANDLE) watcher->handle;
+    while (WaitForSingleObject(handle, 0) == WAIT_OBJECT_0) {
+        changed = true;
+        if (!FindNextChangeNotification(handle))
+            break;
+    }
+#elif defined(__linux__)
+    // events are variable sized, only the count matters here
+    _Alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t len = read((int) watcher->handle, buffer, sizeof(buffer));
+        if (len <= 0)
+            break;    // EAGAIN: queue drained
+        changed = true;
+    }
+#endif
+    return changed;
+}
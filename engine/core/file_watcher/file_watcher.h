@@ -0,0 +1,22 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Watches a single directory (non-recursive) for files being written, created or moved in
+// Linux: inotify, Windows: change notifications, other platforms: unsupported, init returns false
+
+typedef struct file_watcher
+{
+    intptr_t handle;    // inotify fd / change notification handle, -1 when inactive
+    intptr_t watch;     // inotify watch descriptor
+} file_watcher;
+
+bool file_watcher_init(file_watcher* watcher, const char* dir);
+void file_watcher_destroy(file_watcher* watcher);
+
+// Non-blocking, drains pending events and returns true if anything changed since the last poll
+bool file_watcher_poll(file_watcher* watcher);
+
+#endif    // FILE_WATCHER_H
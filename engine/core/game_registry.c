@@ -4,18 +4,105 @@
 
 #include "gameobject.h"
 
+#include "memory/memalign.h"
+#include "memory/pool_allocator.h"
+
+typedef struct game_registry_type
+{
+    StartFunction  startFn;
+    UpdateFunction updateFn;
+    uint32_t       dataSize;
+    uint32_t       _pad0;
+    pool_allocator pool;
+} game_registry_type;
+
+// handle target, slots are recycled through a free list and keep their generation
+typedef struct game_registry_slot
+{
+    GameObject* object;
+    uint32_t    generation;
+    uint32_t    nextFree;
+} game_registry_slot;
+
 hash_map_t* gGameRegistry = NULL;
 uint32_t    gNumObjects   = 0;
+// sparse set: the hash map finds an object by uuid, the object knows its slot in here
+GameObject*        gGameObjects[MAX_OBJECTS];
+game_registry_type gGameObjectTypes[GAME_REGISTRY_MAX_TYPES];
+uint32_t           gNumObjectTypes = 0;
+game_registry_slot gGameObjectSlots[MAX_OBJECTS];
+uint32_t           gFreeSlot = UINT32_MAX;
+
+// gameObjectData follows the object in the same block
+#define GAME_REGISTRY_DATA_OFFSET align_memory_size(sizeof(GameObject), 16)
+
+static void game_registry_internal_bump_generation(game_registry_slot* slot)
+{
+    if (++slot->generation == 0)
+        slot->generation = 1;
+}
+
+static game_registry_type* game_registry_internal_get_type(uint32_t dataSize, StartFunction StartFn, UpdateFunction UpdateFn, uint32_t* typeIdx)
+{
+    for (uint32_t i = 0; i < gNumObjectTypes; i++) {
+        game_registry_type* type = &gGameObjectTypes[i];
+        if (type->startFn == StartFn && type->updateFn == UpdateFn && type->dataSize == dataSize) {
+            *typeIdx = i;
+            return type;
+        }
+    }
+
+    if (gNumObjectTypes >= GAME_REGISTRY_MAX_TYPES) {
+        LOG_ERROR("[Game Registry] too many gameobject types, raise GAME_REGISTRY_MAX_TYPES");
+        return NULL;
+    }
+
+    game_registry_type* type = &gGameObjectTypes[gNumObjectTypes];
+    type->startFn            = StartFn;
+    type->updateFn           = UpdateFn;
+    type->dataSize           = dataSize;
+    pool_allocator_init(&type->pool, GAME_REGISTRY_DATA_OFFSET + dataSize, GAME_REGISTRY_OBJECTS_PER_SLAB);
+    *typeIdx = gNumObjectTypes++;
+    return type;
+}
 
 void game_registry_init(void)
 {
     gNumObjects = 0;
-    // create the hash_map
-    gGameRegistry = hash_map_create(MAX_OBJECTS);
+
+    // generations survive a destroy/init so handles from before stay stale
+    for (uint32_t i = 0; i < MAX_OBJECTS; i++) {
+        game_registry_slot* slot = &gGameObjectSlots[i];
+        slot->object             = NULL;
+        slot->nextFree           = i + 1 < MAX_OBJECTS ? i + 1 : UINT32_MAX;
+        if (slot->generation == 0)
+            slot->generation = 1;
+    }
+    gFreeSlot = 0;
+
+    // twice the registry size: even a full registry stays under the grow load, so spawn/despawn
+    // churn never reallocates the map, tombstone cleanups rehash it in place
+    gGameRegistry = hash_map_create(MAX_OBJECTS * 2);
 }
 
 void game_registry_destroy(void)
 {
+    // the pools own every object and its data
+    for (uint32_t i = 0; i < gNumObjectTypes; i++)
+        pool_allocator_destroy(&gGameObjectTypes[i].pool);
+    gNumObjectTypes = 0;
+
+    memset(gGameObjects, 0, sizeof(gGameObjects));
+    gNumObjects = 0;
+
+    for (uint32_t i = 0; i < MAX_OBJECTS; i++) {
+        if (gGameObjectSlots[i].object) {
+            gGameObjectSlots[i].object = NULL;
+            game_registry_internal_bump_generation(&gGameObjectSlots[i]);
+        }
+    }
+    gFreeSlot = UINT32_MAX;
+
     hash_map_destroy(gGameRegistry);
 }
 
@@ -23,21 +110,36 @@ random_uuid_t game_registry_register_gameobject_type(uint32_t gameObjectDataSize
 {
     random_uuid_t uuid = {{0, 0, 0, 0}};
 
-    if (gNumObjects >= MAX_OBJECTS) {
+    GameObject* game_object = game_registry_get_gameobject(game_registry_spawn_gameobject(gameObjectDataSize, StartFn, UpdateFn));
+    if (game_object)
+        uuid_copy(&game_object->uuid, &uuid);
+    return uuid;    // Return the UUID of the registered object
+}
+
+gameobject_handle game_registry_spawn_gameobject(uint32_t gameObjectDataSize, StartFunction StartFn, UpdateFunction UpdateFn)
+{
+    if (gNumObjects >= MAX_OBJECTS || gFreeSlot == UINT32_MAX) {
         LOG_ERROR("Registry FULL cannot create new game objects!");
-        return uuid;
+        return GAMEOBJECT_INVALID_HANDLE;
     }
 
-    uuid_generate(&uuid);
+    uint32_t            typeIdx = 0;
+    game_registry_type* type    = game_registry_internal_get_type(gameObjectDataSize, StartFn, UpdateFn, &typeIdx);
+    if (!type)
+        return GAMEOBJECT_INVALID_HANDLE;
 
-    GameObject* game_object = malloc(sizeof(GameObject));
+    GameObject* game_object = pool_allocator_alloc(&type->pool);
     if (!game_object) {
         LOG_ERROR("Error allocating memory for GameObject");
-        return uuid;
+        return GAMEOBJECT_INVALID_HANDLE;
     }
 
-    memset(game_object, 0, sizeof(GameObject));
+    random_uuid_t uuid;
+    uuid_generate(&uuid);
+
+    memset(game_object, 0, GAME_REGISTRY_DATA_OFFSET + gameObjectDataSize);
     uuid_copy(&uuid, &game_object->uuid);
+    game_object->typeIdx = typeIdx;
 
     game_object->sdfNodeIdx = UINT32_MAX;
 
@@ -49,22 +151,48 @@ random_uuid_t game_registry_register_gameobject_type(uint32_t gameObjectDataSize
     glm_quat_copy(rotquat, game_object->transform.rotation);
 
     if (gameObjectDataSize > 0)
-        game_object->gameObjectData = malloc(gameObjectDataSize);
+        game_object->gameObjectData = (uint8_t*) game_object + GAME_REGISTRY_DATA_OFFSET;
     game_object->startFn  = StartFn;
     game_object->updateFn = UpdateFn;
 
     hash_map_set_key_value(gGameRegistry, uuid, (void*) game_object);
 
+    game_object->registryIdx  = gNumObjects;
+    gGameObjects[gNumObjects] = game_object;
     gNumObjects++;
-    return uuid;    // Return the UUID of the registered object
+
+    game_registry_slot* slot       = &gGameObjectSlots[gFreeSlot];
+    game_object->handle.index      = gFreeSlot;
+    game_object->handle.generation = slot->generation;
+    slot->object                   = game_object;
+    gFreeSlot                      = slot->nextFree;
+    return game_object->handle;
 }
 
 void game_registry_unregister_gameobject_type(const random_uuid_t uuid)
 {
     GameObject* game_object = hash_map_get_value(gGameRegistry, uuid);
-    if (game_object->gameObjectData)
-        free(game_object->gameObjectData);
+    if (!game_object) {
+        LOG_ERROR("[Game Registry] cannot unregister unknown gameobject! | UUID: %s", uuid_to_string(&uuid));
+        return;
+    }
+
+    // swap remove, the last object takes over the freed slot
+    GameObject* last                       = gGameObjects[gNumObjects - 1];
+    gGameObjects[game_object->registryIdx] = last;
+    last->registryIdx                      = game_object->registryIdx;
+    gGameObjects[gNumObjects - 1]          = NULL;
+    gNumObjects--;
+
+    // stale from here on, the slot goes back to the free list with its next generation
+    game_registry_slot* slot = &gGameObjectSlots[game_object->handle.index];
+    slot->object             = NULL;
+    slot->nextFree           = gFreeSlot;
+    gFreeSlot                = game_object->handle.index;
+    game_registry_internal_bump_generation(slot);
+
     hash_map_remove_entry(gGameRegistry, game_object->uuid);
+    pool_allocator_free(&gGameObjectTypes[game_object->typeIdx].pool, game_object);
 }
 
 GameObject* game_registry_get_gameobject_by_uuid(random_uuid_t goUUID)
@@ -78,11 +206,35 @@ GameObject* game_registry_get_gameobject_by_uuid(random_uuid_t goUUID)
     }
 }
 
+void game_registry_get_gameobjects_by_uuid(const random_uuid_t* uuids, uint32_t count, GameObject** out_objects)
+{
+    hash_map_get_values_batch(gGameRegistry, uuids, count, (void**) out_objects);
+}
+
+GameObject* game_registry_get_gameobject(gameobject_handle handle)
+{
+    if (handle.index >= MAX_OBJECTS)
+        return NULL;
+    const game_registry_slot* slot = &gGameObjectSlots[handle.index];
+    return slot->generation == handle.generation ? slot->object : NULL;
+}
+
+gameobject_handle game_registry_get_handle(random_uuid_t goUUID)
+{
+    GameObject* go = game_registry_get_gameobject_by_uuid(goUUID);
+    return go ? go->handle : GAMEOBJECT_INVALID_HANDLE;
+}
+
 hash_map_t* game_registry_get_instance(void)
 {
     return gGameRegistry;
 }
 
+GameObject** game_registry_get_objects(void)
+{
+    return gGameObjects;
+}
+
 uint32_t game_registry_get_num_objects(void)
 {
     return gNumObjects;
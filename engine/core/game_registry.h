@@ -13,10 +13,27 @@
 
 typedef struct GameObject GameObject;
 
+// Index into the registry's slot table plus the generation the slot had when the object was
+// registered. Unregistering bumps the slot's generation, so handles to removed objects go stale
+// instead of pointing at whatever reuses the slot. Resolving one is an array lookup, keep uuids
+// for serialization and debugging and use handles for per-frame access
+typedef struct gameobject_handle
+{
+    uint32_t index;
+    uint32_t generation;    // 0 is never a live generation
+} gameobject_handle;
+
+#define GAMEOBJECT_INVALID_HANDLE ((gameobject_handle) {UINT32_MAX, 0})
+
 /*******************************/
 // GameObjects Registry
 /*******************************/
 
+// Objects are pooled per type (start, update and data size), a type's objects and their data
+// share one block each and sit next to each other in the same slabs
+#define GAME_REGISTRY_MAX_TYPES        32
+#define GAME_REGISTRY_OBJECTS_PER_SLAB 64
+
 // Initialize the game object registry
 void game_registry_init(void);
 
@@ -25,16 +42,27 @@ void game_registry_destroy(void);
 
 // Private methods to create game objects in the game world
 random_uuid_t game_registry_register_gameobject_type(uint32_t gameObjectDataSize, StartFunction StartFn, UpdateFunction UpdateFn);
+// Same as above but returns the handle, GAMEOBJECT_INVALID_HANDLE on failure
+gameobject_handle game_registry_spawn_gameobject(uint32_t gameObjectDataSize, StartFunction StartFn, UpdateFunction UpdateFn);
 
 // Unregister and remove it from the game registry
 void game_registry_unregister_gameobject_type(const random_uuid_t uuid);
 
 // Returns the game object ptr stored in the registry
 GameObject* game_registry_get_gameobject_by_uuid(random_uuid_t goUUID);
+// Batched lookup, out_objects[i] is NULL when uuids[i] isn't registered
+void game_registry_get_gameobjects_by_uuid(const random_uuid_t* uuids, uint32_t count, GameObject** out_objects);
+// O(1), NULL when the handle is stale or invalid
+GameObject* game_registry_get_gameobject(gameobject_handle handle);
+// One uuid lookup to trade for a handle, GAMEOBJECT_INVALID_HANDLE when uuid isn't registered
+gameobject_handle game_registry_get_handle(random_uuid_t goUUID);
 
 hash_map_t* game_registry_get_instance(void);
 
-uint32_t game_registry_get_num_objects(void);
+// Live objects packed in [0, game_registry_get_num_objects()), removes swap the last one into
+// the hole so the order isn't stable. Iterate this instead of the hash map slots
+GameObject** game_registry_get_objects(void);
+uint32_t     game_registry_get_num_objects(void);
 
 /*******************************/
 // Macros for Registration & Instantiation
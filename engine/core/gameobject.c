@@ -145,4 +145,101 @@ void gameobject_set_scale(random_uuid_t goUUID, float scale)
         go->transform.scale = scale;
     } else
         LOG_ERROR("Failed to update scale for gameobject %s", uuid_to_string(&goUUID));
-}
\ No newline at end of file
+}
+
+//-------------------------------------------------------
+// Handle API
+
+static GameObject* gameobject_internal_resolve(gameobject_handle handle)
+{
+    GameObject* go = game_registry_get_gameobject(handle);
+    if (go == NULL)
+        LOG_ERROR("[GameObject] stale or invalid handle | index: %u generation: %u", handle.index, handle.generation);
+    return go;
+}
+
+gameobject_handle gameobject_get_handle(random_uuid_t goUUID)
+{
+    return game_registry_get_handle(goUUID);
+}
+
+bool gameobject_handle_is_valid(gameobject_handle handle)
+{
+    return game_registry_get_gameobject(handle) != NULL;
+}
+
+random_uuid_t gameobject_handle_get_uuid(gameobject_handle handle)
+{
+    random_uuid_t uuid = {{0, 0, 0, 0}};
+    GameObject*   go   = gameobject_internal_resolve(handle);
+    if (go != NULL)
+        uuid_copy(&go->uuid, &uuid);
+    return uuid;
+}
+
+mat4s gameobject_handle_get_transform(gameobject_handle handle)
+{
+    return gameobject_ptr_get_transform(gameobject_internal_resolve(handle));
+}
+
+void gameobject_handle_get_position(gameobject_handle handle, vec3* position)
+{
+    GameObject* obj = gameobject_internal_resolve(handle);
+    if (obj) {
+        glm_vec3_copy(obj->transform.position.raw, *position);
+    } else {
+        glm_vec3_zero(*position);
+    }
+}
+
+void gameobject_handle_get_rotation(gameobject_handle handle, versor* rotationQuat)
+{
+    GameObject* obj = gameobject_internal_resolve(handle);
+    if (obj) {
+        glm_quat_copy(obj->transform.rotation, *rotationQuat);
+    } else {
+        glm_quat_identity(*rotationQuat);
+    }
+}
+
+void gameobject_handle_get_scale(gameobject_handle handle, float* scale)
+{
+    GameObject* obj = gameobject_internal_resolve(handle);
+    if (obj) {
+        *scale = obj->transform.scale;
+    } else {
+        *scale = 1.0f;
+    }
+}
+
+void gameobject_handle_set_transform(gameobject_handle handle, Transform transform)
+{
+    GameObject* go = gameobject_internal_resolve(handle);
+    if (go != NULL) {
+        go->transform = transform;
+    }
+}
+
+void gameobject_handle_set_position(gameobject_handle handle, vec3 position)
+{
+    GameObject* go = gameobject_internal_resolve(handle);
+    if (go != NULL) {
+        glm_vec3_copy(position, go->transform.position.raw);
+    }
+}
+
+void gameobject_handle_set_rotation(gameobject_handle handle, versor rotationQuat)
+{
+    GameObject* go = gameobject_internal_resolve(handle);
+    if (go != NULL) {
+        glm_quat_copy(rotationQuat, go->transform.rotation);
+    }
+}
+
+void gameobject_handle_set_scale(gameobject_handle handle, float scale)
+{
+    GameObject* go = gameobject_internal_resolve(handle);
+    if (go != NULL) {
+        go->transform.scale = scale;
+    }
+}
@@ -21,14 +21,17 @@
 
 typedef struct GameObject
 {
-    random_uuid_t  uuid;
-    Transform      transform;
-    bool           isRenderable;
-    bool           _pad0[3];
-    uint32_t       sdfNodeIdx;        // index of the sdf node in sdf scene array
-    void*          gameObjectData;    // Object-specific data that can be serialized/reflected
-    StartFunction  startFn;
-    UpdateFunction updateFn;
+    random_uuid_t     uuid;
+    Transform         transform;
+    bool              isRenderable;
+    bool              _pad0[3];
+    uint32_t          sdfNodeIdx;        // index of the sdf node in sdf scene array
+    uint32_t          registryIdx;       // slot in the registry's dense object array, changes when others are removed
+    uint32_t          typeIdx;           // registry pool the object and its data were allocated from
+    gameobject_handle handle;            // registry slot + generation, stays valid until the object is unregistered
+    void*             gameObjectData;    // Object-specific data that can be serialized/reflected, right after the object in its pool block
+    StartFunction     startFn;
+    UpdateFunction    updateFn;
     // TODO: Add collision callback functions here if needed
 } GameObject;
 
@@ -51,4 +54,19 @@ void gameobject_set_rotation(random_uuid_t goUUID, versor rorationQuad);
 void gameobject_set_rotation_euler(random_uuid_t goUUID, vec3 rotationEuler);
 void gameobject_set_scale(random_uuid_t goUUID, float scale);
 
+// Handle API: same as above without the uuid hash and probe, stale handles log and behave like unknown uuids
+gameobject_handle gameobject_get_handle(random_uuid_t goUUID);
+bool              gameobject_handle_is_valid(gameobject_handle handle);
+random_uuid_t     gameobject_handle_get_uuid(gameobject_handle handle);
+
+mat4s gameobject_handle_get_transform(gameobject_handle handle);
+void  gameobject_handle_get_position(gameobject_handle handle, vec3* position);
+void  gameobject_handle_get_rotation(gameobject_handle handle, versor* rotationQuat);
+void  gameobject_handle_get_scale(gameobject_handle handle, float* scale);
+
+void gameobject_handle_set_transform(gameobject_handle handle, Transform transform);
+void gameobject_handle_set_position(gameobject_handle handle, vec3 position);
+void gameobject_handle_set_rotation(gameobject_handle handle, versor rotationQuat);
+void gameobject_handle_set_scale(gameobject_handle handle, float scale);
+
 #endif
@@ -0,0 +1,77 @@
+#include "heap_stats.h"
+
+#include <stddef.h>
+
+#include "../threads/threads.h"
+
+#if BYOE_COUNT_HEAP_ALLOCS
+
+static volatile uint32_t s_HeapAllocCount;
+
+// the linker routes every malloc/calloc/realloc/aligned allocation reference through these, __real_* is the libc one
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+int   __real_posix_memalign(void** ptr, size_t alignment, size_t size);
+void* __real_memalign(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+    atomic_add_u32(&s_HeapAllocCount, 1);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    atomic_add_u32(&s_HeapAllocCount, 1);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    atomic_add_u32(&s_HeapAllocCount, 1);
+    return __real_realloc(ptr, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size)
+{
+    atomic_add_u32(&s_HeapAllocCount, 1);
+    return __real_aligned_alloc(alignment, size);
+}
+
+int __wrap_posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    atomic_add_u32(&s_HeapAllocCount, 1);
+    return __real_posix_memalign(ptr, alignment, size);
+}
+
+void* __wrap_memalign(size_t alignment, size_t size)
+{
+    atomic_add_u32(&s_HeapAllocCount, 1);
+    return __real_memalign(alignment, size);
+}
+
+bool heap_stats_is_enabled(void)
+{
+    return true;
+}
+
+uint32_t heap_stats_get_alloc_count(void)
+{
+    return atomic_load_u32(&s_HeapAllocCount);
+}
+
+#else
+
+bool heap_stats_is_enabled(void)
+{
+    return false;
+}
+
+uint32_t heap_stats_get_alloc_count(void)
+{
+    return 0;
+}
+
+#endif
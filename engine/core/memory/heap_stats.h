@@ -0,0 +1,13 @@
+#ifndef HEAP_STATS_H
+#define HEAP_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// malloc/calloc/realloc/aligned_alloc/posix_memalign/memalign calls made so far by code linked into the executable, static libraries included.
+// Only counted in BYOE_COUNT_HEAP_ALLOCS builds (GNU ld --wrap), calls made inside shared libraries are never seen.
+
+bool     heap_stats_is_enabled(void);
+uint32_t heap_stats_get_alloc_count(void);
+
+#endif    // HEAP_STATS_H
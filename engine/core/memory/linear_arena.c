@@ -0,0 +1,68 @@
+#include "linear_arena.h"
+
+#include <stdlib.h>
+
+#include "../logging/log.h"
+#include "memalign.h"
+
+struct linear_arena_overflow
+{
+    linear_arena_overflow* next;
+};
+
+bool linear_arena_init(linear_arena* arena, size_t capacity)
+{
+    arena->base            = malloc(capacity);
+    arena->capacity        = arena->base ? capacity : 0;
+    arena->offset          = 0;
+    arena->high_water      = 0;
+    arena->overflow        = NULL;
+    arena->overflow_allocs = 0;
+
+    if (!arena->base) {
+        LOG_ERROR("[Memory] cannot reserve %zu bytes for a linear arena", capacity);
+        return false;
+    }
+    return true;
+}
+
+void linear_arena_destroy(linear_arena* arena)
+{
+    linear_arena_reset(arena);
+    free(arena->base);
+    arena->base     = NULL;
+    arena->capacity = 0;
+}
+
+void* linear_arena_alloc(linear_arena* arena, size_t size, size_t alignment)
+{
+    // offsets from an aligned base, malloc alignment covers everything up to max_align_t
+    size_t offset = align_memory_size(arena->offset, alignment);
+    if (offset + size <= arena->capacity) {
+        arena->offset = offset + size;
+        if (arena->offset > arena->high_water)
+            arena->high_water = arena->offset;
+        return arena->base + offset;
+    }
+
+    // header first, then enough slack to align the payload
+    linear_arena_overflow* overflow = malloc(sizeof(linear_arena_overflow) + alignment + size);
+    if (!overflow)
+        return NULL;
+
+    overflow->next  = arena->overflow;
+    arena->overflow = overflow;
+    arena->overflow_allocs++;
+
+    return align_memory((uint8_t*) (overflow + 1), alignment);
+}
+
+void linear_arena_reset(linear_arena* arena)
+{
+    while (arena->overflow) {
+        linear_arena_overflow* next = arena->overflow->next;
+        free(arena->overflow);
+        arena->overflow = next;
+    }
+    arena->offset = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef LINEAR_ARENA_H
+#define LINEAR_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump allocator over a single block reserved up front, everything is released at once by linear_arena_reset.
+// Requests that don't fit still succeed through the heap and are freed by the next reset,
+// overflow_allocs counts them so the capacity can be tuned until it stays at 0.
+
+typedef struct linear_arena_overflow linear_arena_overflow;
+
+typedef struct linear_arena
+{
+    uint8_t*               base;
+    size_t                 capacity;
+    size_t                 offset;
+    size_t                 high_water;         // largest offset reached since init
+    linear_arena_overflow* overflow;           // heap fallbacks of the current cycle
+    uint32_t               overflow_allocs;    // since init
+    uint32_t               _pad0;
+} linear_arena;
+
+bool linear_arena_init(linear_arena* arena, size_t capacity);
+void linear_arena_destroy(linear_arena* arena);
+
+// alignment must be a power of two, the memory is not cleared
+void* linear_arena_alloc(linear_arena* arena, size_t size, size_t alignment);
+void  linear_arena_reset(linear_arena* arena);
+
+#define LINEAR_ARENA_ALLOC(arena, Type, count) ((Type*) linear_arena_alloc(arena, sizeof(Type) * (count), _Alignof(Type)))
+
+#endif    // LINEAR_ARENA_H
@@ -0,0 +1,107 @@
+#include "pool_allocator.h"
+
+#include <stdlib.h>
+
+#include "../logging/log.h"
+#include "memalign.h"
+
+struct pool_allocator_slab
+{
+    pool_allocator_slab* next;
+};
+
+typedef struct pool_allocator_free_block
+{
+    struct pool_allocator_free_block* next;
+} pool_allocator_free_block;
+
+static bool pool_allocator_add_slab(pool_allocator* pool, uint32_t block_count)
+{
+    size_t alignment = pool->block_size < POOL_ALLOCATOR_CACHE_LINE ? pool->block_size : POOL_ALLOCATOR_CACHE_LINE;
+
+    // header first, then enough slack to align the first block
+    pool_allocator_slab* slab = malloc(sizeof(pool_allocator_slab) + alignment + pool->block_size * block_count);
+    if (!slab) {
+        LOG_ERROR("[Memory] cannot allocate a pool slab of %u x %zu bytes", block_count, pool->block_size);
+        return false;
+    }
+    slab->next  = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+    pool->capacity += block_count;
+
+    // whatever is left in the previous slab goes on the free list so it isn't lost
+    for (; pool->cursor != pool->end; pool->cursor += pool->block_size) {
+        pool_allocator_free_block* free_block = (pool_allocator_free_block*) pool->cursor;
+        free_block->next                      = pool->free_list;
+        pool->free_list                       = free_block;
+    }
+
+    pool->cursor = align_memory((uint8_t*) (slab + 1), alignment);
+    pool->end    = pool->cursor + pool->block_size * block_count;
+    return true;
+}
+
+size_t pool_allocator_size_class(size_t size)
+{
+    if (size > POOL_ALLOCATOR_CACHE_LINE)
+        return align_memory_size(size, POOL_ALLOCATOR_CACHE_LINE);
+
+    size_t size_class = POOL_ALLOCATOR_MIN_BLOCK;
+    while (size_class < size)
+        size_class *= 2;
+    return size_class;
+}
+
+void pool_allocator_init(pool_allocator* pool, size_t block_size, uint32_t blocks_per_slab)
+{
+    *pool                 = (pool_allocator){0};
+    pool->block_size      = pool_allocator_size_class(block_size);
+    pool->blocks_per_slab = blocks_per_slab ? blocks_per_slab : 1;
+}
+
+void pool_allocator_destroy(pool_allocator* pool)
+{
+    while (pool->slabs) {
+        pool_allocator_slab* next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+    *pool = (pool_allocator){0};
+}
+
+bool pool_allocator_reserve(pool_allocator* pool, uint32_t count)
+{
+    uint32_t available = pool->capacity - pool->live;
+    if (available >= count)
+        return true;
+
+    uint32_t missing = count - available;
+    return pool_allocator_add_slab(pool, missing > pool->blocks_per_slab ? missing : pool->blocks_per_slab);
+}
+
+void* pool_allocator_alloc(pool_allocator* pool)
+{
+    void* block = pool->free_list;
+    if (block) {
+        pool->free_list = ((pool_allocator_free_block*) block)->next;
+    } else {
+        if (pool->cursor == pool->end && !pool_allocator_add_slab(pool, pool->blocks_per_slab))
+            return NULL;
+        block = pool->cursor;
+        pool->cursor += pool->block_size;
+    }
+    pool->live++;
+    return block;
+}
+
+void pool_allocator_free(pool_allocator* pool, void* block)
+{
+    if (!block)
+        return;
+
+    pool_allocator_free_block* free_block = block;
+    free_block->next                      = pool->free_list;
+    pool->free_list                       = free_block;
+    pool->live--;
+}
@@ -0,0 +1,48 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed size blocks carved out of slabs, freed blocks go on an intrusive free list and are
+// handed out again first. Alloc and free are O(1) and only a new slab calls the heap, so
+// blocks allocated together end up next to each other. Slabs are only released by destroy.
+//
+// Block sizes are rounded up to a size class: powers of two up to a cache line, whole
+// cache lines above that. Blocks are aligned to their size up to a cache line, so a block
+// never straddles more cache lines than it has to.
+
+#define POOL_ALLOCATOR_CACHE_LINE 64
+#define POOL_ALLOCATOR_MIN_BLOCK  16
+
+typedef struct pool_allocator_slab pool_allocator_slab;
+
+typedef struct pool_allocator
+{
+    pool_allocator_slab* slabs;
+    uint8_t*             cursor;    // never used blocks of the newest slab, handed out in order
+    uint8_t*             end;
+    void*                free_list;
+    size_t               block_size;
+    uint32_t             blocks_per_slab;
+    uint32_t             live;
+    uint32_t             capacity;      // blocks over all slabs
+    uint32_t             slab_count;    // each one is a heap allocation
+} pool_allocator;
+
+size_t pool_allocator_size_class(size_t size);
+
+// No memory is reserved until the first alloc, see pool_allocator_reserve
+void pool_allocator_init(pool_allocator* pool, size_t block_size, uint32_t blocks_per_slab);
+void pool_allocator_destroy(pool_allocator* pool);
+
+// Makes sure count more blocks can be allocated without touching the heap
+bool pool_allocator_reserve(pool_allocator* pool, uint32_t count);
+
+// NULL only when a new slab can't be allocated, the memory is not cleared
+void* pool_allocator_alloc(pool_allocator* pool);
+// block must come from this pool, NULL is ignored
+void pool_allocator_free(pool_allocator* pool, void* block);
+
+#endif    // POOL_ALLOCATOR_H
@@ -1,15 +1,21 @@
 #include "rng.h"
 
+#include "../threads/threads.h"
+
 // Seed value for the RNG
-static uint32_t xorshift32_state = 23122023;    // You can set any non-zero seed value
+static volatile uint32_t xorshift32_state = 23122023;    // You can set any non-zero seed value
 
+// Lock-free so uuid_generate can be used from worker threads during resource creation
 uint32_t rng_generate(void)
 {
-    uint32_t x = xorshift32_state;
-    x ^= x << 13;
-    x ^= x >> 17;
-    x ^= x << 5;
-    xorshift32_state = x;
+    uint32_t old, x;
+    do {
+        old = xorshift32_state;
+        x   = old;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    } while (atomic_cas_u32(&xorshift32_state, old, x) != old);
     return x;
 }
 
@@ -0,0 +1,162 @@
+#include "job_system.h"
+
+#include "threads.h"
+
+#include "../logging/log.h"
+
+typedef struct job_system_state
+{
+    thread_t  workers[JOB_SYSTEM_MAX_WORKERS];
+    uint32_t  worker_count;
+    mutex_t   lock;
+    condvar_t work_cv;    // a new batch was published or quit was requested
+    condvar_t done_cv;    // a worker went idle or the last job finished
+    // current batch, published under lock
+    job_proc          proc;
+    void*             arg;
+    uint32_t          job_count;
+    uint32_t          generation;
+    volatile uint32_t next_job;
+    volatile uint32_t jobs_done;
+    uint32_t          busy_workers;    // picked up the current generation and not finished yet
+    bool              quit;
+    bool              _pad0[3];
+} job_system_state;
+
+static job_system_state s_JobSystem;
+
+// Pulls jobs off the shared counter until the batch is drained
+static void job_system_internal_run_jobs(job_proc proc, void* arg, uint32_t job_count)
+{
+    uint32_t job_idx = atomic_add_u32(&s_JobSystem.next_job, 1);
+    while (job_idx < job_count) {
+        proc(arg, job_idx);
+
+        if (atomic_add_u32(&s_JobSystem.jobs_done, 1) + 1 == job_count) {
+            mutex_lock(&s_JobSystem.lock);
+            condvar_broadcast(&s_JobSystem.done_cv);
+            mutex_unlock(&s_JobSystem.lock);
+        }
+        job_idx = atomic_add_u32(&s_JobSystem.next_job, 1);
+    }
+}
+
+static void job_system_internal_worker_proc(void* arg)
+{
+    (void) arg;
+
+    uint32_t seen_generation = 0;
+
+    mutex_lock(&s_JobSystem.lock);
+    for (;;) {
+        while (!s_JobSystem.quit && seen_generation == s_JobSystem.generation)
+            condvar_wait(&s_JobSystem.work_cv, &s_JobSystem.lock);
+        if (s_JobSystem.quit)
+            break;
+
+        // snapshot under the lock, the caller won't publish another batch while we're busy
+        seen_generation    = s_JobSystem.generation;
+        job_proc proc      = s_JobSystem.proc;
+        void*    proc_arg  = s_JobSystem.arg;
+        uint32_t job_count = s_JobSystem.job_count;
+        s_JobSystem.busy_workers++;
+        mutex_unlock(&s_JobSystem.lock);
+
+        job_system_internal_run_jobs(proc, proc_arg, job_count);
+
+        mutex_lock(&s_JobSystem.lock);
+        s_JobSystem.busy_workers--;
+        if (s_JobSystem.busy_workers == 0)
+            condvar_broadcast(&s_JobSystem.done_cv);
+    }
+    mutex_unlock(&s_JobSystem.lock);
+}
+
+bool job_system_init(uint32_t worker_count)
+{
+    if (s_JobSystem.worker_count > 0) {
+        LOG_WARN("[JobSystem] already initialized with %u workers", s_JobSystem.worker_count);
+        return true;
+    }
+
+    if (worker_count > JOB_SYSTEM_MAX_WORKERS)
+        worker_count = JOB_SYSTEM_MAX_WORKERS;
+
+    s_JobSystem = (job_system_state){0};
+    if (worker_count == 0)
+        return true;
+
+    if (!mutex_init(&s_JobSystem.lock) || !condvar_init(&s_JobSystem.work_cv) || !condvar_init(&s_JobSystem.done_cv)) {
+        LOG_ERROR("[JobSystem] failed to create sync primitives, running single threaded");
+        job_system_destroy();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < worker_count; i++) {
+        if (!thread_create(&s_JobSystem.workers[i], job_system_internal_worker_proc, NULL)) {
+            LOG_ERROR("[JobSystem] only %u of %u workers started", i, worker_count);
+            break;
+        }
+        s_JobSystem.worker_count++;
+    }
+
+    LOG_INFO("[JobSystem] %u worker threads", s_JobSystem.worker_count);
+    return s_JobSystem.worker_count == worker_count;
+}
+
+void job_system_destroy(void)
+{
+    if (s_JobSystem.worker_count > 0) {
+        mutex_lock(&s_JobSystem.lock);
+        s_JobSystem.quit = true;
+        condvar_broadcast(&s_JobSystem.work_cv);
+        mutex_unlock(&s_JobSystem.lock);
+
+        for (uint32_t i = 0; i < s_JobSystem.worker_count; i++)
+            thread_join(&s_JobSystem.workers[i]);
+    }
+
+    condvar_destroy(&s_JobSystem.done_cv);
+    condvar_destroy(&s_JobSystem.work_cv);
+    mutex_destroy(&s_JobSystem.lock);
+
+    s_JobSystem = (job_system_state){0};
+}
+
+uint32_t job_system_get_worker_count(void)
+{
+    return s_JobSystem.worker_count;
+}
+
+void job_system_parallel_for(job_proc proc, void* arg, uint32_t job_count)
+{
+    if (job_count == 0)
+        return;
+
+    if (s_JobSystem.worker_count == 0 || job_count == 1) {
+        for (uint32_t i = 0; i < job_count; i++)
+            proc(arg, i);
+        return;
+    }
+
+    mutex_lock(&s_JobSystem.lock);
+    // a worker that woke up late for the previous batch may still be draining its (empty) counter
+    while (s_JobSystem.busy_workers > 0)
+        condvar_wait(&s_JobSystem.done_cv, &s_JobSystem.lock);
+
+    s_JobSystem.proc      = proc;
+    s_JobSystem.arg       = arg;
+    s_JobSystem.job_count = job_count;
+    atomic_store_u32(&s_JobSystem.next_job, 0);
+    atomic_store_u32(&s_JobSystem.jobs_done, 0);
+    s_JobSystem.generation++;
+    condvar_broadcast(&s_JobSystem.work_cv);
+    mutex_unlock(&s_JobSystem.lock);
+
+    job_system_internal_run_jobs(proc, arg, job_count);
+
+    mutex_lock(&s_JobSystem.lock);
+    while (atomic_load_u32(&s_JobSystem.jobs_done) < job_count || s_JobSystem.busy_workers > 0)
+        condvar_wait(&s_JobSystem.done_cv, &s_JobSystem.lock);
+    mutex_unlock(&s_JobSystem.lock);
+}
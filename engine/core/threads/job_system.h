@@ -0,0 +1,22 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed pool of worker threads running fork-join batches, the calling thread always helps out
+// Not initialized (or 0 workers) means every batch runs serially on the caller
+
+#define JOB_SYSTEM_MAX_WORKERS 31
+
+typedef void (*job_proc)(void* arg, uint32_t job_idx);
+
+bool     job_system_init(uint32_t worker_count);
+void     job_system_destroy(void);
+uint32_t job_system_get_worker_count(void);
+
+// Runs proc(arg, i) for every i in [0, job_count) and returns once all of them are done
+// Batches are not reentrant, only one thread may call this at a time and never from inside a job
+void job_system_parallel_for(job_proc proc, void* arg, uint32_t job_count);
+
+#endif    // JOB_SYSTEM_H
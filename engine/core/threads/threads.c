@@ -0,0 +1,238 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200809L
+    #if defined(__APPLE__)
+        #define _DARWIN_C_SOURCE
+    #endif
+#endif
+
+#include "threads.h"
+
+#include "../logging/log.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #include <intrin.h>
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+static DWORD WINAPI thread_internal_trampoline(LPVOID arg)
+{
+    thread_t* thread = (thread_t*) arg;
+    thread->proc(thread->arg);
+    return 0;
+}
+#else
+static void* thread_internal_trampoline(void* arg)
+{
+    thread_t* thread = (thread_t*) arg;
+    thread->proc(thread->arg);
+    return NULL;
+}
+#endif
+
+bool thread_create(thread_t* thread, thread_proc proc, void* arg)
+{
+    thread->proc = proc;
+    thread->arg  = arg;
+
+#if defined(_WIN32)
+    HANDLE handle = CreateThread(NULL, 0, thread_internal_trampoline, thread, 0, NULL);
+    if (!handle) {
+        LOG_ERROR("[Threads] CreateThread failed (%lu)", GetLastError());
+        return false;
+    }
+    thread->handle = (uintptr_t) handle;
+#else
+    pthread_t handle;
+    int       res = pthread_create(&handle, NULL, thread_internal_trampoline, thread);
+    if (res != 0) {
+        LOG_ERROR("[Threads] pthread_create failed (%d)", res);
+        return false;
+    }
+    thread->handle = (uintptr_t) handle;
+#endif
+    return true;
+}
+
+void thread_join(thread_t* thread)
+{
+#if defined(_WIN32)
+    HANDLE handle = (HANDLE) thread->handle;
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+#else
+    pthread_join((pthread_t) thread->handle, NULL);
+#endif
+    thread->handle = 0;
+}
+
+uint32_t thread_hardware_concurrency(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (uint32_t) info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t) count : 1;
+#endif
+}
+
+bool mutex_init(mutex_t* mutex)
+{
+#if defined(_WIN32)
+    SRWLOCK* lock = malloc(sizeof(SRWLOCK));
+    if (!lock)
+        return false;
+    InitializeSRWLock(lock);
+    mutex->handle = lock;
+#else
+    pthread_mutex_t* lock = malloc(sizeof(pthread_mutex_t));
+    if (!lock || pthread_mutex_init(lock, NULL) != 0) {
+        LOG_ERROR("[Threads] pthread_mutex_init failed");
+        free(lock);
+        return false;
+    }
+    mutex->handle = lock;
+#endif
+    return true;
+}
+
+void mutex_destroy(mutex_t* mutex)
+{
+    if (!mutex->handle)
+        return;
+#if !defined(_WIN32)
+    pthread_mutex_destroy((pthread_mutex_t*) mutex->handle);
+#endif
+    free(mutex->handle);
+    mutex->handle = NULL;
+}
+
+void mutex_lock(mutex_t* mutex)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive((SRWLOCK*) mutex->handle);
+#else
+    pthread_mutex_lock((pthread_mutex_t*) mutex->handle);
+#endif
+}
+
+void mutex_unlock(mutex_t* mutex)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive((SRWLOCK*) mutex->handle);
+#else
+    pthread_mutex_unlock((pthread_mutex_t*) mutex->handle);
+#endif
+}
+
+bool condvar_init(condvar_t* cv)
+{
+#if defined(_WIN32)
+    CONDITION_VARIABLE* handle = malloc(sizeof(CONDITION_VARIABLE));
+    if (!handle)
+        return false;
+    InitializeConditionVariable(handle);
+    cv->handle = handle;
+#else
+    pthread_cond_t* handle = malloc(sizeof(pthread_cond_t));
+    if (!handle || pthread_cond_init(handle, NULL) != 0) {
+        LOG_ERROR("[Threads] pthread_cond_init failed");
+        free(handle);
+        return false;
+    }
+    cv->handle = handle;
+#endif
+    return true;
+}
+
+void condvar_destroy(condvar_t* cv)
+{
+    if (!cv->handle)
+        return;
+#if !defined(_WIN32)
+    pthread_cond_destroy((pthread_cond_t*) cv->handle);
+#endif
+    free(cv->handle);
+    cv->handle = NULL;
+}
+
+void condvar_wait(condvar_t* cv, mutex_t* mutex)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW((CONDITION_VARIABLE*) cv->handle, (SRWLOCK*) mutex->handle, INFINITE, 0);
+#else
+    pthread_cond_wait((pthread_cond_t*) cv->handle, (pthread_mutex_t*) mutex->handle);
+#endif
+}
+
+void condvar_signal(condvar_t* cv)
+{
+#if defined(_WIN32)
+    WakeConditionVariable((CONDITION_VARIABLE*) cv->handle);
+#else
+    pthread_cond_signal((pthread_cond_t*) cv->handle);
+#endif
+}
+
+void condvar_broadcast(condvar_t* cv)
+{
+#if defined(_WIN32)
+    WakeAllConditionVariable((CONDITION_VARIABLE*) cv->handle);
+#else
+    pthread_cond_broadcast((pthread_cond_t*) cv->handle);
+#endif
+}
+
+uint32_t atomic_cas_u32(volatile uint32_t* dst, uint32_t expected, uint32_t desired)
+{
+#if defined(_MSC_VER)
+    return (uint32_t) _InterlockedCompareExchange((volatile long*) dst, (long) desired, (long) expected);
+#else
+    __atomic_compare_exchange_n(dst, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return expected;
+#endif
+}
+
+uint32_t atomic_add_u32(volatile uint32_t* dst, uint32_t value)
+{
+#if defined(_MSC_VER)
+    return (uint32_t) _InterlockedExchangeAdd((volatile long*) dst, (long) value);
+#else
+    return __atomic_fetch_add(dst, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void atomic_store_u32(volatile uint32_t* dst, uint32_t value)
+{
+#if defined(_MSC_VER)
+    _InterlockedExchange((volatile long*) dst, (long) value);
+#else
+    __atomic_store_n(dst, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void* atomic_cas_ptr(void* volatile* dst, void* expected, void* desired)
+{
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchangePointer(dst, desired, expected);
+#else
+    __atomic_compare_exchange_n(dst, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return expected;
+#endif
+}
+
+void atomic_store_ptr(void* volatile* dst, void* value)
+{
+#if defined(_MSC_VER)
+    _InterlockedExchangePointer(dst, value);
+#else
+    __atomic_store_n(dst, value, __ATOMIC_SEQ_CST);
+#endif
+}
@@ -0,0 +1,97 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Thin wrapper over pthreads/Win32 threads, C11 <threads.h> and <stdatomic.h> are not available on every toolchain we build with
+
+typedef void (*thread_proc)(void* arg);
+
+typedef struct thread_t
+{
+    uintptr_t   handle;
+    thread_proc proc;
+    void*       arg;
+} thread_t;
+
+// thread must stay alive until thread_join
+bool thread_create(thread_t* thread, thread_proc proc, void* arg);
+void thread_join(thread_t* thread);
+
+uint32_t thread_hardware_concurrency(void);
+
+//---------------------------------------------------------
+// Mutex and condition variable, handles are heap allocated by *_init
+
+typedef struct mutex_t
+{
+    void* handle;
+} mutex_t;
+
+typedef struct condvar_t
+{
+    void* handle;
+} condvar_t;
+
+bool mutex_init(mutex_t* mutex);
+void mutex_destroy(mutex_t* mutex);
+void mutex_lock(mutex_t* mutex);
+void mutex_unlock(mutex_t* mutex);
+
+bool condvar_init(condvar_t* cv);
+void condvar_destroy(condvar_t* cv);
+// mutex must be locked, it is released while waiting and locked again before returning (spurious wakeups included)
+void condvar_wait(condvar_t* cv, mutex_t* mutex);
+void condvar_signal(condvar_t* cv);
+void condvar_broadcast(condvar_t* cv);
+
+//---------------------------------------------------------
+// Atomics, read-modify-writes and stores are sequentially consistent and return the previous value
+
+uint32_t atomic_cas_u32(volatile uint32_t* dst, uint32_t expected, uint32_t desired);
+uint32_t atomic_add_u32(volatile uint32_t* dst, uint32_t value);
+void     atomic_store_u32(volatile uint32_t* dst, uint32_t value);
+
+void* atomic_cas_ptr(void* volatile* dst, void* expected, void* desired);
+void  atomic_store_ptr(void* volatile* dst, void* value);
+
+// Loads are acquire and inline: plain loads that lookups can issue per probe without taking
+// the cache line exclusive, an interlocked op would make every reader contend like a writer
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    // x86/x64 loads already have acquire semantics, only the compiler must not reorder around them
+    #if defined(_M_ARM64)
+        #define THREADS_ACQUIRE_BARRIER() __dmb(_ARM64_BARRIER_ISH)
+    #else
+        #define THREADS_ACQUIRE_BARRIER() _ReadWriteBarrier()
+    #endif
+#endif
+
+static inline uint32_t atomic_load_u32(volatile uint32_t* src)
+{
+#if defined(_MSC_VER)
+    uint32_t value = (uint32_t) __iso_volatile_load32((const volatile int*) src);
+    THREADS_ACQUIRE_BARRIER();
+    return value;
+#else
+    return __atomic_load_n(src, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void* atomic_load_ptr(void* volatile* src)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+    void* value = (void*) __iso_volatile_load64((const volatile __int64*) src);
+    THREADS_ACQUIRE_BARRIER();
+    return value;
+#elif defined(_MSC_VER)
+    void* value = (void*) __iso_volatile_load32((const volatile int*) src);
+    THREADS_ACQUIRE_BARRIER();
+    return value;
+#else
+    return __atomic_load_n(src, __ATOMIC_ACQUIRE);
+#endif
+}
+
+#endif    // THREADS_H
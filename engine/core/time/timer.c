@@ -0,0 +1,33 @@
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "timer.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+uint64_t timer_now_ns(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    // split to avoid overflowing counter * 1e9
+    uint64_t secs = (uint64_t) (counter.QuadPart / freq.QuadPart);
+    uint64_t rem  = (uint64_t) (counter.QuadPart % freq.QuadPart);
+    return secs * 1000000000ull + rem * 1000000000ull / (uint64_t) freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+double timer_elapsed_ms(uint64_t start_ns)
+{
+    return (double) (timer_now_ns() - start_ns) / 1e6;
+}
@@ -0,0 +1,10 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+// Monotonic high resolution clock, usable before glfwInit
+uint64_t timer_now_ns(void);
+double   timer_elapsed_ms(uint64_t start_ns);
+
+#endif    // TIMER_H
@@ -2,6 +2,8 @@
 
 #include <GLFW/glfw3.h>
 #include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../render/frontend/gfx_frontend.h"
 
@@ -12,12 +14,48 @@ static uint64_t    FPS             = 0;
 static uint64_t    AvgFPS          = 0;
 static uint64_t    FPSSamples      = 0;
 static GLFWwindow* g_GameWindowRef = NULL;
+static bool        s_QuitRequested = false;
+static uint64_t    s_EngineStartNs = 0;
 
 static engine_version s_EngineVersion = {0, 1, 0, ""};
 static char           s_VersionString[64];
 
 static rhi_api api = 0;
 
+static engine_startup_timings s_StartupTimings;
+
+// the first frames still build swapchain dependent tables and fill the per-frame arenas
+#define ENGINE_HEAP_WARMUP_FRAMES 16
+
+static engine_frame_heap_stats s_FrameHeapStats;
+static uint64_t                s_FrameIndex = 0;
+
+// running sums behind the averages
+static engine_frame_pacing_stats s_FramePacing;
+static double                    s_FramePacingSums[4];
+
+static void engine_internal_update_frame_pacing(double input_to_present_ms)
+{
+    const renderer_sdf_frame_pacing* pacing = renderer_sdf_get_frame_pacing();
+
+    s_FramePacing.cpu_wait_ms         = pacing->cpu_wait_ms;
+    s_FramePacing.gpu_ms              = pacing->gpu_ms;
+    s_FramePacing.present_wait_ms     = pacing->present_wait_ms;
+    s_FramePacing.input_to_present_ms = input_to_present_ms;
+    s_FramePacing.frames++;
+
+    s_FramePacingSums[0] += s_FramePacing.cpu_wait_ms;
+    s_FramePacingSums[1] += s_FramePacing.gpu_ms;
+    s_FramePacingSums[2] += s_FramePacing.present_wait_ms;
+    s_FramePacingSums[3] += s_FramePacing.input_to_present_ms;
+
+    double frames                         = (double) s_FramePacing.frames;
+    s_FramePacing.avg_cpu_wait_ms         = s_FramePacingSums[0] / frames;
+    s_FramePacing.avg_gpu_ms              = s_FramePacingSums[1] / frames;
+    s_FramePacing.avg_present_wait_ms     = s_FramePacingSums[2] / frames;
+    s_FramePacing.avg_input_to_present_ms = s_FramePacingSums[3] / frames;
+}
+
 void engine_init(struct GLFWwindow** gameWindow, uint32_t width, uint32_t height)
 {
     LOG_SUCCESS("Welcome to Build your own engine! BYOE!!");
@@ -26,9 +64,55 @@ void engine_init(struct GLFWwindow** gameWindow, uint32_t width, uint32_t height
     cpu_caps_print_info();
     os_caps_print_info();
 
+    // engine_init may run again after engine_destroy, e.g. in the tests
+    s_QuitRequested          = false;
+    s_FrameIndex             = 0;
+    s_FrameHeapStats         = (engine_frame_heap_stats) {0};
+    s_FrameHeapStats.enabled = heap_stats_is_enabled();
+    s_FramePacing            = (engine_frame_pacing_stats) {0};
+    memset(s_FramePacingSums, 0, sizeof(s_FramePacingSums));
+
+    uint64_t startup_start = timer_now_ns();
+    s_EngineStartNs        = startup_start;
+    uint64_t phase_start   = startup_start;
+
+    // BYOE_HEADLESS=1 renders offscreen without a display, e.g. CI on a software Vulkan ICD
+    const char* headless_env = getenv("BYOE_HEADLESS");
+    if (headless_env && strcmp(headless_env, "0") != 0)
+        g_gfxConfig.headless = true;
+
+    // BYOE_PRESENT_MODE=fifo|mailbox|immediate, BYOE_FRAME_QUEUE_DEPTH=1..MAX_FRAMES_INFLIGHT, BYOE_LATE_LATCH=1
+    const char* present_mode_env = getenv("BYOE_PRESENT_MODE");
+    if (present_mode_env) {
+        if (strcmp(present_mode_env, "fifo") == 0)
+            g_gfxConfig.present_mode = GFX_PRESENT_MODE_FIFO;
+        else if (strcmp(present_mode_env, "mailbox") == 0)
+            g_gfxConfig.present_mode = GFX_PRESENT_MODE_MAILBOX;
+        else if (strcmp(present_mode_env, "immediate") == 0)
+            g_gfxConfig.present_mode = GFX_PRESENT_MODE_IMMEDIATE;
+        else
+            LOG_WARN("Unknown BYOE_PRESENT_MODE '%s', expected fifo, mailbox or immediate", present_mode_env);
+    }
+
+    // gfx_init clamps it
+    const char* queue_depth_env = getenv("BYOE_FRAME_QUEUE_DEPTH");
+    if (queue_depth_env)
+        g_gfxConfig.frame_queue_depth = (uint32_t) strtoul(queue_depth_env, NULL, 10);
+
+    const char* late_latch_env = getenv("BYOE_LATE_LATCH");
+    if (late_latch_env && strcmp(late_latch_env, "0") != 0)
+        s_FramePacing.late_latch = true;
+
     // Follow this order strictly to avoid load crashing
-    render_utils_init_glfw();
-    *gameWindow = render_utils_create_glfw_window("BYOE Game: Spooky Asteroids!", width, height);
+    if (g_gfxConfig.headless) {
+        LOG_INFO("Running headless, no window is created");
+        *gameWindow = NULL;
+    } else {
+        render_utils_init_glfw();
+        *gameWindow = render_utils_create_glfw_window("BYOE Game: Spooky Asteroids!", width, height);
+    }
+
+    s_StartupTimings.window_ms = timer_elapsed_ms(phase_start);
 
 #if defined __APPLE__ || defined __linux__
     api = Vulkan;
@@ -36,17 +120,29 @@ void engine_init(struct GLFWwindow** gameWindow, uint32_t width, uint32_t height
     api = D3D12;    // TODO: can use vulkan too, maybe check with command line options?
 #endif
 
+    // only the Vulkan backend has a headless context
+    if (g_gfxConfig.headless)
+        api = Vulkan;
+
     if (gfx_init(api) != Success) {
         LOG_ERROR("Error initializing gfx");
         gfx_destroy();
         exit(-1);
     }
 
+    // workers record command buffers for the renderer, the main thread takes the remaining core
+    job_system_init(thread_hardware_concurrency() - 1);
+
     renderer_desc desc = {0};
-    desc.width         = width;
-    desc.height        = height;
-    desc.window        = *gameWindow;
-    bool success       = renderer_sdf_init(desc);
+    desc.width               = width;
+    desc.height              = height;
+    desc.window              = *gameWindow;
+    desc.write_to_backbuffer = true;
+
+    phase_start  = timer_now_ns();
+    bool success = renderer_sdf_init(desc);
+
+    s_StartupTimings.renderer_ms = timer_elapsed_ms(phase_start);
     if (!success) {
         LOG_ERROR("Error initializing SDF renderer");
         renderer_sdf_destroy();
@@ -54,29 +150,108 @@ void engine_init(struct GLFWwindow** gameWindow, uint32_t width, uint32_t height
         exit(-1);
     }
 
+    const renderer_sdf_startup_timings* renderer_timings = renderer_sdf_get_startup_timings();
+
+    s_StartupTimings.context_ms                = renderer_timings->context_ms;
+    s_StartupTimings.shaders_ms                = renderer_timings->shaders_ms;
+    s_StartupTimings.pipelines_ms              = renderer_timings->pipelines_ms;
+    s_StartupTimings.shaders_pipelines_wall_ms = renderer_timings->shaders_pipelines_wall_ms;
+    s_StartupTimings.pipeline_cache_bytes      = renderer_timings->pipeline_cache_bytes;
+
     g_GameWindowRef = *gameWindow;
 
     ////////////////////////////////////////////////////////
     // START GAME RUNTIME
+    phase_start = timer_now_ns();
+
     game_registry_init();
 
     // register game objects on run-time side
     game_main();
 
     gameobjects_start();
+
+    s_StartupTimings.game_main_ms = timer_elapsed_ms(phase_start);
     ////////////////////////////////////////////////////////
+
+    s_StartupTimings.total_ms = timer_elapsed_ms(startup_start);
+
+    LOG_INFO("Frame pacing: queue depth %u | late latch %s", g_gfxConfig.frame_queue_depth, s_FramePacing.late_latch ? "on" : "off");
+
+    LOG_INFO("Startup: %.2f ms | window %.2f ms | context %.2f ms | shaders %.2f ms | pipelines %.2f ms (%u jobs, %.2f ms wall) | game_main %.2f ms",
+        s_StartupTimings.total_ms,
+        s_StartupTimings.window_ms,
+        s_StartupTimings.context_ms,
+        s_StartupTimings.shaders_ms,
+        s_StartupTimings.pipelines_ms,
+        renderer_timings->pipeline_jobs,
+        s_StartupTimings.shaders_pipelines_wall_ms,
+        s_StartupTimings.game_main_ms);
+}
+
+engine_startup_timings engine_get_startup_timings(void)
+{
+    return s_StartupTimings;
+}
+
+engine_frame_heap_stats engine_get_frame_heap_stats(void)
+{
+    return s_FrameHeapStats;
+}
+
+engine_frame_pacing_stats engine_get_frame_pacing_stats(void)
+{
+    return s_FramePacing;
+}
+
+void engine_set_late_latch(bool enable)
+{
+    s_FramePacing.late_latch = enable;
 }
 
 void engine_destroy(void)
 {
+    if (s_FrameHeapStats.enabled)
+        LOG_INFO("Heap allocations: %" PRIu64 " over %" PRIu64 " steady-state frames, worst frame %u", s_FrameHeapStats.steady_state_allocs, s_FrameHeapStats.steady_state_frames, s_FrameHeapStats.max_frame_allocs);
+
+    if (s_FramePacing.frames)
+        LOG_INFO("Frame pacing over %" PRIu64 " frames: cpu wait %.2f ms | gpu %.2f ms | present wait %.2f ms | input to present %.2f ms",
+            s_FramePacing.frames,
+            s_FramePacing.avg_cpu_wait_ms,
+            s_FramePacing.avg_gpu_ms,
+            s_FramePacing.avg_present_wait_ms,
+            s_FramePacing.avg_input_to_present_ms);
+
+    const renderer_sdf_redraw_stats* redraw = renderer_sdf_get_redraw_stats();
+    if (redraw->full_frames + redraw->partial_frames + redraw->skipped_frames)
+        LOG_INFO("Incremental redraw: %" PRIu64 " full | %" PRIu64 " partial | %" PRIu64 " skipped frames, %" PRIu64 " pixels marched",
+            redraw->full_frames,
+            redraw->partial_frames,
+            redraw->skipped_frames,
+            redraw->marched_pixels);
+
+    hash_map_stats_t registry;
+    hash_map_stats(game_registry_get_instance(), &registry);
+    LOG_INFO("Game registry: %zu/%zu slots | %zu tombstones | probe avg %.2f max %zu | %zu resizes, %.2f ms rehashing",
+        registry.length,
+        registry.capacity,
+        registry.tombstones,
+        (double) registry.avg_probe_length,
+        registry.max_probe_length,
+        registry.resize_count,
+        (double) registry.rehash_ns / 1e6);
+
     renderer_sdf_destroy();
     gfx_destroy();
+    job_system_destroy();
     game_registry_destroy();
     LOG_SUCCESS("Exiting BYOE...Byee!");
 }
 
 bool engine_should_quit(void)
 {
+    if (!g_GameWindowRef)
+        return s_QuitRequested;
     return glfwWindowShouldClose(g_GameWindowRef);
 }
 
@@ -84,12 +259,16 @@ void engine_request_quit(void)
 {
     if (g_GameWindowRef)
         glfwSetWindowShouldClose(g_GameWindowRef, true);
+    else
+        s_QuitRequested = true;
 }
 
 void engine_run(void)
 {
     while (!engine_should_quit()) {
-        float currentFrame = (float) glfwGetTime();
+        uint32_t heap_allocs_start = heap_stats_get_alloc_count();
+
+        float currentFrame = (float) (timer_elapsed_ms(s_EngineStartNs) / 1000.0);
         deltaTime          = currentFrame - lastFrame;
         FPS                = (int) (1.0f / deltaTime);
 
@@ -100,16 +279,29 @@ void engine_run(void)
             char windowTitle[250];
             sprintf(
                 windowTitle,
-                "BYOE Game: spooky asteroids! | FPS: %" PRIu64 " | Avg. FPS: %" PRIu64 " | render dt: %2.2fms | RHI: %s",
+                "BYOE Game: spooky asteroids! | FPS: %" PRIu64 " | Avg. FPS: %" PRIu64 " | render dt: %2.2fms | wait %2.2fms | gpu %2.2fms | present %2.2fms | input->present %2.2fms | RHI: %s",
                 FPS,
                 engine_get_avg_fps(),
                 deltaTime * 1000.0f,
+                s_FramePacing.cpu_wait_ms,
+                s_FramePacing.gpu_ms,
+                s_FramePacing.present_wait_ms,
+                s_FramePacing.input_to_present_ms,
                 api == Vulkan ? "Vulkan" : "D3D12");
-            glfwSetWindowTitle(g_GameWindowRef, windowTitle);
+            if (g_GameWindowRef)
+                glfwSetWindowTitle(g_GameWindowRef, windowTitle);
             elapsedTime = 0.0f;
         }
 
-        gamestate_update(g_GameWindowRef);
+        // late latch: block on the frame slot first, so the input below is as fresh as possible when recorded
+        if (s_FramePacing.late_latch)
+            renderer_sdf_begin_frame();
+
+        uint64_t input_sample_start = timer_now_ns();
+
+        // headless has no input, the game state keeps its defaults
+        if (g_GameWindowRef)
+            gamestate_update(g_GameWindowRef);
 
         gameobjects_update(deltaTime);
 
@@ -117,7 +309,20 @@ void engine_run(void)
         renderer_sdf_render();
         // ------
 
+        engine_internal_update_frame_pacing(timer_elapsed_ms(input_sample_start));
+
         lastFrame = currentFrame;
+
+        s_FrameHeapStats.last_frame_allocs = heap_stats_get_alloc_count() - heap_allocs_start;
+        if (s_FrameIndex++ >= ENGINE_HEAP_WARMUP_FRAMES) {
+            s_FrameHeapStats.steady_state_frames++;
+            s_FrameHeapStats.steady_state_allocs += s_FrameHeapStats.last_frame_allocs;
+            // only new worsts are logged, a resize reallocates once and shouldn't flood the log
+            if (s_FrameHeapStats.last_frame_allocs > s_FrameHeapStats.max_frame_allocs) {
+                s_FrameHeapStats.max_frame_allocs = s_FrameHeapStats.last_frame_allocs;
+                LOG_WARN("Frame %" PRIu64 " made %u heap allocations", s_FrameIndex, s_FrameHeapStats.last_frame_allocs);
+            }
+        }
     }
 }
 
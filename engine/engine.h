@@ -15,11 +15,17 @@
 
 #include "core/containers/hash_map.h"
 #include "core/logging/log.h"
+#include "core/memory/heap_stats.h"
+#include "core/memory/linear_arena.h"
 #include "core/memory/memalign.h"
+#include "core/memory/pool_allocator.h"
 #include "core/rng/rng.h"
 #include "core/simd/compiler_defs.h"
 #include "core/simd/intrinsics.h"
 #include "core/simd/platform_caps.h"
+#include "core/threads/job_system.h"
+#include "core/threads/threads.h"
+#include "core/time/timer.h"
 #include "core/uuid/uuid.h"
 
 #include "render/render_structs.h"
@@ -47,8 +53,59 @@ typedef struct engine_version
     char    build[13];    // Optional build metadata (e.g., "alpha", "beta", "rc")
 } engine_version;
 
+// Wall-clock breakdown of the last engine_init, in milliseconds
+typedef struct engine_startup_timings
+{
+    double   window_ms;                    // glfw init + window creation
+    double   context_ms;                   // gfx backend context, swapchain, pools and heaps
+    double   shaders_ms;                   // summed over the pipeline build jobs
+    double   pipelines_ms;                 // summed over the pipeline build jobs
+    double   shaders_pipelines_wall_ms;
+    double   renderer_ms;                  // whole renderer_sdf_init, includes the three above
+    double   game_main_ms;                 // registry init, game_main and gameobjects_start
+    double   total_ms;
+    uint64_t pipeline_cache_bytes;         // pipeline cache blob loaded from disk, 0 on a cold start
+} engine_startup_timings;
+
+// Heap allocations made by engine_run frames, only counted in BYOE_COUNT_HEAP_ALLOCS builds
+typedef struct engine_frame_heap_stats
+{
+    uint64_t steady_state_frames;    // frames after the warm-up ones that create lazy resources
+    uint64_t steady_state_allocs;    // expected to stay 0
+    uint32_t last_frame_allocs;
+    uint32_t max_frame_allocs;       // worst steady-state frame
+    bool     enabled;
+    bool     _pad0[7];
+} engine_frame_heap_stats;
+
+// Where engine_run frames waited, in milliseconds, averages are over every frame since engine_init
+typedef struct engine_frame_pacing_stats
+{
+    double   cpu_wait_ms;            // GPU retiring the in-flight slot being reused
+    double   gpu_ms;                 // lags the queue depth, 0 without timestamp queries
+    double   present_wait_ms;        // backbuffer acquire + present
+    double   input_to_present_ms;    // gamestate_update until the frame's present call returned, CPU side only:
+                                     // the GPU may still be executing it and scanout is not included
+    double   avg_cpu_wait_ms;
+    double   avg_gpu_ms;
+    double   avg_present_wait_ms;
+    double   avg_input_to_present_ms;
+    uint64_t frames;
+    bool     late_latch;
+    bool     _pad0[7];
+} engine_frame_pacing_stats;
+
 void engine_init(struct GLFWwindow** gameWindow, uint32_t width, uint32_t height);
 
+engine_startup_timings engine_get_startup_timings(void);
+
+engine_frame_heap_stats engine_get_frame_heap_stats(void);
+
+engine_frame_pacing_stats engine_get_frame_pacing_stats(void);
+
+// Samples input after the renderer waited on the frame slot instead of before it, see renderer_sdf_begin_frame
+void engine_set_late_latch(bool enable);
+
 void engine_destroy(void);
 
 bool engine_should_quit(void);
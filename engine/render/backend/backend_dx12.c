@@ -8,6 +8,7 @@
 
     #include "../core/memory/memalign.h"
     #include "../core/shader.h"
+    #include "../core/time/timer.h"
     #include <stdint.h>
 // clang-format off
 #ifdef _WIN32 // careful of the order
@@ -126,6 +127,7 @@ const rhi_jumptable dx12_jumptable = {
     dx12_create_descriptor_heap,
     dx12_destroy_descriptor_heap,
     dx12_build_descriptor_table,
+    dx12_destroy_descriptor_table,
     dx12_create_texture_resource,
     dx12_destroy_texture_resource,
     dx12_create_sampler,
@@ -139,6 +141,7 @@ const rhi_jumptable dx12_jumptable = {
     dx12d_destroy_sampler_resource_view,
     dx12_create_uniform_buffer_resource_view,
     dx12_destroy_uniform_buffer_resource_view,
+    dx12_create_swapchain_storage_view,
     dx12_create_single_time_command_buffer,
     dx12_destroy_single_time_command_buffer,
     dx12_readback_swapchain,
@@ -168,6 +171,37 @@ const rhi_jumptable dx12_jumptable = {
     dx12_transition_image_layout,
     dx12_transition_swapchain_layout,
     dx12_clear_image,
+    dx12_insert_shader_write_barrier,
+    dx12_create_timestamp_query_pool,
+    dx12_destroy_timestamp_query_pool,
+    dx12_reset_timestamp_queries,
+    dx12_begin_gpu_zone,
+    dx12_end_gpu_zone,
+    dx12_resolve_timestamp_queries,
+    dx12_create_storage_buffer_resource,
+    dx12_destroy_storage_buffer_resource,
+    dx12_update_storage_buffer,
+    dx12_read_storage_buffer,
+    dx12_create_storage_buffer_resource_view,
+    dx12_destroy_storage_buffer_resource_view,
+    dx12_insert_host_read_barrier,
+    dx12_create_readback_ring,
+    dx12_destroy_readback_ring,
+    dx12_record_swapchain_readback,
+    dx12_resolve_readback,
+    dx12_create_secondary_gfx_cmd_buf,
+    dx12_reset_gfx_cmd_pool,
+    dx12_begin_secondary_gfx_cmd_recording,
+    dx12_execute_secondary_gfx_cmds,
+    dx12_create_async_compute_cmd_pool,
+    dx12_submit_async_compute,
+    dx12_insert_queue_image_barrier,
+    dx12_get_memory_stats,
+    dx12_create_bindless_heap,
+    dx12_destroy_bindless_heap,
+    dx12_bindless_register,
+    dx12_bindless_release,
+    dx12_bind_bindless_heap,
 };
 //--------------------------------------------------------
 
@@ -301,6 +335,19 @@ typedef struct single_time_cmd_buf_backend
     ID3D12GraphicsCommandList* cmd_list;
 } single_time_cmd_buf_backend;
 
+typedef struct readback_ring_backend
+{
+    ID3D12Resource* buffer;
+    uint8_t*        mapped;         // persistently mapped for the lifetime of the ring, readback heaps allow that
+    UINT64          slot_stride;    // slot footprint rounded up to D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+    bool            slot_written[MAX_FRAMES_INFLIGHT];
+    bool            _pad0[5];
+    uint32_t        slot_width[MAX_FRAMES_INFLIGHT];
+    uint32_t        slot_height[MAX_FRAMES_INFLIGHT];
+    uint32_t        slot_row_pitch[MAX_FRAMES_INFLIGHT];
+    uint32_t        _pad1;
+} readback_ring_backend;
+
 //--------------------------------------------------------
 
 static D3D12_DESCRIPTOR_HEAP_TYPE dx12_util_heap_descriptor_type_translate(gfx_heap_type heap_type)
@@ -799,6 +846,13 @@ static void dx12_internal_destroy_res_view(gfx_resource_view* view)
 gfx_context dx12_ctx_init(GLFWwindow* window)
 {
     gfx_context ctx = {0};
+
+    // no offscreen backbuffers, engine_init switches headless runs to Vulkan
+    if (g_gfxConfig.headless) {
+        LOG_ERROR("[D3D12] Headless mode is not supported, use the Vulkan backend");
+        return ctx;
+    }
+
     uuid_generate(&ctx.uuid);
 
     memset(&s_DXCtx, 0, sizeof(context_backend));
@@ -873,6 +927,12 @@ gfx_context dx12_ctx_init(GLFWwindow* window)
     // Create frame sync primitives
     ctx.frame_sync.timeline_syncobj = dx12_create_syncobj(GFX_SYNCOBJ_TYPE_TIMELINE);
 
+    // timestamps, secondaries, bindless, memory stats and async compute are stubs on D3D12, see gfx_frontend.h
+    ctx.supports.timestamps     = false;
+    ctx.supports.secondary_cmds = false;
+    ctx.supports.bindless       = false;
+    ctx.supports.memory_stats   = false;
+
     // Cache CommandListSubmission commands
 
     return ctx;
@@ -1685,9 +1745,17 @@ gfx_descriptor_table dx12_build_descriptor_table(const gfx_root_signature* root_
                     &((resource_view_backend*) (res_view->backend))->srv_desc,
                     table_cpu_start);
             } break;
-            case GFX_RESOURCE_TYPE_STORAGE_IMAGE:
-            case GFX_RESOURCE_TYPE_STORAGE_TEXEL_BUFFER:
             case GFX_RESOURCE_TYPE_STORAGE_BUFFER: {
+                ID3D12Device_CreateUnorderedAccessView(
+                    DXDevice,
+                    res->ubo ? (ID3D12Resource*) (res->ubo->backend) : NULL,    // a null UAV drops the writes if the buffer failed to create
+                    NULL,
+                    &((resource_view_backend*) (res_view->backend))->uav_desc,
+                    table_cpu_start);
+                break;
+            }
+            case GFX_RESOURCE_TYPE_STORAGE_IMAGE:
+            case GFX_RESOURCE_TYPE_STORAGE_TEXEL_BUFFER: {
                 ID3D12Device_CreateUnorderedAccessView(
                     DXDevice,
                     (ID3D12Resource*) (res->texture->backend),
@@ -1737,6 +1805,14 @@ gfx_descriptor_table dx12_build_descriptor_table(const gfx_root_signature* root_
     return table;
 }
 
+void dx12_destroy_descriptor_table(gfx_descriptor_table* table)
+{
+    // Heap is a linear allocator, the descriptors are only reclaimed when the heap is destroyed
+    uuid_destroy(&table->uuid);
+    free(table->backend);
+    table->backend = NULL;
+}
+
 gfx_resource dx12_create_texture_resource(gfx_texture_create_info desc)
 {
     gfx_resource resource = {0};
@@ -2049,6 +2125,122 @@ void dx12_destroy_uniform_buffer_resource_view(gfx_resource_view* view)
     dx12_internal_destroy_res_view(view);
 }
 
+gfx_resource dx12_create_storage_buffer_resource(uint32_t size)
+{
+    // buffers share gfx_uniform_buffer, descriptor tables resolve both through resource->ubo
+    gfx_resource resource = {0};
+    resource.ubo          = malloc(sizeof(gfx_uniform_buffer));
+    uuid_generate(&resource.ubo->uuid);
+
+    // CPU visible write-back memory that also allows UAV access, the GPU writes and the host maps the same buffer
+    D3D12_HEAP_PROPERTIES heapProps = {0};
+    heapProps.Type                  = D3D12_HEAP_TYPE_CUSTOM;
+    heapProps.CPUPageProperty       = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
+    heapProps.MemoryPoolPreference  = D3D12_MEMORY_POOL_L0;
+
+    // Raw views address the buffer in 4 byte elements
+    uint32_t aligned_size = (uint32_t) align_memory_size(size, 4);
+
+    D3D12_RESOURCE_DESC buffer_desc = {0};
+    buffer_desc.Dimension           = D3D12_RESOURCE_DIMENSION_BUFFER;
+    buffer_desc.Width               = aligned_size;
+    buffer_desc.Height              = 1;
+    buffer_desc.DepthOrArraySize    = 1;
+    buffer_desc.MipLevels           = 1;
+    buffer_desc.SampleDesc.Count    = 1;
+    buffer_desc.Layout              = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    buffer_desc.Flags               = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    ID3D12Resource* d3dresource = NULL;
+    HRESULT         hr          = ID3D12Device9_CreateCommittedResource(DXDevice, &heapProps, D3D12_HEAP_FLAG_NONE, &buffer_desc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, NULL, &IID_ID3D12Resource, &d3dresource);
+    if (FAILED(hr)) {
+        uuid_destroy(&resource.ubo->uuid);
+        free(resource.ubo);
+        resource.ubo = NULL;
+        LOG_ERROR("[D3D12] Failed to create commited storage buffer resource! (HRESULT=0x%08X)", hr);
+        return resource;
+    }
+
+    resource.ubo->backend = d3dresource;
+    resource.ubo->size    = aligned_size;
+    resource.ubo->offset  = 0;
+
+    return resource;
+}
+
+void dx12_destroy_storage_buffer_resource(gfx_resource* resource)
+{
+    dx12_destroy_uniform_buffer_resource(resource);
+}
+
+void dx12_update_storage_buffer(gfx_resource* resource, uint32_t size, uint32_t offset, const void* data)
+{
+    ID3D12Resource* buffer = (ID3D12Resource*) resource->ubo->backend;
+    D3D12_RANGE     range  = {0, 0};    // nothing is read back
+    void*           mapped = NULL;
+
+    HRESULT hr = ID3D12Resource_Map(buffer, 0, &range, &mapped);
+    if (SUCCEEDED(hr)) {
+        memcpy((uint8_t*) mapped + offset, data, size);
+        D3D12_RANGE written = {offset, offset + size};
+        ID3D12Resource_Unmap(buffer, 0, &written);
+    }
+}
+
+void dx12_read_storage_buffer(const gfx_resource* resource, uint32_t size, uint32_t offset, void* out_data)
+{
+    ID3D12Resource* buffer = (ID3D12Resource*) resource->ubo->backend;
+    D3D12_RANGE     range  = {offset, offset + size};
+    void*           mapped = NULL;
+
+    HRESULT hr = ID3D12Resource_Map(buffer, 0, &range, &mapped);
+    if (FAILED(hr)) {
+        memset(out_data, 0, size);
+        return;
+    }
+    memcpy(out_data, (const uint8_t*) mapped + offset, size);
+    D3D12_RANGE written = {0, 0};    // nothing is written
+    ID3D12Resource_Unmap(buffer, 0, &written);
+}
+
+gfx_resource_view dx12_create_storage_buffer_resource_view(gfx_resource* resource, uint32_t size, uint32_t offset)
+{
+    UNUSED(resource);
+    gfx_resource_view view = {0};
+    uuid_generate(&view.uuid);
+    view.type = GFX_RESOURCE_TYPE_STORAGE_BUFFER;
+
+    resource_view_backend* backend = malloc(sizeof(resource_view_backend));
+    view.backend                   = backend;
+
+    // SSBOs are cross compiled to RWByteAddressBuffer, which needs a raw view
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc = {0};
+    uav_desc.Format                           = DXGI_FORMAT_R32_TYPELESS;
+    uav_desc.ViewDimension                    = D3D12_UAV_DIMENSION_BUFFER;
+    uav_desc.Buffer.FirstElement              = offset / 4;
+    uav_desc.Buffer.NumElements               = (UINT) align_memory_size(size, 4) / 4;
+    uav_desc.Buffer.Flags                     = D3D12_BUFFER_UAV_FLAG_RAW;
+
+    backend->uav_desc = uav_desc;
+
+    return view;
+}
+
+void dx12_destroy_storage_buffer_resource_view(gfx_resource_view* view)
+{
+    dx12_internal_destroy_res_view(view);
+}
+
+gfx_resource_view dx12_create_swapchain_storage_view(const gfx_swapchain* swapchain, uint32_t backbuffer_idx)
+{
+    // Flip model swapchain buffers cannot be created with DXGI_USAGE_UNORDERED_ACCESS
+    UNUSED(swapchain);
+    UNUSED(backbuffer_idx);
+    LOG_ERROR("[D3D12] swapchain backbuffers cannot be used as storage images");
+    gfx_resource_view view = {0};
+    return view;
+}
+
 gfx_cmd_buf dx12_create_single_time_command_buffer(void)
 {
     gfx_cmd_buf cmd_buf = {0};
@@ -2256,11 +2448,22 @@ rhi_error_codes dx12_frame_begin(gfx_context* context)
     uint32_t       frame_idx          = context->swapchain.current_backbuffer_idx;
     gfx_syncobj    frame_fence        = context->frame_sync.timeline_syncobj;
     gfx_sync_point current_sync_point = context->frame_sync.frame_syncpoint[frame_idx];
+
+    // frames are indexed by backbuffer, a queue shallower than the swapchain also waits on the frame depth - 1 submits back
+    gfx_sync_point depth_sync_point = context->frame_sync.global_syncpoint + 1;
+    if (depth_sync_point > g_gfxConfig.frame_queue_depth) {
+        depth_sync_point -= g_gfxConfig.frame_queue_depth;
+        if (depth_sync_point > current_sync_point)
+            current_sync_point = depth_sync_point;
+    }
     #if ENABLE_SYNC_LOGGING
     LOG_SUCCESS("[Frame Begin] --- current_sync_point to wait on: %llu (frame_idx = %d)", current_sync_point, frame_idx);
     #endif
 
+    uint64_t wait_start = timer_now_ns();
     dx12_wait_on_previous_cmds(&frame_fence, current_sync_point);
+    context->frame_waits.cpu_wait_ms     = timer_elapsed_ms(wait_start);
+    context->frame_waits.present_wait_ms = 0.0;    // GetCurrentBackBufferIndex doesn't block
 
     // for API completion sake
     context->inflight_frame_idx  = frame_idx;
@@ -2274,7 +2477,9 @@ rhi_error_codes dx12_frame_begin(gfx_context* context)
 
 rhi_error_codes dx12_frame_end(gfx_context* context)
 {
+    uint64_t present_start = timer_now_ns();
     dx12_present(context);
+    context->frame_waits.present_wait_ms = timer_elapsed_ms(present_start);
 
     gfx_sync_point wait_value = dx12_internal_signal(context);
     uint32_t       frame_idx  = context->swapchain.current_backbuffer_idx;
@@ -2394,8 +2599,16 @@ rhi_error_codes dx12_present(const gfx_context* context)
 {
     TracyCZoneNC(ctx, "Present", COLOR_PRESENT, true);
 
+    // Flip model: sync interval 1 is FIFO, 0 lets the compositor pick the newest frame (mailbox) and tears only when allowed
+    UINT sync_interval = 0;
+    UINT flags         = 0;
+    if (g_gfxConfig.present_mode == GFX_PRESENT_MODE_FIFO)
+        sync_interval = 1;
+    else if (g_gfxConfig.present_mode == GFX_PRESENT_MODE_IMMEDIATE)
+        flags = DXGI_PRESENT_ALLOW_TEARING;
+
     const swapchain_backend* sc_backend = (const swapchain_backend*) context->swapchain.backend;
-    HRESULT                  hr         = IDXGISwapChain4_Present(sc_backend->swapchain, 0, DXGI_PRESENT_ALLOW_TEARING);
+    HRESULT                  hr         = IDXGISwapChain4_Present(sc_backend->swapchain, sync_interval, flags);
     if (FAILED(hr)) {
         LOG_ERROR("[D3D12] Swapchain failed to present (HRESULT = 0x%08X)", (unsigned int) hr);
         return FailedPresent;
@@ -2697,6 +2910,14 @@ rhi_error_codes dx12_transition_image_layout(const gfx_cmd_buf* cmd_buf, const g
     barrier.Transition.StateAfter  = dx12_util_translate_image_layout_to_res_state(new_layout);
     barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 
+    // Same state on both sides is an invalid transition, it only orders UAV accesses
+    if (old_layout == new_layout) {
+        barrier               = (D3D12_RESOURCE_BARRIER){0};
+        barrier.Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+        barrier.Flags         = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        barrier.UAV.pResource = image->texture->backend;
+    }
+
     ID3D12GraphicsCommandList_ResourceBarrier(cmd_list, 1, &barrier);
 
     TracyCZoneEnd(ctx);
@@ -2745,4 +2966,330 @@ rhi_error_codes dx12_clear_image(const gfx_cmd_buf* cmd_buf, const gfx_resource*
     return Success;
 }
 
+//--------------------------------------------------------
+// Profiling
+//--------------------------------------------------------
+
+// Not implemented, gfx_context.supports.timestamps is false on D3D12
+gfx_query_pool dx12_create_timestamp_query_pool(uint32_t max_zones)
+{
+    UNUSED(max_zones);
+    LOG_WARN("[D3D12] timestamp queries are not implemented yet, GPU zones are disabled");
+    gfx_query_pool query_pool = {0};
+    return query_pool;
+}
+
+void dx12_destroy_timestamp_query_pool(gfx_query_pool* query_pool)
+{
+    uuid_destroy(&query_pool->uuid);
+}
+
+rhi_error_codes dx12_reset_timestamp_queries(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx)
+{
+    UNUSED(cmd_buf);
+    UNUSED(query_pool);
+    UNUSED(frame_idx);
+    return FailedUnknown;
+}
+
+rhi_error_codes dx12_begin_gpu_zone(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx)
+{
+    UNUSED(cmd_buf);
+    UNUSED(query_pool);
+    UNUSED(frame_idx);
+    UNUSED(zone_idx);
+    return FailedUnknown;
+}
+
+rhi_error_codes dx12_end_gpu_zone(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx)
+{
+    UNUSED(cmd_buf);
+    UNUSED(query_pool);
+    UNUSED(frame_idx);
+    UNUSED(zone_idx);
+    return FailedUnknown;
+}
+
+rhi_error_codes dx12_insert_shader_write_barrier(const gfx_cmd_buf* cmd_buf)
+{
+    ID3D12GraphicsCommandList* cmd_list = (ID3D12GraphicsCommandList*) (cmd_buf->backend);
+
+    // A null resource orders every UAV access before the barrier against the ones after it
+    D3D12_RESOURCE_BARRIER barrier = {0};
+    barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    barrier.Flags                  = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    barrier.UAV.pResource          = NULL;
+    ID3D12GraphicsCommandList_ResourceBarrier(cmd_list, 1, &barrier);
+
+    return Success;
+}
+
+rhi_error_codes dx12_insert_host_read_barrier(const gfx_cmd_buf* cmd_buf, const gfx_resource* buffer)
+{
+    ID3D12GraphicsCommandList* cmd_list = (ID3D12GraphicsCommandList*) (cmd_buf->backend);
+
+    // The frame fence wait makes the writes host visible, this only orders them against later dispatches
+    D3D12_RESOURCE_BARRIER barrier = {0};
+    barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    barrier.Flags                  = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    barrier.UAV.pResource          = (ID3D12Resource*) buffer->ubo->backend;
+    ID3D12GraphicsCommandList_ResourceBarrier(cmd_list, 1, &barrier);
+
+    return Success;
+}
+
+rhi_error_codes dx12_resolve_timestamp_queries(const gfx_query_pool* query_pool, uint32_t frame_idx, double* out_zone_ms, uint32_t zone_count)
+{
+    UNUSED(query_pool);
+    UNUSED(frame_idx);
+    for (uint32_t i = 0; i < zone_count; i++)
+        out_zone_ms[i] = 0.0;
+    return FailedUnknown;
+}
+
+gfx_readback_ring dx12_create_readback_ring(uint32_t width, uint32_t height)
+{
+    gfx_readback_ring ring = {0};
+    uuid_generate(&ring.uuid);
+    ring.width     = width;
+    ring.height    = height;
+    ring.slot_size = width * height * 4;
+
+    readback_ring_backend* backend = malloc(sizeof(readback_ring_backend));
+    memset(backend, 0, sizeof(readback_ring_backend));
+    ring.backend = backend;
+
+    // copy rows are pitched to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and placed footprints start on 512 byte boundaries
+    UINT64 row_pitch     = ((UINT64) width * 4 + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) / D3D12_TEXTURE_DATA_PITCH_ALIGNMENT * D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
+    UINT64 slot_size     = row_pitch * height;
+    backend->slot_stride = (slot_size + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) / D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT * D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+
+    D3D12_HEAP_PROPERTIES heap_props = {
+        .Type                 = D3D12_HEAP_TYPE_READBACK,
+        .CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+        .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN};
+
+    D3D12_RESOURCE_DESC buffer_desc = {
+        .Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER,
+        .Alignment        = 0,
+        .Width            = backend->slot_stride * MAX_FRAMES_INFLIGHT,
+        .Height           = 1,
+        .DepthOrArraySize = 1,
+        .MipLevels        = 1,
+        .Format           = DXGI_FORMAT_UNKNOWN,
+        .SampleDesc       = {1, 0},
+        .Layout           = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+        .Flags            = D3D12_RESOURCE_FLAG_NONE};
+
+    HRESULT hr = ID3D12Device_CreateCommittedResource(
+        DXDevice,
+        &heap_props,
+        D3D12_HEAP_FLAG_NONE,
+        &buffer_desc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        NULL,
+        &IID_ID3D12Resource,
+        (void**) &backend->buffer);
+    DX_CHECK_HR(hr);
+
+    void* mapped = NULL;
+    DX_CHECK_HR(ID3D12Resource_Map(backend->buffer, 0, NULL, &mapped));
+    backend->mapped = (uint8_t*) mapped;
+
+    return ring;
+}
+
+void dx12_destroy_readback_ring(gfx_readback_ring* ring)
+{
+    uuid_destroy(&ring->uuid);
+
+    readback_ring_backend* backend = ring->backend;
+    if (!backend)
+        return;
+
+    D3D12_RANGE write_range = {0, 0};
+    ID3D12Resource_Unmap(backend->buffer, 0, &write_range);
+    ID3D12Resource_Release(backend->buffer);
+
+    free(backend);
+    ring->backend = NULL;
+}
+
+rhi_error_codes dx12_record_swapchain_readback(const gfx_cmd_buf* cmd_buf, const gfx_readback_ring* ring, const gfx_swapchain* swapchain, uint32_t frame_idx)
+{
+    readback_ring_backend* backend = ring->backend;
+    if (swapchain->width * swapchain->height * 4 > ring->slot_size)
+        return FailedMemoryAlloc;
+
+    ID3D12GraphicsCommandList* cmd_list   = (ID3D12GraphicsCommandList*) (cmd_buf->backend);
+    ID3D12Resource*            backbuffer = ((swapchain_backend*) swapchain->backend)->backbuffers[swapchain->current_backbuffer_idx];
+
+    D3D12_RESOURCE_DESC backbuffer_desc = {0};
+    ID3D12Resource_GetDesc(backbuffer, &backbuffer_desc);
+
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout     = {0};
+    UINT64                             total_size = 0;
+    ID3D12Device_GetCopyableFootprints(DXDevice, &backbuffer_desc, 0, 1, backend->slot_stride * frame_idx, &layout, NULL, NULL, &total_size);
+    if (total_size > backend->slot_stride)
+        return FailedMemoryAlloc;
+
+    D3D12_RESOURCE_BARRIER barrier = {
+        .Type       = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+        .Flags      = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+        .Transition = {
+            .pResource   = backbuffer,
+            .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+            .StateBefore = D3D12_RESOURCE_STATE_PRESENT,
+            .StateAfter  = D3D12_RESOURCE_STATE_COPY_SOURCE}};
+    ID3D12GraphicsCommandList_ResourceBarrier(cmd_list, 1, &barrier);
+
+    D3D12_TEXTURE_COPY_LOCATION src = {
+        .pResource        = backbuffer,
+        .Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+        .SubresourceIndex = 0};
+
+    D3D12_TEXTURE_COPY_LOCATION dst = {
+        .pResource       = backend->buffer,
+        .Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+        .PlacedFootprint = layout};
+
+    ID3D12GraphicsCommandList_CopyTextureRegion(cmd_list, &dst, 0, 0, 0, &src, NULL);
+
+    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    barrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_PRESENT;
+    ID3D12GraphicsCommandList_ResourceBarrier(cmd_list, 1, &barrier);
+
+    // readback heaps are host visible once the frame fence is waited on, no barrier needed for the CPU side
+    backend->slot_written[frame_idx]   = true;
+    backend->slot_width[frame_idx]     = swapchain->width;
+    backend->slot_height[frame_idx]    = swapchain->height;
+    backend->slot_row_pitch[frame_idx] = layout.Footprint.RowPitch;
+
+    return Success;
+}
+
+rhi_error_codes dx12_resolve_readback(const gfx_readback_ring* ring, uint32_t frame_idx, gfx_texture_readback* out_readback)
+{
+    readback_ring_backend* backend = ring->backend;
+    if (!backend || !backend->slot_written[frame_idx])
+        return FailedQueryNotReady;
+
+    // each recorded slot is handed out once
+    backend->slot_written[frame_idx] = false;
+
+    // readback heaps are CPU cached, packing the pitched rows in place keeps the Vulkan layout of tight rows
+    uint8_t* slot      = backend->mapped + backend->slot_stride * frame_idx;
+    uint32_t row_bytes = backend->slot_width[frame_idx] * 4;
+    if (backend->slot_row_pitch[frame_idx] != row_bytes) {
+        for (uint32_t y = 1; y < backend->slot_height[frame_idx]; y++)
+            memmove(slot + (size_t) row_bytes * y, slot + (size_t) backend->slot_row_pitch[frame_idx] * y, row_bytes);
+    }
+
+    out_readback->width          = backend->slot_width[frame_idx];
+    out_readback->height         = backend->slot_height[frame_idx];
+    out_readback->bits_per_pixel = 32;
+    out_readback->pixels         = (char*) slot;
+
+    return Success;
+}
+
+// Not implemented, gfx_context.supports.secondary_cmds is false and the renderer records single threaded
+gfx_cmd_buf dx12_create_secondary_gfx_cmd_buf(gfx_cmd_pool* pool)
+{
+    UNUSED(pool);
+    return (gfx_cmd_buf){0};
+}
+
+rhi_error_codes dx12_reset_gfx_cmd_pool(const gfx_cmd_pool* pool)
+{
+    UNUSED(pool);
+    return FailedUnknown;
+}
+
+rhi_error_codes dx12_begin_secondary_gfx_cmd_recording(const gfx_cmd_pool* allocator, const gfx_cmd_buf* cmd_buf)
+{
+    UNUSED(allocator);
+    UNUSED(cmd_buf);
+    return FailedUnknown;
+}
+
+rhi_error_codes dx12_execute_secondary_gfx_cmds(const gfx_cmd_buf* cmd_buf, const gfx_cmd_buf* secondaries, uint32_t count)
+{
+    UNUSED(cmd_buf);
+    UNUSED(secondaries);
+    UNUSED(count);
+    return FailedUnknown;
+}
+
+// Not implemented, gfx_context.async_compute.is_supported is false and compute runs on the direct queue
+gfx_cmd_pool dx12_create_async_compute_cmd_pool(void)
+{
+    return (gfx_cmd_pool){0};
+}
+
+rhi_error_codes dx12_submit_async_compute(gfx_context* ctx, const gfx_cmd_buf* cmd_buf)
+{
+    UNUSED(ctx);
+    UNUSED(cmd_buf);
+    return FailedUnknown;
+}
+
+rhi_error_codes dx12_insert_queue_image_barrier(const gfx_cmd_buf* cmd_buf, const gfx_resource* image, gfx_image_layout old_layout, gfx_image_layout new_layout, gfx_queue_type src_queue, gfx_queue_type dst_queue, bool acquire)
+{
+    UNUSED(cmd_buf);
+    UNUSED(image);
+    UNUSED(old_layout);
+    UNUSED(new_layout);
+    UNUSED(src_queue);
+    UNUSED(dst_queue);
+    UNUSED(acquire);
+    return FailedUnknown;
+}
+
+// Not implemented, gfx_context.supports.memory_stats is false since D3D12 only uses committed resources
+gfx_memory_stats dx12_get_memory_stats(void)
+{
+    gfx_memory_stats stats = {0};
+    return stats;
+}
+
+// Not implemented, gfx_context.supports.bindless is false and every pass binds descriptor tables
+gfx_bindless_heap dx12_create_bindless_heap(uint32_t resource_capacity, uint32_t sampler_capacity, uint32_t push_constant_size)
+{
+    (void) resource_capacity;
+    (void) sampler_capacity;
+    (void) push_constant_size;
+    LOG_ERROR("[D3D12] bindless heaps are not implemented yet");
+    gfx_bindless_heap heap = {0};
+    return heap;
+}
+
+void dx12_destroy_bindless_heap(gfx_bindless_heap* heap)
+{
+    (void) heap;
+}
+
+gfx_bindless_slot dx12_bindless_register(gfx_bindless_heap* heap, const gfx_resource* resource, const gfx_resource_view* view)
+{
+    (void) heap;
+    (void) resource;
+    (void) view;
+    gfx_bindless_slot slot = {.index = GFX_BINDLESS_INVALID_INDEX};
+    return slot;
+}
+
+void dx12_bindless_release(gfx_bindless_heap* heap, gfx_bindless_slot slot)
+{
+    (void) heap;
+    (void) slot;
+}
+
+rhi_error_codes dx12_bind_bindless_heap(const gfx_cmd_buf* cmd_buf, const gfx_bindless_heap* heap, gfx_pipeline_type pipeline_type)
+{
+    (void) cmd_buf;
+    (void) heap;
+    (void) pipeline_type;
+    return FailedUnknown;
+}
+
 #endif    // _WIN32
\ No newline at end of file
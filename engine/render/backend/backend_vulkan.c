@@ -3,8 +3,10 @@
 #include "../core/common.h"
 #include "../core/containers/typed_growable_array.h"
 #include "../core/logging/log.h"
+#include "../core/memory/linear_arena.h"
 
 #include "../core/shader.h"
+#include "../core/time/timer.h"
 #include <stdint.h>
 // clang-format off
 #define VK_NO_PROTOTYPES
@@ -19,6 +21,7 @@
 #include <GLFW/glfw3.h>
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>    // memset
 
@@ -48,6 +51,7 @@ const rhi_jumptable vulkan_jumptable = {
     vulkan_device_create_descriptor_heap,
     vulkan_device_destroy_descriptor_heap,
     vulkan_device_build_descriptor_table,
+    vulkan_device_destroy_descriptor_table,
 
     vulkan_device_create_texture_resource,
     vulkan_device_destroy_texture_resource,
@@ -67,6 +71,7 @@ const rhi_jumptable vulkan_jumptable = {
 
     vulkan_device_create_uniform_buffer_resource_view,
     vulkan_device_destroy_uniform_buffer_resource_view,
+    vulkan_device_create_swapchain_storage_view,
 
     vulkan_device_create_single_time_command_buffer,
     vulkan_device_destroy_single_time_command_buffer,
@@ -107,7 +112,41 @@ const rhi_jumptable vulkan_jumptable = {
     vulkan_transition_image_layout,
     vulkan_transition_swapchain_layout,
 
-    vulkan_clear_image};
+    vulkan_clear_image,
+    vulkan_insert_shader_write_barrier,
+
+    vulkan_device_create_timestamp_query_pool,
+    vulkan_device_destroy_timestamp_query_pool,
+    vulkan_reset_timestamp_queries,
+    vulkan_begin_gpu_zone,
+    vulkan_end_gpu_zone,
+    vulkan_resolve_timestamp_queries,
+
+    vulkan_device_create_storage_buffer_resource,
+    vulkan_device_destroy_storage_buffer_resource,
+    vulkan_device_update_storage_buffer,
+    vulkan_device_read_storage_buffer,
+    vulkan_device_create_storage_buffer_resource_view,
+    vulkan_device_destroy_storage_buffer_resource_view,
+    vulkan_insert_host_read_barrier,
+
+    vulkan_device_create_readback_ring,
+    vulkan_device_destroy_readback_ring,
+    vulkan_record_swapchain_readback,
+    vulkan_resolve_readback,
+    vulkan_device_create_secondary_gfx_cmd_buf,
+    vulkan_reset_gfx_cmd_pool,
+    vulkan_begin_secondary_gfx_cmd_recording,
+    vulkan_execute_secondary_gfx_cmds,
+    vulkan_device_create_async_compute_cmd_pool,
+    vulkan_submit_async_compute,
+    vulkan_insert_queue_image_barrier,
+    vulkan_device_get_memory_stats,
+    vulkan_device_create_bindless_heap,
+    vulkan_device_destroy_bindless_heap,
+    vulkan_device_bindless_register,
+    vulkan_device_bindless_release,
+    vulkan_device_bind_bindless_heap};
 
 //--------------------------------------------------------
 
@@ -137,6 +176,10 @@ DEFINE_CLAMP(int)
 
 #define SHADER_BINARY_EXT "spv"
 
+// Per in-flight frame scratch for the transient arrays of submits and descriptor writes, overflow spills to the heap
+#define VK_FRAME_ARENA_SIZE (64 * 1024)
+#define VK_FRAME_ALLOC(Type, count) LINEAR_ARENA_ALLOC(s_VkCtx.frame_arena, Type, count)
+
 //--------------------------------------------------------
 // Internal Types
 //--------------------------------------------------------
@@ -183,6 +226,7 @@ typedef struct swapchain_backend
     VkExtent2D         extents;
     VkImage            backbuffers[MAX_BACKBUFFERS];
     VkImageView        backbuffer_views[MAX_BACKBUFFERS];
+    vulkan_allocation  backbuffer_allocs[MAX_BACKBUFFERS];    // headless only, offscreen backbuffers own their images
 } swapchain_backend;
 
 typedef struct cmd_pool_backend
@@ -226,32 +270,139 @@ typedef struct descriptor_table_backend
 {
     VkDescriptorSet  set;
     VkPipelineLayout pipeline_layout_ref;
+    VkDescriptorPool pool_ref;
     uint32_t         set_idx;
 } descriptor_table_backend;
 
+//-------------------------
+// Device memory allocator
+
+#define VK_MEMORY_BLOCK_SIZE     (64ull * 1024 * 1024)    // capped to 1/8th of the heap for small heaps
+#define VK_MEMORY_MIN_ALLOC_SIZE 256                      // chunk granularity, every sub-allocation offset is a multiple of it
+#define VK_MEMORY_TLSF_SL_LOG2   4
+#define VK_MEMORY_TLSF_SL_COUNT  (1 << VK_MEMORY_TLSF_SL_LOG2)
+#define VK_MEMORY_TLSF_FL_COUNT  32
+
+typedef enum vulkan_memory_pool_kind
+{
+    VULKAN_MEMORY_POOL_BUFFER,    // buffers and images never share a block, so bufferImageGranularity never applies
+    VULKAN_MEMORY_POOL_IMAGE,
+    VULKAN_MEMORY_POOL_LINEAR,    // bump allocated and rewound once empty, for short lived staging buffers
+    VULKAN_MEMORY_POOL_COUNT
+} vulkan_memory_pool_kind;
+
+// Range of a TLSF block, free or handed out
+typedef struct vulkan_memory_chunk
+{
+    VkDeviceSize                offset;
+    VkDeviceSize                size;
+    struct vulkan_memory_chunk* prev_phys;    // address ordered neighbours, free ones are merged on release
+    struct vulkan_memory_chunk* next_phys;
+    struct vulkan_memory_chunk* prev_free;    // free list of the size class
+    struct vulkan_memory_chunk* next_free;
+    bool                        is_free;
+    bool                        _pad0[7];
+} vulkan_memory_chunk;
+
+// One VkDeviceMemory, sub-allocated with TLSF: sizes are binned into power of two classes split into
+// VK_MEMORY_TLSF_SL_COUNT linear ranges, two bitmaps find a big enough non-empty bin in O(1)
+typedef struct vulkan_memory_block
+{
+    VkDeviceMemory              memory;
+    VkDeviceSize                size;
+    VkDeviceSize                used;
+    VkDeviceSize                linear_head;    // linear pool only
+    uint8_t*                    mapped;         // persistently mapped when the memory type is host visible
+    vulkan_memory_chunk*        first_chunk;
+    struct vulkan_memory_block* next;
+    vulkan_memory_chunk*        free_lists[VK_MEMORY_TLSF_FL_COUNT][VK_MEMORY_TLSF_SL_COUNT];
+    uint32_t                    sl_bitmaps[VK_MEMORY_TLSF_FL_COUNT];
+    uint32_t                    fl_bitmap;
+    uint32_t                    allocation_count;
+    uint32_t                    memory_type;
+    vulkan_memory_pool_kind     kind;
+} vulkan_memory_block;
+
+typedef struct vulkan_allocation
+{
+    VkDeviceMemory       memory;
+    VkDeviceSize         offset;
+    VkDeviceSize         size;
+    uint8_t*             mapped;    // already offset, NULL if the memory is not host visible
+    vulkan_memory_block* block;     // NULL for dedicated allocations
+    vulkan_memory_chunk* chunk;     // TLSF pools only
+    uint32_t             memory_type;
+    uint32_t             _pad0;
+} vulkan_allocation;
+
+// Not thread safe, resources are created and destroyed on the main thread
+typedef struct vulkan_memory_allocator
+{
+    vulkan_memory_block* pools[VK_MAX_MEMORY_TYPES][VULKAN_MEMORY_POOL_COUNT];
+    VkDeviceSize         heap_reserved[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize         used_bytes;
+    VkDeviceSize         dedicated_bytes;
+    uint32_t             block_count;
+    uint32_t             dedicated_count;
+    uint32_t             allocation_count;
+    uint32_t             _pad0;
+} vulkan_memory_allocator;
+//-------------------------
+
 typedef struct texture_backend
 {
-    VkImage        image;
-    VkDeviceMemory memory;
+    VkImage           image;
+    vulkan_allocation allocation;
 } texture_backend;
 
 typedef struct buffer_backend
 {
-    VkBuffer       buffer;
-    VkDeviceMemory memory;
+    VkBuffer          buffer;
+    vulkan_allocation allocation;
 } buffer_backend;
 
 typedef struct root_signature_backend
 {
     VkPipelineLayout       pipeline_layout;
     VkDescriptorSetLayout* vk_descriptor_set_layouts;
+    VkShaderStageFlags     push_constant_stages;    // 0 pushes to the stage of the bound range, bindless pushes to all
 } root_signature_backend;
 
+// Sets are allocated from an update-after-bind pool, slots can be written while frames using other slots are in flight
+typedef struct bindless_heap_backend
+{
+    VkDescriptorPool pool;
+    VkDescriptorSet  resource_set;
+    VkDescriptorSet  sampler_set;
+    uint32_t*        free_slots[GFX_BINDLESS_RANGE_COUNT];    // released indices, reused first
+    uint32_t         free_count[GFX_BINDLESS_RANGE_COUNT];
+    uint32_t         next_slot[GFX_BINDLESS_RANGE_COUNT];     // first never used index
+} bindless_heap_backend;
+
 typedef struct sampler_backend
 {
     VkSampler sampler;
 } sampler_backend;
 
+typedef struct readback_ring_backend
+{
+    VkBuffer          buffer;
+    vulkan_allocation allocation;
+    uint8_t*          mapped;         // persistently mapped for the lifetime of the ring
+    VkDeviceSize      slot_stride;    // slot_size rounded up to nonCoherentAtomSize
+    bool              coherent;
+    bool              slot_written[MAX_FRAMES_INFLIGHT];
+    bool              _pad0[4];
+    uint32_t          slot_width[MAX_FRAMES_INFLIGHT];
+    uint32_t          slot_height[MAX_FRAMES_INFLIGHT];
+} readback_ring_backend;
+
+typedef struct query_pool_backend
+{
+    VkQueryPool pool;
+    uint32_t    zones_written[MAX_FRAMES_INFLIGHT];    // bitmask of zones recorded since the last reset
+} query_pool_backend;
+
 //-------------------------
 // TODO: Combine these 2 structs
 typedef struct queue_indices
@@ -295,6 +446,14 @@ typedef struct context_backend
     queue_indices                    queue_idxs;
     queue_backend                    queues;
     cmd_pool_backend                 single_time_cmd_pool;
+    uint32_t                         timestamp_valid_bits;    // of the gfx queue family, 0 if unsupported
+    uint32_t                         supported_extension_count;
+    VkPipelineCache                  pipeline_cache;
+    linear_arena                     frame_arenas[MAX_FRAMES_INFLIGHT];
+    linear_arena*                    frame_arena;    // the current frame's, reset by frame_begin once its previous use retired
+    vulkan_memory_allocator          allocator;
+    bool                             memory_budget_supported;    // VK_EXT_memory_budget enabled
+    bool                             _pad0[7];
 } context_backend;
 
 static context_backend s_VkCtx;
@@ -316,6 +475,16 @@ static VkPrimitiveTopology vulkan_util_draw_type_translate(gfx_draw_type draw_ty
     }
 }
 
+static VkPresentModeKHR vulkan_util_present_mode_translate(gfx_present_mode present_mode)
+{
+    switch (present_mode) {
+        case GFX_PRESENT_MODE_FIFO: return VK_PRESENT_MODE_FIFO_KHR;
+        case GFX_PRESENT_MODE_MAILBOX: return VK_PRESENT_MODE_MAILBOX_KHR;
+        case GFX_PRESENT_MODE_IMMEDIATE: return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        default: return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
+
 static VkBlendOp vulkan_util_blend_op_translate(gfx_blend_op blend_op)
 {
     switch (blend_op) {
@@ -500,6 +669,12 @@ static VkPipelineBindPoint vulkan_util_pipeline_type_bindpoint_translate(gfx_pip
     }
 }
 
+// Headless backbuffers are never presented, they rest in GENERAL between frames instead
+static VkImageLayout vulkan_util_present_layout(void)
+{
+    return g_gfxConfig.headless ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 static VkImageLayout vulkan_util_translate_image_layout(gfx_image_layout layout)
 {
     switch (layout) {
@@ -518,7 +693,7 @@ static VkImageLayout vulkan_util_translate_image_layout(gfx_image_layout layout)
         case GFX_IMAGE_LAYOUT_SHADER_READ_ONLY:
             return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         case GFX_IMAGE_LAYOUT_PRESENTATION:
-            return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            return vulkan_util_present_layout();
         default:
             LOG_ERROR("Unsupported gfx_image_layout!");
             return VK_IMAGE_LAYOUT_UNDEFINED;
@@ -752,6 +927,48 @@ static void vulkan_internal_insert_image_memory_barrier(VkCommandBuffer cmdBuffe
         barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
         sourceStage           = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
         destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR && new_layout == VK_IMAGE_LAYOUT_GENERAL) {
+        // backbuffer written directly by compute, previous contents are discarded
+        // src stage chains with the image_ready semaphore wait (COLOR_ATTACHMENT_OUTPUT) at submit
+        barrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        sourceStage           = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_GENERAL && new_layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        sourceStage           = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_GENERAL && new_layout == VK_IMAGE_LAYOUT_GENERAL) {
+        // storage image written by compute and read/written again by compute or fragment, no layout change
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        sourceStage           = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_GENERAL && new_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+        // headless backbuffer (GENERAL is its present layout) drawn by the screen quad, may still be read by last frame's copy
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        sourceStage           = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_GENERAL) {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        sourceStage           = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_GENERAL && new_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        // headless backbuffer readback
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        sourceStage           = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_GENERAL) {
+        // next frame's writes wait for the copy to finish reading
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        sourceStage           = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        destinationStage      = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     }
 
     vkCmdPipelineBarrier(
@@ -771,6 +988,24 @@ static void vulkan_internal_insert_image_memory_barrier(VkCommandBuffer cmdBuffe
 // Context
 //--------------------------------------------------------
 
+static bool vulkan_internal_is_instance_layer_supported(const char* layer_name)
+{
+    uint32_t layerCount = 0;
+    vkEnumerateInstanceLayerProperties(&layerCount, NULL);
+
+    VkLayerProperties* layers = calloc(layerCount, sizeof(VkLayerProperties));
+    if (!layers)
+        return false;
+    vkEnumerateInstanceLayerProperties(&layerCount, layers);
+
+    bool found = false;
+    for (uint32_t i = 0; i < layerCount && !found; ++i)
+        found = strcmp(layers[i].layerName, layer_name) == 0;
+
+    free(layers);
+    return found;
+}
+
 static VkInstance vulkan_internal_create_instance(void)
 {
     VkDebugUtilsMessengerCreateInfoEXT debug_ci = {
@@ -797,31 +1032,46 @@ static VkInstance vulkan_internal_create_instance(void)
         .engineVersion      = VK_MAKE_VERSION(1, 0, 0),
         .pEngineName        = "byoe"};
 
-    const char* instance_layers[] = {VK_LAYER_KHRONOS_VALIDATION_NAME};
+    const char* instance_layers[]  = {VK_LAYER_KHRONOS_VALIDATION_NAME};
+    uint32_t    instanceLayerCount = sizeof(instance_layers) / sizeof(const char*);
+
+    // CI machines running a software ICD usually don't ship the validation layers
+    if (!vulkan_internal_is_instance_layer_supported(VK_LAYER_KHRONOS_VALIDATION_NAME)) {
+        LOG_WARN("[Vulkan] %s not found, running without validation", VK_LAYER_KHRONOS_VALIDATION_NAME);
+        instanceLayerCount = 0;
+    }
 
+    // headless has no window and no surface, so GLFW and the surface extensions are skipped
     uint32_t     glfwExtensionsCount = 0;
-    const char** glfwExtensions;
-    glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionsCount);
-    LOG_WARN("[Vulkan] GLFW loaded extensions count : %u", glfwExtensionsCount);
+    const char** glfwExtensions      = NULL;
+    if (!g_gfxConfig.headless) {
+        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionsCount);
+        LOG_WARN("[Vulkan] GLFW loaded extensions count : %u", glfwExtensionsCount);
 
-    for (uint32_t i = 0; i < glfwExtensionsCount; ++i) {
-        LOG_INFO("GLFW required extension: %s", glfwExtensions[i]);
+        for (uint32_t i = 0; i < glfwExtensionsCount; ++i) {
+            LOG_INFO("GLFW required extension: %s", glfwExtensions[i]);
+        }
     }
 
     const char* base_extensions[] = {
-#ifdef _WIN32
-        VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
-#elif __APPLE__
+#ifdef __APPLE__
         VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME,
 #endif
-        VK_KHR_SURFACE_EXTENSION_NAME,
         VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME,
         VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
         "VK_EXT_debug_report",
     };
 
-    uint32_t baseExtensionsCount  = sizeof(base_extensions) / sizeof(base_extensions[0]);
-    uint32_t totalExtensionsCount = baseExtensionsCount + glfwExtensionsCount;
+    const char* surface_extensions[] = {
+#ifdef _WIN32
+        VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+#endif
+        VK_KHR_SURFACE_EXTENSION_NAME,
+    };
+
+    uint32_t baseExtensionsCount    = sizeof(base_extensions) / sizeof(base_extensions[0]);
+    uint32_t surfaceExtensionsCount = g_gfxConfig.headless ? 0 : sizeof(surface_extensions) / sizeof(surface_extensions[0]);
+    uint32_t totalExtensionsCount   = baseExtensionsCount + surfaceExtensionsCount + glfwExtensionsCount;
 
     const uint32_t EXTENSION_MAX_CHAR_LEN = 256;
     const char**   instance_extensions    = calloc(totalExtensionsCount, sizeof(char) * EXTENSION_MAX_CHAR_LEN);
@@ -833,8 +1083,12 @@ static VkInstance vulkan_internal_create_instance(void)
         instance_extensions[i] = base_extensions[i];
     }
 
+    for (uint32_t i = 0; i < surfaceExtensionsCount; ++i) {
+        instance_extensions[baseExtensionsCount + i] = surface_extensions[i];
+    }
+
     for (uint32_t i = 0; i < glfwExtensionsCount; ++i) {
-        instance_extensions[baseExtensionsCount + i] = glfwExtensions[i];
+        instance_extensions[baseExtensionsCount + surfaceExtensionsCount + i] = glfwExtensions[i];
     }
 
     LOG_INFO("Total Vulkan instance extensions requested:");
@@ -850,7 +1104,7 @@ static VkInstance vulkan_internal_create_instance(void)
         .pNext                   = &debug_ci,    // struct injection
         .flags                   = 0,
         .pApplicationInfo        = &app_info,
-        .enabledLayerCount       = sizeof(instance_layers) / sizeof(const char*),
+        .enabledLayerCount       = instanceLayerCount,
         .ppEnabledLayerNames     = instance_layers,
         .enabledExtensionCount   = totalExtensionsCount,
         .ppEnabledExtensionNames = instance_extensions};
@@ -933,10 +1187,11 @@ static void vulkan_internal_print_gpu_stats(VkPhysicalDevice gpu)
     LOG_INFO("[Vulkan] Driver Version     : %d.%d.%d", VK_VERSION_MAJOR(props.driverVersion), VK_VERSION_MINOR(props.driverVersion), VK_VERSION_PATCH(props.driverVersion));
 }
 
-static VkExtensionProperties* vulkan_internal_query_supported_device_extensions(VkPhysicalDevice gpu)
+static VkExtensionProperties* vulkan_internal_query_supported_device_extensions(VkPhysicalDevice gpu, uint32_t* count)
 {
     uint32_t extCount = 0;
     vkEnumerateDeviceExtensionProperties(gpu, NULL, &extCount, NULL);
+    *count = 0;
     if (extCount > 0) {
         VkExtensionProperties* supported_extensions = calloc(extCount, sizeof(VkExtensionProperties));
         if (vkEnumerateDeviceExtensionProperties(gpu, NULL, &extCount, supported_extensions) == VK_SUCCESS) {
@@ -944,12 +1199,22 @@ static VkExtensionProperties* vulkan_internal_query_supported_device_extensions(
             for (uint32_t i = 0; i < extCount; ++i) {
                 LOG_INFO("  %s", supported_extensions[i].extensionName);
             }
+            *count = extCount;
         }
         return supported_extensions;
     }
     return NULL;
 }
 
+static bool vulkan_internal_is_device_extension_supported(const char* name)
+{
+    for (uint32_t i = 0; i < s_VkCtx.supported_extension_count; i++) {
+        if (strcmp(s_VkCtx.supported_extensions[i].extensionName, name) == 0)
+            return true;
+    }
+    return false;
+}
+
 static QueueFamPropsArrayView vulkan_internal_query_queue_props(VkPhysicalDevice gpu)
 {
     uint32_t queueFamilyCount;
@@ -968,6 +1233,7 @@ static QueueFamPropsArrayView vulkan_internal_query_queue_props(VkPhysicalDevice
 static queue_indices vulkan_internal_get_queue_family_indices(QueueFamPropsArrayView props, VkPhysicalDevice gpu, VkSurfaceKHR surface)
 {
     queue_indices indices = {0};
+    indices.async_compute = UINT32_MAX;
 
     for (uint32_t i = 0; i < props.size; ++i) {
         VkQueueFamilyProperties queue_prop = props.arr[i];
@@ -976,17 +1242,28 @@ static queue_indices vulkan_internal_get_queue_family_indices(QueueFamPropsArray
             indices.gfx = i;
 
         VkBool32 presentationSupported = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(gpu, indices.gfx, surface, &presentationSupported);
+        if (surface != VK_NULL_HANDLE)
+            vkGetPhysicalDeviceSurfaceSupportKHR(gpu, indices.gfx, surface, &presentationSupported);
 
         if (presentationSupported)
             indices.present = i;
 
-        if (queue_prop.queueFlags & VK_QUEUE_COMPUTE_BIT && !(queue_prop.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+        // first compute-only family, it needs timestamps so the GPU pass timings keep working on it
+        if (queue_prop.queueFlags & VK_QUEUE_COMPUTE_BIT && !(queue_prop.queueFlags & VK_QUEUE_GRAPHICS_BIT) && queue_prop.timestampValidBits > 0 && indices.async_compute == UINT32_MAX)
             indices.async_compute = i;
 
         //if (indices.gfx != UINT32_MAX && indices.present != UINT32_MAX && indices.async_compute != UINT32_MAX)
         //    break;
     }
+
+    // headless: nothing is presented, the gfx queue stands in for present
+    if (surface == VK_NULL_HANDLE)
+        indices.present = indices.gfx;
+
+    // no dedicated family, async compute work goes to the gfx queue
+    if (indices.async_compute == UINT32_MAX)
+        indices.async_compute = indices.gfx;
+
     return indices;
 }
 
@@ -1037,9 +1314,13 @@ static VkDevice vulkan_internal_create_logical_device(device_create_info_ex info
 {
     (void) info;
 
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .pNext = NULL};
+
     VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
-        .pNext = NULL};
+        .pNext = &descriptorIndexingFeatures};
 
     VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {
         .sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
@@ -1057,6 +1338,7 @@ static VkDevice vulkan_internal_create_logical_device(device_create_info_ex info
 #endif
     device_features.features.sampleRateShading = VK_TRUE;
 
+    // VK_KHR_swapchain stays first, headless skips it
     const char* device_extensions[] = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
@@ -1072,15 +1354,24 @@ static VkDevice vulkan_internal_create_logical_device(device_create_info_ex info
         VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
         "VK_KHR_portability_subset",
 #endif
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
     };
 
+    // VK_EXT_memory_budget stays last, it's optional and only feeds the allocator stats
+    uint32_t firstExtension = g_gfxConfig.headless ? 1 : 0;
+    uint32_t lastExtension  = sizeof(device_extensions) / sizeof(const char*);
+
+    s_VkCtx.memory_budget_supported = vulkan_internal_is_device_extension_supported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (!s_VkCtx.memory_budget_supported)
+        lastExtension--;
+
     VkDeviceCreateInfo device_ci = {
         .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         .pNext                   = &device_features,
         .queueCreateInfoCount    = info.queue_cis.size,
         .pQueueCreateInfos       = info.queue_cis.data,
-        .enabledExtensionCount   = sizeof(device_extensions) / sizeof(const char*),
-        .ppEnabledExtensionNames = device_extensions,
+        .enabledExtensionCount   = lastExtension - firstExtension,
+        .ppEnabledExtensionNames = device_extensions + firstExtension,
         .enabledLayerCount       = 0};
 
     VkDevice device = VK_NULL_HANDLE;
@@ -1088,6 +1379,12 @@ static VkDevice vulkan_internal_create_logical_device(device_create_info_ex info
     VK_CHECK_RESULT(vkCreateDevice(info.gpu, &device_ci, NULL, &device), "Failed to create VkDevice");
 
     g_gfxConfig.use_timeline_semaphores = timelineFeatures.timelineSemaphore;
+    // uniform buffers aren't part of the bindless heap, their update-after-bind support is spotty
+    g_gfxConfig.use_bindless = descriptorIndexingFeatures.runtimeDescriptorArray &&
+                               descriptorIndexingFeatures.descriptorBindingPartiallyBound &&
+                               descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+                               descriptorIndexingFeatures.descriptorBindingStorageImageUpdateAfterBind &&
+                               descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind;
 
     return device;
 }
@@ -1103,6 +1400,635 @@ static queue_backend vulkan_internal_create_queues(queue_indices indices)
     return backend;
 }
 
+//--------------------------------------------------------
+// Pipeline cache, persisted across runs at g_gfxConfig.pipeline_cache_path
+
+_Static_assert(sizeof(((gfx_pipeline_cache_file_header*) 0)->pipeline_cache_uuid) == VK_UUID_SIZE, "pipeline cache header UUID size");
+
+static void* vulkan_internal_load_pipeline_cache_blob(const char* path, size_t* size)
+{
+    *size = 0;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOG_INFO("[Vulkan] No pipeline cache at %s, cold start", path);
+        return NULL;
+    }
+
+    gfx_pipeline_cache_file_header header = {0};
+    void*                          blob   = NULL;
+    if (fread(&header, sizeof(header), 1, file) != 1)
+        goto invalid;
+
+    if (header.magic != GFX_PIPELINE_CACHE_FILE_MAGIC ||
+        header.vendor_id != s_VkCtx.props.vendorID ||
+        header.device_id != s_VkCtx.props.deviceID ||
+        header.driver_version != s_VkCtx.props.driverVersion ||
+        memcmp(header.pipeline_cache_uuid, s_VkCtx.props.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        header.data_size == 0) {
+        LOG_WARN("[Vulkan] Pipeline cache at %s was built for a different device/driver, discarding", path);
+        fclose(file);
+        return NULL;
+    }
+
+    blob = malloc(header.data_size);
+    if (!blob || fread(blob, header.data_size, 1, file) != 1)
+        goto invalid;
+
+    fclose(file);
+    *size = (size_t) header.data_size;
+    return blob;
+
+invalid:
+    LOG_WARN("[Vulkan] Pipeline cache at %s is truncated, discarding", path);
+    free(blob);
+    fclose(file);
+    return NULL;
+}
+
+// loaded_bytes is the blob size the driver accepted, 0 on a cold start
+static VkPipelineCache vulkan_internal_create_pipeline_cache(uint64_t* loaded_bytes)
+{
+    *loaded_bytes    = 0;
+    size_t blob_size = 0;
+    void*  blob      = NULL;
+    if (g_gfxConfig.pipeline_cache_path)
+        blob = vulkan_internal_load_pipeline_cache_blob(g_gfxConfig.pipeline_cache_path, &blob_size);
+
+    VkPipelineCacheCreateInfo cacheCI = {0};
+    cacheCI.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheCI.initialDataSize           = blob_size;
+    cacheCI.pInitialData              = blob;
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    VkResult        res   = vkCreatePipelineCache(VKDEVICE, &cacheCI, NULL, &cache);
+    if (res != VK_SUCCESS && blob) {
+        // driver rejected the blob, start from an empty cache instead
+        LOG_WARN("[Vulkan] Driver rejected pipeline cache data (%d), cold start", res);
+        cacheCI.initialDataSize = 0;
+        cacheCI.pInitialData    = NULL;
+        res                     = vkCreatePipelineCache(VKDEVICE, &cacheCI, NULL, &cache);
+    } else if (blob) {
+        LOG_INFO("[Vulkan] Loaded pipeline cache (%zu bytes) from %s", blob_size, g_gfxConfig.pipeline_cache_path);
+        *loaded_bytes = blob_size;
+    }
+    free(blob);
+
+    if (res != VK_SUCCESS) {
+        LOG_ERROR("[Vulkan] Cannot create pipeline cache (%d), pipelines will be built uncached", res);
+        return VK_NULL_HANDLE;
+    }
+    VK_TAG_OBJECT("PIPELINE_CACHE", VK_OBJECT_TYPE_PIPELINE_CACHE, cache);
+    return cache;
+}
+
+static void vulkan_internal_save_pipeline_cache(VkPipelineCache cache)
+{
+    if (cache == VK_NULL_HANDLE || !g_gfxConfig.pipeline_cache_path)
+        return;
+
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(VKDEVICE, cache, &data_size, NULL) != VK_SUCCESS || data_size == 0)
+        return;
+
+    void* data = malloc(data_size);
+    if (vkGetPipelineCacheData(VKDEVICE, cache, &data_size, data) != VK_SUCCESS) {
+        free(data);
+        return;
+    }
+
+    gfx_pipeline_cache_file_header header = {0};
+    header.magic                          = GFX_PIPELINE_CACHE_FILE_MAGIC;
+    header.vendor_id                      = s_VkCtx.props.vendorID;
+    header.device_id                      = s_VkCtx.props.deviceID;
+    header.driver_version                 = s_VkCtx.props.driverVersion;
+    header.data_size                      = data_size;
+    memcpy(header.pipeline_cache_uuid, s_VkCtx.props.pipelineCacheUUID, VK_UUID_SIZE);
+
+    FILE* file = fopen(g_gfxConfig.pipeline_cache_path, "wb");
+    if (!file) {
+        LOG_WARN("[Vulkan] Cannot open %s to save the pipeline cache", g_gfxConfig.pipeline_cache_path);
+        free(data);
+        return;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(data, data_size, 1, file) == 1;
+    fclose(file);
+    free(data);
+
+    if (written)
+        LOG_INFO("[Vulkan] Saved pipeline cache (%zu bytes) to %s", data_size, g_gfxConfig.pipeline_cache_path);
+    else {
+        LOG_WARN("[Vulkan] Failed writing the pipeline cache, removing partial file");
+        remove(g_gfxConfig.pipeline_cache_path);
+    }
+}
+
+//--------------------------------------------------------
+// Device memory allocator
+// Resources are sub-allocated out of big VkDeviceMemory blocks, one pool per memory type and
+// vulkan_memory_pool_kind. Anything bigger than half a block, or that the driver wants dedicated,
+// gets its own VkDeviceMemory. Host visible blocks stay mapped for their whole lifetime.
+
+#if defined(__clang__) || defined(__GNUC__)
+static uint32_t vulkan_internal_memory_msb(VkDeviceSize x)
+{
+    return 63 - (uint32_t) __builtin_clzll(x);
+}
+
+static uint32_t vulkan_internal_memory_lsb(uint32_t x)
+{
+    return (uint32_t) __builtin_ctz(x);
+}
+#else
+static uint32_t vulkan_internal_memory_msb(VkDeviceSize x)
+{
+    uint32_t bit = 0;
+    while (x >>= 1)
+        bit++;
+    return bit;
+}
+
+static uint32_t vulkan_internal_memory_lsb(uint32_t x)
+{
+    uint32_t bit = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        bit++;
+    }
+    return bit;
+}
+#endif
+
+static VkDeviceSize vulkan_internal_memory_align(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// First level is the power of two class, second level one of VK_MEMORY_TLSF_SL_COUNT linear steps inside it
+static void vulkan_internal_tlsf_mapping(VkDeviceSize size, uint32_t* fl, uint32_t* sl)
+{
+    *fl = vulkan_internal_memory_msb(size);
+    *sl = (uint32_t) (size >> (*fl - VK_MEMORY_TLSF_SL_LOG2)) ^ VK_MEMORY_TLSF_SL_COUNT;
+}
+
+static void vulkan_internal_tlsf_insert(vulkan_memory_block* block, vulkan_memory_chunk* chunk)
+{
+    uint32_t fl, sl;
+    vulkan_internal_tlsf_mapping(chunk->size, &fl, &sl);
+
+    chunk->is_free   = true;
+    chunk->prev_free = NULL;
+    chunk->next_free = block->free_lists[fl][sl];
+    if (chunk->next_free)
+        chunk->next_free->prev_free = chunk;
+
+    block->free_lists[fl][sl] = chunk;
+    block->sl_bitmaps[fl] |= 1u << sl;
+    block->fl_bitmap |= 1u << fl;
+}
+
+static void vulkan_internal_tlsf_remove(vulkan_memory_block* block, vulkan_memory_chunk* chunk)
+{
+    uint32_t fl, sl;
+    vulkan_internal_tlsf_mapping(chunk->size, &fl, &sl);
+
+    if (chunk->prev_free)
+        chunk->prev_free->next_free = chunk->next_free;
+    else
+        block->free_lists[fl][sl] = chunk->next_free;
+    if (chunk->next_free)
+        chunk->next_free->prev_free = chunk->prev_free;
+
+    if (!block->free_lists[fl][sl]) {
+        block->sl_bitmaps[fl] &= ~(1u << sl);
+        if (!block->sl_bitmaps[fl])
+            block->fl_bitmap &= ~(1u << fl);
+    }
+
+    chunk->is_free   = false;
+    chunk->prev_free = NULL;
+    chunk->next_free = NULL;
+}
+
+// Good fit in O(1): round up to the next size class so any chunk of the bin found is big enough
+static vulkan_memory_chunk* vulkan_internal_tlsf_find(const vulkan_memory_block* block, VkDeviceSize size)
+{
+    size += (1ull << (vulkan_internal_memory_msb(size) - VK_MEMORY_TLSF_SL_LOG2)) - 1;
+
+    uint32_t fl, sl;
+    vulkan_internal_tlsf_mapping(size, &fl, &sl);
+    if (fl >= VK_MEMORY_TLSF_FL_COUNT)
+        return NULL;
+
+    uint32_t sl_map = block->sl_bitmaps[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint32_t fl_map = fl + 1 < VK_MEMORY_TLSF_FL_COUNT ? block->fl_bitmap & (~0u << (fl + 1)) : 0;
+        if (!fl_map)
+            return NULL;
+
+        fl     = vulkan_internal_memory_lsb(fl_map);
+        sl_map = block->sl_bitmaps[fl];
+    }
+
+    return block->free_lists[fl][vulkan_internal_memory_lsb(sl_map)];
+}
+
+static bool vulkan_internal_tlsf_alloc(vulkan_memory_block* block, VkDeviceSize size, VkDeviceSize alignment, vulkan_allocation* allocation)
+{
+    // chunk offsets are multiples of VK_MEMORY_MIN_ALLOC_SIZE, so this much padding always fits the aligned range
+    VkDeviceSize padded = alignment > VK_MEMORY_MIN_ALLOC_SIZE ? size + alignment - VK_MEMORY_MIN_ALLOC_SIZE : size;
+
+    vulkan_memory_chunk* chunk = vulkan_internal_tlsf_find(block, padded);
+    if (!chunk)
+        return false;
+
+    vulkan_internal_tlsf_remove(block, chunk);
+
+    // neighbours of a free chunk are never free, so the split off ranges don't need merging
+    VkDeviceSize front = vulkan_internal_memory_align(chunk->offset, alignment) - chunk->offset;
+    if (front > 0) {
+        vulkan_memory_chunk* pad = calloc(1, sizeof(vulkan_memory_chunk));
+        pad->offset              = chunk->offset;
+        pad->size                = front;
+        pad->prev_phys           = chunk->prev_phys;
+        pad->next_phys           = chunk;
+        if (chunk->prev_phys)
+            chunk->prev_phys->next_phys = pad;
+        else
+            block->first_chunk = pad;
+        chunk->prev_phys = pad;
+        chunk->offset += front;
+        chunk->size -= front;
+        vulkan_internal_tlsf_insert(block, pad);
+    }
+
+    if (chunk->size > size) {
+        vulkan_memory_chunk* tail = calloc(1, sizeof(vulkan_memory_chunk));
+        tail->offset              = chunk->offset + size;
+        tail->size                = chunk->size - size;
+        tail->prev_phys           = chunk;
+        tail->next_phys           = chunk->next_phys;
+        if (chunk->next_phys)
+            chunk->next_phys->prev_phys = tail;
+        chunk->next_phys = tail;
+        chunk->size      = size;
+        vulkan_internal_tlsf_insert(block, tail);
+    }
+
+    allocation->offset = chunk->offset;
+    allocation->chunk  = chunk;
+    return true;
+}
+
+static void vulkan_internal_tlsf_free(vulkan_memory_block* block, vulkan_memory_chunk* chunk)
+{
+    vulkan_memory_chunk* prev = chunk->prev_phys;
+    if (prev && prev->is_free) {
+        vulkan_internal_tlsf_remove(block, prev);
+        prev->size += chunk->size;
+        prev->next_phys = chunk->next_phys;
+        if (chunk->next_phys)
+            chunk->next_phys->prev_phys = prev;
+        free(chunk);
+        chunk = prev;
+    }
+
+    vulkan_memory_chunk* next = chunk->next_phys;
+    if (next && next->is_free) {
+        vulkan_internal_tlsf_remove(block, next);
+        chunk->size += next->size;
+        chunk->next_phys = next->next_phys;
+        if (next->next_phys)
+            next->next_phys->prev_phys = chunk;
+        free(next);
+    }
+
+    vulkan_internal_tlsf_insert(block, chunk);
+}
+
+static VkDeviceSize vulkan_internal_memory_block_largest_free(const vulkan_memory_block* block)
+{
+    if (block->kind == VULKAN_MEMORY_POOL_LINEAR)
+        return block->size - block->linear_head;
+
+    if (!block->fl_bitmap)
+        return 0;
+
+    // the largest chunk sits in the highest non-empty bin, which is only sorted by size class
+    uint32_t     fl      = vulkan_internal_memory_msb(block->fl_bitmap);
+    uint32_t     sl      = vulkan_internal_memory_msb(block->sl_bitmaps[fl]);
+    VkDeviceSize largest = 0;
+    for (const vulkan_memory_chunk* chunk = block->free_lists[fl][sl]; chunk; chunk = chunk->next_free) {
+        if (chunk->size > largest)
+            largest = chunk->size;
+    }
+    return largest;
+}
+
+static bool vulkan_internal_memory_is_host_visible(uint32_t memory_type)
+{
+    return (s_VkCtx.mem_props.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+static uint32_t vulkan_internal_memory_heap(uint32_t memory_type)
+{
+    return s_VkCtx.mem_props.memoryTypes[memory_type].heapIndex;
+}
+
+// Small heaps, e.g. a 256MB BAR window, get smaller blocks so a single block can't hog them
+static VkDeviceSize vulkan_internal_memory_block_size(uint32_t memory_type)
+{
+    VkDeviceSize heap_size = s_VkCtx.mem_props.memoryHeaps[vulkan_internal_memory_heap(memory_type)].size;
+    VkDeviceSize size      = heap_size / 8 < VK_MEMORY_BLOCK_SIZE ? heap_size / 8 : VK_MEMORY_BLOCK_SIZE;
+    return size / VK_MEMORY_MIN_ALLOC_SIZE * VK_MEMORY_MIN_ALLOC_SIZE;
+}
+
+static uint32_t vulkan_internal_memory_find_type(uint32_t type_filter, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred)
+{
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        VkMemoryPropertyFlags flags = pass == 0 ? required | preferred : required;
+        for (uint32_t i = 0; i < s_VkCtx.mem_props.memoryTypeCount; i++) {
+            if ((type_filter & (1u << i)) && (s_VkCtx.mem_props.memoryTypes[i].propertyFlags & flags) == flags)
+                return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static VkResult vulkan_internal_memory_allocate_device_memory(uint32_t memory_type, VkDeviceSize size, VkImage dedicated_image, VkDeviceMemory* memory, uint8_t** mapped)
+{
+    VkMemoryDedicatedAllocateInfo dedicated_info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .image = dedicated_image};
+
+    VkMemoryAllocateInfo alloc_info = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext           = dedicated_image != VK_NULL_HANDLE ? &dedicated_info : NULL,
+        .allocationSize  = size,
+        .memoryTypeIndex = memory_type};
+
+    VkResult result = vkAllocateMemory(VKDEVICE, &alloc_info, NULL, memory);
+    if (result != VK_SUCCESS)
+        return result;
+
+    *mapped = NULL;
+    if (vulkan_internal_memory_is_host_visible(memory_type))
+        VK_CHECK_RESULT(vkMapMemory(VKDEVICE, *memory, 0, VK_WHOLE_SIZE, 0, (void**) mapped), "[Vulkan] cannot map memory block");
+
+    s_VkCtx.allocator.heap_reserved[vulkan_internal_memory_heap(memory_type)] += size;
+    return VK_SUCCESS;
+}
+
+static void vulkan_internal_memory_free_device_memory(uint32_t memory_type, VkDeviceSize size, VkDeviceMemory memory, const uint8_t* mapped)
+{
+    if (mapped)
+        vkUnmapMemory(VKDEVICE, memory);
+    vkFreeMemory(VKDEVICE, memory, NULL);
+
+    s_VkCtx.allocator.heap_reserved[vulkan_internal_memory_heap(memory_type)] -= size;
+}
+
+static vulkan_memory_block* vulkan_internal_memory_create_block(uint32_t memory_type, vulkan_memory_pool_kind kind)
+{
+    VkDeviceSize   size   = vulkan_internal_memory_block_size(memory_type);
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    uint8_t*       mapped = NULL;
+    if (vulkan_internal_memory_allocate_device_memory(memory_type, size, VK_NULL_HANDLE, &memory, &mapped) != VK_SUCCESS)
+        return NULL;
+
+    vulkan_memory_block* block = calloc(1, sizeof(vulkan_memory_block));
+    block->memory              = memory;
+    block->size                = size;
+    block->mapped              = mapped;
+    block->memory_type         = memory_type;
+    block->kind                = kind;
+
+    if (kind != VULKAN_MEMORY_POOL_LINEAR) {
+        block->first_chunk       = calloc(1, sizeof(vulkan_memory_chunk));
+        block->first_chunk->size = size;
+        vulkan_internal_tlsf_insert(block, block->first_chunk);
+    }
+
+    block->next                                = s_VkCtx.allocator.pools[memory_type][kind];
+    s_VkCtx.allocator.pools[memory_type][kind] = block;
+    s_VkCtx.allocator.block_count++;
+
+    return block;
+}
+
+static void vulkan_internal_memory_destroy_block(vulkan_memory_block* block)
+{
+    vulkan_memory_block** link = &s_VkCtx.allocator.pools[block->memory_type][block->kind];
+    while (*link != block)
+        link = &(*link)->next;
+    *link = block->next;
+
+    vulkan_memory_chunk* chunk = block->first_chunk;
+    while (chunk) {
+        vulkan_memory_chunk* next = chunk->next_phys;
+        free(chunk);
+        chunk = next;
+    }
+
+    vulkan_internal_memory_free_device_memory(block->memory_type, block->size, block->memory, block->mapped);
+    s_VkCtx.allocator.block_count--;
+    free(block);
+}
+
+// dedicated_image is the image the driver asked a dedicated allocation for, VK_NULL_HANDLE otherwise
+static VkResult vulkan_internal_memory_alloc(const VkMemoryRequirements* requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, vulkan_memory_pool_kind kind, VkImage dedicated_image, vulkan_allocation* allocation)
+{
+    memset(allocation, 0, sizeof(vulkan_allocation));
+
+    uint32_t memory_type = vulkan_internal_memory_find_type(requirements->memoryTypeBits, required, preferred);
+    if (memory_type == UINT32_MAX) {
+        LOG_ERROR("[Vulkan] no memory type matches flags 0x%x for type bits 0x%x", required, requirements->memoryTypeBits);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+
+    vulkan_memory_allocator* allocator = &s_VkCtx.allocator;
+    allocation->memory_type            = memory_type;
+
+    // flush/invalidate ranges of non-coherent memory have to start on an atom boundary
+    VkDeviceSize alignment = requirements->alignment;
+    if (vulkan_internal_memory_is_host_visible(memory_type) && !(s_VkCtx.mem_props.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        alignment = alignment > s_VkCtx.props.limits.nonCoherentAtomSize ? alignment : s_VkCtx.props.limits.nonCoherentAtomSize;
+    if (alignment < VK_MEMORY_MIN_ALLOC_SIZE)
+        alignment = VK_MEMORY_MIN_ALLOC_SIZE;
+
+    VkDeviceSize size = vulkan_internal_memory_align(requirements->size, VK_MEMORY_MIN_ALLOC_SIZE);
+
+    if (dedicated_image != VK_NULL_HANDLE || size > vulkan_internal_memory_block_size(memory_type) / 2) {
+        VkResult result = vulkan_internal_memory_allocate_device_memory(memory_type, requirements->size, dedicated_image, &allocation->memory, &allocation->mapped);
+        if (result != VK_SUCCESS)
+            return result;
+
+        allocation->size = requirements->size;
+        allocator->dedicated_count++;
+        allocator->dedicated_bytes += requirements->size;
+        allocator->used_bytes += requirements->size;
+        allocator->allocation_count++;
+        return VK_SUCCESS;
+    }
+
+    vulkan_memory_block* block = allocator->pools[memory_type][kind];
+    for (; block; block = block->next) {
+        if (kind == VULKAN_MEMORY_POOL_LINEAR) {
+            VkDeviceSize offset = vulkan_internal_memory_align(block->linear_head, alignment);
+            if (offset + size <= block->size) {
+                block->linear_head = offset + size;
+                allocation->offset = offset;
+                break;
+            }
+        } else if (vulkan_internal_tlsf_alloc(block, size, alignment, allocation))
+            break;
+    }
+
+    if (!block) {
+        block = vulkan_internal_memory_create_block(memory_type, kind);
+        if (!block)
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+        // an empty block always fits anything below the dedicated threshold
+        if (kind == VULKAN_MEMORY_POOL_LINEAR)
+            block->linear_head = size;
+        else
+            vulkan_internal_tlsf_alloc(block, size, alignment, allocation);
+    }
+
+    block->allocation_count++;
+    block->used += size;
+    allocator->used_bytes += size;
+    allocator->allocation_count++;
+
+    allocation->memory = block->memory;
+    allocation->size   = size;
+    allocation->block  = block;
+    allocation->mapped = block->mapped ? block->mapped + allocation->offset : NULL;
+
+    return VK_SUCCESS;
+}
+
+// Returns the image when the driver prefers it in its own VkDeviceMemory, VK_NULL_HANDLE otherwise
+static VkImage vulkan_internal_get_image_memory_requirements(VkImage image, VkMemoryRequirements* requirements)
+{
+    VkMemoryDedicatedRequirements dedicated = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS};
+
+    VkMemoryRequirements2 requirements2 = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicated};
+
+    VkImageMemoryRequirementsInfo2 info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
+        .image = image};
+
+    vkGetImageMemoryRequirements2(VKDEVICE, &info, &requirements2);
+    *requirements = requirements2.memoryRequirements;
+
+    return dedicated.prefersDedicatedAllocation || dedicated.requiresDedicatedAllocation ? image : VK_NULL_HANDLE;
+}
+
+static void vulkan_internal_memory_free(vulkan_allocation* allocation)
+{
+    if (allocation->memory == VK_NULL_HANDLE)
+        return;
+
+    vulkan_memory_allocator* allocator = &s_VkCtx.allocator;
+    allocator->used_bytes -= allocation->size;
+    allocator->allocation_count--;
+
+    vulkan_memory_block* block = allocation->block;
+    if (!block) {
+        // dedicated, mapped points at the start of the memory
+        vulkan_internal_memory_free_device_memory(allocation->memory_type, allocation->size, allocation->memory, allocation->mapped);
+        allocator->dedicated_count--;
+        allocator->dedicated_bytes -= allocation->size;
+    } else {
+        block->allocation_count--;
+        block->used -= allocation->size;
+
+        if (block->kind == VULKAN_MEMORY_POOL_LINEAR) {
+            if (block->allocation_count == 0)
+                block->linear_head = 0;
+        } else
+            vulkan_internal_tlsf_free(block, allocation->chunk);
+
+        // keep one empty block per pool so create/destroy churn doesn't hit vkAllocateMemory every time
+        bool is_only_block = allocator->pools[block->memory_type][block->kind] == block && !block->next;
+        if (block->allocation_count == 0 && !is_only_block)
+            vulkan_internal_memory_destroy_block(block);
+    }
+
+    memset(allocation, 0, sizeof(vulkan_allocation));
+}
+
+static void vulkan_internal_destroy_memory_allocator(void)
+{
+    vulkan_memory_allocator* allocator = &s_VkCtx.allocator;
+    if (allocator->allocation_count > 0)
+        LOG_WARN("[Vulkan] %u device memory allocations leaked (%u dedicated)", allocator->allocation_count, allocator->dedicated_count);
+
+    for (uint32_t type = 0; type < VK_MAX_MEMORY_TYPES; type++) {
+        for (uint32_t kind = 0; kind < VULKAN_MEMORY_POOL_COUNT; kind++) {
+            while (allocator->pools[type][kind])
+                vulkan_internal_memory_destroy_block(allocator->pools[type][kind]);
+        }
+    }
+}
+
+gfx_memory_stats vulkan_device_get_memory_stats(void)
+{
+    const vulkan_memory_allocator* allocator = &s_VkCtx.allocator;
+
+    gfx_memory_stats stats      = {0};
+    stats.blocks                = allocator->block_count;
+    stats.dedicated_allocations = allocator->dedicated_count;
+    stats.allocations           = allocator->allocation_count;
+    stats.bytes_used            = allocator->used_bytes;
+    stats.bytes_reserved        = allocator->dedicated_bytes;
+
+    // weighed per block, a few half empty blocks are not fragmented just because their free space isn't contiguous across blocks
+    VkDeviceSize free_bytes    = 0;
+    VkDeviceSize largest_bytes = 0;
+    for (uint32_t type = 0; type < VK_MAX_MEMORY_TYPES; type++) {
+        for (uint32_t kind = 0; kind < VULKAN_MEMORY_POOL_COUNT; kind++) {
+            for (const vulkan_memory_block* block = allocator->pools[type][kind]; block; block = block->next) {
+                VkDeviceSize largest = vulkan_internal_memory_block_largest_free(block);
+                stats.bytes_reserved += block->size;
+                free_bytes += block->size - block->used;
+                largest_bytes += largest;
+                if (largest > stats.largest_free_range)
+                    stats.largest_free_range = largest;
+            }
+        }
+    }
+    stats.fragmentation = free_bytes > 0 ? 1.0f - (float) largest_bytes / (float) free_bytes : 0.0f;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+    if (s_VkCtx.memory_budget_supported) {
+        VkPhysicalDeviceMemoryProperties2 mem_props = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = &budget};
+        vkGetPhysicalDeviceMemoryProperties2(VKGPU, &mem_props);
+    }
+
+    stats.budget_supported = s_VkCtx.memory_budget_supported;
+    stats.heap_count       = s_VkCtx.mem_props.memoryHeapCount < MAX_GFX_MEMORY_HEAPS ? s_VkCtx.mem_props.memoryHeapCount : MAX_GFX_MEMORY_HEAPS;
+    for (uint32_t i = 0; i < stats.heap_count; i++) {
+        gfx_memory_heap_stats* heap = &stats.heaps[i];
+        heap->size                  = s_VkCtx.mem_props.memoryHeaps[i].size;
+        heap->device_local          = (s_VkCtx.mem_props.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        heap->reserved              = allocator->heap_reserved[i];
+        heap->budget                = s_VkCtx.memory_budget_supported ? budget.heapBudget[i] : heap->size;
+        heap->usage                 = s_VkCtx.memory_budget_supported ? budget.heapUsage[i] : heap->reserved;
+    }
+
+    return stats;
+}
+
 //--------------------------------------------------------
 
 gfx_context vulkan_ctx_init(GLFWwindow* window)
@@ -1114,6 +2040,10 @@ gfx_context vulkan_ctx_init(GLFWwindow* window)
     ctx.backend  = &s_VkCtx;
     s_VkCtx.hwnd = window;
 
+    for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++)
+        linear_arena_init(&s_VkCtx.frame_arenas[i], VK_FRAME_ARENA_SIZE);
+    s_VkCtx.frame_arena = &s_VkCtx.frame_arenas[0];
+
     if (volkInitialize() != VK_SUCCESS) {
         LOG_ERROR("Failed to initialize Volk");
         return ctx;
@@ -1123,7 +2053,8 @@ gfx_context vulkan_ctx_init(GLFWwindow* window)
 
     volkLoadInstance(VKINSTANCE);
 
-    s_VkCtx.surface = vulkan_internal_create_surface(window, VKINSTANCE);
+    if (!g_gfxConfig.headless)
+        s_VkCtx.surface = vulkan_internal_create_surface(window, VKINSTANCE);
 
     // query physical GPUs and create a logical device
     VKGPU = vulkan_internal_select_best_gpu(VKINSTANCE);
@@ -1135,10 +2066,11 @@ gfx_context vulkan_ctx_init(GLFWwindow* window)
     vulkan_internal_query_device_props(VKGPU, &s_VkCtx);
     vulkan_internal_print_gpu_stats(VKGPU);
 
-    s_VkCtx.supported_extensions = vulkan_internal_query_supported_device_extensions(VKGPU);
+    s_VkCtx.supported_extensions = vulkan_internal_query_supported_device_extensions(VKGPU, &s_VkCtx.supported_extension_count);
 
     QueueFamPropsArrayView queue_fam_props = vulkan_internal_query_queue_props(VKGPU);
     s_VkCtx.queue_idxs                     = vulkan_internal_get_queue_family_indices(queue_fam_props, VKGPU, s_VkCtx.surface);
+    s_VkCtx.timestamp_valid_bits           = queue_fam_props.arr[s_VkCtx.queue_idxs.gfx].timestampValidBits;
 
     device_create_info_ex device_ci_ex = {0};
     device_ci_ex.gpu                   = VKGPU;
@@ -1148,8 +2080,17 @@ gfx_context vulkan_ctx_init(GLFWwindow* window)
     if (VKDEVICE == VK_NULL_HANDLE)
         return ctx;
 
+    // headless has no acquire/present semaphores to pace frames with, only the timeline
+    if (g_gfxConfig.headless && !g_gfxConfig.use_timeline_semaphores) {
+        LOG_ERROR("[Vulkan] Headless mode requires timeline semaphore support");
+        uuid_destroy(&ctx.uuid);
+        return ctx;
+    }
+
     s_VkCtx.queues = vulkan_internal_create_queues(s_VkCtx.queue_idxs);
 
+    s_VkCtx.pipeline_cache = vulkan_internal_create_pipeline_cache(&ctx.pipeline_cache_loaded_bytes);
+
     // Create in-flight sync primitives (Fence or TimelimeSemaphores per in-flight frame)
     if (!g_gfxConfig.use_timeline_semaphores) {
         for (int i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
@@ -1161,8 +2102,18 @@ gfx_context vulkan_ctx_init(GLFWwindow* window)
         VK_TAG_OBJECT("INFLIGHT_TIMELINE_SEMA", VK_OBJECT_TYPE_SEMAPHORE, *((VkFence*) (ctx.frame_sync.timeline_syncobj.backend)));
     }
 
+    // Async compute is synced with the gfx queue through its own timeline, binary semaphores would need one per frame and queue
+    ctx.async_compute.is_supported = g_gfxConfig.use_timeline_semaphores && s_VkCtx.queue_idxs.async_compute != s_VkCtx.queue_idxs.gfx;
+    if (ctx.async_compute.is_supported) {
+        ctx.async_compute.timeline_syncobj = vulkan_device_create_syncobj(GFX_SYNCOBJ_TYPE_TIMELINE);
+        VK_TAG_OBJECT("ASYNC_COMPUTE_TIMELINE_SEMA", VK_OBJECT_TYPE_SEMAPHORE, *((VkSemaphore*) (ctx.async_compute.timeline_syncobj.backend)));
+        LOG_INFO("[Vulkan] Async compute on queue family %u, gfx on %u", s_VkCtx.queue_idxs.async_compute, s_VkCtx.queue_idxs.gfx);
+    } else {
+        LOG_INFO("[Vulkan] No dedicated compute queue family, compute runs on the gfx queue");
+    }
+
     // Create frame sync primitives per swapchain image
-    for (int i = 0; i < MAX_BACKBUFFERS; i++) {
+    for (int i = 0; i < MAX_BACKBUFFERS && !g_gfxConfig.headless; i++) {
         ctx.present_sync.rendering_done[i] = vulkan_device_create_syncobj(GFX_SYNCOBJ_TYPE_GPU);
         ctx.present_sync.image_ready[i]    = vulkan_device_create_syncobj(GFX_SYNCOBJ_TYPE_GPU);
 
@@ -1176,6 +2127,11 @@ gfx_context vulkan_ctx_init(GLFWwindow* window)
     cmdPoolCI.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     VK_CHECK_RESULT(vkCreateCommandPool(VKDEVICE, &cmdPoolCI, NULL, &s_VkCtx.single_time_cmd_pool.pool), "Cannot create single time gfx command pool");
 
+    ctx.supports.timestamps     = s_VkCtx.timestamp_valid_bits != 0;
+    ctx.supports.secondary_cmds = true;
+    ctx.supports.bindless       = g_gfxConfig.use_bindless;    // set from the descriptor indexing features at device creation
+    ctx.supports.memory_stats   = true;
+
     return ctx;
 }
 
@@ -1186,6 +2142,9 @@ void vulkan_ctx_destroy(gfx_context* ctx)
 
     free(s_VkCtx.supported_extensions);
 
+    if (ctx->async_compute.is_supported)
+        vulkan_device_destroy_syncobj(&ctx->async_compute.timeline_syncobj);
+
     if (g_gfxConfig.use_timeline_semaphores)
         vulkan_device_destroy_syncobj(&ctx->frame_sync.timeline_syncobj);
     else {
@@ -1194,14 +2153,26 @@ void vulkan_ctx_destroy(gfx_context* ctx)
         }
     }
 
-    for (uint32_t i = 0; i < MAX_BACKBUFFERS; i++) {
+    for (uint32_t i = 0; i < MAX_BACKBUFFERS && !g_gfxConfig.headless; i++) {
         vulkan_device_destroy_syncobj(&ctx->present_sync.rendering_done[i]);
         vulkan_device_destroy_syncobj(&ctx->present_sync.image_ready[i]);
     }
 
+    vulkan_internal_save_pipeline_cache(s_VkCtx.pipeline_cache);
+    vkDestroyPipelineCache(VKDEVICE, s_VkCtx.pipeline_cache, NULL);
+
     vkDestroyCommandPool(VKDEVICE, s_VkCtx.single_time_cmd_pool.pool, NULL);
-    vkDestroySurfaceKHR(VKINSTANCE, s_VkCtx.surface, NULL);
-    vkDestroyDevice(s_VkCtx.logical_device, NULL);
+    vulkan_internal_destroy_memory_allocator();
+
+    for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
+        if (s_VkCtx.frame_arenas[i].overflow_allocs > 0)
+            LOG_WARN("[Vulkan] frame arena %u spilled %u allocations to the heap, peak %zu of %zu bytes", i, s_VkCtx.frame_arenas[i].overflow_allocs, s_VkCtx.frame_arenas[i].high_water, s_VkCtx.frame_arenas[i].capacity);
+        linear_arena_destroy(&s_VkCtx.frame_arenas[i]);
+    }
+
+    if (s_VkCtx.surface != VK_NULL_HANDLE)
+        vkDestroySurfaceKHR(VKINSTANCE, s_VkCtx.surface, NULL);
+    vkDestroyDevice(s_VkCtx.logical_device, NULL);
     vulkan_internal_destroy_debug_utils_messenger(VKINSTANCE, s_VkCtx.debug_messenger, NULL);
     vkDestroyInstance(VKINSTANCE, NULL);
 }
@@ -1237,20 +2208,42 @@ static VkSurfaceFormatKHR vulkan_internal_choose_surface_format(void)
     return formats[0];
 }
 
+static const char* vulkan_internal_present_mode_name(VkPresentModeKHR mode)
+{
+    switch (mode) {
+        case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX";
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE";
+        default: return "UNKNOWN";
+    }
+}
+
+// g_gfxConfig.present_mode if the surface supports it, FIFO is the only mode the spec guarantees
 static VkPresentModeKHR vulkan_internal_choose_present_mode(void)
 {
+    VkPresentModeKHR requested = vulkan_util_present_mode_translate(g_gfxConfig.present_mode);
+
     uint32_t presentModesCount = 0;
     vkGetPhysicalDeviceSurfacePresentModesKHR(VKGPU, VKSURFACE, &presentModesCount, NULL);
 
     VkPresentModeKHR* present_modes = calloc(presentModesCount, sizeof(VkPresentModeKHR));
     vkGetPhysicalDeviceSurfacePresentModesKHR(VKGPU, VKSURFACE, &presentModesCount, present_modes);
 
+    VkPresentModeKHR chosen = VK_PRESENT_MODE_FIFO_KHR;    // V-Sync
     for (uint32_t i = 0; i < presentModesCount; i++) {
-        VkPresentModeKHR mode = present_modes[i];
-        if (mode == VK_PRESENT_MODE_MAILBOX_KHR)
-            return mode;
+        if (present_modes[i] == requested) {
+            chosen = requested;
+            break;
+        }
     }
-    return VK_PRESENT_MODE_FIFO_KHR;    // V-Sync
+    free(present_modes);
+
+    if (chosen != requested)
+        LOG_WARN("[Vulkan] Present mode %s is not supported by the surface, falling back to FIFO", vulkan_internal_present_mode_name(requested));
+    else
+        LOG_INFO("[Vulkan] Present mode: %s", vulkan_internal_present_mode_name(chosen));
+
+    return chosen;
 }
 
 static VkExtent2D vulkan_internal_choose_extents(void)
@@ -1273,6 +2266,67 @@ static VkExtent2D vulkan_internal_choose_extents(void)
     }
 }
 
+static bool vulkan_internal_format_supports_storage(VkFormat format)
+{
+    VkFormatProperties format_props = {0};
+    vkGetPhysicalDeviceFormatProperties(VKGPU, format, &format_props);
+    if (!(format_props.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+        return false;
+
+    // swapchain formats (BGRA) have no matching GLSL image format qualifier
+    VkPhysicalDeviceFeatures features = {0};
+    vkGetPhysicalDeviceFeatures(VKGPU, &features);
+    return features.shaderStorageImageWriteWithoutFormat == VK_TRUE;
+}
+
+static bool vulkan_internal_swapchain_supports_storage(VkSurfaceCapabilitiesKHR caps, VkFormat format)
+{
+    if (!(caps.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT))
+        return false;
+
+    return vulkan_internal_format_supports_storage(format);
+}
+
+// Headless stand-in for vkGetSwapchainImagesKHR, device local images we own and rotate through ourselves
+static void vulkan_internal_create_offscreen_backbuffers(gfx_swapchain* swapchain, swapchain_backend* backend)
+{
+    backend->format.format     = VK_FORMAT_B8G8R8A8_UNORM;
+    backend->format.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    backend->extents           = (VkExtent2D){swapchain->width, swapchain->height};
+
+    swapchain->image_count      = MAX_FRAMES_INFLIGHT < MAX_BACKBUFFERS ? MAX_FRAMES_INFLIGHT : MAX_BACKBUFFERS;
+    swapchain->supports_storage = vulkan_internal_format_supports_storage(backend->format.format);
+
+    VkImageUsageFlags image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (swapchain->supports_storage)
+        image_usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+    for (uint32_t i = 0; i < swapchain->image_count; i++) {
+        VkImageCreateInfo image_info = {
+            .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType     = VK_IMAGE_TYPE_2D,
+            .format        = backend->format.format,
+            .extent        = {swapchain->width, swapchain->height, 1},
+            .mipLevels     = 1,
+            .arrayLayers   = 1,
+            .samples       = VK_SAMPLE_COUNT_1_BIT,
+            .tiling        = VK_IMAGE_TILING_OPTIMAL,
+            .usage         = image_usage,
+            .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+        VK_CHECK_RESULT(vkCreateImage(VKDEVICE, &image_info, NULL, &backend->backbuffers[i]), "[Vulkan] Cannot create offscreen backbuffer");
+
+        VkMemoryRequirements mem_requirements;
+        VkImage              dedicated_image = vulkan_internal_get_image_memory_requirements(backend->backbuffers[i], &mem_requirements);
+
+        VK_CHECK_RESULT(vulkan_internal_memory_alloc(&mem_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, VULKAN_MEMORY_POOL_IMAGE, dedicated_image, &backend->backbuffer_allocs[i]), "[Vulkan] Cannot allocate offscreen backbuffer memory");
+        vkBindImageMemory(VKDEVICE, backend->backbuffers[i], backend->backbuffer_allocs[i].memory, backend->backbuffer_allocs[i].offset);
+
+        VK_TAG_OBJECT("OFFSCREEN_BACKBUFFER", VK_OBJECT_TYPE_IMAGE, backend->backbuffers[i]);
+    }
+}
+
 static void vulkan_internal_retrieve_swap_images(swapchain_backend* backend)
 {
     uint32_t swapImageCount = 0;
@@ -1307,49 +2361,47 @@ static void vulkan_internal_destroy_backbuffers(swapchain_backend* backend, uint
     for (uint32_t i = 0; i < image_count; i++) {
         vkDestroyImageView(VKDEVICE, backend->backbuffer_views[i], NULL);
         backend->backbuffer_views[i] = VK_NULL_HANDLE;
+
+        // swapchain images belong to the swapchain, only offscreen ones are ours
+        if (backend->backbuffer_allocs[i].memory != VK_NULL_HANDLE) {
+            vkDestroyImage(VKDEVICE, backend->backbuffers[i], NULL);
+            vulkan_internal_memory_free(&backend->backbuffer_allocs[i]);
+            backend->backbuffers[i] = VK_NULL_HANDLE;
+        }
     }
 }
 
-gfx_swapchain vulkan_device_create_swapchain(uint32_t width, uint32_t height)
+static void vulkan_internal_create_surface_backbuffers(gfx_swapchain* swapchain, swapchain_backend* backend)
 {
-    gfx_swapchain swapchain = {0};
-    uuid_generate(&swapchain.uuid);
-
-    swapchain.width  = width;
-    swapchain.height = height;
-
-    swapchain_backend* backend = malloc(sizeof(swapchain_backend));
-    if (!backend) {
-        LOG_ERROR("error malloc swapchain_backend");
-        uuid_destroy(&swapchain.uuid);
-        return swapchain;
-    }
-    memset(backend, 0, sizeof(swapchain_backend));
-    swapchain.backend = backend;
-
     VkSurfaceCapabilitiesKHR caps = vulkan_internal_query_swap_surface_caps();
 
     backend->format       = vulkan_internal_choose_surface_format();
     backend->present_mode = vulkan_internal_choose_present_mode();
     backend->extents      = vulkan_internal_choose_extents();
 
-    swapchain.image_count = caps.minImageCount + 1;
-    if (caps.maxImageCount > 0 && swapchain.image_count > caps.maxImageCount)
-        swapchain.image_count = caps.maxImageCount;
+    swapchain->image_count = caps.minImageCount + 1;
+    if (caps.maxImageCount > 0 && swapchain->image_count > caps.maxImageCount)
+        swapchain->image_count = caps.maxImageCount;
 
     // Clamp it to some max value
-    if (swapchain.image_count > MAX_BACKBUFFERS)
-        swapchain.image_count = MAX_BACKBUFFERS;
+    if (swapchain->image_count > MAX_BACKBUFFERS)
+        swapchain->image_count = MAX_BACKBUFFERS;
+
+    swapchain->supports_storage = vulkan_internal_swapchain_supports_storage(caps, backend->format.format);
+
+    VkImageUsageFlags image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (swapchain->supports_storage)
+        image_usage |= VK_IMAGE_USAGE_STORAGE_BIT;
 
     VkSwapchainCreateInfoKHR sc_ci = {
         .sType                 = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
         .surface               = VKSURFACE,
-        .minImageCount         = swapchain.image_count,
+        .minImageCount         = swapchain->image_count,
         .imageFormat           = backend->format.format,
         .imageColorSpace       = backend->format.colorSpace,
         .imageExtent           = backend->extents,
         .imageArrayLayers      = 1,
-        .imageUsage            = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        .imageUsage            = image_usage,
         .imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE,
         .compositeAlpha        = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .queueFamilyIndexCount = 0,
@@ -1366,11 +2418,35 @@ gfx_swapchain vulkan_device_create_swapchain(uint32_t width, uint32_t height)
     }
 
     vulkan_internal_retrieve_swap_images(backend);
+}
+
+gfx_swapchain vulkan_device_create_swapchain(uint32_t width, uint32_t height)
+{
+    gfx_swapchain swapchain = {0};
+    uuid_generate(&swapchain.uuid);
+
+    swapchain.width  = width;
+    swapchain.height = height;
+
+    swapchain_backend* backend = malloc(sizeof(swapchain_backend));
+    if (!backend) {
+        LOG_ERROR("error malloc swapchain_backend");
+        uuid_destroy(&swapchain.uuid);
+        return swapchain;
+    }
+    memset(backend, 0, sizeof(swapchain_backend));
+    swapchain.backend = backend;
+
+    if (g_gfxConfig.headless)
+        vulkan_internal_create_offscreen_backbuffers(&swapchain, backend);
+    else
+        vulkan_internal_create_surface_backbuffers(&swapchain, backend);
+
     vulkan_internal_retrieve_swap_image_views(backend, swapchain.image_count);
 
     for (uint32_t i = 0; i < swapchain.image_count; i++) {
         gfx_cmd_buf cmd_buff = vulkan_device_create_single_time_command_buffer();
-        vulkan_internal_insert_image_memory_barrier(*(VkCommandBuffer*) (cmd_buff.backend), backend->backbuffers[i], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        vulkan_internal_insert_image_memory_barrier(*(VkCommandBuffer*) (cmd_buff.backend), backend->backbuffers[i], VK_IMAGE_LAYOUT_UNDEFINED, vulkan_util_present_layout());
         vulkan_device_destroy_single_time_command_buffer(&cmd_buff);
     }
 
@@ -1477,7 +2553,7 @@ void vulkan_device_destroy_syncobj(gfx_syncobj* syncobj)
     BACKEND_SAFE_FREE(syncobj);
 }
 
-gfx_cmd_pool vulkan_device_create_gfx_cmd_pool(void)
+static gfx_cmd_pool vulkan_internal_create_cmd_pool(uint32_t queue_family_idx)
 {
     gfx_cmd_pool pool = {0};
     uuid_generate(&pool.uuid);
@@ -1492,7 +2568,7 @@ gfx_cmd_pool vulkan_device_create_gfx_cmd_pool(void)
 
     VkCommandPoolCreateInfo cmdPoolCI = {0};
     cmdPoolCI.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    cmdPoolCI.queueFamilyIndex        = s_VkCtx.queue_idxs.gfx;    // same as present
+    cmdPoolCI.queueFamilyIndex        = queue_family_idx;
     cmdPoolCI.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
     VK_CHECK_RESULT(vkCreateCommandPool(VKDEVICE, &cmdPoolCI, NULL, &backend->pool), "Cannot create gfx command pool");
@@ -1500,6 +2576,16 @@ gfx_cmd_pool vulkan_device_create_gfx_cmd_pool(void)
     return pool;
 }
 
+gfx_cmd_pool vulkan_device_create_gfx_cmd_pool(void)
+{
+    return vulkan_internal_create_cmd_pool(s_VkCtx.queue_idxs.gfx);    // same as present
+}
+
+gfx_cmd_pool vulkan_device_create_async_compute_cmd_pool(void)
+{
+    return vulkan_internal_create_cmd_pool(s_VkCtx.queue_idxs.async_compute);
+}
+
 void vulkan_device_destroy_gfx_cmd_pool(gfx_cmd_pool* pool)
 {
     if (!uuid_is_null(&pool->uuid)) {
@@ -1526,6 +2612,30 @@ gfx_cmd_buf vulkan_device_create_gfx_cmd_buf(gfx_cmd_pool* pool)
     return cmd_buf;
 }
 
+gfx_cmd_buf vulkan_device_create_secondary_gfx_cmd_buf(gfx_cmd_pool* pool)
+{
+    VkCommandBufferAllocateInfo alloc = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext              = NULL,
+        .commandPool        = ((cmd_pool_backend*) (pool->backend))->pool,
+        .commandBufferCount = 1,
+        .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY};
+
+    gfx_cmd_buf cmd_buf = {0};
+    uuid_generate(&cmd_buf.uuid);
+    cmd_buf.backend = malloc(sizeof(VkCommandBuffer));
+
+    VK_CHECK_RESULT(vkAllocateCommandBuffers(VKDEVICE, &alloc, cmd_buf.backend), "[Vulkan] cannot allocate secondary command buffer");
+    return cmd_buf;
+}
+
+rhi_error_codes vulkan_reset_gfx_cmd_pool(const gfx_cmd_pool* pool)
+{
+    // Resetting the whole pool is cheaper than resetting its command buffers one by one
+    VK_CHECK_RESULT(vkResetCommandPool(VKDEVICE, ((cmd_pool_backend*) (pool->backend))->pool, 0), "[Vulkan] Failed to reset command pool");
+    return Success;
+}
+
 void vulkan_device_free_gfx_cmd_buf(gfx_cmd_buf* cmd_buf)
 {
     // Since freeing pool will take care of this we ignore it
@@ -1645,6 +2755,7 @@ gfx_root_signature vulkan_device_create_root_signature(const gfx_descriptor_tabl
     uuid_generate(&root_sig.uuid);
     root_signature_backend* backend = malloc(sizeof(root_signature_backend));
     root_sig.backend                = backend;
+    backend->push_constant_stages   = 0;
 
     if (set_layout_count > 0) {
         root_sig.descriptor_layout_count = set_layout_count;
@@ -1772,7 +2883,7 @@ static gfx_pipeline vulkan_internal_create_compute_pipeline(gfx_pipeline_create_
     };
 
     pipeline.backend = malloc(sizeof(VkPipeline));
-    VK_CHECK_RESULT(vkCreateComputePipelines(VKDEVICE, VK_NULL_HANDLE, 1, &computePipelineCI, NULL, pipeline.backend), "[Vulkan] Cannot create compute graphics pipeline");
+    VK_CHECK_RESULT(vkCreateComputePipelines(VKDEVICE, s_VkCtx.pipeline_cache, 1, &computePipelineCI, NULL, pipeline.backend), "[Vulkan] Cannot create compute graphics pipeline");
 
     return pipeline;
 }
@@ -1971,7 +3082,7 @@ static gfx_pipeline vulkan_internal_create_gfx_pipeline(gfx_pipeline_create_info
         .renderPass          = VK_NULL_HANDLE};    // renderPass is NULL since we are using VK_KHR_dynamic_rendering extension
 
     pipeline.backend = malloc(sizeof(VkPipeline));
-    VK_CHECK_RESULT(vkCreateGraphicsPipelines(VKDEVICE, VK_NULL_HANDLE, 1, &graphics_pipeline_ci, NULL, pipeline.backend), "[Vulkan] could not create graphics pipeline");
+    VK_CHECK_RESULT(vkCreateGraphicsPipelines(VKDEVICE, s_VkCtx.pipeline_cache, 1, &graphics_pipeline_ci, NULL, pipeline.backend), "[Vulkan] could not create graphics pipeline");
 
     free(stages);
 
@@ -2037,6 +3148,45 @@ void vulkan_device_destroy_descriptor_heap(gfx_descriptor_heap* descriptor_table
     }
 }
 
+// Points the write at buffer_info or image_info, filled from the resource/view
+static void vulkan_internal_fill_descriptor_write(const gfx_resource* res, const gfx_resource_view* res_view, VkWriteDescriptorSet* write, VkDescriptorBufferInfo* buffer_info, VkDescriptorImageInfo* image_info)
+{
+    switch (res_view->type) {
+        case GFX_RESOURCE_TYPE_UNIFORM_BUFFER:
+        case GFX_RESOURCE_TYPE_STORAGE_BUFFER: {
+            *buffer_info = (VkDescriptorBufferInfo){
+                .buffer = (VkBuffer) ((buffer_backend*) (res->ubo->backend))->buffer,
+                .offset = ((buffer_view_backend*) (res_view->backend))->offset,
+                .range  = ((buffer_view_backend*) (res_view->backend))->range,
+            };
+            write->pBufferInfo = buffer_info;
+        } break;
+        case GFX_RESOURCE_TYPE_SAMPLER: {
+            *image_info = (VkDescriptorImageInfo){
+                .sampler = (VkSampler) ((sampler_backend*) (res->sampler->backend))->sampler,
+            };
+            write->pImageInfo = image_info;
+        } break;
+        case GFX_RESOURCE_TYPE_STORAGE_IMAGE: {
+            *image_info = (VkDescriptorImageInfo){
+                .imageView   = (VkImageView) ((tex_resource_view_backend*) (res_view->backend))->view,
+                .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+            };
+            write->pImageInfo = image_info;
+        } break;
+        case GFX_RESOURCE_TYPE_SAMPLED_IMAGE: {
+            *image_info = (VkDescriptorImageInfo){
+                .imageView   = (VkImageView) ((tex_resource_view_backend*) (res_view->backend))->view,
+                .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            };
+            write->pImageInfo = image_info;
+        } break;
+        default:
+            LOG_ERROR("[Vulkan] Unknown resource type!");
+            break;
+    }
+}
+
 gfx_descriptor_table vulkan_device_build_descriptor_table(const gfx_root_signature* root_sig, gfx_descriptor_heap* heap, gfx_descriptor_table_entry* entries, uint32_t num_entries)
 {
     gfx_descriptor_table table = {0};
@@ -2049,6 +3199,7 @@ gfx_descriptor_table vulkan_device_build_descriptor_table(const gfx_root_signatu
     descriptor_table_backend* table_backend = malloc(sizeof(descriptor_table_backend));
     table.backend                           = table_backend;
     table_backend->pipeline_layout_ref      = ((root_signature_backend*) (root_sig->backend))->pipeline_layout;
+    table_backend->pool_ref                 = heap_backend->pool;
     table_backend->set_idx                  = set_idx;
 
     VkDescriptorSetAllocateInfo info = {0};
@@ -2060,9 +3211,9 @@ gfx_descriptor_table vulkan_device_build_descriptor_table(const gfx_root_signatu
 
     VK_CHECK_RESULT(vkAllocateDescriptorSets(VKDEVICE, &info, &table_backend->set), "[Vulkan] Failed to allocate descriptor set");
 
-    VkWriteDescriptorSet*   writes       = malloc(sizeof(VkWriteDescriptorSet) * num_entries);
-    VkDescriptorBufferInfo* buffer_infos = malloc(sizeof(VkDescriptorBufferInfo) * num_entries);
-    VkDescriptorImageInfo*  image_infos  = malloc(sizeof(VkDescriptorImageInfo) * num_entries);
+    VkWriteDescriptorSet*   writes       = VK_FRAME_ALLOC(VkWriteDescriptorSet, num_entries);
+    VkDescriptorBufferInfo* buffer_infos = VK_FRAME_ALLOC(VkDescriptorBufferInfo, num_entries);
+    VkDescriptorImageInfo*  image_infos  = VK_FRAME_ALLOC(VkDescriptorImageInfo, num_entries);
 
     memset(writes, 0, sizeof(VkWriteDescriptorSet) * num_entries);
 
@@ -2081,63 +3232,268 @@ gfx_descriptor_table vulkan_device_build_descriptor_table(const gfx_root_signatu
             .descriptorType  = (VkDescriptorType) vulkan_util_descriptor_type_translate(res_view->type),
             .descriptorCount = 1,
         };
-
-        switch (res_view->type) {
-            case GFX_RESOURCE_TYPE_UNIFORM_BUFFER:
-            case GFX_RESOURCE_TYPE_STORAGE_BUFFER: {
-                buffer_infos[i] = (VkDescriptorBufferInfo){
-                    .buffer = (VkBuffer) ((buffer_backend*) (res->ubo->backend))->buffer,
-                    .offset = ((buffer_view_backend*) (res_view->backend))->offset,
-                    .range  = ((buffer_view_backend*) (res_view->backend))->range,
-                };
-                writes[i].pBufferInfo = &buffer_infos[i];
-            } break;
-            case GFX_RESOURCE_TYPE_SAMPLER: {
-                image_infos[i] = (VkDescriptorImageInfo){
-                    .sampler = (VkSampler) ((sampler_backend*) (res->sampler->backend))->sampler,
-                };
-                writes[i].pImageInfo = &image_infos[i];
-            } break;
-            case GFX_RESOURCE_TYPE_STORAGE_IMAGE: {
-                image_infos[i] = (VkDescriptorImageInfo){
-                    .imageView   = (VkImageView) ((tex_resource_view_backend*) (res_view->backend))->view,
-                    .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
-                };
-                writes[i].pImageInfo = &image_infos[i];
-            } break;
-            case GFX_RESOURCE_TYPE_SAMPLED_IMAGE: {
-                image_infos[i] = (VkDescriptorImageInfo){
-                    .imageView   = (VkImageView) ((tex_resource_view_backend*) (res_view->backend))->view,
-                    .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                };
-                writes[i].pImageInfo = &image_infos[i];
-            } break;
-            default:
-                LOG_ERROR("[Vulkan] Unknown resource type!");
-                break;
-        }
+        vulkan_internal_fill_descriptor_write(res, res_view, &writes[i], &buffer_infos[i], &image_infos[i]);
     }
 
     vkUpdateDescriptorSets(VKDEVICE, num_entries, writes, 0, NULL);
 
-    free(writes);
-    free(buffer_infos);
-    free(image_infos);
-
     return table;
 }
 
-static uint32_t vulkan_internal_find_memory_type(VkPhysicalDevice physical_device, uint32_t type_filter, VkMemoryPropertyFlags properties)
+void vulkan_device_destroy_descriptor_table(gfx_descriptor_table* table)
 {
-    VkPhysicalDeviceMemoryProperties memory_properties;
-    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+    if (table->backend) {
+        descriptor_table_backend* backend = table->backend;
+        // heaps are created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+        vkFreeDescriptorSets(VKDEVICE, backend->pool_ref, 1, &backend->set);
+    }
+    BACKEND_SAFE_FREE(table);
+}
 
-    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
-        if ((type_filter & (1 << i)) && (memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
+//--------------------------------------------------------
+// Bindless heap: set 0 holds one runtime array per resource range, set 1 the samplers.
+// Every binding is partially bound and update-after-bind, so only the slots a shader
+// actually indexes need to be valid and registering never waits on frames in flight.
+
+#define VK_BINDLESS_RESOURCE_SET 0
+#define VK_BINDLESS_SAMPLER_SET  1
+
+static VkDescriptorType vulkan_util_bindless_range_descriptor_type(gfx_bindless_range range)
+{
+    switch (range) {
+        case GFX_BINDLESS_RANGE_SAMPLED_IMAGE: return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        case GFX_BINDLESS_RANGE_STORAGE_IMAGE: return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        case GFX_BINDLESS_RANGE_STORAGE_BUFFER: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        case GFX_BINDLESS_RANGE_SAMPLER: return VK_DESCRIPTOR_TYPE_SAMPLER;
+        default: return VK_DESCRIPTOR_TYPE_MAX_ENUM;
     }
-    return UINT32_MAX;
+}
+
+static gfx_bindless_range vulkan_util_bindless_range_translate(gfx_resource_type type)
+{
+    switch (type) {
+        case GFX_RESOURCE_TYPE_SAMPLED_IMAGE: return GFX_BINDLESS_RANGE_SAMPLED_IMAGE;
+        case GFX_RESOURCE_TYPE_STORAGE_IMAGE: return GFX_BINDLESS_RANGE_STORAGE_IMAGE;
+        case GFX_RESOURCE_TYPE_STORAGE_BUFFER: return GFX_BINDLESS_RANGE_STORAGE_BUFFER;
+        case GFX_RESOURCE_TYPE_SAMPLER: return GFX_BINDLESS_RANGE_SAMPLER;
+        default: return GFX_BINDLESS_RANGE_COUNT;
+    }
+}
+
+static uint32_t vulkan_internal_bindless_range_limit(const VkPhysicalDeviceDescriptorIndexingProperties* props, gfx_bindless_range range)
+{
+    // ranges are visible to every stage, so the per-stage limit caps the whole array
+    switch (range) {
+        case GFX_BINDLESS_RANGE_SAMPLED_IMAGE: return props->maxDescriptorSetUpdateAfterBindSampledImages < props->maxPerStageDescriptorUpdateAfterBindSampledImages ? props->maxDescriptorSetUpdateAfterBindSampledImages : props->maxPerStageDescriptorUpdateAfterBindSampledImages;
+        case GFX_BINDLESS_RANGE_STORAGE_IMAGE: return props->maxDescriptorSetUpdateAfterBindStorageImages < props->maxPerStageDescriptorUpdateAfterBindStorageImages ? props->maxDescriptorSetUpdateAfterBindStorageImages : props->maxPerStageDescriptorUpdateAfterBindStorageImages;
+        case GFX_BINDLESS_RANGE_STORAGE_BUFFER: return props->maxDescriptorSetUpdateAfterBindStorageBuffers < props->maxPerStageDescriptorUpdateAfterBindStorageBuffers ? props->maxDescriptorSetUpdateAfterBindStorageBuffers : props->maxPerStageDescriptorUpdateAfterBindStorageBuffers;
+        case GFX_BINDLESS_RANGE_SAMPLER: return props->maxDescriptorSetUpdateAfterBindSamplers < props->maxPerStageDescriptorUpdateAfterBindSamplers ? props->maxDescriptorSetUpdateAfterBindSamplers : props->maxPerStageDescriptorUpdateAfterBindSamplers;
+        default: return 0;
+    }
+}
+
+static VkDescriptorSetLayout vulkan_internal_create_bindless_set_layout(const gfx_bindless_heap* heap, gfx_bindless_range first, uint32_t count)
+{
+    VkDescriptorSetLayoutBinding bindings[GFX_BINDLESS_RANGE_COUNT];
+    VkDescriptorBindingFlags     binding_flags[GFX_BINDLESS_RANGE_COUNT];
+    for (uint32_t i = 0; i < count; i++) {
+        gfx_bindless_range range = (gfx_bindless_range) (first + i);
+        bindings[i]              = (VkDescriptorSetLayoutBinding){
+                         .binding            = i,
+                         .descriptorType     = vulkan_util_bindless_range_descriptor_type(range),
+                         .descriptorCount    = heap->capacity[range],
+                         .stageFlags         = VK_SHADER_STAGE_ALL,
+                         .pImmutableSamplers = NULL,
+        };
+        binding_flags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_ci = {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .pNext         = NULL,
+        .bindingCount  = count,
+        .pBindingFlags = binding_flags,
+    };
+
+    VkDescriptorSetLayoutCreateInfo set_layout_ci = {
+        .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext        = &binding_flags_ci,
+        .flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = count,
+        .pBindings    = bindings,
+    };
+
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    VK_CHECK_RESULT(vkCreateDescriptorSetLayout(VKDEVICE, &set_layout_ci, NULL, &layout), "[Vulkan] cannot create bindless descriptor set layout");
+    return layout;
+}
+
+gfx_bindless_heap vulkan_device_create_bindless_heap(uint32_t resource_capacity, uint32_t sampler_capacity, uint32_t push_constant_size)
+{
+    gfx_bindless_heap heap = {0};
+    if (!g_gfxConfig.use_bindless) {
+        LOG_ERROR("[Vulkan] descriptor indexing is not supported, cannot create a bindless heap");
+        return heap;
+    }
+
+    uuid_generate(&heap.uuid);
+
+    VkPhysicalDeviceDescriptorIndexingProperties indexing_props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+        .pNext = NULL};
+    VkPhysicalDeviceProperties2 props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &indexing_props};
+    vkGetPhysicalDeviceProperties2(VKGPU, &props);
+
+    bindless_heap_backend* backend = calloc(1, sizeof(bindless_heap_backend));
+    heap.backend                   = backend;
+    heap.push_constant_size        = push_constant_size;
+
+    VkDescriptorPoolSize pool_sizes[GFX_BINDLESS_RANGE_COUNT];
+    for (uint32_t i = 0; i < GFX_BINDLESS_RANGE_COUNT; i++) {
+        gfx_bindless_range range = (gfx_bindless_range) i;
+        uint32_t           limit = vulkan_internal_bindless_range_limit(&indexing_props, range);
+        uint32_t           wants = range == GFX_BINDLESS_RANGE_SAMPLER ? sampler_capacity : resource_capacity;
+
+        heap.capacity[i]       = wants < limit ? wants : limit;
+        backend->free_slots[i] = malloc(sizeof(uint32_t) * heap.capacity[i]);
+        pool_sizes[i]          = (VkDescriptorPoolSize){vulkan_util_bindless_range_descriptor_type(range), heap.capacity[i]};
+    }
+
+    VkDescriptorPoolCreateInfo pool_ci = {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext         = NULL,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets       = 2,
+        .poolSizeCount = GFX_BINDLESS_RANGE_COUNT,
+        .pPoolSizes    = pool_sizes,
+    };
+    VK_CHECK_RESULT(vkCreateDescriptorPool(VKDEVICE, &pool_ci, NULL, &backend->pool), "[Vulkan] Failed to create bindless descriptor pool");
+
+    // Owned by the heap, destroyed with it through vulkan_device_destroy_root_signature
+    root_signature_backend* root_sig_backend                              = malloc(sizeof(root_signature_backend));
+    root_sig_backend->vk_descriptor_set_layouts                           = malloc(sizeof(VkDescriptorSetLayout) * 2);
+    root_sig_backend->vk_descriptor_set_layouts[VK_BINDLESS_RESOURCE_SET] = vulkan_internal_create_bindless_set_layout(&heap, GFX_BINDLESS_RANGE_SAMPLED_IMAGE, GFX_BINDLESS_RANGE_SAMPLER);
+    root_sig_backend->vk_descriptor_set_layouts[VK_BINDLESS_SAMPLER_SET]  = vulkan_internal_create_bindless_set_layout(&heap, GFX_BINDLESS_RANGE_SAMPLER, 1);
+    root_sig_backend->push_constant_stages                                = VK_SHADER_STAGE_ALL;
+
+    VkPushConstantRange push_constant_range = {
+        .offset     = 0,
+        .size       = push_constant_size,
+        .stageFlags = VK_SHADER_STAGE_ALL,
+    };
+
+    VkPipelineLayoutCreateInfo pipeline_layout_ci = {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext                  = NULL,
+        .flags                  = 0,
+        .setLayoutCount         = 2,
+        .pSetLayouts            = root_sig_backend->vk_descriptor_set_layouts,
+        .pushConstantRangeCount = push_constant_size > 0 ? 1 : 0,
+        .pPushConstantRanges    = &push_constant_range,
+    };
+    VK_CHECK_RESULT(vkCreatePipelineLayout(VKDEVICE, &pipeline_layout_ci, NULL, &root_sig_backend->pipeline_layout), "[Vulkan] cannot create bindless pipeline layout");
+
+    uuid_generate(&heap.root_sig.uuid);
+    heap.root_sig.backend                 = root_sig_backend;
+    heap.root_sig.descriptor_layout_count = 2;
+    if (push_constant_size > 0) {
+        heap.root_sig.push_constant_count = 1;
+        heap.root_sig.push_constants      = malloc(sizeof(gfx_root_constant_range));
+        // stage is ignored when pushing, push_constant_stages covers all of them
+        *heap.root_sig.push_constants = (gfx_root_constant_range){.size = push_constant_size, .offset = 0, .stage = GFX_SHADER_STAGE_PS};
+    }
+
+    VkDescriptorSet*            sets[2] = {&backend->resource_set, &backend->sampler_set};
+    VkDescriptorSetAllocateInfo info    = {
+           .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+           .pNext              = NULL,
+           .descriptorPool     = backend->pool,
+           .descriptorSetCount = 1,
+    };
+    for (uint32_t i = 0; i < 2; i++) {
+        info.pSetLayouts = &root_sig_backend->vk_descriptor_set_layouts[i];
+        VK_CHECK_RESULT(vkAllocateDescriptorSets(VKDEVICE, &info, sets[i]), "[Vulkan] Failed to allocate bindless descriptor set");
+    }
+    VK_TAG_OBJECT("BINDLESS_RESOURCE_HEAP", VK_OBJECT_TYPE_DESCRIPTOR_SET, backend->resource_set);
+    VK_TAG_OBJECT("BINDLESS_SAMPLER_HEAP", VK_OBJECT_TYPE_DESCRIPTOR_SET, backend->sampler_set);
+
+    LOG_INFO("[Vulkan] Bindless heap: %u sampled images, %u storage images, %u storage buffers, %u samplers", heap.capacity[GFX_BINDLESS_RANGE_SAMPLED_IMAGE], heap.capacity[GFX_BINDLESS_RANGE_STORAGE_IMAGE], heap.capacity[GFX_BINDLESS_RANGE_STORAGE_BUFFER], heap.capacity[GFX_BINDLESS_RANGE_SAMPLER]);
+
+    return heap;
+}
+
+void vulkan_device_destroy_bindless_heap(gfx_bindless_heap* heap)
+{
+    bindless_heap_backend* backend = heap->backend;
+    if (!backend)
+        return;
+
+    // frees both sets with it
+    vkDestroyDescriptorPool(VKDEVICE, backend->pool, NULL);
+    for (uint32_t i = 0; i < GFX_BINDLESS_RANGE_COUNT; i++)
+        free(backend->free_slots[i]);
+
+    vulkan_device_destroy_root_signature(&heap->root_sig);
+    BACKEND_SAFE_FREE(heap);
+}
+
+gfx_bindless_slot vulkan_device_bindless_register(gfx_bindless_heap* heap, const gfx_resource* resource, const gfx_resource_view* view)
+{
+    bindless_heap_backend* backend = heap->backend;
+    gfx_bindless_slot      slot    = {.index = GFX_BINDLESS_INVALID_INDEX, .range = vulkan_util_bindless_range_translate(view->type)};
+
+    if (slot.range == GFX_BINDLESS_RANGE_COUNT) {
+        LOG_ERROR("[Vulkan] resource type %d cannot be registered in the bindless heap", view->type);
+        return slot;
+    }
+
+    if (backend->free_count[slot.range] > 0)
+        slot.index = backend->free_slots[slot.range][--backend->free_count[slot.range]];
+    else if (backend->next_slot[slot.range] < heap->capacity[slot.range])
+        slot.index = backend->next_slot[slot.range]++;
+    else {
+        LOG_ERROR("[Vulkan] bindless range %d is full (%u slots)", slot.range, heap->capacity[slot.range]);
+        return slot;
+    }
+
+    bool                   is_sampler  = slot.range == GFX_BINDLESS_RANGE_SAMPLER;
+    VkDescriptorBufferInfo buffer_info = {0};
+    VkDescriptorImageInfo  image_info  = {0};
+    VkWriteDescriptorSet   write       = {
+                .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet          = is_sampler ? backend->sampler_set : backend->resource_set,
+                .dstBinding      = is_sampler ? 0 : (uint32_t) slot.range,
+                .dstArrayElement = slot.index,
+                .descriptorType  = vulkan_util_bindless_range_descriptor_type(slot.range),
+                .descriptorCount = 1,
+    };
+    vulkan_internal_fill_descriptor_write(resource, view, &write, &buffer_info, &image_info);
+
+    vkUpdateDescriptorSets(VKDEVICE, 1, &write, 0, NULL);
+
+    return slot;
+}
+
+void vulkan_device_bindless_release(gfx_bindless_heap* heap, gfx_bindless_slot slot)
+{
+    bindless_heap_backend* backend = heap->backend;
+    if (slot.index == GFX_BINDLESS_INVALID_INDEX || slot.range >= GFX_BINDLESS_RANGE_COUNT)
+        return;
+
+    // the stale descriptor stays in the slot, partially bound only requires it not to be indexed
+    backend->free_slots[slot.range][backend->free_count[slot.range]++] = slot.index;
+}
+
+rhi_error_codes vulkan_device_bind_bindless_heap(const gfx_cmd_buf* cmd_buf, const gfx_bindless_heap* heap, gfx_pipeline_type pipeline_type)
+{
+    const bindless_heap_backend*  backend          = heap->backend;
+    const root_signature_backend* root_sig_backend = heap->root_sig.backend;
+
+    VkDescriptorSet sets[2] = {backend->resource_set, backend->sampler_set};
+    vkCmdBindDescriptorSets(*(VkCommandBuffer*) cmd_buf->backend, vulkan_util_pipeline_type_bindpoint_translate(pipeline_type), root_sig_backend->pipeline_layout, 0, 2, sets, 0, NULL);
+    return Success;
 }
 
 gfx_resource vulkan_device_create_texture_resource(gfx_texture_create_info desc)
@@ -2173,15 +3529,10 @@ gfx_resource vulkan_device_create_texture_resource(gfx_texture_create_info desc)
     VK_CHECK_RESULT(vkCreateImage(VKDEVICE, &image_info, NULL, &backend->image), "[Vulkan] cannot create VkImage");
 
     VkMemoryRequirements mem_requirements;
-    vkGetImageMemoryRequirements(VKDEVICE, backend->image, &mem_requirements);
-
-    VkMemoryAllocateInfo alloc_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_requirements.size,
-        .memoryTypeIndex = vulkan_internal_find_memory_type(VKGPU, mem_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)};
+    VkImage              dedicated_image = vulkan_internal_get_image_memory_requirements(backend->image, &mem_requirements);
 
-    VK_CHECK_RESULT(vkAllocateMemory(VKDEVICE, &alloc_info, NULL, &backend->memory), "[Vulkan] cannot allocate memory for image");
-    vkBindImageMemory(VKDEVICE, backend->image, backend->memory, 0);
+    VK_CHECK_RESULT(vulkan_internal_memory_alloc(&mem_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, VULKAN_MEMORY_POOL_IMAGE, dedicated_image, &backend->allocation), "[Vulkan] cannot allocate memory for image");
+    vkBindImageMemory(VKDEVICE, backend->image, backend->allocation.memory, backend->allocation.offset);
 
     // transition layout
     gfx_cmd_buf cmd_buff = vulkan_device_create_single_time_command_buffer();
@@ -2199,7 +3550,7 @@ void vulkan_device_destroy_texture_resource(gfx_resource* resource)
 
     texture_backend* backend = ((texture_backend*) resource->texture->backend);
 
-    vkFreeMemory(VKDEVICE, backend->memory, NULL);
+    vulkan_internal_memory_free(&backend->allocation);
 
     VkImage vk_image = backend->image;
     vkDestroyImage(VKDEVICE, vk_image, NULL);
@@ -2305,21 +3656,17 @@ static VkBuffer vulkan_internal_create_buffer_backend(uint32_t size, VkBufferUsa
     return buffer;
 }
 
-static VkDeviceMemory vulkan_internal_create_buffer_memory(VkBuffer buffer, uint32_t offset)
+// Host visible and coherent since contents are updated and read straight through the persistent mapping
+static vulkan_allocation vulkan_internal_create_buffer_memory(VkBuffer buffer, VkMemoryPropertyFlags preferred, vulkan_memory_pool_kind kind)
 {
-    VkDeviceMemory memory = VK_NULL_HANDLE;
+    vulkan_allocation allocation = {0};
 
     VkMemoryRequirements mem_requirements;
     vkGetBufferMemoryRequirements(VKDEVICE, buffer, &mem_requirements);
 
-    VkMemoryAllocateInfo alloc_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_requirements.size,
-        .memoryTypeIndex = vulkan_internal_find_memory_type(VKGPU, mem_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)};    // since can be mapped on CPU to udpate it's contents
-
-    VK_CHECK_RESULT(vkAllocateMemory(VKDEVICE, &alloc_info, NULL, &memory), "[Vulkan] cannot allocate memory for buffer");
-    vkBindBufferMemory(VKDEVICE, buffer, memory, offset);
-    return memory;
+    VK_CHECK_RESULT(vulkan_internal_memory_alloc(&mem_requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, preferred, kind, VK_NULL_HANDLE, &allocation), "[Vulkan] cannot allocate memory for buffer");
+    vkBindBufferMemory(VKDEVICE, buffer, allocation.memory, allocation.offset);
+    return allocation;
 }
 
 gfx_resource vulkan_device_create_uniform_buffer_resource(uint32_t size)
@@ -2332,8 +3679,8 @@ gfx_resource vulkan_device_create_uniform_buffer_resource(uint32_t size)
     buffer_backend* backend = malloc(sizeof(buffer_backend));
     ubo->backend            = backend;
 
-    backend->buffer = vulkan_internal_create_buffer_backend(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
-    backend->memory = vulkan_internal_create_buffer_memory(backend->buffer, 0);
+    backend->buffer     = vulkan_internal_create_buffer_backend(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    backend->allocation = vulkan_internal_create_buffer_memory(backend->buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VULKAN_MEMORY_POOL_BUFFER);
 
     return resource;
 }
@@ -2343,8 +3690,8 @@ void vulkan_device_destroy_uniform_buffer_resource(gfx_resource* resource)
     uuid_destroy(&resource->ubo->uuid);
 
     buffer_backend* backend = (buffer_backend*) (resource->ubo->backend);
-    vkFreeMemory(VKDEVICE, backend->memory, NULL);
     vkDestroyBuffer(VKDEVICE, backend->buffer, NULL);
+    vulkan_internal_memory_free(&backend->allocation);
     free(backend);
     backend = NULL;
 
@@ -2354,19 +3701,46 @@ void vulkan_device_destroy_uniform_buffer_resource(gfx_resource* resource)
     resource->ubo = NULL;
 }
 
-static void* vulkan_internal_get_mapped_buffer_region(VkDeviceMemory memory, uint32_t size, uint32_t offset)
+void vulkan_device_update_uniform_buffer(gfx_resource* resource, uint32_t size, uint32_t offset, void* data)
 {
-    void* mapped = NULL;
-    VK_CHECK_RESULT(vkMapMemory(VKDEVICE, memory, offset, size, 0, &mapped), "[Vulkan] cannot map memory");
-    return mapped;
+    buffer_backend* backend = (buffer_backend*) resource->ubo->backend;
+    memcpy(backend->allocation.mapped + offset, data, size);
 }
 
-void vulkan_device_update_uniform_buffer(gfx_resource* resource, uint32_t size, uint32_t offset, void* data)
+gfx_resource vulkan_device_create_storage_buffer_resource(uint32_t size)
+{
+    // buffers share gfx_uniform_buffer, descriptor tables resolve both through resource->ubo
+    gfx_resource resource = {0};
+    resource.ubo          = malloc(sizeof(gfx_uniform_buffer));
+    uuid_generate(&resource.ubo->uuid);
+    resource.ubo->size   = size;
+    resource.ubo->offset = 0;
+
+    buffer_backend* backend = malloc(sizeof(buffer_backend));
+    resource.ubo->backend   = backend;
+
+    backend->buffer     = vulkan_internal_create_buffer_backend(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    backend->allocation = vulkan_internal_create_buffer_memory(backend->buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VULKAN_MEMORY_POOL_BUFFER);
+    VK_TAG_OBJECT("STORAGE_BUFFER", VK_OBJECT_TYPE_BUFFER, backend->buffer)
+
+    return resource;
+}
+
+void vulkan_device_destroy_storage_buffer_resource(gfx_resource* resource)
+{
+    vulkan_device_destroy_uniform_buffer_resource(resource);
+}
+
+void vulkan_device_update_storage_buffer(gfx_resource* resource, uint32_t size, uint32_t offset, const void* data)
 {
     buffer_backend* backend = (buffer_backend*) resource->ubo->backend;
-    void*           mapped  = vulkan_internal_get_mapped_buffer_region(backend->memory, size, offset);
-    memcpy(mapped, data, size);
-    vkUnmapMemory(VKDEVICE, backend->memory);
+    memcpy(backend->allocation.mapped + offset, data, size);
+}
+
+void vulkan_device_read_storage_buffer(const gfx_resource* resource, uint32_t size, uint32_t offset, void* out_data)
+{
+    const buffer_backend* backend = (const buffer_backend*) resource->ubo->backend;
+    memcpy(out_data, backend->allocation.mapped + offset, size);
 }
 
 void vulkan_device_destroy_texture_resource_view(gfx_resource_view* view)
@@ -2411,6 +3785,53 @@ void vulkan_device_destroy_uniform_buffer_resource_view(gfx_resource_view* view)
     BACKEND_SAFE_FREE(view);
 }
 
+gfx_resource_view vulkan_device_create_storage_buffer_resource_view(gfx_resource* resource, uint32_t size, uint32_t offset)
+{
+    gfx_resource_view view = vulkan_device_create_uniform_buffer_resource_view(resource, size, offset);
+    view.type              = GFX_RESOURCE_TYPE_STORAGE_BUFFER;
+    return view;
+}
+
+void vulkan_device_destroy_storage_buffer_resource_view(gfx_resource_view* view)
+{
+    BACKEND_SAFE_FREE(view);
+}
+
+gfx_resource_view vulkan_device_create_swapchain_storage_view(const gfx_swapchain* swapchain, uint32_t backbuffer_idx)
+{
+    gfx_resource_view view = {0};
+    if (!swapchain->supports_storage || backbuffer_idx >= swapchain->image_count) {
+        LOG_ERROR("[Vulkan] swapchain backbuffer %u cannot be used as a storage image", backbuffer_idx);
+        return view;
+    }
+
+    uuid_generate(&view.uuid);
+    view.type = GFX_RESOURCE_TYPE_STORAGE_IMAGE;
+
+    tex_resource_view_backend* backend    = malloc(sizeof(tex_resource_view_backend));
+    view.backend                          = backend;
+    const swapchain_backend*   sc_backend = swapchain->backend;
+
+    // Separate view from the one used as color attachment, so it can be freed with vulkan_device_destroy_texture_resource_view
+    VkImageViewCreateInfo view_ci = {
+        .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image            = sc_backend->backbuffers[backbuffer_idx],
+        .viewType         = VK_IMAGE_VIEW_TYPE_2D,
+        .format           = sc_backend->format.format,
+        .components       = (VkComponentMapping){VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY},
+        .subresourceRange = {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = 1,
+            .baseArrayLayer = 0,
+            .layerCount     = 1}};
+
+    VK_CHECK_RESULT(vkCreateImageView(VKDEVICE, &view_ci, NULL, &backend->view), "[Vulkan] Cannot create swapchain storage image view");
+    VK_TAG_OBJECT("SWAPCHAIN_STORAGE_VIEW", VK_OBJECT_TYPE_IMAGE_VIEW, backend->view);
+
+    return view;
+}
+
 gfx_cmd_buf vulkan_device_create_single_time_command_buffer(void)
 {
     VkCommandBufferAllocateInfo alloc_info = {
@@ -2419,9 +3840,10 @@ gfx_cmd_buf vulkan_device_create_single_time_command_buffer(void)
         .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
         .commandBufferCount = 1};
 
+    // submitted and waited on by destroy, so the handle never outlives the frame arena
     gfx_cmd_buf cmd_buf = {0};
     uuid_generate(&cmd_buf.uuid);
-    cmd_buf.backend = malloc(sizeof(VkCommandBuffer));
+    cmd_buf.backend = VK_FRAME_ALLOC(VkCommandBuffer, 1);
 
     VK_CHECK_RESULT(vkAllocateCommandBuffers(VKDEVICE, &alloc_info, cmd_buf.backend), "[Vulkan] Failed to allocate single-time command buffer");
     VkCommandBufferBeginInfo begin_info = {
@@ -2449,7 +3871,7 @@ void vulkan_device_destroy_single_time_command_buffer(gfx_cmd_buf* cmd_buf)
     vkFreeCommandBuffers(VKDEVICE, s_VkCtx.single_time_cmd_pool.pool, 1, &vk_cmd_buf);
 
     uuid_destroy(&cmd_buf->uuid);
-    free(cmd_buf->backend);
+    cmd_buf->backend = NULL;
 }
 
 gfx_texture_readback vulkan_device_readback_swapchain(const gfx_swapchain* swapchain)
@@ -2459,9 +3881,15 @@ gfx_texture_readback vulkan_device_readback_swapchain(const gfx_swapchain* swapc
     vkDeviceWaitIdle(VKDEVICE);
 
     // create temporary vulkan buffer for transferring image from GPU to CPU
-    uint32_t       size           = swapchain->width * swapchain->height * 32;    // 4 since RGBA8_UNORM
-    VkBuffer       staging_buffer = vulkan_internal_create_buffer_backend(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-    VkDeviceMemory staging_memory = vulkan_internal_create_buffer_memory(staging_buffer, 0);
+    uint32_t          size           = swapchain->width * swapchain->height * 4;    // 4 since RGBA8_UNORM
+    VkBuffer          staging_buffer = vulkan_internal_create_buffer_backend(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    vulkan_allocation staging_memory = {0};
+
+    // same as the readback ring, cached memory is preferred and invalidated below when it isn't coherent
+    VkMemoryRequirements mem_requirements;
+    vkGetBufferMemoryRequirements(VKDEVICE, staging_buffer, &mem_requirements);
+    VK_CHECK_RESULT(vulkan_internal_memory_alloc(&mem_requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT, VULKAN_MEMORY_POOL_LINEAR, VK_NULL_HANDLE, &staging_memory), "[Vulkan] cannot allocate readback staging memory");
+    vkBindBufferMemory(VKDEVICE, staging_buffer, staging_memory.memory, staging_memory.offset);
 
     gfx_cmd_buf     cmd_buf    = vulkan_device_create_single_time_command_buffer();
     VkCommandBuffer vk_cmd_buf = *(VkCommandBuffer*) cmd_buf.backend;
@@ -2469,7 +3897,7 @@ gfx_texture_readback vulkan_device_readback_swapchain(const gfx_swapchain* swapc
     VkImage swap_vk_image = ((swapchain_backend*) (swapchain->backend))->backbuffers[swapchain->current_backbuffer_idx];
 
     // Change the image layout from shader read only optimal to transfer source
-    vulkan_internal_insert_image_memory_barrier(vk_cmd_buf, swap_vk_image, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    vulkan_internal_insert_image_memory_barrier(vk_cmd_buf, swap_vk_image, vulkan_util_present_layout(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
     {
         // 1.1 Copy from staging buffer to Image
 
@@ -2487,24 +3915,42 @@ gfx_texture_readback vulkan_device_readback_swapchain(const gfx_swapchain* swapc
 
         vkCmdCopyImageToBuffer(vk_cmd_buf, swap_vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging_buffer, 1, &region);
     }
-    vulkan_internal_insert_image_memory_barrier(vk_cmd_buf, swap_vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    vulkan_internal_insert_image_memory_barrier(vk_cmd_buf, swap_vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vulkan_util_present_layout());
+
+    VkBufferMemoryBarrier host_barrier = {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = staging_buffer,
+        .offset              = 0,
+        .size                = VK_WHOLE_SIZE,
+    };
+    vkCmdPipelineBarrier(vk_cmd_buf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &host_barrier, 0, NULL);
 
     vulkan_device_destroy_single_time_command_buffer(&cmd_buf);
 
+    if (!(s_VkCtx.mem_props.memoryTypes[staging_memory.memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        // pooled offsets and sizes are atom aligned by the allocator, dedicated memory is invalidated whole
+        VkMappedMemoryRange range = {
+            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+            .memory = staging_memory.memory,
+            .offset = staging_memory.offset,
+            .size   = staging_memory.block ? staging_memory.size : VK_WHOLE_SIZE};
+        vkInvalidateMappedMemoryRanges(VKDEVICE, 1, &range);
+    }
+
     readback.width          = swapchain->width;
     readback.height         = swapchain->height;
     readback.bits_per_pixel = 32;
     readback.pixels         = malloc(size);
 
-    if (readback.pixels) {
-        void* data = vulkan_internal_get_mapped_buffer_region(staging_memory, size, 0);
-        if (data)
-            memcpy(readback.pixels, data, size);
-        vkUnmapMemory(VKDEVICE, staging_memory);
-    }
+    if (readback.pixels)
+        memcpy(readback.pixels, staging_memory.mapped, size);
 
     vkDestroyBuffer(VKDEVICE, staging_buffer, NULL);
-    vkFreeMemory(VKDEVICE, staging_memory, NULL);
+    vulkan_internal_memory_free(&staging_memory);
 
     return readback;
 }
@@ -2529,8 +3975,16 @@ rhi_error_codes vulkan_frame_begin(gfx_context* ctx)
     } else {
         in_flight_sync = &ctx->frame_sync.inflight_syncobj[inflight_idx];
     }
+    uint64_t wait_start = timer_now_ns();
     vulkan_wait_on_previous_cmds(in_flight_sync, ctx->frame_sync.frame_syncpoint[inflight_idx]);
+    ctx->frame_waits.cpu_wait_ms = timer_elapsed_ms(wait_start);
+
+    s_VkCtx.frame_arena = &s_VkCtx.frame_arenas[inflight_idx];
+    linear_arena_reset(s_VkCtx.frame_arena);
+
+    wait_start = timer_now_ns();
     vulkan_acquire_image(ctx);
+    ctx->frame_waits.present_wait_ms = timer_elapsed_ms(wait_start);
 
     ctx->cmd_queue.cmds_count = 0;
 
@@ -2542,9 +3996,12 @@ rhi_error_codes vulkan_frame_begin(gfx_context* ctx)
 
 rhi_error_codes vulkan_frame_end(gfx_context* context)
 {
+    uint64_t present_start = timer_now_ns();
     vulkan_present(context);
+    context->frame_waits.present_wait_ms += timer_elapsed_ms(present_start);
 
-    context->inflight_frame_idx  = (context->inflight_frame_idx + 1) % MAX_FRAMES_INFLIGHT;
+    // a shallower queue waits on more recent frames, trading throughput for input latency
+    context->inflight_frame_idx  = (context->inflight_frame_idx + 1) % g_gfxConfig.frame_queue_depth;
     context->current_syncobj_idx = (context->current_syncobj_idx + 1) % (context->swapchain.image_count);
 
 #if ENABLE_SYNC_LOGGING
@@ -2591,6 +4048,12 @@ rhi_error_codes vulkan_acquire_image(gfx_context* ctx)
     * We must track which semaphore was used for which imageIndex.
     * Later submits and presents use this mapping for correct synchronization.
     */
+    // headless: offscreen backbuffers are rotated in lockstep with the sync index, frame_begin already waited on the timeline
+    if (g_gfxConfig.headless) {
+        ctx->swapchain.current_backbuffer_idx = ctx->current_syncobj_idx;
+        return Success;
+    }
+
     gfx_syncobj image_ready = ctx->present_sync.image_ready[ctx->current_syncobj_idx];
 #if ENABLE_SYNC_LOGGING
     LOG_SUCCESS("[ACQUIRE] current_syncobj_idx: %d", ctx->current_syncobj_idx);
@@ -2621,17 +4084,28 @@ rhi_error_codes vulkan_gfx_cmd_submit_queue(const gfx_cmd_queue* cmd_queue, gfx_
     if (g_gfxConfig.use_timeline_semaphores)
         submit_sync.signal_syncobjs_count++;
 
-    VkSemaphore* wait_semaphores   = malloc(submit_sync.wait_syncobjs_count * sizeof(VkSemaphore));
-    VkSemaphore* signal_semaphores = malloc(submit_sync.signal_syncobjs_count * sizeof(VkSemaphore));
+    uint32_t wait_syncobjs_count = submit_sync.wait_syncobjs_count;
+    if (submit_sync.cross_queue_wait_value)
+        submit_sync.wait_syncobjs_count++;
 
-    for (uint32_t i = 0; i < submit_sync.wait_syncobjs_count; ++i)
+    VkSemaphore*          wait_semaphores   = VK_FRAME_ALLOC(VkSemaphore, submit_sync.wait_syncobjs_count);
+    VkPipelineStageFlags* wait_stages       = VK_FRAME_ALLOC(VkPipelineStageFlags, submit_sync.wait_syncobjs_count);
+    VkSemaphore*          signal_semaphores = VK_FRAME_ALLOC(VkSemaphore, submit_sync.signal_syncobjs_count);
+
+    for (uint32_t i = 0; i < wait_syncobjs_count; ++i) {
         wait_semaphores[i] = *((VkSemaphore*) (submit_sync.wait_synobjs[i].backend));
+        wait_stages[i]     = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+
+    // async compute results are acquired by a barrier at the top of the frame, so nothing may start before it
+    if (submit_sync.cross_queue_wait_value) {
+        wait_semaphores[wait_syncobjs_count] = *((VkSemaphore*) (submit_sync.cross_queue_syncobj->backend));
+        wait_stages[wait_syncobjs_count]     = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
 
     for (uint32_t i = 0; i < signal_syncobjs_count; ++i)
         signal_semaphores[i] = *((VkSemaphore*) (submit_sync.signal_synobjs[i].backend));
 
-    VkPipelineStageFlags waitStages[1] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-
     VkTimelineSemaphoreSubmitInfo timelineInfo = {
         .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
         .pNext                     = NULL,
@@ -2657,14 +4131,18 @@ rhi_error_codes vulkan_gfx_cmd_submit_queue(const gfx_cmd_queue* cmd_queue, gfx_
         timelineInfo.waitSemaphoreValueCount   = submit_sync.wait_syncobjs_count;
         timelineInfo.signalSemaphoreValueCount = submit_sync.signal_syncobjs_count;
 
-        uint64_t* wait_values = malloc(sizeof(uint64_t) * submit_sync.wait_syncobjs_count);
+        uint64_t* wait_values = VK_FRAME_ALLOC(uint64_t, submit_sync.wait_syncobjs_count);
         memset(wait_values, 0, sizeof(uint64_t) * submit_sync.wait_syncobjs_count);
-        uint64_t* signal_values = malloc(sizeof(uint64_t) * submit_sync.signal_syncobjs_count);
+        uint64_t* signal_values = VK_FRAME_ALLOC(uint64_t, submit_sync.signal_syncobjs_count);
         memset(signal_values, 0, sizeof(uint64_t) * submit_sync.signal_syncobjs_count);
 
         signal_semaphores[submit_sync.signal_syncobjs_count - 1] = inflight;
         signal_values[submit_sync.signal_syncobjs_count - 1]     = signal_value;    // Signal the new value
 
+        // binary semaphores ignore their value, only the cross queue timeline needs one
+        if (submit_sync.cross_queue_wait_value)
+            wait_values[wait_syncobjs_count] = submit_sync.cross_queue_wait_value;
+
         timelineInfo.pWaitSemaphoreValues   = wait_values;
         timelineInfo.pSignalSemaphoreValues = signal_values;
     }
@@ -2676,20 +4154,12 @@ rhi_error_codes vulkan_gfx_cmd_submit_queue(const gfx_cmd_queue* cmd_queue, gfx_
         .pCommandBuffers      = (VkCommandBuffer*) cmd_queue->cmds,
         .waitSemaphoreCount   = submit_sync.wait_syncobjs_count,
         .pWaitSemaphores      = wait_semaphores,
-        .pWaitDstStageMask    = waitStages,
+        .pWaitDstStageMask    = wait_stages,
         .signalSemaphoreCount = submit_sync.signal_syncobjs_count,
         .pSignalSemaphores    = signal_semaphores,
     };
     VK_CHECK_RESULT(vkQueueSubmit(s_VkCtx.queues.gfx, 1, &submitInfo, signal_fence), "Failed to submit command buffers");
 
-    free(wait_semaphores);
-    free(signal_semaphores);
-
-    if (g_gfxConfig.use_timeline_semaphores) {
-        free((void*) timelineInfo.pWaitSemaphoreValues);
-        free((void*) timelineInfo.pSignalSemaphoreValues);
-    }
-
     return Success;
 }
 
@@ -2707,13 +4177,23 @@ rhi_error_codes vulkan_gfx_cmd_submit_for_rendering(gfx_context* ctx)
         in_flight_sync = &ctx->frame_sync.inflight_syncobj[inflight_idx];
     }
 
-    submit_sync.wait_syncobjs_count   = 1;
-    submit_sync.wait_synobjs          = &(ctx->present_sync.image_ready[curr_syncobj_idx]);
-    submit_sync.signal_syncobjs_count = 1;
-    submit_sync.signal_synobjs        = &(ctx->present_sync.rendering_done[curr_syncobj_idx]);
-    submit_sync.inflight_syncobj      = in_flight_sync;
-    submit_sync.inflight_syncpoint    = &ctx->frame_sync.frame_syncpoint[inflight_idx];
-    submit_sync.global_syncpoint      = &ctx->frame_sync.global_syncpoint;
+    // headless has nothing to acquire or present, the timeline signal is the only sync
+    if (!g_gfxConfig.headless) {
+        submit_sync.wait_syncobjs_count   = 1;
+        submit_sync.wait_synobjs          = &(ctx->present_sync.image_ready[curr_syncobj_idx]);
+        submit_sync.signal_syncobjs_count = 1;
+        submit_sync.signal_synobjs        = &(ctx->present_sync.rendering_done[curr_syncobj_idx]);
+    }
+    submit_sync.inflight_syncobj   = in_flight_sync;
+    submit_sync.inflight_syncpoint = &ctx->frame_sync.frame_syncpoint[inflight_idx];
+    submit_sync.global_syncpoint   = &ctx->frame_sync.global_syncpoint;
+
+    // consumes this frame's async compute work, if any was submitted
+    if (ctx->async_compute.gfx_wait_syncpoint) {
+        submit_sync.cross_queue_syncobj       = &ctx->async_compute.timeline_syncobj;
+        submit_sync.cross_queue_wait_value    = ctx->async_compute.gfx_wait_syncpoint;
+        ctx->async_compute.gfx_wait_syncpoint = 0;
+    }
 
 #if ENABLE_SYNC_LOGGING
     LOG_SUCCESS("[PRE-SUBMIT] curr_syncobj_idx: %d | inflight_idx: %d | global_syncpoint: %llu", curr_syncobj_idx, inflight_idx, ctx->frame_sync.global_syncpoint);
@@ -2721,8 +4201,47 @@ rhi_error_codes vulkan_gfx_cmd_submit_for_rendering(gfx_context* ctx)
     return vulkan_gfx_cmd_submit_queue(&ctx->cmd_queue, submit_sync);
 }
 
+rhi_error_codes vulkan_submit_async_compute(gfx_context* ctx, const gfx_cmd_buf* cmd_buf)
+{
+    if (!ctx->async_compute.is_supported)
+        return FailedUnknown;
+
+    VkSemaphore timeline     = *((VkSemaphore*) (ctx->async_compute.timeline_syncobj.backend));
+    uint64_t    signal_value = ++ctx->async_compute.global_syncpoint;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext                     = NULL,
+        .waitSemaphoreValueCount   = 0,
+        .pWaitSemaphoreValues      = NULL,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues    = &signal_value,
+    };
+
+    // No wait: frame_begin already waited on the gfx work that last read this frame's resources,
+    // so compute for frame N+1 is free to overlap frame N's gfx and present work
+    VkSubmitInfo submitInfo = {
+        .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext                = &timelineInfo,
+        .commandBufferCount   = 1,
+        .pCommandBuffers      = (VkCommandBuffer*) cmd_buf->backend,
+        .waitSemaphoreCount   = 0,
+        .pWaitSemaphores      = NULL,
+        .pWaitDstStageMask    = NULL,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores    = &timeline,
+    };
+    VK_CHECK_RESULT(vkQueueSubmit(s_VkCtx.queues.async_compute, 1, &submitInfo, VK_NULL_HANDLE), "Failed to submit async compute command buffer");
+
+    ctx->async_compute.gfx_wait_syncpoint = signal_value;
+    return Success;
+}
+
 rhi_error_codes vulkan_present(const gfx_context* ctx)
 {
+    if (g_gfxConfig.headless)
+        return Success;
+
     gfx_syncobj rendering_done = ctx->present_sync.rendering_done[ctx->current_syncobj_idx];
 
     VkPresentInfoKHR presentInfo = {
@@ -2777,6 +4296,43 @@ rhi_error_codes vulkan_begin_gfx_cmd_recording(const gfx_cmd_pool* allocator, co
     return Success;
 }
 
+rhi_error_codes vulkan_begin_secondary_gfx_cmd_recording(const gfx_cmd_pool* allocator, const gfx_cmd_buf* cmd_buf)
+{
+    UNUSED(allocator);
+
+    // Compute only and recorded outside of render passes, so there is nothing to inherit
+    VkCommandBufferInheritanceInfo inheritance = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = NULL};
+
+    VkCommandBufferBeginInfo begin = {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext            = NULL,
+        .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = &inheritance};
+
+    VK_CHECK_RESULT(vkBeginCommandBuffer(*(VkCommandBuffer*) cmd_buf->backend, &begin), "[Vulkan] Failed to start recoding secondary command buffer");
+    return Success;
+}
+
+rhi_error_codes vulkan_execute_secondary_gfx_cmds(const gfx_cmd_buf* cmd_buf, const gfx_cmd_buf* secondaries, uint32_t count)
+{
+    if (count == 0)
+        return Success;
+
+    if (count > MAX_RECORD_THREADS) {
+        LOG_ERROR("[Vulkan] %u secondary command buffers exceed MAX_RECORD_THREADS", count);
+        return FailedUnknown;
+    }
+
+    VkCommandBuffer vk_secondaries[MAX_RECORD_THREADS] = {0};
+    for (uint32_t i = 0; i < count; i++)
+        vk_secondaries[i] = *(VkCommandBuffer*) secondaries[i].backend;
+
+    vkCmdExecuteCommands(*(VkCommandBuffer*) cmd_buf->backend, count, vk_secondaries);
+    return Success;
+}
+
 rhi_error_codes vulkan_end_gfx_cmd_recording(const gfx_cmd_buf* cmd_buf)
 {
     VK_CHECK_RESULT(vkEndCommandBuffer(*(VkCommandBuffer*) cmd_buf->backend), "[Vulkan] Failed to end recoding command buffer");
@@ -2916,7 +4472,8 @@ rhi_error_codes vulkan_device_bind_push_constant(const gfx_cmd_buf* cmd_buf, gfx
 {
     VkCommandBuffer         commandBuffer     = *(VkCommandBuffer*) cmd_buf->backend;
     root_signature_backend* rootS_sig_backend = root_sig->backend;
-    vkCmdPushConstants(commandBuffer, rootS_sig_backend->pipeline_layout, vulkan_util_shader_stage_bits(push_constant.range.stage), push_constant.range.offset, push_constant.range.size, push_constant.data);
+    VkShaderStageFlags      stages            = rootS_sig_backend->push_constant_stages ? rootS_sig_backend->push_constant_stages : (VkShaderStageFlags) vulkan_util_shader_stage_bits(push_constant.range.stage);
+    vkCmdPushConstants(commandBuffer, rootS_sig_backend->pipeline_layout, stages, push_constant.range.offset, push_constant.range.size, push_constant.data);
     return Success;
 }
 
@@ -2942,6 +4499,76 @@ rhi_error_codes vulkan_transition_image_layout(const gfx_cmd_buf* cmd_buffer, co
     return Success;
 }
 
+static uint32_t vulkan_internal_queue_family_idx(gfx_queue_type queue)
+{
+    return queue == GFX_QUEUE_TYPE_ASYNC_COMPUTE ? s_VkCtx.queue_idxs.async_compute : s_VkCtx.queue_idxs.gfx;
+}
+
+// Shader stages the queue can execute, a compute-only queue rejects barriers naming graphics stages
+static VkPipelineStageFlags vulkan_internal_queue_shader_stages(gfx_queue_type queue)
+{
+    if (queue == GFX_QUEUE_TYPE_ASYNC_COMPUTE && s_VkCtx.queue_idxs.async_compute != s_VkCtx.queue_idxs.gfx)
+        return VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    return VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+}
+
+static VkAccessFlags vulkan_internal_layout_shader_access(gfx_image_layout layout, bool is_src)
+{
+    switch (layout) {
+        case GFX_IMAGE_LAYOUT_GENERAL:
+            return is_src ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        case GFX_IMAGE_LAYOUT_SHADER_READ_ONLY:
+            return is_src ? 0 : VK_ACCESS_SHADER_READ_BIT;    // prior reads only need an execution dependency
+        default:
+            return 0;
+    }
+}
+
+rhi_error_codes vulkan_insert_queue_image_barrier(const gfx_cmd_buf* cmd_buffer, const gfx_resource* image, gfx_image_layout old_layout, gfx_image_layout new_layout, gfx_queue_type src_queue, gfx_queue_type dst_queue, bool acquire)
+{
+    uint32_t src_family = vulkan_internal_queue_family_idx(src_queue);
+    uint32_t dst_family = vulkan_internal_queue_family_idx(dst_queue);
+    bool     transfer   = src_family != dst_family;
+
+    // same family: the release half already did the layout change
+    if (!transfer && acquire)
+        return Success;
+
+    VkImageMemoryBarrier barrier = {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .oldLayout           = vulkan_util_translate_image_layout(old_layout),
+        .newLayout           = vulkan_util_translate_image_layout(new_layout),
+        .srcQueueFamilyIndex = transfer ? src_family : VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = transfer ? dst_family : VK_QUEUE_FAMILY_IGNORED,
+        .image               = ((texture_backend*) image->texture->backend)->image,
+        .subresourceRange    = {
+               .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+               .baseMipLevel   = 0,
+               .levelCount     = VK_REMAINING_MIP_LEVELS,
+               .baseArrayLayer = 0,
+               .layerCount     = VK_REMAINING_ARRAY_LAYERS,
+        },
+        .srcAccessMask = vulkan_internal_layout_shader_access(old_layout, true),
+        .dstAccessMask = vulkan_internal_layout_shader_access(new_layout, false),
+    };
+
+    VkPipelineStageFlags src_stage = old_layout == GFX_IMAGE_LAYOUT_UNDEFINED ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : vulkan_internal_queue_shader_stages(src_queue);
+    VkPipelineStageFlags dst_stage = vulkan_internal_queue_shader_stages(dst_queue);
+
+    // Release: only the src queue's writes are made available, the acquire makes them visible on the dst queue
+    // Acquire: the semaphore wait between the two submits already covers the execution dependency
+    if (transfer && !acquire) {
+        barrier.dstAccessMask = 0;
+        dst_stage             = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    } else if (transfer) {
+        barrier.srcAccessMask = 0;
+        src_stage             = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+
+    vkCmdPipelineBarrier(*(VkCommandBuffer*) cmd_buffer->backend, src_stage, dst_stage, 0, 0, NULL, 0, NULL, 1, &barrier);
+    return Success;
+}
+
 rhi_error_codes vulkan_transition_swapchain_layout(const gfx_cmd_buf* cmd_buffer, const gfx_swapchain* sc, gfx_image_layout old_layout, gfx_image_layout new_layout)
 {
     VkCommandBuffer    vkCmdBuffer = *(VkCommandBuffer*) cmd_buffer->backend;
@@ -2969,3 +4596,286 @@ rhi_error_codes vulkan_clear_image(const gfx_cmd_buf* cmd_buffer, const gfx_reso
 
     return Success;
 }
+
+rhi_error_codes vulkan_insert_shader_write_barrier(const gfx_cmd_buf* cmd_buffer)
+{
+    VkCommandBuffer vkCmdBuffer = *(VkCommandBuffer*) cmd_buffer->backend;
+
+    VkMemoryBarrier barrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+
+    vkCmdPipelineBarrier(vkCmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, NULL, 0, NULL);
+
+    return Success;
+}
+
+rhi_error_codes vulkan_insert_host_read_barrier(const gfx_cmd_buf* cmd_buffer, const gfx_resource* buffer)
+{
+    VkCommandBuffer vkCmdBuffer = *(VkCommandBuffer*) cmd_buffer->backend;
+    buffer_backend* backend     = buffer->ubo->backend;
+
+    VkBufferMemoryBarrier barrier = {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = backend->buffer,
+        .offset              = 0,
+        .size                = VK_WHOLE_SIZE,
+    };
+
+    vkCmdPipelineBarrier(vkCmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &barrier, 0, NULL);
+
+    return Success;
+}
+
+//--------------------------------------------------------
+// Streaming readback
+//--------------------------------------------------------
+
+gfx_readback_ring vulkan_device_create_readback_ring(uint32_t width, uint32_t height)
+{
+    gfx_readback_ring ring = {0};
+    uuid_generate(&ring.uuid);
+    ring.width     = width;
+    ring.height    = height;
+    ring.slot_size = width * height * 4;
+
+    readback_ring_backend* backend = malloc(sizeof(readback_ring_backend));
+    memset(backend, 0, sizeof(readback_ring_backend));
+    ring.backend = backend;
+
+    // slot offsets double as invalidate ranges, so they have to sit on atom boundaries
+    VkDeviceSize atom    = s_VkCtx.props.limits.nonCoherentAtomSize > 16 ? s_VkCtx.props.limits.nonCoherentAtomSize : 16;
+    backend->slot_stride = (ring.slot_size + atom - 1) / atom * atom;
+
+    backend->buffer = vulkan_internal_create_buffer_backend((uint32_t) (backend->slot_stride * MAX_FRAMES_INFLIGHT), VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    VkMemoryRequirements mem_requirements;
+    vkGetBufferMemoryRequirements(VKDEVICE, backend->buffer, &mem_requirements);
+
+    // cached memory makes the CPU side memcpy fast, any host visible type does if the device has none
+    VK_CHECK_RESULT(vulkan_internal_memory_alloc(&mem_requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT, VULKAN_MEMORY_POOL_BUFFER, VK_NULL_HANDLE, &backend->allocation), "[Vulkan] cannot allocate readback ring memory");
+    vkBindBufferMemory(VKDEVICE, backend->buffer, backend->allocation.memory, backend->allocation.offset);
+    backend->mapped   = backend->allocation.mapped;
+    backend->coherent = (s_VkCtx.mem_props.memoryTypes[backend->allocation.memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    VK_TAG_OBJECT("READBACK_RING", VK_OBJECT_TYPE_BUFFER, backend->buffer);
+
+    return ring;
+}
+
+void vulkan_device_destroy_readback_ring(gfx_readback_ring* ring)
+{
+    uuid_destroy(&ring->uuid);
+
+    readback_ring_backend* backend = ring->backend;
+    if (!backend)
+        return;
+
+    vkDestroyBuffer(VKDEVICE, backend->buffer, NULL);
+    vulkan_internal_memory_free(&backend->allocation);
+
+    free(backend);
+    ring->backend = NULL;
+}
+
+rhi_error_codes vulkan_record_swapchain_readback(const gfx_cmd_buf* cmd_buffer, const gfx_readback_ring* ring, const gfx_swapchain* swapchain, uint32_t frame_idx)
+{
+    readback_ring_backend* backend = ring->backend;
+    if (swapchain->width * swapchain->height * 4 > ring->slot_size)
+        return FailedMemoryAlloc;
+
+    VkCommandBuffer vkCmdBuffer   = *(VkCommandBuffer*) cmd_buffer->backend;
+    VkImage         swap_vk_image = ((swapchain_backend*) (swapchain->backend))->backbuffers[swapchain->current_backbuffer_idx];
+
+    vulkan_internal_insert_image_memory_barrier(vkCmdBuffer, swap_vk_image, vulkan_util_present_layout(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    {
+        VkBufferImageCopy region = {
+            .bufferOffset                    = backend->slot_stride * frame_idx,
+            .bufferRowLength                 = 0,
+            .bufferImageHeight               = 0,
+            .imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .imageSubresource.mipLevel       = 0,
+            .imageSubresource.baseArrayLayer = 0,
+            .imageSubresource.layerCount     = 1,
+            .imageOffset                     = {0, 0, 0},
+            .imageExtent                     = {swapchain->width, swapchain->height, 1},
+        };
+
+        vkCmdCopyImageToBuffer(vkCmdBuffer, swap_vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, backend->buffer, 1, &region);
+    }
+    vulkan_internal_insert_image_memory_barrier(vkCmdBuffer, swap_vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vulkan_util_present_layout());
+
+    VkBufferMemoryBarrier barrier = {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = backend->buffer,
+        .offset              = backend->slot_stride * frame_idx,
+        .size                = backend->slot_stride,
+    };
+    vkCmdPipelineBarrier(vkCmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &barrier, 0, NULL);
+
+    backend->slot_written[frame_idx] = true;
+    backend->slot_width[frame_idx]   = swapchain->width;
+    backend->slot_height[frame_idx]  = swapchain->height;
+
+    return Success;
+}
+
+rhi_error_codes vulkan_resolve_readback(const gfx_readback_ring* ring, uint32_t frame_idx, gfx_texture_readback* out_readback)
+{
+    readback_ring_backend* backend = ring->backend;
+    if (!backend || !backend->slot_written[frame_idx])
+        return FailedQueryNotReady;
+
+    // each recorded slot is handed out once
+    backend->slot_written[frame_idx] = false;
+
+    if (!backend->coherent) {
+        VkMappedMemoryRange range = {
+            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+            .memory = backend->allocation.memory,
+            .offset = backend->allocation.offset + backend->slot_stride * frame_idx,
+            .size   = backend->slot_stride};
+        vkInvalidateMappedMemoryRanges(VKDEVICE, 1, &range);
+    }
+
+    out_readback->width          = backend->slot_width[frame_idx];
+    out_readback->height         = backend->slot_height[frame_idx];
+    out_readback->bits_per_pixel = 32;
+    out_readback->pixels         = (char*) (backend->mapped + backend->slot_stride * frame_idx);
+
+    return Success;
+}
+
+//--------------------------------------------------------
+// Profiling
+//--------------------------------------------------------
+
+gfx_query_pool vulkan_device_create_timestamp_query_pool(uint32_t max_zones)
+{
+    gfx_query_pool query_pool = {0};
+
+    if (s_VkCtx.timestamp_valid_bits == 0) {
+        LOG_WARN("[Vulkan] gfx queue does not support timestamp queries, GPU zones are disabled");
+        return query_pool;
+    }
+
+    if (max_zones > MAX_GPU_TIMESTAMP_ZONES) {
+        LOG_WARN("[Vulkan] timestamp zones clamped to %d", MAX_GPU_TIMESTAMP_ZONES);
+        max_zones = MAX_GPU_TIMESTAMP_ZONES;
+    }
+
+    uuid_generate(&query_pool.uuid);
+    query_pool.max_zones = max_zones;
+
+    query_pool_backend* backend = malloc(sizeof(query_pool_backend));
+    memset(backend, 0, sizeof(query_pool_backend));
+    query_pool.backend = backend;
+
+    VkQueryPoolCreateInfo pool_ci = {
+        .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = max_zones * 2 * MAX_FRAMES_INFLIGHT};
+
+    VK_CHECK_RESULT(vkCreateQueryPool(VKDEVICE, &pool_ci, NULL, &backend->pool), "[Vulkan] Cannot create timestamp query pool");
+    VK_TAG_OBJECT("GPU_TIMESTAMP_QUERY_POOL", VK_OBJECT_TYPE_QUERY_POOL, backend->pool);
+
+    return query_pool;
+}
+
+void vulkan_device_destroy_timestamp_query_pool(gfx_query_pool* query_pool)
+{
+    if (query_pool->backend)
+        vkDestroyQueryPool(VKDEVICE, ((query_pool_backend*) (query_pool->backend))->pool, NULL);
+    BACKEND_SAFE_FREE(query_pool);
+}
+
+// Each in-flight frame owns [frame_idx * max_zones * 2, (frame_idx + 1) * max_zones * 2), begin/end pairs per zone
+static uint32_t vulkan_internal_timestamp_query_idx(const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx)
+{
+    return (frame_idx * query_pool->max_zones + zone_idx) * 2;
+}
+
+rhi_error_codes vulkan_reset_timestamp_queries(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx)
+{
+    query_pool_backend* backend = query_pool->backend;
+    if (!backend)
+        return FailedUnknown;
+
+    vkCmdResetQueryPool(*(VkCommandBuffer*) cmd_buf->backend, backend->pool, vulkan_internal_timestamp_query_idx(query_pool, frame_idx, 0), query_pool->max_zones * 2);
+    backend->zones_written[frame_idx] = 0;
+
+    return Success;
+}
+
+rhi_error_codes vulkan_begin_gpu_zone(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx)
+{
+    query_pool_backend* backend = query_pool->backend;
+    if (!backend || zone_idx >= query_pool->max_zones)
+        return FailedUnknown;
+
+    vkCmdWriteTimestamp(*(VkCommandBuffer*) cmd_buf->backend, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, backend->pool, vulkan_internal_timestamp_query_idx(query_pool, frame_idx, zone_idx));
+
+    return Success;
+}
+
+rhi_error_codes vulkan_end_gpu_zone(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx)
+{
+    query_pool_backend* backend = query_pool->backend;
+    if (!backend || zone_idx >= query_pool->max_zones)
+        return FailedUnknown;
+
+    vkCmdWriteTimestamp(*(VkCommandBuffer*) cmd_buf->backend, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, backend->pool, vulkan_internal_timestamp_query_idx(query_pool, frame_idx, zone_idx) + 1);
+    backend->zones_written[frame_idx] |= 1u << zone_idx;
+
+    return Success;
+}
+
+rhi_error_codes vulkan_resolve_timestamp_queries(const gfx_query_pool* query_pool, uint32_t frame_idx, double* out_zone_ms, uint32_t zone_count)
+{
+    query_pool_backend* backend = query_pool->backend;
+    if (!backend)
+        return FailedUnknown;
+
+    if (zone_count > query_pool->max_zones)
+        zone_count = query_pool->max_zones;
+
+    // nothing recorded yet in this slot (first frames or after a reset without zones)
+    if (!backend->zones_written[frame_idx])
+        return FailedQueryNotReady;
+
+    const uint64_t valid_mask = s_VkCtx.timestamp_valid_bits >= 64 ? UINT64_MAX : ((1ull << s_VkCtx.timestamp_valid_bits) - 1);
+    const double   ns_to_ms   = (double) s_VkCtx.props.limits.timestampPeriod / 1e6;
+
+    rhi_error_codes result = Success;
+    for (uint32_t i = 0; i < zone_count; i++) {
+        out_zone_ms[i] = 0.0;
+
+        // Zone not recorded this frame, also guards against reading queries that were never reset
+        if (!(backend->zones_written[frame_idx] & (1u << i)))
+            continue;
+
+        // [begin, begin_available, end, end_available], no WAIT_BIT so this never stalls
+        uint64_t data[4] = {0};
+        VkResult res     = vkGetQueryPoolResults(VKDEVICE, backend->pool, vulkan_internal_timestamp_query_idx(query_pool, frame_idx, i), 2, sizeof(data), data, sizeof(uint64_t) * 2, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        if (res == VK_NOT_READY || !data[1] || !data[3]) {
+            result = FailedQueryNotReady;
+            continue;
+        }
+
+        uint64_t begin = data[0] & valid_mask;
+        uint64_t end   = data[2] & valid_mask;
+        out_zone_ms[i] = (double) ((end - begin) & valid_mask) * ns_to_ms;
+    }
+
+    return result;
+}
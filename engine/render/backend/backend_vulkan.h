@@ -54,6 +54,7 @@ gfx_descriptor_heap vulkan_device_create_descriptor_heap(gfx_heap_type heap_type
 void                vulkan_device_destroy_descriptor_heap(gfx_descriptor_heap* heap);
 
 gfx_descriptor_table vulkan_device_build_descriptor_table(const gfx_root_signature*, gfx_descriptor_heap* heap, gfx_descriptor_table_entry* entries, uint32_t num_entries);
+void                 vulkan_device_destroy_descriptor_table(gfx_descriptor_table* table);
 
 gfx_resource vulkan_device_create_texture_resource(gfx_texture_create_info desc);
 void         vulkan_device_destroy_texture_resource(gfx_resource* resource);
@@ -65,6 +66,11 @@ gfx_resource vulkan_device_create_uniform_buffer_resource(uint32_t size);
 void         vulkan_device_destroy_uniform_buffer_resource(gfx_resource* resource);
 void         vulkan_device_update_uniform_buffer(gfx_resource* resource, uint32_t size, uint32_t offset, void* data);
 
+gfx_resource vulkan_device_create_storage_buffer_resource(uint32_t size);
+void         vulkan_device_destroy_storage_buffer_resource(gfx_resource* resource);
+void         vulkan_device_update_storage_buffer(gfx_resource* resource, uint32_t size, uint32_t offset, const void* data);
+void         vulkan_device_read_storage_buffer(const gfx_resource* resource, uint32_t size, uint32_t offset, void* out_data);
+
 gfx_resource_view vulkan_device_create_texture_resource_view(const gfx_resource_view_create_info desc);
 void              vulkan_device_destroy_texture_resource_view(gfx_resource_view* view);
 
@@ -74,6 +80,11 @@ void              vulkan_backend_destroy_sampler_resource_view(gfx_resource_view
 gfx_resource_view vulkan_device_create_uniform_buffer_resource_view(gfx_resource* resource, uint32_t size, uint32_t offset);
 void              vulkan_device_destroy_uniform_buffer_resource_view(gfx_resource_view* view);
 
+gfx_resource_view vulkan_device_create_storage_buffer_resource_view(gfx_resource* resource, uint32_t size, uint32_t offset);
+void              vulkan_device_destroy_storage_buffer_resource_view(gfx_resource_view* view);
+
+gfx_resource_view vulkan_device_create_swapchain_storage_view(const gfx_swapchain* swapchain, uint32_t backbuffer_idx);
+
 gfx_cmd_buf vulkan_device_create_single_time_command_buffer(void);
 void        vulkan_device_destroy_single_time_command_buffer(gfx_cmd_buf* cmd_buf);
 
@@ -118,5 +129,41 @@ rhi_error_codes vulkan_transition_image_layout(const gfx_cmd_buf* cmd_buffer, co
 rhi_error_codes vulkan_transition_swapchain_layout(const gfx_cmd_buf* cmd_buffer, const gfx_swapchain* swapchain, gfx_image_layout old_layout, gfx_image_layout new_layout);
 
 rhi_error_codes vulkan_clear_image(const gfx_cmd_buf* cmd_buffer, const gfx_resource* image);
+rhi_error_codes vulkan_insert_shader_write_barrier(const gfx_cmd_buf* cmd_buffer);
+
+rhi_error_codes vulkan_insert_host_read_barrier(const gfx_cmd_buf* cmd_buffer, const gfx_resource* buffer);
+
+gfx_readback_ring vulkan_device_create_readback_ring(uint32_t width, uint32_t height);
+void              vulkan_device_destroy_readback_ring(gfx_readback_ring* ring);
+rhi_error_codes   vulkan_record_swapchain_readback(const gfx_cmd_buf* cmd_buffer, const gfx_readback_ring* ring, const gfx_swapchain* swapchain, uint32_t frame_idx);
+rhi_error_codes   vulkan_resolve_readback(const gfx_readback_ring* ring, uint32_t frame_idx, gfx_texture_readback* out_readback);
+
+gfx_cmd_buf     vulkan_device_create_secondary_gfx_cmd_buf(gfx_cmd_pool* pool);
+rhi_error_codes vulkan_reset_gfx_cmd_pool(const gfx_cmd_pool* pool);
+rhi_error_codes vulkan_begin_secondary_gfx_cmd_recording(const gfx_cmd_pool* allocator, const gfx_cmd_buf* cmd_buf);
+rhi_error_codes vulkan_execute_secondary_gfx_cmds(const gfx_cmd_buf* cmd_buf, const gfx_cmd_buf* secondaries, uint32_t count);
+
+gfx_cmd_pool    vulkan_device_create_async_compute_cmd_pool(void);
+rhi_error_codes vulkan_submit_async_compute(gfx_context* ctx, const gfx_cmd_buf* cmd_buf);
+rhi_error_codes vulkan_insert_queue_image_barrier(const gfx_cmd_buf* cmd_buffer, const gfx_resource* image, gfx_image_layout old_layout, gfx_image_layout new_layout, gfx_queue_type src_queue, gfx_queue_type dst_queue, bool acquire);
+
+gfx_memory_stats vulkan_device_get_memory_stats(void);
+
+gfx_bindless_heap vulkan_device_create_bindless_heap(uint32_t resource_capacity, uint32_t sampler_capacity, uint32_t push_constant_size);
+void              vulkan_device_destroy_bindless_heap(gfx_bindless_heap* heap);
+gfx_bindless_slot vulkan_device_bindless_register(gfx_bindless_heap* heap, const gfx_resource* resource, const gfx_resource_view* view);
+void              vulkan_device_bindless_release(gfx_bindless_heap* heap, gfx_bindless_slot slot);
+rhi_error_codes   vulkan_device_bind_bindless_heap(const gfx_cmd_buf* cmd_buf, const gfx_bindless_heap* heap, gfx_pipeline_type pipeline_type);
+
+//------------------------------------------
+// Profiling
+//------------------------------------------
+
+gfx_query_pool  vulkan_device_create_timestamp_query_pool(uint32_t max_zones);
+void            vulkan_device_destroy_timestamp_query_pool(gfx_query_pool* query_pool);
+rhi_error_codes vulkan_reset_timestamp_queries(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx);
+rhi_error_codes vulkan_begin_gpu_zone(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx);
+rhi_error_codes vulkan_end_gpu_zone(const gfx_cmd_buf* cmd_buf, const gfx_query_pool* query_pool, uint32_t frame_idx, uint32_t zone_idx);
+rhi_error_codes vulkan_resolve_timestamp_queries(const gfx_query_pool* query_pool, uint32_t frame_idx, double* out_zone_ms, uint32_t zone_count);
 
 #endif    // BACKEND_VULKAN_N
@@ -12,6 +12,11 @@ rhi_jumptable g_rhi;
 //---------------------------
 gfx_config g_gfxConfig = {
     .use_timeline_semaphores = false,
+    .headless                = false,
+    .use_bindless            = false,
+    .present_mode            = GFX_PRESENT_MODE_MAILBOX,
+    .frame_queue_depth       = MAX_FRAMES_INFLIGHT,
+    .pipeline_cache_path     = "./game/shaders_built/vk_pipeline_cache.bin",
 };
 //---------------------------
 
@@ -19,6 +24,11 @@ int gfx_init(rhi_api api)
 {
     g_current_api = api;
 
+    if (g_gfxConfig.frame_queue_depth == 0 || g_gfxConfig.frame_queue_depth > MAX_FRAMES_INFLIGHT) {
+        LOG_WARN("frame_queue_depth %u is out of range, clamping to [1, %d]", g_gfxConfig.frame_queue_depth, MAX_FRAMES_INFLIGHT);
+        g_gfxConfig.frame_queue_depth = g_gfxConfig.frame_queue_depth == 0 ? 1 : MAX_FRAMES_INFLIGHT;
+    }
+
     if (g_current_api == Vulkan) {
         g_rhi = vulkan_jumptable;
     }
@@ -36,6 +36,7 @@ typedef enum rhi_error_codes
     FailedCommandAllocatorReset,
     FailedCommandBegin,
     FailedCommandEnd,
+    FailedQueryNotReady,
 } rhi_error_codes;
 
 //------------------------------------------
@@ -47,6 +48,7 @@ void gfx_destroy(void);
 
 typedef struct rhi_jumptablefrontend
 {
+    // Fills gfx_context.supports, the window is NULL when g_gfxConfig.headless which only the Vulkan backend supports
     gfx_context (*ctx_init)(GLFWwindow*);
     void (*ctx_destroy)(gfx_context*);
     void (*flush_gpu_work)(gfx_context*);
@@ -79,6 +81,7 @@ typedef struct rhi_jumptablefrontend
     void (*destroy_descriptor_heap)(gfx_descriptor_heap*);
 
     gfx_descriptor_table (*build_descriptor_table)(const gfx_root_signature*, gfx_descriptor_heap*, gfx_descriptor_table_entry*, uint32_t);
+    void (*destroy_descriptor_table)(gfx_descriptor_table*);
 
     gfx_resource (*create_texture_resource)(gfx_texture_create_info);
     void (*destroy_texture_resource)(gfx_resource*);
@@ -99,9 +102,13 @@ typedef struct rhi_jumptablefrontend
     gfx_resource_view (*create_uniform_buffer_resource_view)(gfx_resource*, uint32_t, uint32_t);
     void (*destroy_uniform_buffer_resource_view)(gfx_resource_view*);
 
+    // destroyed using destroy_texture_resource_view, only valid if gfx_swapchain::supports_storage
+    gfx_resource_view (*create_swapchain_storage_view)(const gfx_swapchain*, uint32_t);
+
     gfx_cmd_buf (*create_single_time_cmd_buffer)(void);
     void (*destroy_single_time_cmd_buffer)(gfx_cmd_buf*);
 
+    // Blocking one-off capture (idles the device), use the readback ring for continuous capture
     gfx_texture_readback (*readback_swapchain)(const gfx_swapchain*);
 
     rhi_error_codes (*frame_begin)(gfx_context*);
@@ -139,6 +146,69 @@ typedef struct rhi_jumptablefrontend
     rhi_error_codes (*insert_swapchain_layout_barrier)(const gfx_cmd_buf*, const gfx_swapchain*, gfx_image_layout, gfx_image_layout);
 
     rhi_error_codes (*clear_image)(const gfx_cmd_buf*, const gfx_resource*);
+    // Storage image/buffer writes of the dispatches recorded so far are visible to the following ones
+    rhi_error_codes (*insert_shader_write_barrier)(const gfx_cmd_buf*);
+
+    // GPU timestamp zones, queries are split into per in-flight frame ranges
+    // Only valid when gfx_context.supports.timestamps, not implemented on D3D12
+    gfx_query_pool (*create_timestamp_query_pool)(uint32_t);
+    void (*destroy_timestamp_query_pool)(gfx_query_pool*);
+    rhi_error_codes (*reset_timestamp_queries)(const gfx_cmd_buf*, const gfx_query_pool*, uint32_t);
+    rhi_error_codes (*begin_gpu_zone)(const gfx_cmd_buf*, const gfx_query_pool*, uint32_t, uint32_t);
+    rhi_error_codes (*end_gpu_zone)(const gfx_cmd_buf*, const gfx_query_pool*, uint32_t, uint32_t);
+    // Non-blocking, call only after the in-flight frame has been waited on
+    rhi_error_codes (*resolve_timestamp_queries)(const gfx_query_pool*, uint32_t, double*, uint32_t);
+
+    // CPU visible storage buffers, used for small GPU -> CPU counters
+    gfx_resource (*create_storage_buffer_resource)(uint32_t);
+    void (*destroy_storage_buffer_resource)(gfx_resource*);
+    void (*update_storage_buffer)(gfx_resource*, uint32_t, uint32_t, const void*);
+    void (*read_storage_buffer)(const gfx_resource*, uint32_t, uint32_t, void*);
+    gfx_resource_view (*create_storage_buffer_resource_view)(gfx_resource*, uint32_t, uint32_t);
+    void (*destroy_storage_buffer_resource_view)(gfx_resource_view*);
+    // Makes shader writes to the buffer visible to read_storage_buffer once the frame has been waited on
+    rhi_error_codes (*insert_host_read_barrier)(const gfx_cmd_buf*, const gfx_resource*);
+
+    // Streaming swapchain readback, the copy is recorded into the frame and resolved once that in-flight frame has been waited on
+    gfx_readback_ring (*create_readback_ring)(uint32_t, uint32_t);
+    void (*destroy_readback_ring)(gfx_readback_ring*);
+    // Expects the current backbuffer in GFX_IMAGE_LAYOUT_PRESENTATION and leaves it there
+    rhi_error_codes (*record_swapchain_readback)(const gfx_cmd_buf*, const gfx_readback_ring*, const gfx_swapchain*, uint32_t);
+    // Non-blocking, pixels point into the mapped slot and stay valid until the slot is recorded again
+    rhi_error_codes (*resolve_readback)(const gfx_readback_ring*, uint32_t, gfx_texture_readback*);
+
+    // Multi-threaded recording, each thread owns its pool and records compute work outside render passes
+    // Only valid when gfx_context.supports.secondary_cmds, D3D12 has no bundle path and records single threaded
+    gfx_cmd_buf (*create_secondary_gfx_cmd_buf)(gfx_cmd_pool*);
+    // Only once the frame that used the pool's command buffers has been waited on
+    rhi_error_codes (*reset_gfx_cmd_pool)(const gfx_cmd_pool*);
+    rhi_error_codes (*begin_secondary_gfx_cmd_recording)(const gfx_cmd_pool*, const gfx_cmd_buf*);
+    // Secondaries run in array order, no state is inherited from or leaked back into the primary
+    rhi_error_codes (*execute_secondary_gfx_cmds)(const gfx_cmd_buf*, const gfx_cmd_buf*, uint32_t);
+
+    // Async compute, only valid when gfx_context.async_compute.is_supported, never on D3D12 (no compute queue yet)
+    gfx_cmd_pool (*create_async_compute_cmd_pool)(void);
+    // Signals the compute timeline, the next gfx_cmd_submit_for_rendering waits on it
+    rhi_error_codes (*submit_async_compute)(gfx_context*, const gfx_cmd_buf*);
+    // Layout change plus queue family ownership transfer, recorded twice with identical arguments:
+    // the release half (acquire = false) on the src queue and the acquire half on the dst queue
+    // Same queue, or queues sharing a family, only need the release half which is then a plain barrier
+    rhi_error_codes (*insert_queue_image_barrier)(const gfx_cmd_buf*, const gfx_resource*, gfx_image_layout, gfx_image_layout, gfx_queue_type, gfx_queue_type, bool);
+
+    // Block/heap usage of the device memory allocator, budgets come from VK_EXT_memory_budget when the device has it
+    // Only valid when gfx_context.supports.memory_stats, D3D12 uses committed resources and reports nothing
+    gfx_memory_stats (*get_memory_stats)(void);
+
+    // Bindless, only valid when g_gfxConfig.use_bindless and gfx_context.supports.bindless, capacities are clamped to the device limits
+    // Not implemented on D3D12, passes stay on descriptor tables there
+    gfx_bindless_heap (*create_bindless_heap)(uint32_t, uint32_t, uint32_t);
+    void (*destroy_bindless_heap)(gfx_bindless_heap*);
+    // Writes the view into a free slot of its range, resources are only needed for buffers and samplers
+    gfx_bindless_slot (*bindless_register)(gfx_bindless_heap*, const gfx_resource*, const gfx_resource_view*);
+    // The slot is reused by the next register, only once no frame in flight indexes it anymore
+    void (*bindless_release)(gfx_bindless_heap*, gfx_bindless_slot);
+    // Executing secondaries leaves the primary's bindings undefined, bind again after that
+    rhi_error_codes (*bind_bindless_heap)(const gfx_cmd_buf*, const gfx_bindless_heap*, gfx_pipeline_type);
 } rhi_jumptable;
 
 //---------------------------
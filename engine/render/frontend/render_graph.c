@@ -0,0 +1,439 @@
+#include "render_graph.h"
+
+#include "../core/logging/log.h"
+
+#include <string.h>
+
+// Layout tracking slots: imported resources by index, transients by their physical texture
+#define RENDER_GRAPH_MAX_TRACKED (RENDER_GRAPH_MAX_RESOURCES + RENDER_GRAPH_MAX_PHYSICAL)
+
+static gfx_image_layout render_graph_internal_access_layout(render_graph_access access)
+{
+    switch (access) {
+        case RENDER_GRAPH_ACCESS_STORAGE_READ:
+        case RENDER_GRAPH_ACCESS_STORAGE_WRITE: return GFX_IMAGE_LAYOUT_GENERAL;
+        case RENDER_GRAPH_ACCESS_SAMPLED: return GFX_IMAGE_LAYOUT_SHADER_READ_ONLY;
+        case RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT: return GFX_IMAGE_LAYOUT_COLOR_ATTACHMENT;
+        case RENDER_GRAPH_ACCESS_DEPTH_ATTACHMENT: return GFX_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT;
+        case RENDER_GRAPH_ACCESS_TRANSFER_SRC: return GFX_IMAGE_LAYOUT_TRANSFER_SRC;
+        case RENDER_GRAPH_ACCESS_TRANSFER_DST: return GFX_IMAGE_LAYOUT_TRANSFER_DST;
+    }
+    return GFX_IMAGE_LAYOUT_UNDEFINED;
+}
+
+static uint32_t render_graph_internal_texel_size(gfx_format format)
+{
+    switch (format) {
+        case GFX_FORMAT_R8INT:
+        case GFX_FORMAT_R8UINT:
+        case GFX_FORMAT_R8F: return 1;
+        case GFX_FORMAT_R16F:
+        case GFX_FORMAT_DEPTH16UNORM: return 2;
+        case GFX_FORMAT_RGBINT:
+        case GFX_FORMAT_RGBUINT:
+        case GFX_FORMAT_RGBUNORM: return 3;
+        case GFX_FORMAT_RGB32F: return 12;
+        case GFX_FORMAT_RGBA32F: return 16;
+        case GFX_FORMAT_NONE: return 0;
+        default: return 4;
+    }
+}
+
+static uint64_t render_graph_internal_texture_bytes(const gfx_texture_create_info* desc)
+{
+    uint64_t depth = desc->depth ? desc->depth : 1;
+    return (uint64_t) desc->width * desc->height * depth * render_graph_internal_texel_size(desc->format);
+}
+
+static bool render_graph_internal_same_desc(const gfx_texture_create_info* a, const gfx_texture_create_info* b)
+{
+    return a->width == b->width && a->height == b->height && a->depth == b->depth && a->format == b->format && a->tex_type == b->tex_type && a->res_type == b->res_type;
+}
+
+static uint32_t render_graph_internal_tracked_slot(const render_graph* graph, render_graph_resource resource)
+{
+    const render_graph_resource_node* node = &graph->resources[resource];
+    if (node->kind == RENDER_GRAPH_RESOURCE_TRANSIENT)
+        return RENDER_GRAPH_MAX_RESOURCES + node->physical;
+    return resource;
+}
+
+static render_graph_resource render_graph_internal_add_resource(render_graph* graph, render_graph_resource_node node)
+{
+    if (graph->resource_count >= RENDER_GRAPH_MAX_RESOURCES) {
+        LOG_ERROR("[RenderGraph] too many resources, max: %d (%s)", RENDER_GRAPH_MAX_RESOURCES, node.name);
+        return RENDER_GRAPH_INVALID_RESOURCE;
+    }
+
+    node.physical                           = RENDER_GRAPH_INVALID_RESOURCE;
+    node.first_pass                         = UINT32_MAX;
+    node.last_pass                          = 0;
+    graph->resources[graph->resource_count] = node;
+    graph->compiled                         = false;
+    return graph->resource_count++;
+}
+
+static void render_graph_internal_add_access(render_graph* graph, uint32_t pass, render_graph_resource resource, render_graph_access access, bool is_write)
+{
+    if (pass >= graph->pass_count || resource >= graph->resource_count) {
+        LOG_ERROR("[RenderGraph] invalid pass (%u) or resource (%u)", pass, resource);
+        return;
+    }
+
+    render_graph_pass* p = &graph->passes[pass];
+    if (p->access_count >= RENDER_GRAPH_MAX_PASS_ACCESSES) {
+        LOG_ERROR("[RenderGraph] too many accesses in pass %s, max: %d", p->name, RENDER_GRAPH_MAX_PASS_ACCESSES);
+        return;
+    }
+
+    p->accesses[p->access_count++] = (render_graph_pass_access){.resource = resource, .access = access, .is_write = is_write};
+    graph->compiled                = false;
+}
+
+// Walks back from the outputs, a pass survives if something downstream consumes what it writes
+static void render_graph_internal_cull(render_graph* graph)
+{
+    bool needed[RENDER_GRAPH_MAX_RESOURCES] = {0};
+    for (uint32_t r = 0; r < graph->resource_count; r++)
+        needed[r] = graph->resources[r].is_output;
+
+    for (uint32_t i = graph->pass_count; i-- > 0;) {
+        render_graph_pass* pass = &graph->passes[i];
+
+        bool alive = pass->has_side_effects;
+        for (uint32_t a = 0; a < pass->access_count && !alive; a++)
+            alive = pass->accesses[a].is_write && needed[pass->accesses[a].resource];
+
+        pass->culled = !alive;
+        if (!alive) {
+            graph->stats.culled_passes++;
+            continue;
+        }
+
+        for (uint32_t a = 0; a < pass->access_count; a++) {
+            if (!pass->accesses[a].is_write)
+                needed[pass->accesses[a].resource] = true;
+        }
+    }
+}
+
+// Transients get the first free pooled texture with a matching description, lifetimes are [first_pass, last_pass]
+static bool render_graph_internal_assign_physical(render_graph* graph)
+{
+    for (uint32_t p = 0; p < graph->physical_count; p++)
+        graph->physical[p].busy_until = UINT32_MAX;
+
+    for (uint32_t i = 0; i < graph->pass_count; i++) {
+        const render_graph_pass* pass = &graph->passes[i];
+        if (pass->culled)
+            continue;
+
+        for (uint32_t a = 0; a < pass->access_count; a++) {
+            render_graph_resource_node* node = &graph->resources[pass->accesses[a].resource];
+            if (node->first_pass == UINT32_MAX)
+                node->first_pass = i;
+            node->last_pass = i;
+        }
+    }
+
+    for (uint32_t i = 0; i < graph->pass_count; i++) {
+        const render_graph_pass* pass = &graph->passes[i];
+        if (pass->culled)
+            continue;
+
+        for (uint32_t a = 0; a < pass->access_count; a++) {
+            render_graph_resource_node* node = &graph->resources[pass->accesses[a].resource];
+            if (node->kind != RENDER_GRAPH_RESOURCE_TRANSIENT || node->first_pass != i || node->physical != RENDER_GRAPH_INVALID_RESOURCE)
+                continue;
+
+            if (!pass->accesses[a].is_write)
+                LOG_WARN("[RenderGraph] transient %s is read by %s before anything wrote it", node->name, pass->name);
+
+            uint32_t physical = RENDER_GRAPH_INVALID_RESOURCE;
+            for (uint32_t p = 0; p < graph->physical_count && physical == RENDER_GRAPH_INVALID_RESOURCE; p++) {
+                const render_graph_physical_texture* tex  = &graph->physical[p];
+                bool                                 free = tex->busy_until == UINT32_MAX || tex->busy_until < i;
+                if (free && render_graph_internal_same_desc(&tex->desc, &node->desc))
+                    physical = p;
+            }
+
+            if (physical == RENDER_GRAPH_INVALID_RESOURCE) {
+                if (graph->physical_count >= RENDER_GRAPH_MAX_PHYSICAL) {
+                    LOG_ERROR("[RenderGraph] out of physical textures, max: %d (%s)", RENDER_GRAPH_MAX_PHYSICAL, node->name);
+                    return false;
+                }
+
+                physical                  = graph->physical_count++;
+                graph->physical[physical] = (render_graph_physical_texture){
+                    .desc       = node->desc,
+                    .texture    = g_rhi.create_texture_resource(node->desc),
+                    .layout     = GFX_IMAGE_LAYOUT_UNDEFINED,
+                    .end_layout = GFX_IMAGE_LAYOUT_UNDEFINED,
+                };
+            }
+
+            graph->physical[physical].busy_until = node->last_pass;
+            node->physical                       = physical;
+
+            graph->stats.transient_textures++;
+            graph->stats.transient_bytes += render_graph_internal_texture_bytes(&node->desc);
+        }
+    }
+
+    for (uint32_t p = 0; p < graph->physical_count; p++) {
+        if (graph->physical[p].busy_until != UINT32_MAX) {
+            graph->stats.physical_textures++;
+            graph->stats.physical_bytes += render_graph_internal_texture_bytes(&graph->physical[p].desc);
+        }
+    }
+
+    return true;
+}
+
+static void render_graph_internal_compute_barriers(render_graph* graph)
+{
+    gfx_image_layout layouts[RENDER_GRAPH_MAX_TRACKED] = {0};
+    bool             written[RENDER_GRAPH_MAX_TRACKED] = {0};
+
+    // imported resources may still be written by earlier work in the frame, their first access is ordered too
+    for (uint32_t r = 0; r < graph->resource_count; r++) {
+        if (graph->resources[r].kind != RENDER_GRAPH_RESOURCE_TRANSIENT) {
+            layouts[r] = graph->resources[r].initial_layout;
+            written[r] = true;
+        }
+    }
+    // a pooled texture left in GENERAL may still be written by the previous frame
+    for (uint32_t p = 0; p < graph->physical_count; p++) {
+        layouts[RENDER_GRAPH_MAX_RESOURCES + p] = graph->physical[p].layout;
+        written[RENDER_GRAPH_MAX_RESOURCES + p] = graph->physical[p].layout == GFX_IMAGE_LAYOUT_GENERAL;
+    }
+
+    for (uint32_t i = 0; i < graph->pass_count; i++) {
+        render_graph_pass* pass = &graph->passes[i];
+        if (pass->culled)
+            continue;
+
+        for (uint32_t a = 0; a < pass->access_count; a++) {
+            const render_graph_pass_access* access = &pass->accesses[a];
+
+            uint32_t         slot     = render_graph_internal_tracked_slot(graph, access->resource);
+            gfx_image_layout required = render_graph_internal_access_layout(access->access);
+
+            // storage accesses stay in GENERAL, only an earlier write needs ordering there
+            bool needs_barrier = layouts[slot] != required || (required == GFX_IMAGE_LAYOUT_GENERAL && written[slot]);
+            if (!needs_barrier)
+                continue;
+
+            pass->barriers[pass->barrier_count++] = (render_graph_barrier){access->resource, layouts[slot], required};
+            layouts[slot]                         = required;
+            written[slot]                         = false;
+            graph->stats.barriers++;
+        }
+
+        // after all barriers of the pass, a read + write of the same resource doesn't order against itself
+        for (uint32_t a = 0; a < pass->access_count; a++) {
+            if (pass->accesses[a].is_write)
+                written[render_graph_internal_tracked_slot(graph, pass->accesses[a].resource)] = true;
+        }
+    }
+
+    for (uint32_t r = 0; r < graph->resource_count; r++) {
+        const render_graph_resource_node* node = &graph->resources[r];
+        if (node->kind == RENDER_GRAPH_RESOURCE_TRANSIENT) {
+            if (node->physical != RENDER_GRAPH_INVALID_RESOURCE)
+                graph->physical[node->physical].end_layout = layouts[RENDER_GRAPH_MAX_RESOURCES + node->physical];
+            continue;
+        }
+
+        if (node->final_layout == GFX_IMAGE_LAYOUT_UNDEFINED || node->final_layout == layouts[r])
+            continue;
+
+        graph->final_barriers[graph->final_barrier_count++] = (render_graph_barrier){r, layouts[r], node->final_layout};
+        graph->stats.barriers++;
+    }
+}
+
+static void render_graph_internal_insert_barrier(const render_graph* graph, gfx_cmd_buf* cmd_buff, const render_graph_barrier* barrier)
+{
+    const render_graph_resource_node* node = &graph->resources[barrier->resource];
+    if (node->kind == RENDER_GRAPH_RESOURCE_SWAPCHAIN)
+        g_rhi.insert_swapchain_layout_barrier(cmd_buff, node->swapchain, barrier->old_layout, barrier->new_layout);
+    else
+        g_rhi.insert_image_layout_barrier(cmd_buff, render_graph_get_texture(graph, barrier->resource), barrier->old_layout, barrier->new_layout);
+}
+
+//--------------------------------------------------------
+
+void render_graph_init(render_graph* graph)
+{
+    memset(graph, 0, sizeof(render_graph));
+}
+
+void render_graph_destroy(render_graph* graph)
+{
+    for (uint32_t p = 0; p < graph->physical_count; p++)
+        g_rhi.destroy_texture_resource(&graph->physical[p].texture);
+
+    memset(graph, 0, sizeof(render_graph));
+}
+
+void render_graph_begin(render_graph* graph)
+{
+    graph->pass_count          = 0;
+    graph->resource_count      = 0;
+    graph->final_barrier_count = 0;
+    graph->stats               = (render_graph_stats){0};
+    graph->compiled            = false;
+}
+
+render_graph_resource render_graph_import_texture(render_graph* graph, const char* name, gfx_resource* texture, gfx_image_layout initial_layout, gfx_image_layout final_layout)
+{
+    return render_graph_internal_add_resource(graph, (render_graph_resource_node){
+                                                         .name           = name,
+                                                         .kind           = RENDER_GRAPH_RESOURCE_IMPORTED,
+                                                         .initial_layout = initial_layout,
+                                                         .final_layout   = final_layout,
+                                                         .texture        = texture,
+                                                     });
+}
+
+render_graph_resource render_graph_import_swapchain(render_graph* graph, const char* name, const gfx_swapchain* swapchain, gfx_image_layout initial_layout, gfx_image_layout final_layout)
+{
+    return render_graph_internal_add_resource(graph, (render_graph_resource_node){
+                                                         .name           = name,
+                                                         .kind           = RENDER_GRAPH_RESOURCE_SWAPCHAIN,
+                                                         .initial_layout = initial_layout,
+                                                         .final_layout   = final_layout,
+                                                         .swapchain      = swapchain,
+                                                         .is_output      = true,
+                                                     });
+}
+
+render_graph_resource render_graph_create_texture(render_graph* graph, const char* name, gfx_texture_create_info desc)
+{
+    return render_graph_internal_add_resource(graph, (render_graph_resource_node){
+                                                         .name = name,
+                                                         .kind = RENDER_GRAPH_RESOURCE_TRANSIENT,
+                                                         .desc = desc,
+                                                     });
+}
+
+void render_graph_mark_output(render_graph* graph, render_graph_resource resource)
+{
+    if (resource >= graph->resource_count)
+        return;
+
+    graph->resources[resource].is_output = true;
+    graph->compiled                      = false;
+}
+
+uint32_t render_graph_add_pass(render_graph* graph, const char* name, render_graph_execute_fn execute, void* user_data)
+{
+    if (graph->pass_count >= RENDER_GRAPH_MAX_PASSES) {
+        LOG_ERROR("[RenderGraph] too many passes, max: %d (%s)", RENDER_GRAPH_MAX_PASSES, name);
+        return UINT32_MAX;
+    }
+
+    graph->passes[graph->pass_count] = (render_graph_pass){
+        .name      = name,
+        .execute   = execute,
+        .user_data = user_data,
+    };
+    graph->compiled = false;
+    return graph->pass_count++;
+}
+
+void render_graph_pass_read(render_graph* graph, uint32_t pass, render_graph_resource resource, render_graph_access access)
+{
+    render_graph_internal_add_access(graph, pass, resource, access, false);
+}
+
+void render_graph_pass_write(render_graph* graph, uint32_t pass, render_graph_resource resource, render_graph_access access)
+{
+    render_graph_internal_add_access(graph, pass, resource, access, true);
+}
+
+void render_graph_pass_set_side_effects(render_graph* graph, uint32_t pass)
+{
+    if (pass >= graph->pass_count)
+        return;
+
+    graph->passes[pass].has_side_effects = true;
+    graph->compiled                      = false;
+}
+
+bool render_graph_compile(render_graph* graph)
+{
+    if (graph->compiled)
+        return true;
+
+    graph->stats               = (render_graph_stats){.passes = graph->pass_count};
+    graph->final_barrier_count = 0;
+    for (uint32_t i = 0; i < graph->pass_count; i++)
+        graph->passes[i].barrier_count = 0;
+    for (uint32_t r = 0; r < graph->resource_count; r++) {
+        graph->resources[r].physical   = RENDER_GRAPH_INVALID_RESOURCE;
+        graph->resources[r].first_pass = UINT32_MAX;
+        graph->resources[r].last_pass  = 0;
+    }
+    for (uint32_t p = 0; p < graph->physical_count; p++)
+        graph->physical[p].end_layout = graph->physical[p].layout;
+
+    render_graph_internal_cull(graph);
+
+    if (!render_graph_internal_assign_physical(graph))
+        return false;
+
+    render_graph_internal_compute_barriers(graph);
+
+    graph->compiled = true;
+    return true;
+}
+
+void render_graph_execute(render_graph* graph, gfx_cmd_buf* cmd_buff)
+{
+    if (!render_graph_compile(graph))
+        return;
+
+    for (uint32_t i = 0; i < graph->pass_count; i++) {
+        const render_graph_pass* pass = &graph->passes[i];
+        if (pass->culled)
+            continue;
+
+        for (uint32_t b = 0; b < pass->barrier_count; b++)
+            render_graph_internal_insert_barrier(graph, cmd_buff, &pass->barriers[b]);
+
+        if (pass->execute)
+            pass->execute(cmd_buff, graph, pass->user_data);
+    }
+
+    for (uint32_t b = 0; b < graph->final_barrier_count; b++)
+        render_graph_internal_insert_barrier(graph, cmd_buff, &graph->final_barriers[b]);
+
+    // next frame's transients start from here
+    for (uint32_t p = 0; p < graph->physical_count; p++)
+        graph->physical[p].layout = graph->physical[p].end_layout;
+}
+
+gfx_resource* render_graph_get_texture(const render_graph* graph, render_graph_resource resource)
+{
+    if (resource >= graph->resource_count)
+        return NULL;
+
+    const render_graph_resource_node* node = &graph->resources[resource];
+    switch (node->kind) {
+        case RENDER_GRAPH_RESOURCE_IMPORTED: return node->texture;
+        case RENDER_GRAPH_RESOURCE_SWAPCHAIN: return NULL;
+        case RENDER_GRAPH_RESOURCE_TRANSIENT:
+            if (node->physical == RENDER_GRAPH_INVALID_RESOURCE)
+                return NULL;
+            // const graph, the physical texture itself is still recorded into
+            return (gfx_resource*) &graph->physical[node->physical].texture;
+    }
+    return NULL;
+}
+
+const render_graph_stats* render_graph_get_stats(const render_graph* graph)
+{
+    return &graph->stats;
+}
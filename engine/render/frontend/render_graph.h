@@ -0,0 +1,164 @@
+#ifndef RENDER_GRAPH_H
+#define RENDER_GRAPH_H
+
+#include "gfx_frontend.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frame graph on top of g_rhi: passes declare what they read and write, the graph then
+// culls passes nobody consumes, inserts the layout transitions between them and maps
+// transient textures with disjoint lifetimes onto the same physical texture.
+//
+// Aliasing only reuses whole pooled textures with an identical description, transients
+// of different sizes or formats never share memory (no placed resources on the device
+// allocator).
+//
+// Rebuilt every frame between render_graph_begin and render_graph_execute, passes run
+// in the order they were added. The physical transient pool outlives the frame.
+
+#define RENDER_GRAPH_MAX_PASSES        32
+#define RENDER_GRAPH_MAX_RESOURCES     32
+#define RENDER_GRAPH_MAX_PASS_ACCESSES 8
+#define RENDER_GRAPH_MAX_PHYSICAL      16
+#define RENDER_GRAPH_INVALID_RESOURCE  UINT32_MAX
+
+typedef uint32_t render_graph_resource;
+
+typedef enum render_graph_access
+{
+    RENDER_GRAPH_ACCESS_STORAGE_READ,
+    RENDER_GRAPH_ACCESS_STORAGE_WRITE,
+    RENDER_GRAPH_ACCESS_SAMPLED,
+    RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT,
+    RENDER_GRAPH_ACCESS_DEPTH_ATTACHMENT,
+    RENDER_GRAPH_ACCESS_TRANSFER_SRC,
+    RENDER_GRAPH_ACCESS_TRANSFER_DST,
+} render_graph_access;
+
+typedef enum render_graph_resource_kind
+{
+    RENDER_GRAPH_RESOURCE_IMPORTED,
+    RENDER_GRAPH_RESOURCE_SWAPCHAIN,
+    RENDER_GRAPH_RESOURCE_TRANSIENT,
+} render_graph_resource_kind;
+
+typedef struct render_graph render_graph;
+
+typedef void (*render_graph_execute_fn)(gfx_cmd_buf* cmd_buff, const render_graph* graph, void* user_data);
+
+typedef struct render_graph_pass_access
+{
+    render_graph_resource resource;
+    render_graph_access   access;
+    bool                  is_write;
+    bool                  _pad0[3];
+} render_graph_pass_access;
+
+typedef struct render_graph_barrier
+{
+    render_graph_resource resource;
+    gfx_image_layout      old_layout;
+    gfx_image_layout      new_layout;
+} render_graph_barrier;
+
+typedef struct render_graph_pass
+{
+    const char*              name;
+    render_graph_execute_fn  execute;
+    void*                    user_data;
+    render_graph_pass_access accesses[RENDER_GRAPH_MAX_PASS_ACCESSES];
+    uint32_t                 access_count;
+    // filled by render_graph_compile
+    uint32_t                 barrier_count;
+    render_graph_barrier     barriers[RENDER_GRAPH_MAX_PASS_ACCESSES];
+    bool                     has_side_effects;    // never culled, e.g. writes CPU visible counters
+    bool                     culled;
+    bool                     _pad0[6];
+} render_graph_pass;
+
+typedef struct render_graph_resource_node
+{
+    const char*                name;
+    render_graph_resource_kind kind;
+    gfx_image_layout           initial_layout;    // imported only, transients start where their physical texture was left
+    gfx_image_layout           final_layout;      // UNDEFINED leaves it in whatever layout the last pass needed
+    uint32_t                   physical;          // transient, index into the pool
+    gfx_resource*              texture;           // imported
+    const gfx_swapchain*       swapchain;
+    gfx_texture_create_info    desc;    // transient
+    uint32_t                   first_pass;
+    uint32_t                   last_pass;
+    bool                       is_output;
+    bool                       _pad0[7];
+} render_graph_resource_node;
+
+// Transient textures are pooled by description and reused across frames
+typedef struct render_graph_physical_texture
+{
+    gfx_texture_create_info desc;
+    gfx_resource            texture;
+    gfx_image_layout        layout;        // where the last executed frame left it
+    gfx_image_layout        end_layout;    // where the compiled frame leaves it, applied by execute
+    uint32_t                busy_until;    // last pass using it in the frame being compiled, UINT32_MAX when free
+    uint32_t                _pad0;
+} render_graph_physical_texture;
+
+typedef struct render_graph_stats
+{
+    uint32_t passes;
+    uint32_t culled_passes;
+    uint32_t barriers;
+    uint32_t transient_textures;
+    uint32_t physical_textures;    // transient_textures - physical_textures were aliased away
+    uint32_t _pad0;
+    uint64_t transient_bytes;    // what the transients would take without aliasing, texel data only
+    uint64_t physical_bytes;     // what the physical textures backing them take
+} render_graph_stats;
+
+struct render_graph
+{
+    render_graph_pass             passes[RENDER_GRAPH_MAX_PASSES];
+    render_graph_resource_node    resources[RENDER_GRAPH_MAX_RESOURCES];
+    render_graph_physical_texture physical[RENDER_GRAPH_MAX_PHYSICAL];
+    render_graph_barrier          final_barriers[RENDER_GRAPH_MAX_RESOURCES];
+    uint32_t                      pass_count;
+    uint32_t                      resource_count;
+    uint32_t                      physical_count;
+    uint32_t                      final_barrier_count;
+    render_graph_stats            stats;
+    bool                          compiled;
+    bool                          _pad0[3];
+};
+
+void render_graph_init(render_graph* graph);
+// Destroys the physical transient textures, the GPU must be done with them
+void render_graph_destroy(render_graph* graph);
+
+// Drops last frame's passes and resources, keeps the transient pool
+void render_graph_begin(render_graph* graph);
+
+// initial_layout is the layout the texture is in when the frame starts executing, earlier
+// writes to it are assumed to still be in flight so its first access is always ordered
+render_graph_resource render_graph_import_texture(render_graph* graph, const char* name, gfx_resource* texture, gfx_image_layout initial_layout, gfx_image_layout final_layout);
+// Always an output, barriers go through insert_swapchain_layout_barrier on the current backbuffer
+render_graph_resource render_graph_import_swapchain(render_graph* graph, const char* name, const gfx_swapchain* swapchain, gfx_image_layout initial_layout, gfx_image_layout final_layout);
+// Contents are undefined on first use, the first access has to be a write
+render_graph_resource render_graph_create_texture(render_graph* graph, const char* name, gfx_texture_create_info desc);
+// Keeps the writers of an imported texture alive even if no pass reads it this frame
+void render_graph_mark_output(render_graph* graph, render_graph_resource resource);
+
+uint32_t render_graph_add_pass(render_graph* graph, const char* name, render_graph_execute_fn execute, void* user_data);
+void     render_graph_pass_read(render_graph* graph, uint32_t pass, render_graph_resource resource, render_graph_access access);
+void     render_graph_pass_write(render_graph* graph, uint32_t pass, render_graph_resource resource, render_graph_access access);
+void     render_graph_pass_set_side_effects(render_graph* graph, uint32_t pass);
+
+// Culls, assigns physical textures and computes the barriers, execute compiles on demand
+bool render_graph_compile(render_graph* graph);
+void render_graph_execute(render_graph* graph, gfx_cmd_buf* cmd_buff);
+
+// Physical texture for transients, the imported one otherwise, NULL for the swapchain
+gfx_resource*             render_graph_get_texture(const render_graph* graph, render_graph_resource resource);
+const render_graph_stats* render_graph_get_stats(const render_graph* graph);
+
+#endif    // RENDER_GRAPH_H
@@ -333,6 +333,12 @@ typedef enum gfx_syncobj_type
     GFX_SYNCOBJ_TYPE_TIMELINE
 } gfx_syncobj_type;
 
+typedef enum gfx_queue_type
+{
+    GFX_QUEUE_TYPE_GRAPHICS,
+    GFX_QUEUE_TYPE_ASYNC_COMPUTE,    // aliases the graphics queue when there's no dedicated compute family
+} gfx_queue_type;
+
 typedef enum gfx_pipeline_type
 {
     GFX_PIPELINE_TYPE_GRAPHICS,
@@ -504,10 +510,22 @@ typedef enum gfx_image_layout
     GFX_IMAGE_LAYOUT_PRESENTATION,
 } gfx_image_layout;
 
+typedef enum gfx_present_mode
+{
+    GFX_PRESENT_MODE_FIFO,         // V-Sync, always supported, frames queue up behind the display
+    GFX_PRESENT_MODE_MAILBOX,      // V-Sync, a newer frame replaces the queued one, falls back to FIFO
+    GFX_PRESENT_MODE_IMMEDIATE,    // no V-Sync, can tear, falls back to FIFO
+} gfx_present_mode;
+
 // Values defined in frontend.c
 typedef struct gfx_config
 {
-    bool use_timeline_semaphores;
+    bool             use_timeline_semaphores;
+    bool             headless;               // offscreen backbuffers, no window/surface/present, Vulkan only
+    bool             use_bindless;           // set by the backend when descriptor indexing is supported
+    gfx_present_mode present_mode;           // read at swapchain creation
+    uint32_t         frame_queue_depth;      // frames the CPU may run ahead of the GPU, 1..MAX_FRAMES_INFLIGHT
+    const char*      pipeline_cache_path;    // NULL disables the on-disk pipeline cache
 } gfx_config;
 
 // Global GFX config
@@ -515,6 +533,20 @@ typedef struct gfx_config
 extern gfx_config g_gfxConfig;
 //------------------------------
 
+#define GFX_PIPELINE_CACHE_FILE_MAGIC 0x50434B56    // "VKCP"
+
+// Written in front of the driver blob at g_gfxConfig.pipeline_cache_path, a cache from a different
+// GPU/driver is discarded on load instead of being handed to the driver
+typedef struct gfx_pipeline_cache_file_header
+{
+    uint32_t magic;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t  pipeline_cache_uuid[16];
+    uint64_t data_size;    // blob bytes following the header
+} gfx_pipeline_cache_file_header;
+
 // Draft-1 gfx_XXX memory alloc design
 // void* backend will be allocated by malloc and manual free (hightly fragmented and not data-oriented)
 
@@ -540,7 +572,8 @@ typedef struct gfx_swapchain
     uint32_t      height;
     uint32_t      image_count;
     uint32_t      current_backbuffer_idx;
-    uint32_t      _pad0[2];
+    bool          supports_storage;    // backbuffers can be written by compute as storage images
+    bool          _pad0[7];
 } gfx_swapchain;
 
 typedef struct gfx_vertex_buffer
@@ -664,13 +697,24 @@ typedef struct gfx_cmd_buf
     void*         _pad0;
 } gfx_cmd_buf;
 
-// Example:
-//typedef struct gfx_thread_cmd
-//{
-//    // TODO: add atomics here
-//    gfx_cmd_pool draw_cmds_pool;
-//    gfx_cmd_buf*  draw_cmds[MAX_FRAME_INFLIGHT];
-//} gfx_thread_cmd;
+#define MAX_GPU_TIMESTAMP_ZONES 16
+
+typedef struct gfx_query_pool
+{
+    random_uuid_t uuid;
+    void*         backend;
+    uint32_t      max_zones;    // begin/end timestamp pairs per in-flight frame
+    uint32_t      _pad0;
+} gfx_query_pool;
+
+#define MAX_RECORD_THREADS 16
+
+// Owned by a single recording thread, secondaries are executed from the frame's draw_cmds
+typedef struct gfx_thread_cmd
+{
+    gfx_cmd_pool pool[MAX_FRAMES_INFLIGHT];
+    gfx_cmd_buf  cmds[MAX_FRAMES_INFLIGHT];
+} gfx_thread_cmd;
 
 typedef struct gfx_cmd_queue
 {
@@ -757,6 +801,36 @@ typedef struct gfx_root_signature
     void*                        backend;
 } gfx_root_signature;
 
+//--------------------------------------------
+// Bindless: one global resource heap and one sampler heap, bound once per command buffer.
+// Shaders index the per-range arrays with indices passed in push constants.
+#define GFX_BINDLESS_INVALID_INDEX UINT32_MAX
+
+typedef enum gfx_bindless_range
+{
+    GFX_BINDLESS_RANGE_SAMPLED_IMAGE,     // set 0, binding 0
+    GFX_BINDLESS_RANGE_STORAGE_IMAGE,     // set 0, binding 1
+    GFX_BINDLESS_RANGE_STORAGE_BUFFER,    // set 0, binding 2
+    GFX_BINDLESS_RANGE_SAMPLER,           // set 1, binding 0
+    GFX_BINDLESS_RANGE_COUNT
+} gfx_bindless_range;
+
+typedef struct gfx_bindless_slot
+{
+    uint32_t           index;    // what the shader indexes the range's array with
+    gfx_bindless_range range;
+} gfx_bindless_slot;
+
+typedef struct gfx_bindless_heap
+{
+    random_uuid_t      uuid;
+    gfx_root_signature root_sig;    // shared by every bindless pipeline, push constants are visible to all stages
+    void*              backend;
+    uint32_t           capacity[GFX_BINDLESS_RANGE_COUNT];
+    uint32_t           push_constant_size;
+    uint32_t           _pad0;
+} gfx_bindless_heap;
+
 typedef struct gfx_pipeline_create_info
 {
     gfx_shader         shader;
@@ -826,6 +900,9 @@ typedef struct gfx_submit_syncobj
     // This is used to increment Values to signal queue submits
     // gfx_context owns This
     gfx_sync_point* global_syncpoint;
+    // Timeline value signaled by another queue (async compute) that this submit waits on, 0 skips it
+    const gfx_syncobj* cross_queue_syncobj;
+    gfx_sync_point     cross_queue_wait_value;
 } gfx_submit_syncobj;
 
 typedef struct gfx_context
@@ -853,14 +930,44 @@ typedef struct gfx_context
         };
     } frame_sync;
     // NOTE: Add all the command buffers you want here...Draw, Async etc.
-    // 1 per thread, only single threaded for now
+    // draw_cmds is the frame's primary, thread_cmds are the per recording thread secondaries
     // In DX12 we need one per frame to reset memory when we are done with a command buffer recording and need to reset
     // If we use a single pool, DX12 would never be able to re-use memory that was used by the command buffer even if
     // we reset it, so vulkan should also suffer this wrath of multiple pools per frame in flight
     gfx_cmd_pool draw_cmds_pool[MAX_FRAMES_INFLIGHT];
     // FIXME: Do we really need 2 of these draw_cmds and queue? can't we collapse and use 1?
-    gfx_cmd_buf   draw_cmds[MAX_FRAMES_INFLIGHT];
-    gfx_cmd_queue cmd_queue;
+    gfx_cmd_buf    draw_cmds[MAX_FRAMES_INFLIGHT];
+    gfx_cmd_queue  cmd_queue;
+    gfx_thread_cmd thread_cmds[MAX_RECORD_THREADS];
+    uint32_t       thread_cmds_count;
+    uint32_t       _pad0[3];
+    // Dedicated compute queue, only supported with timeline semaphores and a compute-only queue family
+    struct
+    {
+        gfx_syncobj    timeline_syncobj;
+        gfx_sync_point global_syncpoint;      // last value submitted on the compute queue
+        gfx_sync_point gfx_wait_syncpoint;    // waited on by the next gfx submit, 0 when nothing is pending
+        bool           is_supported;
+        bool           _pad0[7];
+    } async_compute;
+    // Optional RHI features filled by ctx_init, the entry points of unsupported ones are stubs callers skip
+    struct
+    {
+        bool timestamps;        // create_timestamp_query_pool and the gpu zone calls
+        bool secondary_cmds;    // create_secondary_gfx_cmd_buf and friends, single threaded recording otherwise
+        bool bindless;          // create_bindless_heap and friends
+        bool memory_stats;      // get_memory_stats
+        bool _pad0[4];
+    } supports;
+    gfx_cmd_pool compute_cmds_pool[MAX_FRAMES_INFLIGHT];
+    gfx_cmd_buf  compute_cmds[MAX_FRAMES_INFLIGHT];
+    // CPU time the last frame_begin/frame_end spent blocked, filled by the backend
+    struct
+    {
+        double cpu_wait_ms;        // waiting for the GPU to retire the in-flight slot being reused
+        double present_wait_ms;    // backbuffer acquire + present call, where FIFO throttles the CPU
+    } frame_waits;
+    uint64_t pipeline_cache_loaded_bytes;    // blob handed to the driver by ctx_init, 0 on a cold start or a discarded file
 } gfx_context;
 
 typedef struct gfx_attachment
@@ -894,4 +1001,43 @@ typedef struct gfx_texture_readback
     bool     _pad1[8];
 } gfx_texture_readback;
 
+// Persistently mapped staging memory for streaming swapchain copies, one slot per in-flight frame
+typedef struct gfx_readback_ring
+{
+    random_uuid_t uuid;
+    void*         backend;
+    uint32_t      width;
+    uint32_t      height;
+    uint32_t      slot_size;    // bytes of tightly packed 32bpp pixels
+    uint32_t      _pad0;
+} gfx_readback_ring;
+
+#define MAX_GFX_MEMORY_HEAPS 16
+
+typedef struct gfx_memory_heap_stats
+{
+    uint64_t size;
+    uint64_t budget;       // what the process can use before the OS starts evicting, the heap size without VK_EXT_memory_budget
+    uint64_t usage;        // process wide usage, only what the allocator reserved without VK_EXT_memory_budget
+    uint64_t reserved;     // device memory held by the allocator on this heap
+    bool     device_local;
+    bool     _pad0[7];
+} gfx_memory_heap_stats;
+
+// Device memory allocator state, a snapshot taken by get_memory_stats
+typedef struct gfx_memory_stats
+{
+    uint64_t              bytes_reserved;        // blocks + dedicated allocations
+    uint64_t              bytes_used;            // handed out to resources
+    uint64_t              largest_free_range;    // biggest sub-allocation that fits without a new block
+    float                 fragmentation;         // share of free block memory outside the largest free range of its block
+    uint32_t              blocks;
+    uint32_t              dedicated_allocations;
+    uint32_t              allocations;
+    uint32_t              heap_count;
+    bool                  budget_supported;
+    bool                  _pad0[3];
+    gfx_memory_heap_stats heaps[MAX_GFX_MEMORY_HEAPS];
+} gfx_memory_stats;
+
 #endif    // RENDER_STRUCTS_H
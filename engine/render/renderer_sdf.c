@@ -2,16 +2,27 @@
 
 #include <GLFW/glfw3.h>
 
+#include "file_watcher/file_watcher.h"
 #include "frustum.h"
 #include "game_state.h"
 #include "logging/log.h"
 #include "render_utils.h"
 #include "rng/rng.h"
 #include "shader.h"
+#include "threads/job_system.h"
+#include "threads/threads.h"
+#include "time/timer.h"
 
 #include "../scene/sdf_scene.h"
 
 #include "frontend/gfx_frontend.h"
+#include "frontend/render_graph.h"
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 // Image transition TODO:
 // - [P] swapchain to present src before presentation
@@ -23,10 +34,12 @@
 // - [x] sdf_scene_texture image memory pipeline barrier before screen quad pass
 
 // Descriptor Rework TODO:
-// - [ ] create heaps based on new gfx_heap_type instead of gfx_res_type
-// - [ ] Create new global heaps for Images, CBV etc. (for resource type needed)
-// - [ ] build descriptor tables using new API
-// - [ ] bind heaps and tables
+// - [x] create heaps based on new gfx_heap_type instead of gfx_res_type
+// - [x] Create new global heaps for Images, CBV etc. (for resource type needed) -> gfx_bindless_heap
+// - [x] build descriptor tables using new API -> indices registered in the bindless heap
+// - [x] bind heaps and tables -> bind_bindless_heap once per command buffer
+// - [x] screen quad pass on the bindless heap when descriptor indexing is supported
+// The scene pass stays on tables: its nodes are a uniform buffer and the heap has no uniform buffer range
 
 #define TRIANGLE_TEST 0
 
@@ -34,11 +47,50 @@ typedef struct SDFPushConstant
 {
     mat4s view_proj;
     ivec2 resolution;
-    ivec2 _pad0;
+    int   clear_on_miss;
+    int   _pad0;
     vec3s dir_light_pos;
     int   curr_draw_node_idx;
+    int   debug_flags;
+    int   counters_slot;
+    ivec2 dispatch_offset;    // top left pixel of a partial re-march
 } SDFPushConstant;
 
+// raymarch_sdf_scene.comp SDF_DEBUG_FLAG_*
+#define SDF_DEBUG_FLAG_COUNTERS      1
+#define SDF_DEBUG_FLAG_HEATMAP_STEPS 2
+#define SDF_DEBUG_FLAG_HEATMAP_NODES 4
+
+// Mirrors MarchCounters (std430), one per in-flight frame
+typedef struct SDFMarchCounters
+{
+    uint32_t rays;
+    uint32_t steps_lo;
+    uint32_t steps_hi;
+    uint32_t node_evals_lo;
+    uint32_t node_evals_hi;
+    uint32_t min_steps;
+    uint32_t max_steps_node;
+    uint32_t _pad0;
+    uint32_t histogram[SDF_MARCH_HISTOGRAM_BUCKETS];
+} SDFMarchCounters;
+
+typedef struct ScreenQuadPushConstant
+{
+    int      debug_view;
+    uint32_t heatmap_scale;
+    // bindless heap indices, the descriptor table path only pushes up to here
+    uint32_t scene_texture;
+    uint32_t heatmap;
+    uint32_t scene_sampler;
+} ScreenQuadPushConstant;
+
+// Bindless heap sizes, push constants are shared by every bindless pipeline so use the guaranteed minimum
+#define SDF_BINDLESS_RESOURCES          1024
+#define SDF_BINDLESS_SAMPLERS           64
+#define SDF_BINDLESS_PUSH_CONSTANT_SIZE 128
+#define SDF_SCREEN_QUAD_BINDLESS_PS     "./game/shaders_built/screen_quad_bindless.frag"
+
 #if !TRIANGLE_TEST
 typedef struct sdf_resources
 {
@@ -50,6 +102,14 @@ typedef struct sdf_resources
     gfx_pipeline         pipeline;
     gfx_root_signature   root_sig;
     gfx_descriptor_table tables[1];
+    // used when raymarching directly into the swapchain, one table per backbuffer
+    gfx_resource_view    backbuffer_cs_write_views[MAX_BACKBUFFERS];
+    gfx_descriptor_table backbuffer_tables[MAX_BACKBUFFERS];
+    // debug telemetry, bound always and only written when enabled in pc_data.debug_flags
+    gfx_resource         heatmap_texture;
+    gfx_resource_view    heatmap_view;
+    gfx_resource         counters_buffer;
+    gfx_resource_view    counters_view;
     SDFPushConstant      pc_data;
 } sdf_resources;
 
@@ -60,19 +120,36 @@ typedef struct screen_quad_resoruces
     gfx_resource_view    shader_read_view;
     gfx_shader           shader;
     gfx_pipeline         pipeline;
-    gfx_root_signature   root_sig;
+    gfx_root_signature   root_sig;     // the bindless heap's when bindless, owned by the heap then
     gfx_descriptor_table tables[2];    // samplers need different heap so different table for it
+    gfx_bindless_slot    scene_texture_slot;
+    gfx_bindless_slot    heatmap_slot;
+    gfx_bindless_slot    sampler_slot;
 } screen_quad_resoruces;
 
-typedef struct clear_texture_resources
+// Only created with a dedicated compute queue: one scene texture per in-flight frame so frame N+1's
+// raymarch on the compute queue never writes the texture frame N's screen quad is still sampling
+typedef struct async_compute_resources
 {
-    gfx_resource         texture;
-    gfx_resource_view    shader_read_view;
-    gfx_shader           shader;
-    gfx_pipeline         pipeline;
-    gfx_root_signature   root_sig;
-    gfx_descriptor_table tables[1];
-} clear_texture_resources;
+    gfx_resource         scene_textures[MAX_FRAMES_INFLIGHT];
+    gfx_resource_view    cs_write_views[MAX_FRAMES_INFLIGHT];
+    gfx_resource_view    shader_read_views[MAX_FRAMES_INFLIGHT];
+    gfx_descriptor_table scene_tables[MAX_FRAMES_INFLIGHT];
+    gfx_descriptor_table screen_quad_tables[MAX_FRAMES_INFLIGHT];    // set 0 only, the sampler table is shared
+    gfx_bindless_slot    screen_quad_slots[MAX_FRAMES_INFLIGHT];     // replaces screen_quad_tables when bindless
+    bool                 created;
+    bool                 enabled;
+    bool                 _pad0[6];
+} async_compute_resources;
+
+// Inputs of the frame graph pass callbacks, rebuilt with the graph every frame
+typedef struct frame_graph_data
+{
+    const gfx_descriptor_table* scene_table;                  // raymarch output, scene texture or backbuffer
+    const gfx_descriptor_table* screen_quad_table;            // set 0 of the screen quad
+    uint32_t                    screen_quad_scene_texture;    // bindless index of the sampled scene texture
+    uint32_t                    _pad0;
+} frame_graph_data;
 #else
 typedef struct triangle_resources
 {
@@ -82,6 +159,144 @@ typedef struct triangle_resources
 } triangle_resources;
 #endif
 
+typedef struct gpu_timings_state
+{
+    gfx_query_pool           query_pool;
+    renderer_sdf_gpu_timings timings;
+    double                   history[SDF_GPU_TIMINGS_WINDOW][SDF_GPU_PASS_COUNT];
+    double                   history_sum[SDF_GPU_PASS_COUNT];
+    uint32_t                 history_head;
+    uint32_t                 history_count;
+    FILE*                    csv;
+    bool                     log;
+    bool                     _pad0[7];
+} gpu_timings_state;
+
+typedef struct march_debug_state
+{
+    renderer_sdf_march_stats stats;
+    uint64_t                 slot_frame[MAX_FRAMES_INFLIGHT];    // frameCount the slot's counters were recorded in
+    renderer_sdf_debug_view  view;
+    uint32_t                 heatmap_scale;
+    bool                     slot_recorded[MAX_FRAMES_INFLIGHT];
+    bool                     counters_enabled;
+    bool                     stats_valid;
+    bool                     _pad0[3];
+} march_debug_state;
+
+typedef struct frame_capture_state
+{
+    gfx_readback_ring             ring;    // created on the first renderer_sdf_set_frame_capture
+    renderer_sdf_frame_capture_fn callback;
+    void*                         user_data;
+    uint64_t                      slot_frame[MAX_FRAMES_INFLIGHT];    // frameCount the slot's copy was recorded in
+    uint64_t                      frames_delivered;
+} frame_capture_state;
+
+// One per pass, shader + pipeline are built together on a worker thread
+typedef struct pipeline_build_job
+{
+    const char*              cs_path;    // compute when set, otherwise vs_path + ps_path
+    const char*              vs_path;
+    const char*              ps_path;
+    gfx_pipeline_create_info pipeline_ci;    // shader is filled in by the job
+    gfx_shader*              shader_out;
+    gfx_pipeline*            pipeline_out;
+    double                   shader_ms;
+    double                   pipeline_ms;
+} pipeline_build_job;
+
+#define SDF_MAX_PIPELINE_BUILD_JOBS   2
+#define SDF_MAX_RETIRED_PIPELINES     (SDF_MAX_PIPELINE_BUILD_JOBS * (MAX_FRAMES_INFLIGHT + 1))
+#define SDF_SHADER_RELOAD_DEBOUNCE_MS 150.0
+
+// Pipeline replaced by a hot reload, kept alive until the frames that used it retire
+typedef struct retired_pipeline
+{
+    gfx_shader   shader;
+    gfx_pipeline pipeline;
+    uint64_t     retire_frame;    // first frame recorded with the replacement
+    bool         is_compute;
+    bool         _pad0[7];
+} retired_pipeline;
+
+typedef struct shader_reload_state
+{
+    file_watcher       watcher;
+    thread_t           thread;
+    pipeline_build_job jobs[SDF_MAX_PIPELINE_BUILD_JOBS];
+    gfx_shader         staged_shaders[SDF_MAX_PIPELINE_BUILD_JOBS];
+    gfx_pipeline       staged_pipelines[SDF_MAX_PIPELINE_BUILD_JOBS];
+    gfx_shader*        live_shaders[SDF_MAX_PIPELINE_BUILD_JOBS];
+    gfx_pipeline*      live_pipelines[SDF_MAX_PIPELINE_BUILD_JOBS];
+    retired_pipeline   retired[SDF_MAX_RETIRED_PIPELINES];
+    uint32_t           retired_count;
+    uint32_t           jobs_count;
+    uint64_t           last_change_ns;    // 0 for a manual reload, skips the debounce
+    double             build_ms;
+    uint32_t           reload_count;
+    volatile uint32_t  build_done;    // written by the build thread
+    bool               building;
+    bool               threaded;
+    bool               change_pending;
+    bool               key_was_down;
+    bool               _pad0[4];
+} shader_reload_state;
+
+typedef struct cmd_record_state
+{
+    renderer_sdf_record_stats stats;
+    uint32_t                  threads;    // requested count, clamped to the created thread_cmds
+    uint32_t                  _pad0;
+} cmd_record_state;
+
+// Shared by the scene recording jobs, read only while they run
+typedef struct scene_record_job
+{
+    SDFPushConstant             pc_data;    // clear_on_miss and curr_draw_node_idx are set per dispatch
+    const gfx_descriptor_table* table;
+    const int32_t*              dispatch_nodes;    // scene node per dispatch, -1 only clears
+    uint32_t                    dispatch_count;
+    uint32_t                    chunk_count;
+    uint32_t                    frame_idx;
+    uint32_t                    dispatch_extent[2];    // pixels from pc_data.dispatch_offset
+    uint32_t                    _pad0[3];
+} scene_record_job;
+
+#if !TRIANGLE_TEST
+typedef enum scene_redraw_mode
+{
+    SCENE_REDRAW_FULL,       // usual path, may raymarch into the backbuffer or on the compute queue
+    SCENE_REDRAW_HISTORY,    // full march into the scene texture so the next frames can reuse it
+    SCENE_REDRAW_PARTIAL,    // only redraw_state.rect is re-marched into the scene texture
+    SCENE_REDRAW_SKIP,       // the scene texture is up to date, only the screen quad runs
+} scene_redraw_mode;
+
+// Half-open pixel rectangle, empty when x0 >= x1 or y0 >= y1
+typedef struct screen_rect
+{
+    uint32_t x0;
+    uint32_t y0;
+    uint32_t x1;
+    uint32_t y1;
+} screen_rect;
+
+// Everything is compared against the previous frame, history_valid tells if the scene texture shows it
+typedef struct redraw_state
+{
+    SDF_NodeGPUData           marched_nodes[MAX_SDF_NODES];
+    screen_rect               marched_rects[MAX_SDF_NODES];    // per dispatch node
+    mat4s                     marched_view_proj;
+    renderer_sdf_redraw_stats stats;
+    screen_rect               rect;    // re-marched this frame
+    uint32_t                  marched_node_count;
+    scene_redraw_mode         mode;
+    bool                      enabled;
+    bool                      history_valid;
+    bool                      _pad0[14];
+} redraw_state;
+#endif
+
 typedef struct renderer_internal_state
 {
     uint32_t             numPrimitives;
@@ -92,16 +307,32 @@ typedef struct renderer_internal_state
     const SDF_Scene*     scene;
     uint64_t             frameCount;
     bool                 captureSwapchain;
+    bool                 writeToBackbuffer;    // requested in renderer_desc
+    bool                 backbufferTablesBuilt;
+    bool                 frameBegun;           // frame_begin ran, by renderer_sdf_begin_frame or the frame being drawn
+    bool                 resizePending;        // window resized while a frame was begun, applied once it ends
     bool                 _pad0[3];
     mat4s                viewproj;
     gfx_texture_readback lastSwapchainReadback;
     gfx_context          gfxcontext;
     gfx_descriptor_heap  generic_heap;
     gfx_descriptor_heap  samplers_heap;
+    gfx_bindless_heap    bindless_heap;    // only created when g_gfxConfig.use_bindless
+    gpu_timings_state    gpu_timings;
+    march_debug_state    march_debug;
+    // measured once in renderer_sdf_init, shader/pipeline times again on hot reload
+    renderer_sdf_startup_timings startup_timings;
+    shader_reload_state          shader_reload;
+    frame_capture_state          frame_capture;
+    cmd_record_state             cmd_record;
+    renderer_sdf_frame_pacing    frame_pacing;
 #if !TRIANGLE_TEST
     screen_quad_resoruces   screen_quad_resources;
     sdf_resources           sdfscene_resources;
-    clear_texture_resources clear_tex_resources;
+    async_compute_resources async_compute;
+    render_graph            frame_graph;
+    frame_graph_data        frame_graph_data;
+    redraw_state            redraw;
 #else
     triangle_resources triangle;
 #endif
@@ -111,35 +342,81 @@ typedef struct renderer_internal_state
 static renderer_internal_state s_RendererSDFInternalState;
 //---------------------------------------------------------
 // Private functions
+static void renderer_internal_destroy_retired_pipelines(bool gpu_idle);
+
+static bool renderer_internal_use_bindless(void)
+{
+    return s_RendererSDFInternalState.bindless_heap.backend != NULL;
+}
+
+// Paths are passed to the RHI without the extension of the backend's shader binaries
+static bool renderer_internal_shader_binary_exists(const char* path)
+{
+    char* full_path = appendFileExt(path, g_current_api == D3D12 ? "cso" : "spv");
+    FILE* file      = full_path ? fopen(full_path, "rb") : NULL;
+    free(full_path);
+    if (!file)
+        return false;
+    fclose(file);
+    return true;
+}
+
+// Once per command buffer, secondaries bind their own and executing them leaves the primary's bindings undefined
+static void renderer_internal_bind_bindless_heap(const gfx_cmd_buf* cmd_buff)
+{
+    if (renderer_internal_use_bindless())
+        g_rhi.bind_bindless_heap(cmd_buff, &s_RendererSDFInternalState.bindless_heap, GFX_PIPELINE_TYPE_GRAPHICS);
+}
+#if !TRIANGLE_TEST
+static void renderer_internal_create_backbuffer_descriptor_tables(void);
+static void renderer_internal_destroy_backbuffer_descriptor_tables(void);
+#endif
+
 // Resize callback
 static void renderer_internal_sdf_resize(GLFWwindow* window, int width, int height)
 {
     (void) window;
-    s_RendererSDFInternalState.width            = width;
-    s_RendererSDFInternalState.height           = height;
+    s_RendererSDFInternalState.width  = width;
+    s_RendererSDFInternalState.height = height;
+
+    // the acquired backbuffer belongs to the current swapchain, renderer_sdf_render resizes after frame_end
+    if (s_RendererSDFInternalState.frameBegun) {
+        s_RendererSDFInternalState.resizePending = true;
+        return;
+    }
+    s_RendererSDFInternalState.resizePending = false;
+
     s_RendererSDFInternalState.frameCount       = 0;
     s_RendererSDFInternalState.captureSwapchain = false;
 
     g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
 
+    // frameCount restarts, the GPU is idle so nothing retired is in use anymore
+    renderer_internal_destroy_retired_pipelines(true);
+
+    // pending copies are dropped, the ring is sized for the old swapchain
+    if (s_RendererSDFInternalState.frame_capture.ring.backend) {
+        g_rhi.destroy_readback_ring(&s_RendererSDFInternalState.frame_capture.ring);
+        s_RendererSDFInternalState.frame_capture.ring = g_rhi.create_readback_ring(width, height);
+    }
+
+#if !TRIANGLE_TEST
+    // backbuffer views are tied to the old swapchain images
+    renderer_internal_destroy_backbuffer_descriptor_tables();
+
+    s_RendererSDFInternalState.redraw.history_valid = false;
+#endif
+
     g_rhi.resize_swapchain(&s_RendererSDFInternalState.gfxcontext, width, height);
-}
 
-static void renderer_internal_create_shaders(void)
-{
 #if !TRIANGLE_TEST
-    s_RendererSDFInternalState.clear_tex_resources.shader   = g_rhi.create_compute_shader("./game/shaders_built/clear_texture.comp");
-    s_RendererSDFInternalState.sdfscene_resources.shader    = g_rhi.create_compute_shader("./game/shaders_built/raymarch_sdf_scene.comp");
-    s_RendererSDFInternalState.screen_quad_resources.shader = g_rhi.create_vs_ps_shader("./game/shaders_built/screen_quad.vert", "./game/shaders_built/screen_quad.frag");
-#else
-    s_RendererSDFInternalState.triangle.shader = g_rhi.create_vs_ps_shader("./game/shaders_built/triangle.vert", "./game/shaders_built/triangle.frag");
+    renderer_internal_create_backbuffer_descriptor_tables();
 #endif
 }
 
 static void renderer_internal_destroy_shaders(void)
 {
 #if !TRIANGLE_TEST
-    g_rhi.destroy_compute_shader(&s_RendererSDFInternalState.clear_tex_resources.shader);
     g_rhi.destroy_compute_shader(&s_RendererSDFInternalState.sdfscene_resources.shader);
     g_rhi.destroy_vs_ps_shader(&s_RendererSDFInternalState.screen_quad_resources.shader);
 #else
@@ -152,40 +429,39 @@ static void renderer_internal_create_root_sigs(void)
 #if !TRIANGLE_TEST
 
     {
-        gfx_descriptor_binding tex_binding = {
+        gfx_descriptor_binding sdf_scene_ubo_binding = {
             .location = {
                 .binding = 0,
                 .set     = 0,
             },
             .count       = 1,
-            .type        = GFX_RESOURCE_TYPE_STORAGE_IMAGE,
+            .type        = GFX_RESOURCE_TYPE_UNIFORM_BUFFER,
             .stage_flags = GFX_SHADER_STAGE_CS,
         };
 
-        gfx_descriptor_table_layout set_layout_0 = {
-            .bindings      = &tex_binding,
-            .binding_count = 1,
+        gfx_descriptor_binding sdf_scene_tex_binding = {
+            .location = {
+                .binding = 1,
+                .set     = 0,
+            },
+            .count       = 1,
+            .type        = GFX_RESOURCE_TYPE_STORAGE_IMAGE,
+            .stage_flags = GFX_SHADER_STAGE_CS,
         };
 
-        s_RendererSDFInternalState.clear_tex_resources.root_sig = g_rhi.create_root_signature(&set_layout_0, 1, NULL, 0);
-    }
-
-    //------------------------------------------------
-
-    {
-        gfx_descriptor_binding sdf_scene_ubo_binding = {
+        gfx_descriptor_binding sdf_counters_binding = {
             .location = {
-                .binding = 0,
+                .binding = 2,
                 .set     = 0,
             },
             .count       = 1,
-            .type        = GFX_RESOURCE_TYPE_UNIFORM_BUFFER,
+            .type        = GFX_RESOURCE_TYPE_STORAGE_BUFFER,
             .stage_flags = GFX_SHADER_STAGE_CS,
         };
 
-        gfx_descriptor_binding sdf_scene_tex_binding = {
+        gfx_descriptor_binding sdf_heatmap_binding = {
             .location = {
-                .binding = 1,
+                .binding = 3,
                 .set     = 0,
             },
             .count       = 1,
@@ -193,7 +469,7 @@ static void renderer_internal_create_root_sigs(void)
             .stage_flags = GFX_SHADER_STAGE_CS,
         };
 
-        gfx_descriptor_binding sdf_bindings[] = {sdf_scene_ubo_binding, sdf_scene_tex_binding};
+        gfx_descriptor_binding sdf_bindings[] = {sdf_scene_ubo_binding, sdf_scene_tex_binding, sdf_counters_binding, sdf_heatmap_binding};
 
         gfx_descriptor_table_layout set_layout_0 = {
             .bindings      = sdf_bindings,
@@ -211,6 +487,11 @@ static void renderer_internal_create_root_sigs(void)
     //------------------------------------------------
 
     {
+        if (renderer_internal_use_bindless()) {
+            s_RendererSDFInternalState.screen_quad_resources.root_sig = s_RendererSDFInternalState.bindless_heap.root_sig;
+            return;
+        }
+
         gfx_descriptor_binding screen_tex_binding = {
             .location = {
                 .binding = 0,
@@ -221,6 +502,16 @@ static void renderer_internal_create_root_sigs(void)
             .stage_flags = GFX_SHADER_STAGE_PS,
         };
 
+        gfx_descriptor_binding screen_heatmap_binding = {
+            .location = {
+                .binding = 1,
+                .set     = 0,
+            },
+            .count       = 1,
+            .type        = GFX_RESOURCE_TYPE_STORAGE_IMAGE,
+            .stage_flags = GFX_SHADER_STAGE_PS,
+        };
+
         gfx_descriptor_binding screen_sampler_binding = {
             .location = {
                 .binding = 0,
@@ -231,9 +522,11 @@ static void renderer_internal_create_root_sigs(void)
             .stage_flags = GFX_SHADER_STAGE_PS,
         };
 
+        gfx_descriptor_binding screen_set_0_bindings[] = {screen_tex_binding, screen_heatmap_binding};
+
         gfx_descriptor_table_layout screen_set_layout_0 = {
-            .bindings      = &screen_tex_binding,
-            .binding_count = 1,
+            .bindings      = screen_set_0_bindings,
+            .binding_count = ARRAY_SIZE(screen_set_0_bindings),
         };
 
         gfx_descriptor_table_layout screen_set_layout_1 = {
@@ -243,7 +536,12 @@ static void renderer_internal_create_root_sigs(void)
 
         gfx_descriptor_table_layout screen_set_layouts[] = {screen_set_layout_0, screen_set_layout_1};
 
-        s_RendererSDFInternalState.screen_quad_resources.root_sig = g_rhi.create_root_signature(screen_set_layouts, 2, NULL, 0);
+        gfx_root_constant_range screen_pc_range = {
+            .size   = sizeof(ScreenQuadPushConstant),
+            .offset = 0,
+            .stage  = GFX_SHADER_STAGE_PS};
+
+        s_RendererSDFInternalState.screen_quad_resources.root_sig = g_rhi.create_root_signature(screen_set_layouts, 2, &screen_pc_range, 1);
     }
 #else
     // Nothing to bind
@@ -254,75 +552,125 @@ static void renderer_internal_create_root_sigs(void)
 static void renderer_internal_destroy_root_sigs(void)
 {
 #if !TRIANGLE_TEST
-    g_rhi.destroy_root_signature(&s_RendererSDFInternalState.clear_tex_resources.root_sig);
     g_rhi.destroy_root_signature(&s_RendererSDFInternalState.sdfscene_resources.root_sig);
-    g_rhi.destroy_root_signature(&s_RendererSDFInternalState.screen_quad_resources.root_sig);
+    if (!renderer_internal_use_bindless())
+        g_rhi.destroy_root_signature(&s_RendererSDFInternalState.screen_quad_resources.root_sig);
 #else
     g_rhi.destroy_root_signature(&s_RendererSDFInternalState.triangle.root_sig);
 #endif
 }
 
-static void renderer_internal_create_pipelines(void)
+static void renderer_internal_run_pipeline_build_job(pipeline_build_job* job)
 {
-#if !TRIANGLE_TEST
-    gfx_pipeline_create_info clear_tex_pipeline_ci = {
-        .type     = GFX_PIPELINE_TYPE_COMPUTE,
-        .root_sig = s_RendererSDFInternalState.clear_tex_resources.root_sig,
-        .shader   = s_RendererSDFInternalState.clear_tex_resources.shader,
-    };
+    uint64_t start = timer_now_ns();
+    if (job->cs_path)
+        *job->shader_out = g_rhi.create_compute_shader(job->cs_path);
+    else
+        *job->shader_out = g_rhi.create_vs_ps_shader(job->vs_path, job->ps_path);
+    job->shader_ms = timer_elapsed_ms(start);
+
+    start                   = timer_now_ns();
+    job->pipeline_ci.shader = *job->shader_out;
+    *job->pipeline_out      = g_rhi.create_pipeline(job->pipeline_ci);
+    job->pipeline_ms        = timer_elapsed_ms(start);
+}
 
-    s_RendererSDFInternalState.clear_tex_resources.pipeline = g_rhi.create_pipeline(clear_tex_pipeline_ci);
+// Jobs write straight into the live pass resources, needs the root signatures
+static uint32_t renderer_internal_fill_pipeline_build_jobs(pipeline_build_job* jobs)
+{
+    uint32_t jobs_count = 0;
 
-    //------------------------------------------------
+#if !TRIANGLE_TEST
+    jobs[jobs_count++] = (pipeline_build_job){
+        .cs_path     = "./game/shaders_built/raymarch_sdf_scene.comp",
+        .pipeline_ci = {
+            .type     = GFX_PIPELINE_TYPE_COMPUTE,
+            .root_sig = s_RendererSDFInternalState.sdfscene_resources.root_sig,
+        },
+        .shader_out   = &s_RendererSDFInternalState.sdfscene_resources.shader,
+        .pipeline_out = &s_RendererSDFInternalState.sdfscene_resources.pipeline,
+    };
 
-    gfx_pipeline_create_info scene_pipeline_ci = {
-        .type     = GFX_PIPELINE_TYPE_COMPUTE,
-        .root_sig = s_RendererSDFInternalState.sdfscene_resources.root_sig,
-        .shader   = s_RendererSDFInternalState.sdfscene_resources.shader,
+    jobs[jobs_count++] = (pipeline_build_job){
+        .vs_path     = "./game/shaders_built/screen_quad.vert",
+        .ps_path     = renderer_internal_use_bindless() ? SDF_SCREEN_QUAD_BINDLESS_PS : "./game/shaders_built/screen_quad.frag",
+        .pipeline_ci = {
+            .type                = GFX_PIPELINE_TYPE_GRAPHICS,
+            .root_sig            = s_RendererSDFInternalState.screen_quad_resources.root_sig,
+            .draw_type           = GFX_DRAW_TYPE_TRIANGLE,
+            .polygon_mode        = GFX_POLYGON_MODE_FILL,
+            .cull_mode           = GFX_CULL_MODE_NO_CULL,
+            .enable_depth_test   = false,
+            .enable_depth_write  = false,
+            .enable_transparency = false,
+            .color_formats_count = 1,
+            .color_formats[0]    = GFX_FORMAT_SCREEN,
+        },
+        .shader_out   = &s_RendererSDFInternalState.screen_quad_resources.shader,
+        .pipeline_out = &s_RendererSDFInternalState.screen_quad_resources.pipeline,
+    };
+#else
+    jobs[jobs_count++] = (pipeline_build_job){
+        .vs_path     = "./game/shaders_built/triangle.vert",
+        .ps_path     = "./game/shaders_built/triangle.frag",
+        .pipeline_ci = {
+            .type                = GFX_PIPELINE_TYPE_GRAPHICS,
+            .root_sig            = s_RendererSDFInternalState.triangle.root_sig,
+            .draw_type           = GFX_DRAW_TYPE_TRIANGLE,
+            .polygon_mode        = GFX_POLYGON_MODE_FILL,
+            .cull_mode           = GFX_CULL_MODE_NO_CULL,
+            .enable_depth_test   = false,
+            .enable_depth_write  = false,
+            .enable_transparency = false,
+            .color_formats_count = 1,
+            .color_formats[0]    = GFX_FORMAT_SCREEN,
+        },
+        .shader_out   = &s_RendererSDFInternalState.triangle.shader,
+        .pipeline_out = &s_RendererSDFInternalState.triangle.pipeline,
     };
+#endif
 
-    s_RendererSDFInternalState.sdfscene_resources.pipeline = g_rhi.create_pipeline(scene_pipeline_ci);
+    return jobs_count;
+}
 
-    //------------------------------------------------
+static void renderer_internal_pipeline_build_job_proc(void* arg, uint32_t job_idx)
+{
+    renderer_internal_run_pipeline_build_job(&((pipeline_build_job*) arg)[job_idx]);
+}
 
-    gfx_pipeline_create_info scrn_pipeline_ci = {
-        .type                = GFX_PIPELINE_TYPE_GRAPHICS,
-        .root_sig            = s_RendererSDFInternalState.screen_quad_resources.root_sig,
-        .shader              = s_RendererSDFInternalState.screen_quad_resources.shader,
-        .draw_type           = GFX_DRAW_TYPE_TRIANGLE,
-        .polygon_mode        = GFX_POLYGON_MODE_FILL,
-        .cull_mode           = GFX_CULL_MODE_NO_CULL,
-        .enable_depth_test   = false,
-        .enable_depth_write  = false,
-        .enable_transparency = false,
-        .color_formats_count = 1,
-        .color_formats[0]    = GFX_FORMAT_SCREEN,
-    };
+// Blocks until all jobs are done, the backend pipeline cache is shared by all of them
+// Main thread only, the job system runs one batch at a time
+static void renderer_internal_run_pipeline_build_jobs(pipeline_build_job* jobs, uint32_t jobs_count)
+{
+    job_system_parallel_for(renderer_internal_pipeline_build_job_proc, jobs, jobs_count);
+}
 
-    s_RendererSDFInternalState.screen_quad_resources.pipeline = g_rhi.create_pipeline(scrn_pipeline_ci);
-#else
+static void renderer_internal_record_pipeline_build_timings(const pipeline_build_job* jobs, uint32_t jobs_count, double wall_ms)
+{
+    renderer_sdf_startup_timings* timings = &s_RendererSDFInternalState.startup_timings;
+    timings->shaders_ms                   = 0.0;
+    timings->pipelines_ms                 = 0.0;
+    for (uint32_t i = 0; i < jobs_count; i++) {
+        timings->shaders_ms += jobs[i].shader_ms;
+        timings->pipelines_ms += jobs[i].pipeline_ms;
+    }
+    timings->shaders_pipelines_wall_ms = wall_ms;
+    timings->pipeline_jobs             = jobs_count;
+}
 
-    gfx_pipeline_create_info tri_pipeline_ci = {
-        .type                = GFX_PIPELINE_TYPE_GRAPHICS,
-        .root_sig            = s_RendererSDFInternalState.triangle.root_sig,
-        .shader              = s_RendererSDFInternalState.triangle.shader,
-        .draw_type           = GFX_DRAW_TYPE_TRIANGLE,
-        .polygon_mode        = GFX_POLYGON_MODE_FILL,
-        .cull_mode           = GFX_CULL_MODE_NO_CULL,
-        .enable_depth_test   = false,
-        .enable_depth_write  = false,
-        .enable_transparency = false,
-        .color_formats_count = 1,
-        .color_formats[0]    = GFX_FORMAT_SCREEN,
-    };
-    s_RendererSDFInternalState.triangle.pipeline = g_rhi.create_pipeline(tri_pipeline_ci);
-#endif
+static void renderer_internal_create_shaders_and_pipelines(void)
+{
+    pipeline_build_job jobs[SDF_MAX_PIPELINE_BUILD_JOBS] = {0};
+    uint32_t           jobs_count                        = renderer_internal_fill_pipeline_build_jobs(jobs);
+
+    uint64_t start = timer_now_ns();
+    renderer_internal_run_pipeline_build_jobs(jobs, jobs_count);
+    renderer_internal_record_pipeline_build_timings(jobs, jobs_count, timer_elapsed_ms(start));
 }
 
 static void renderer_internal_destroy_pipelines(void)
 {
 #if !TRIANGLE_TEST
-    g_rhi.destroy_pipeline(&s_RendererSDFInternalState.clear_tex_resources.pipeline);
     g_rhi.destroy_pipeline(&s_RendererSDFInternalState.sdfscene_resources.pipeline);
     g_rhi.destroy_pipeline(&s_RendererSDFInternalState.screen_quad_resources.pipeline);
 #else
@@ -341,7 +689,7 @@ static void renderer_internal_create_scene_pass_descriptor_table(void)
         .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE,
         .width    = 800,
         .height   = 600,
-        .format   = GFX_FORMAT_RGBA32F,
+        .format   = GFX_FORMAT_RGBAUNORM,
         .depth    = 1});
 
     s_RendererSDFInternalState.sdfscene_resources.scene_cs_write_view = g_rhi.create_texture_resource_view((gfx_resource_view_create_info){
@@ -351,7 +699,7 @@ static void renderer_internal_create_scene_pass_descriptor_table(void)
              .base_layer   = 0,
              .mip_levels   = 1,
              .base_mip     = 0,
-             .format       = GFX_FORMAT_RGBA32F,
+             .format       = GFX_FORMAT_RGBAUNORM,
              .texture_type = GFX_TEXTURE_TYPE_2D,
         },
         .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE});
@@ -360,31 +708,75 @@ static void renderer_internal_create_scene_pass_descriptor_table(void)
 
     s_RendererSDFInternalState.sdfscene_resources.scene_nodes_ubo_view = g_rhi.create_uniform_buffer_resource_view(&s_RendererSDFInternalState.sdfscene_resources.scene_nodes_uniform_buffer, MAX_GPU_NODES_SIZE, 0);
 
-    gfx_descriptor_table_entry table_entries[] = {
-        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_nodes_uniform_buffer, &s_RendererSDFInternalState.sdfscene_resources.scene_nodes_ubo_view, {0, 0}},
-        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_texture, &s_RendererSDFInternalState.sdfscene_resources.scene_cs_write_view, {0, 1}},
-    };
-    s_RendererSDFInternalState.sdfscene_resources.tables[0] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.sdfscene_resources.root_sig, &s_RendererSDFInternalState.generic_heap, table_entries, ARRAY_SIZE(table_entries));
-}
+    //--------------------------------------------------
+    // step count heatmap and march counters
+    s_RendererSDFInternalState.sdfscene_resources.heatmap_texture = g_rhi.create_texture_resource((gfx_texture_create_info){
+        .tex_type = GFX_TEXTURE_TYPE_2D,
+        .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE,
+        .width    = 800,
+        .height   = 600,
+        .format   = GFX_FORMAT_R32UINT,
+        .depth    = 1});
 
-static void renderer_internal_create_clear_tex_pass_descriptor_table(void)
-{
-    s_RendererSDFInternalState.clear_tex_resources.shader_read_view = g_rhi.create_texture_resource_view((gfx_resource_view_create_info){
-        .resource = &s_RendererSDFInternalState.sdfscene_resources.scene_texture,
+    s_RendererSDFInternalState.sdfscene_resources.heatmap_view = g_rhi.create_texture_resource_view((gfx_resource_view_create_info){
+        .resource = &s_RendererSDFInternalState.sdfscene_resources.heatmap_texture,
         .texture  = {
              .layer_count  = 1,
              .base_layer   = 0,
              .mip_levels   = 1,
              .base_mip     = 0,
-             .format       = GFX_FORMAT_RGBA32F,
+             .format       = GFX_FORMAT_R32UINT,
              .texture_type = GFX_TEXTURE_TYPE_2D,
         },
         .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE});
 
+    s_RendererSDFInternalState.sdfscene_resources.counters_buffer = g_rhi.create_storage_buffer_resource(sizeof(SDFMarchCounters) * MAX_FRAMES_INFLIGHT);
+    s_RendererSDFInternalState.sdfscene_resources.counters_view   = g_rhi.create_storage_buffer_resource_view(&s_RendererSDFInternalState.sdfscene_resources.counters_buffer, sizeof(SDFMarchCounters) * MAX_FRAMES_INFLIGHT, 0);
+
     gfx_descriptor_table_entry table_entries[] = {
-        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_texture, &s_RendererSDFInternalState.clear_tex_resources.shader_read_view, {0, 0}},
+        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_nodes_uniform_buffer, &s_RendererSDFInternalState.sdfscene_resources.scene_nodes_ubo_view, {0, 0}},
+        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_texture, &s_RendererSDFInternalState.sdfscene_resources.scene_cs_write_view, {0, 1}},
+        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.counters_buffer, &s_RendererSDFInternalState.sdfscene_resources.counters_view, {0, 2}},
+        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.heatmap_texture, &s_RendererSDFInternalState.sdfscene_resources.heatmap_view, {0, 3}},
     };
-    s_RendererSDFInternalState.clear_tex_resources.tables[0] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.clear_tex_resources.root_sig, &s_RendererSDFInternalState.generic_heap, table_entries, ARRAY_SIZE(table_entries));
+    s_RendererSDFInternalState.sdfscene_resources.tables[0] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.sdfscene_resources.root_sig, &s_RendererSDFInternalState.generic_heap, table_entries, ARRAY_SIZE(table_entries));
+}
+
+static void renderer_internal_create_backbuffer_descriptor_tables(void)
+{
+    const gfx_swapchain* swapchain = &s_RendererSDFInternalState.gfxcontext.swapchain;
+    if (!s_RendererSDFInternalState.writeToBackbuffer || !swapchain->supports_storage)
+        return;
+
+    sdf_resources* res = &s_RendererSDFInternalState.sdfscene_resources;
+    for (uint32_t i = 0; i < swapchain->image_count; i++) {
+        res->backbuffer_cs_write_views[i] = g_rhi.create_swapchain_storage_view(swapchain, i);
+
+        // storage image entries are resolved from the view alone
+        gfx_descriptor_table_entry table_entries[] = {
+            (gfx_descriptor_table_entry){&res->scene_nodes_uniform_buffer, &res->scene_nodes_ubo_view, {0, 0}},
+            (gfx_descriptor_table_entry){NULL, &res->backbuffer_cs_write_views[i], {0, 1}},
+            (gfx_descriptor_table_entry){&res->counters_buffer, &res->counters_view, {0, 2}},
+            (gfx_descriptor_table_entry){&res->heatmap_texture, &res->heatmap_view, {0, 3}},
+        };
+        res->backbuffer_tables[i] = g_rhi.build_descriptor_table(&res->root_sig, &s_RendererSDFInternalState.generic_heap, table_entries, ARRAY_SIZE(table_entries));
+    }
+    s_RendererSDFInternalState.backbufferTablesBuilt = true;
+}
+
+static void renderer_internal_destroy_backbuffer_descriptor_tables(void)
+{
+    if (!s_RendererSDFInternalState.backbufferTablesBuilt)
+        return;
+
+    sdf_resources* res = &s_RendererSDFInternalState.sdfscene_resources;
+    for (uint32_t i = 0; i < MAX_BACKBUFFERS; i++) {
+        if (!uuid_is_null(&res->backbuffer_tables[i].uuid))
+            g_rhi.destroy_descriptor_table(&res->backbuffer_tables[i]);
+        if (!uuid_is_null(&res->backbuffer_cs_write_views[i].uuid))
+            g_rhi.destroy_texture_resource_view(&res->backbuffer_cs_write_views[i]);
+    }
+    s_RendererSDFInternalState.backbufferTablesBuilt = false;
 }
 
 static void renderer_internal_create_screen_pass_descriptor_table(void)
@@ -396,7 +788,7 @@ static void renderer_internal_create_screen_pass_descriptor_table(void)
              .base_layer   = 0,
              .mip_levels   = 1,
              .base_mip     = 0,
-             .format       = GFX_FORMAT_RGBA32F,
+             .format       = GFX_FORMAT_RGBAUNORM,
              .texture_type = GFX_TEXTURE_TYPE_2D,
         },
         .res_type = GFX_RESOURCE_TYPE_SAMPLED_IMAGE});
@@ -414,24 +806,275 @@ static void renderer_internal_create_screen_pass_descriptor_table(void)
         .resource = &s_RendererSDFInternalState.screen_quad_resources.scene_tex_sampler,
         .res_type = GFX_RESOURCE_TYPE_SAMPLER});
 
-    gfx_descriptor_table_entry entry_0                         = (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_texture, &s_RendererSDFInternalState.screen_quad_resources.shader_read_view, {0, 0}};
+    if (renderer_internal_use_bindless()) {
+        gfx_bindless_heap*     heap = &s_RendererSDFInternalState.bindless_heap;
+        screen_quad_resoruces* res  = &s_RendererSDFInternalState.screen_quad_resources;
+        res->scene_texture_slot     = g_rhi.bindless_register(heap, &s_RendererSDFInternalState.sdfscene_resources.scene_texture, &res->shader_read_view);
+        res->heatmap_slot           = g_rhi.bindless_register(heap, &s_RendererSDFInternalState.sdfscene_resources.heatmap_texture, &s_RendererSDFInternalState.sdfscene_resources.heatmap_view);
+        res->sampler_slot           = g_rhi.bindless_register(heap, &res->scene_tex_sampler, &res->sampler_view);
+        return;
+    }
+
+    gfx_descriptor_table_entry entries_0[] = {
+        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.scene_texture, &s_RendererSDFInternalState.screen_quad_resources.shader_read_view, {0, 0}},
+        (gfx_descriptor_table_entry){&s_RendererSDFInternalState.sdfscene_resources.heatmap_texture, &s_RendererSDFInternalState.sdfscene_resources.heatmap_view, {0, 1}},
+    };
     gfx_descriptor_table_entry entry_1                         = (gfx_descriptor_table_entry){&s_RendererSDFInternalState.screen_quad_resources.scene_tex_sampler, &s_RendererSDFInternalState.screen_quad_resources.sampler_view, {1, 0}};
-    s_RendererSDFInternalState.screen_quad_resources.tables[0] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.screen_quad_resources.root_sig, &s_RendererSDFInternalState.generic_heap, &entry_0, 1);
+    s_RendererSDFInternalState.screen_quad_resources.tables[0] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.screen_quad_resources.root_sig, &s_RendererSDFInternalState.generic_heap, entries_0, ARRAY_SIZE(entries_0));
     s_RendererSDFInternalState.screen_quad_resources.tables[1] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.screen_quad_resources.root_sig, &s_RendererSDFInternalState.samplers_heap, &entry_1, 1);
 }
+
+static void renderer_internal_create_async_compute_resources(void)
+{
+    if (!s_RendererSDFInternalState.gfxcontext.async_compute.is_supported)
+        return;
+
+    sdf_resources*           res   = &s_RendererSDFInternalState.sdfscene_resources;
+    async_compute_resources* async = &s_RendererSDFInternalState.async_compute;
+    for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
+        async->scene_textures[i] = g_rhi.create_texture_resource((gfx_texture_create_info){
+            .tex_type = GFX_TEXTURE_TYPE_2D,
+            .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE,
+            .width    = 800,
+            .height   = 600,
+            .format   = GFX_FORMAT_RGBAUNORM,
+            .depth    = 1});
+
+        gfx_resource_view_create_info view_ci = {
+            .resource = &async->scene_textures[i],
+            .texture  = {
+                 .layer_count  = 1,
+                 .base_layer   = 0,
+                 .mip_levels   = 1,
+                 .base_mip     = 0,
+                 .format       = GFX_FORMAT_RGBAUNORM,
+                 .texture_type = GFX_TEXTURE_TYPE_2D,
+            },
+            .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE};
+        async->cs_write_views[i] = g_rhi.create_texture_resource_view(view_ci);
+
+        view_ci.res_type            = GFX_RESOURCE_TYPE_SAMPLED_IMAGE;
+        async->shader_read_views[i] = g_rhi.create_texture_resource_view(view_ci);
+
+        gfx_descriptor_table_entry scene_entries[] = {
+            (gfx_descriptor_table_entry){&res->scene_nodes_uniform_buffer, &res->scene_nodes_ubo_view, {0, 0}},
+            (gfx_descriptor_table_entry){&async->scene_textures[i], &async->cs_write_views[i], {0, 1}},
+            (gfx_descriptor_table_entry){&res->counters_buffer, &res->counters_view, {0, 2}},
+            (gfx_descriptor_table_entry){&res->heatmap_texture, &res->heatmap_view, {0, 3}},
+        };
+        async->scene_tables[i] = g_rhi.build_descriptor_table(&res->root_sig, &s_RendererSDFInternalState.generic_heap, scene_entries, ARRAY_SIZE(scene_entries));
+
+        if (renderer_internal_use_bindless()) {
+            async->screen_quad_slots[i] = g_rhi.bindless_register(&s_RendererSDFInternalState.bindless_heap, &async->scene_textures[i], &async->shader_read_views[i]);
+            continue;
+        }
+
+        gfx_descriptor_table_entry screen_quad_entries[] = {
+            (gfx_descriptor_table_entry){&async->scene_textures[i], &async->shader_read_views[i], {0, 0}},
+            (gfx_descriptor_table_entry){&res->heatmap_texture, &res->heatmap_view, {0, 1}},
+        };
+        async->screen_quad_tables[i] = g_rhi.build_descriptor_table(&s_RendererSDFInternalState.screen_quad_resources.root_sig, &s_RendererSDFInternalState.generic_heap, screen_quad_entries, ARRAY_SIZE(screen_quad_entries));
+    }
+
+    async->created = true;
+    async->enabled = true;
+}
+
+static void renderer_internal_destroy_async_compute_resources(void)
+{
+    async_compute_resources* async = &s_RendererSDFInternalState.async_compute;
+    if (!async->created)
+        return;
+
+    for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
+        g_rhi.destroy_descriptor_table(&async->scene_tables[i]);
+        if (renderer_internal_use_bindless())
+            g_rhi.bindless_release(&s_RendererSDFInternalState.bindless_heap, async->screen_quad_slots[i]);
+        else
+            g_rhi.destroy_descriptor_table(&async->screen_quad_tables[i]);
+        g_rhi.destroy_texture_resource_view(&async->cs_write_views[i]);
+        g_rhi.destroy_texture_resource_view(&async->shader_read_views[i]);
+        g_rhi.destroy_texture_resource(&async->scene_textures[i]);
+    }
+    *async = (async_compute_resources){0};
+}
 #endif
 
-static void renderer_internal_hot_reload_shaders(void)
+//---------------------------------------------------------
+// Shader hot reload: pipelines are rebuilt on a background thread when
+// game/shaders_built changes and swapped in at the start of a frame.
+// The old ones are destroyed once every frame that recorded them retired.
+
+static void renderer_internal_destroy_retired_pipelines(bool gpu_idle)
 {
-    g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
+    shader_reload_state* reload = &s_RendererSDFInternalState.shader_reload;
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < reload->retired_count; i++) {
+        retired_pipeline* retired = &reload->retired[i];
+        if (gpu_idle || s_RendererSDFInternalState.frameCount >= retired->retire_frame + MAX_FRAMES_INFLIGHT) {
+            g_rhi.destroy_pipeline(&retired->pipeline);
+            if (retired->is_compute)
+                g_rhi.destroy_compute_shader(&retired->shader);
+            else
+                g_rhi.destroy_vs_ps_shader(&retired->shader);
+        } else {
+            reload->retired[kept++] = *retired;
+        }
+    }
+    reload->retired_count = kept;
+}
 
-    renderer_internal_destroy_shaders();
-    renderer_internal_destroy_pipelines();
+static void renderer_internal_shader_reload_proc(void* arg)
+{
+    shader_reload_state* reload = arg;
 
-    renderer_internal_create_shaders();
-    renderer_internal_create_pipelines();
+    // serial on this thread, the main thread keeps recording frames with the job system meanwhile
+    uint64_t start = timer_now_ns();
+    for (uint32_t i = 0; i < reload->jobs_count; i++)
+        renderer_internal_run_pipeline_build_job(&reload->jobs[i]);
+    reload->build_ms = timer_elapsed_ms(start);
 
-    g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
+    atomic_store_u32(&reload->build_done, 1);
+}
+
+static void renderer_internal_start_shader_reload(void)
+{
+    shader_reload_state* reload = &s_RendererSDFInternalState.shader_reload;
+
+    reload->change_pending = false;
+    reload->jobs_count     = renderer_internal_fill_pipeline_build_jobs(reload->jobs);
+
+    // build into staging, the live pipelines are still used by the frames being recorded meanwhile
+    for (uint32_t i = 0; i < reload->jobs_count; i++) {
+        reload->live_shaders[i]      = reload->jobs[i].shader_out;
+        reload->live_pipelines[i]    = reload->jobs[i].pipeline_out;
+        reload->jobs[i].shader_out   = &reload->staged_shaders[i];
+        reload->jobs[i].pipeline_out = &reload->staged_pipelines[i];
+    }
+
+    atomic_store_u32(&reload->build_done, 0);
+    reload->building = true;
+    reload->threaded = thread_create(&reload->thread, renderer_internal_shader_reload_proc, reload);
+    if (!reload->threaded)
+        renderer_internal_shader_reload_proc(reload);
+}
+
+static void renderer_internal_finish_shader_reload(void)
+{
+    shader_reload_state* reload = &s_RendererSDFInternalState.shader_reload;
+
+    if (reload->threaded)
+        thread_join(&reload->thread);
+    reload->building = false;
+
+    // retired list is full only when reloads outpace the frames in flight, fall back to a stall
+    if (reload->retired_count + reload->jobs_count > SDF_MAX_RETIRED_PIPELINES) {
+        g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
+        renderer_internal_destroy_retired_pipelines(true);
+    }
+
+    for (uint32_t i = 0; i < reload->jobs_count; i++) {
+        reload->retired[reload->retired_count++] = (retired_pipeline){
+            .shader       = *reload->live_shaders[i],
+            .pipeline     = *reload->live_pipelines[i],
+            .retire_frame = s_RendererSDFInternalState.frameCount,
+            .is_compute   = reload->jobs[i].cs_path != NULL,
+        };
+        *reload->live_shaders[i]   = reload->staged_shaders[i];
+        *reload->live_pipelines[i] = reload->staged_pipelines[i];
+    }
+
+    renderer_internal_record_pipeline_build_timings(reload->jobs, reload->jobs_count, reload->build_ms);
+    reload->reload_count++;
+
+#if !TRIANGLE_TEST
+    // the new shaders may draw something else, the next frame marches everything again
+    s_RendererSDFInternalState.redraw.history_valid = false;
+#endif
+
+    LOG_INFO("[Renderer] Hot reloaded %u pipelines in %.2f ms on a background thread", reload->jobs_count, reload->build_ms);
+}
+
+// Called at the start of every frame, before frame_begin
+static void renderer_internal_update_shader_reload(void)
+{
+    shader_reload_state* reload     = &s_RendererSDFInternalState.shader_reload;
+    const GameState*     game_state = gamestate_get_global_instance();
+
+    // SPACE still forces a reload, edge triggered so holding it doesn't queue rebuilds
+    bool key_down = game_state->keycodes[GLFW_KEY_SPACE] == GLFW_PRESS;
+    if (key_down && !reload->key_was_down) {
+        reload->change_pending = true;
+        reload->last_change_ns = 0;
+    }
+    reload->key_was_down = key_down;
+
+    if (file_watcher_poll(&reload->watcher)) {
+        reload->change_pending = true;
+        reload->last_change_ns = timer_now_ns();
+    }
+
+    renderer_internal_destroy_retired_pipelines(false);
+
+    if (reload->building) {
+        if (!atomic_load_u32(&reload->build_done))
+            return;
+        renderer_internal_finish_shader_reload();
+    }
+
+    // a shader rebuild writes several files back to back, wait for it to settle
+    if (reload->change_pending && timer_elapsed_ms(reload->last_change_ns) >= SDF_SHADER_RELOAD_DEBOUNCE_MS)
+        renderer_internal_start_shader_reload();
+}
+
+static void renderer_internal_destroy_shader_reload(void)
+{
+    shader_reload_state* reload = &s_RendererSDFInternalState.shader_reload;
+
+    // GPU is idle here, an unfinished build is joined and swapped so it's destroyed with the rest
+    if (reload->building)
+        renderer_internal_finish_shader_reload();
+    renderer_internal_destroy_retired_pipelines(true);
+
+    file_watcher_destroy(&reload->watcher);
+}
+
+static void renderer_internal_destroy_thread_cmd(gfx_thread_cmd* thread_cmd)
+{
+    for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
+        g_rhi.destroy_gfx_cmd_pool(&thread_cmd->pool[i]);
+        if (!uuid_is_null(&thread_cmd->cmds[i].uuid))
+            g_rhi.free_gfx_cmd_buf(&thread_cmd->cmds[i]);
+    }
+    *thread_cmd = (gfx_thread_cmd){0};
+}
+
+// Grows the per-thread pools up to count, they are only released with the context
+static uint32_t renderer_internal_create_thread_cmds(uint32_t count)
+{
+    gfx_context* ctx = &s_RendererSDFInternalState.gfxcontext;
+
+    // backend without secondary command buffers, recording stays single threaded
+    while (ctx->supports.secondary_cmds && ctx->thread_cmds_count < count) {
+        gfx_thread_cmd* thread_cmd = &ctx->thread_cmds[ctx->thread_cmds_count];
+
+        bool created = true;
+        for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
+            thread_cmd->pool[i] = g_rhi.create_gfx_cmd_pool();
+            thread_cmd->cmds[i] = g_rhi.create_secondary_gfx_cmd_buf(&thread_cmd->pool[i]);
+            created             = created && !uuid_is_null(&thread_cmd->cmds[i].uuid);
+        }
+
+        // out of pools, record with the threads created so far
+        if (!created) {
+            renderer_internal_destroy_thread_cmd(thread_cmd);
+            break;
+        }
+        ctx->thread_cmds_count++;
+    }
+
+    return ctx->thread_cmds_count;
 }
 
 static bool render_internal_sdf_init_gfx_ctx(uint32_t width, uint32_t height)
@@ -452,10 +1095,34 @@ static bool render_internal_sdf_init_gfx_ctx(uint32_t width, uint32_t height)
             s_RendererSDFInternalState.gfxcontext.draw_cmds[i]      = g_rhi.create_gfx_cmd_buf(&s_RendererSDFInternalState.gfxcontext.draw_cmds_pool[i]);
         }
 
+        // the caller records a chunk too, so one thread per worker plus itself
+        renderer_sdf_set_record_threads(job_system_get_worker_count() + 1);
+
+        for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT && s_RendererSDFInternalState.gfxcontext.async_compute.is_supported; i++) {
+            s_RendererSDFInternalState.gfxcontext.compute_cmds_pool[i] = g_rhi.create_async_compute_cmd_pool();
+            s_RendererSDFInternalState.gfxcontext.compute_cmds[i]      = g_rhi.create_gfx_cmd_buf(&s_RendererSDFInternalState.gfxcontext.compute_cmds_pool[i]);
+        }
+
         // Create the global pools
         s_RendererSDFInternalState.generic_heap  = g_rhi.create_descriptor_heap(GFX_HEAP_TYPE_SRV_UAV_CBV, 1024);
         s_RendererSDFInternalState.samplers_heap = g_rhi.create_descriptor_heap(GFX_HEAP_TYPE_SAMPLER, 1024);
 
+        // the backend may not implement bindless heaps at all
+        if (g_gfxConfig.use_bindless && !s_RendererSDFInternalState.gfxcontext.supports.bindless) {
+            LOG_WARN("[Renderer] bindless heaps are not supported by this backend, falling back to descriptor tables");
+            g_gfxConfig.use_bindless = false;
+        }
+
+        // the bindless screen quad isn't part of every shader build, stay on descriptor tables without it
+        if (g_gfxConfig.use_bindless && !renderer_internal_shader_binary_exists(SDF_SCREEN_QUAD_BINDLESS_PS)) {
+            LOG_WARN("[Renderer] %s is not built, falling back to descriptor tables", SDF_SCREEN_QUAD_BINDLESS_PS);
+            g_gfxConfig.use_bindless = false;
+        }
+
+        // passes on the bindless heap push indices instead of binding their own tables
+        if (g_gfxConfig.use_bindless)
+            s_RendererSDFInternalState.bindless_heap = g_rhi.create_bindless_heap(SDF_BINDLESS_RESOURCES, SDF_BINDLESS_SAMPLERS, SDF_BINDLESS_PUSH_CONSTANT_SIZE);
+
         return true;
     } else {
         LOG_ERROR("Failed to create gfx backend!");
@@ -467,24 +1134,36 @@ static void renderer_internal_sdf_destroy_gfx_ctx(void)
 {
     g_rhi.destroy_descriptor_heap(&s_RendererSDFInternalState.generic_heap);
     g_rhi.destroy_descriptor_heap(&s_RendererSDFInternalState.samplers_heap);
+    if (renderer_internal_use_bindless())
+        g_rhi.destroy_bindless_heap(&s_RendererSDFInternalState.bindless_heap);
 
     for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT; i++) {
         g_rhi.destroy_gfx_cmd_pool(&s_RendererSDFInternalState.gfxcontext.draw_cmds_pool[i]);
         g_rhi.free_gfx_cmd_buf(&s_RendererSDFInternalState.gfxcontext.draw_cmds[i]);
     }
+
+    for (uint32_t i = 0; i < MAX_FRAMES_INFLIGHT && s_RendererSDFInternalState.gfxcontext.async_compute.is_supported; i++) {
+        g_rhi.destroy_gfx_cmd_pool(&s_RendererSDFInternalState.gfxcontext.compute_cmds_pool[i]);
+        g_rhi.free_gfx_cmd_buf(&s_RendererSDFInternalState.gfxcontext.compute_cmds[i]);
+    }
+
+    for (uint32_t i = 0; i < s_RendererSDFInternalState.gfxcontext.thread_cmds_count; i++)
+        renderer_internal_destroy_thread_cmd(&s_RendererSDFInternalState.gfxcontext.thread_cmds[i]);
+    s_RendererSDFInternalState.gfxcontext.thread_cmds_count = 0;
+    s_RendererSDFInternalState.cmd_record                   = (cmd_record_state){0};
 }
 
 static void renderer_internal_create_sdf_pass_resources(void)
 {
-    // create the shaders and pipeline
-    renderer_internal_create_shaders();
+    // root signatures first, the pipeline jobs reference them
     renderer_internal_create_root_sigs();
-    renderer_internal_create_pipelines();
+    renderer_internal_create_shaders_and_pipelines();
 
 #if !TRIANGLE_TEST
     renderer_internal_create_scene_pass_descriptor_table();
-    renderer_internal_create_clear_tex_pass_descriptor_table();
     renderer_internal_create_screen_pass_descriptor_table();
+    renderer_internal_create_backbuffer_descriptor_tables();
+    renderer_internal_create_async_compute_resources();
 #endif
 
     g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
@@ -497,13 +1176,26 @@ static void renderer_internal_destroy_sdf_pass_resources(void)
     renderer_internal_destroy_pipelines();
 
 #if !TRIANGLE_TEST
-    g_rhi.destroy_texture_resource_view(&s_RendererSDFInternalState.clear_tex_resources.shader_read_view);
+    renderer_internal_destroy_backbuffer_descriptor_tables();
+    renderer_internal_destroy_async_compute_resources();
 
     g_rhi.destroy_texture_resource(&s_RendererSDFInternalState.sdfscene_resources.scene_texture);
     g_rhi.destroy_texture_resource_view(&s_RendererSDFInternalState.sdfscene_resources.scene_cs_write_view);
     g_rhi.destroy_uniform_buffer_resource(&s_RendererSDFInternalState.sdfscene_resources.scene_nodes_uniform_buffer);
     g_rhi.destroy_uniform_buffer_resource_view(&s_RendererSDFInternalState.sdfscene_resources.scene_nodes_ubo_view);
 
+    g_rhi.destroy_texture_resource(&s_RendererSDFInternalState.sdfscene_resources.heatmap_texture);
+    g_rhi.destroy_texture_resource_view(&s_RendererSDFInternalState.sdfscene_resources.heatmap_view);
+    if (s_RendererSDFInternalState.sdfscene_resources.counters_buffer.ubo) {
+        g_rhi.destroy_storage_buffer_resource(&s_RendererSDFInternalState.sdfscene_resources.counters_buffer);
+        g_rhi.destroy_storage_buffer_resource_view(&s_RendererSDFInternalState.sdfscene_resources.counters_view);
+    }
+
+    if (renderer_internal_use_bindless()) {
+        g_rhi.bindless_release(&s_RendererSDFInternalState.bindless_heap, s_RendererSDFInternalState.screen_quad_resources.scene_texture_slot);
+        g_rhi.bindless_release(&s_RendererSDFInternalState.bindless_heap, s_RendererSDFInternalState.screen_quad_resources.heatmap_slot);
+        g_rhi.bindless_release(&s_RendererSDFInternalState.bindless_heap, s_RendererSDFInternalState.screen_quad_resources.sampler_slot);
+    }
     g_rhi.destroy_texture_resource_view(&s_RendererSDFInternalState.screen_quad_resources.shader_read_view);
     g_rhi.destroy_sampler_resource_view(&s_RendererSDFInternalState.screen_quad_resources.sampler_view);
     g_rhi.destroy_sampler(&s_RendererSDFInternalState.screen_quad_resources.scene_tex_sampler);
@@ -511,77 +1203,482 @@ static void renderer_internal_destroy_sdf_pass_resources(void)
 }
 
 #if !TRIANGLE_TEST
-static void renderer_internal_scene_clear_pass(gfx_cmd_buf* cmd_buff)
+static bool renderer_internal_march_counters_enabled(void)
 {
-    const SDF_Scene* scene = s_RendererSDFInternalState.scene;
+    return s_RendererSDFInternalState.march_debug.counters_enabled && s_RendererSDFInternalState.sdfscene_resources.counters_buffer.ubo;
+}
 
-    if (!scene)
-        return;
+static int renderer_internal_march_debug_flags(void)
+{
+    int flags = 0;
+    if (renderer_internal_march_counters_enabled())
+        flags |= SDF_DEBUG_FLAG_COUNTERS;
+    if (s_RendererSDFInternalState.march_debug.view == SDF_DEBUG_VIEW_STEP_HEATMAP)
+        flags |= SDF_DEBUG_FLAG_HEATMAP_STEPS;
+    else if (s_RendererSDFInternalState.march_debug.view == SDF_DEBUG_VIEW_NODE_HEATMAP)
+        flags |= SDF_DEBUG_FLAG_HEATMAP_NODES;
+    return flags;
+}
 
-    gfx_render_pass scene_clear_pass = {.is_compute_pass = true};
-    g_rhi.begin_render_pass(cmd_buff, scene_clear_pass, s_RendererSDFInternalState.gfxcontext.swapchain.current_backbuffer_idx);
-    {
-        g_rhi.bind_root_signature(cmd_buff, &s_RendererSDFInternalState.clear_tex_resources.root_sig, GFX_PIPELINE_TYPE_COMPUTE);
-        g_rhi.bind_compute_pipeline(cmd_buff, &s_RendererSDFInternalState.clear_tex_resources.pipeline);
+// The heatmap and counters are shared by every in-flight slot, debug views stay on the gfx queue.
+// Takes precedence over raymarching into the backbuffer
+static bool renderer_internal_use_async_compute(void)
+{
+    const async_compute_resources* async = &s_RendererSDFInternalState.async_compute;
+    if (!async->created || !async->enabled || s_RendererSDFInternalState.redraw.mode != SCENE_REDRAW_FULL)
+        return false;
+    return renderer_internal_march_debug_flags() == 0;
+}
+
+static bool renderer_internal_is_drawing_to_backbuffer(void)
+{
+    // partial and skipped frames build on last frame's scene texture
+    if (s_RendererSDFInternalState.redraw.mode != SCENE_REDRAW_FULL)
+        return false;
+    // the heatmap is only visualized by the screen quad
+    if (s_RendererSDFInternalState.march_debug.view != SDF_DEBUG_VIEW_NONE)
+        return false;
+    // a compute queue overlaps the raymarch with the previous frame, that beats skipping the screen quad
+    if (renderer_internal_use_async_compute())
+        return false;
+    return s_RendererSDFInternalState.backbufferTablesBuilt && s_RendererSDFInternalState.gfxcontext.swapchain.supports_storage;
+}
+
+// Reads back the counters this in-flight slot recorded last time and re-arms it for the current frame
+static void renderer_internal_resolve_march_counters(void)
+{
+    march_debug_state* dbg  = &s_RendererSDFInternalState.march_debug;
+    uint32_t           slot = s_RendererSDFInternalState.gfxcontext.inflight_frame_idx;
+    gfx_resource*      buf  = &s_RendererSDFInternalState.sdfscene_resources.counters_buffer;
+
+    if (dbg->slot_recorded[slot]) {
+        SDFMarchCounters counters = {0};
+        g_rhi.read_storage_buffer(buf, sizeof(SDFMarchCounters), slot * sizeof(SDFMarchCounters), &counters);
+
+        renderer_sdf_march_stats* stats = &dbg->stats;
+        stats->frame                    = dbg->slot_frame[slot];
+        stats->rays                     = counters.rays;
+        stats->total_steps              = ((uint64_t) counters.steps_hi << 32) | counters.steps_lo;
+        stats->total_node_evals         = ((uint64_t) counters.node_evals_hi << 32) | counters.node_evals_lo;
+        stats->mean_steps               = counters.rays ? (double) stats->total_steps / (double) counters.rays : 0.0;
+        stats->mean_node_evals          = counters.rays ? (double) stats->total_node_evals / (double) counters.rays : 0.0;
+        stats->min_steps                = counters.rays ? counters.min_steps : 0;
+        stats->max_steps                = counters.max_steps_node >> 16;
+        stats->max_steps_node           = counters.rays ? (int32_t) (counters.max_steps_node & 0xFFFF) : -1;
+        memcpy(stats->histogram, counters.histogram, sizeof(stats->histogram));
+
+        dbg->stats_valid         = true;
+        dbg->slot_recorded[slot] = false;
+    }
+
+    if (renderer_internal_march_counters_enabled()) {
+        SDFMarchCounters reset = {0};
+        reset.min_steps        = UINT32_MAX;
+        g_rhi.update_storage_buffer(buf, sizeof(SDFMarchCounters), slot * sizeof(SDFMarchCounters), &reset);
+
+        dbg->slot_recorded[slot] = true;
+        dbg->slot_frame[slot]    = s_RendererSDFInternalState.frameCount;
+    }
+}
+
+// Non-ref nodes in draw order, a single clear-only dispatch when there are none
+static uint32_t renderer_internal_gather_scene_dispatches(const SDF_Scene* scene, int32_t* dispatch_nodes)
+{
+    uint32_t dispatch_count = 0;
+    for (uint32_t i = 0; i < scene->current_node_head; ++i) {
+        if (scene->nodes[i].is_ref_node) continue;
+        dispatch_nodes[dispatch_count++] = (int32_t) i;
+    }
+
+    // Nothing was drawn, still clear the target
+    if (dispatch_count == 0)
+        dispatch_nodes[dispatch_count++] = -1;
+
+    return dispatch_count;
+}
+
+//---------------------------------------------------------
+// Incremental redraw: idle frames re-present the scene texture, small changes only re-march
+// the union of the changed nodes' old and new screen rects. Node dispatches overwrite each
+// other on hit without a depth test, so every node is re-marched inside the rect.
+
+// Smooth blends pull the surface out by up to k/4 (k = 0.5 in sceneSDF), hits land up to RAY_MIN_STEP early
+#define SDF_SMOOTH_BLEND_MARGIN 0.125f
+#define SDF_HIT_MARGIN          0.01f
+#define SDF_MAX_SUBTREE_NODES   64
+
+static mat4s renderer_internal_scene_view_proj(void)
+{
+    const Camera camera     = gamestate_get_global_instance()->camera;
+    mat4s        projection = glms_perspective(camera.fov, (float) s_RendererSDFInternalState.width / (float) s_RendererSDFInternalState.height, camera.near_plane, camera.far_plane);
+    return glms_mul(projection, camera.lookAt);
+}
+
+static uint32_t renderer_internal_rect_area(screen_rect rect)
+{
+    if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1)
+        return 0;
+    return (rect.x1 - rect.x0) * (rect.y1 - rect.y0);
+}
+
+static screen_rect renderer_internal_rect_union(screen_rect a, screen_rect b)
+{
+    if (renderer_internal_rect_area(a) == 0)
+        return b;
+    if (renderer_internal_rect_area(b) == 0)
+        return a;
+
+    return (screen_rect){
+        .x0 = a.x0 < b.x0 ? a.x0 : b.x0,
+        .y0 = a.y0 < b.y0 ? a.y0 : b.y0,
+        .x1 = a.x1 > b.x1 ? a.x1 : b.x1,
+        .y1 = a.y1 > b.y1 ? a.y1 : b.y1,
+    };
+}
+
+static screen_rect renderer_internal_full_screen_rect(void)
+{
+    return (screen_rect){0, 0, s_RendererSDFInternalState.width, s_RendererSDFInternalState.height};
+}
+
+// Loose radius around the primitive origin before scaling, negative when unbounded. The packed params
+// are extents, radii and offsets so their sum bounds the other shapes, 2/sqrt(3) covers the hex prism corners
+static float renderer_internal_primitive_radius(const SDF_NodeGPUData* node)
+{
+    switch (node->primType) {
+        case SDF_PRIM_Plane: return -1.0f;
+        case SDF_PRIM_Cone: {
+            // apex at the origin, the slant height reaches the furthest base point
+            float cos_angle = fabsf(cosf(node->packed_params[0].x));
+            return cos_angle > 1e-3f ? fabsf(node->packed_params[0].y) / cos_angle : -1.0f;
+        }
+        default: {
+            float sum = 0.0f;
+            for (uint32_t v = 0; v < 2; v++)
+                for (uint32_t c = 0; c < 4; c++)
+                    sum += fabsf(node->packed_params[v].raw[c]);
+            return sum * 1.1548f;
+        }
+    }
+}
+
+// False when the sphere reaches behind the camera, inverse of the uv -> NDC mapping in raymarch_sdf_scene.comp
+static bool renderer_internal_project_sphere(mat4s view_proj, vec3s center, float radius, screen_rect* rect)
+{
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+    for (uint32_t i = 0; i < 8; i++) {
+        vec4s corner = {{center.x + ((i & 1) ? radius : -radius), center.y + ((i & 2) ? radius : -radius), center.z + ((i & 4) ? radius : -radius), 1.0f}};
+        vec4s clip   = glms_mat4_mulv(view_proj, corner);
+        if (clip.w <= 1e-4f)
+            return false;
+
+        float x = clip.x / clip.w;
+        float y = clip.y / clip.w;
+        min_x   = x < min_x ? x : min_x;
+        max_x   = x > max_x ? x : max_x;
+        min_y   = y < min_y ? y : min_y;
+        max_y   = y > max_y ? y : max_y;
+    }
+
+    // ndc y points up, pixel rows down, one extra pixel against rounding
+    float width  = (float) s_RendererSDFInternalState.width;
+    float height = (float) s_RendererSDFInternalState.height;
+    float x0     = floorf((min_x * 0.5f + 0.5f) * width) - 1.0f;
+    float x1     = ceilf((max_x * 0.5f + 0.5f) * width) + 1.0f;
+    float y0     = floorf((0.5f - max_y * 0.5f) * height) - 1.0f;
+    float y1     = ceilf((0.5f - min_y * 0.5f) * height) + 1.0f;
+
+    rect->x0 = (uint32_t) (x0 < 0.0f ? 0.0f : (x0 > width ? width : x0));
+    rect->x1 = (uint32_t) (x1 < 0.0f ? 0.0f : (x1 > width ? width : x1));
+    rect->y0 = (uint32_t) (y0 < 0.0f ? 0.0f : (y0 > height ? height : y0));
+    rect->y1 = (uint32_t) (y1 < 0.0f ? 0.0f : (y1 > height ? height : y1));
+    return true;
+}
+
+// Nodes sceneSDF visits for this dispatch, UINT32_MAX when the tree is too deep or points out of the scene
+static uint32_t renderer_internal_collect_subtree(const SDF_NodeGPUData* nodes, uint32_t node_count, int32_t root, int32_t* subtree, bool* smooth)
+{
+    int32_t  stack[SDF_MAX_SUBTREE_NODES];
+    bool     stack_smooth[SDF_MAX_SUBTREE_NODES];
+    uint32_t sp    = 0;
+    uint32_t count = 0;
+
+    stack[sp]          = root;
+    stack_smooth[sp++] = false;
+    while (sp > 0) {
+        sp--;
+        int32_t idx = stack[sp];
+        if (idx < 0)
+            continue;
+        if ((uint32_t) idx >= node_count || count == SDF_MAX_SUBTREE_NODES)
+            return UINT32_MAX;
+
+        subtree[count]  = idx;
+        smooth[count++] = stack_smooth[sp];
+
+        const SDF_NodeGPUData* node = &nodes[idx];
+        if (node->nodeType == SDF_NODE_OBJECT) {
+            if (sp + 2 > SDF_MAX_SUBTREE_NODES)
+                return UINT32_MAX;
+            bool is_smooth     = node->blend >= SDF_BLEND_SMOOTH_UNION;
+            stack[sp]          = node->prim_b;
+            stack_smooth[sp++] = is_smooth;
+            stack[sp]          = node->prim_a;
+            stack_smooth[sp++] = is_smooth;
+        }
+    }
+    return count;
+}
+
+// Primitives are placed by the dispatch node's transform times their own, objects only forward it (see sceneSDF)
+// Full screen when a primitive is unbounded or reaches behind the camera
+static screen_rect renderer_internal_node_screen_rect(const SDF_NodeGPUData* nodes, const int32_t* subtree, const bool* smooth, uint32_t count, mat4s view_proj)
+{
+    if (count == UINT32_MAX)
+        return renderer_internal_full_screen_rect();
+
+    // sceneSDF folds every primitive into one running distance, so smooth blends add up
+    float margin = SDF_HIT_MARGIN;
+    for (uint32_t i = 0; i < count; i++)
+        if (smooth[i] && nodes[subtree[i]].nodeType == SDF_NODE_PRIMITIVE)
+            margin += SDF_SMOOTH_BLEND_MARGIN;
+
+    mat4s       root_transform = nodes[subtree[0]].transform;
+    screen_rect rect           = {0};
+    for (uint32_t i = 0; i < count; i++) {
+        const SDF_NodeGPUData* node = &nodes[subtree[i]];
+        if (node->nodeType != SDF_NODE_PRIMITIVE)
+            continue;
+
+        float radius = renderer_internal_primitive_radius(node);
+        if (radius < 0.0f)
+            return renderer_internal_full_screen_rect();
+
+        mat4s       world  = glms_mul(root_transform, node->transform);
+        vec3s       center = {{world.col[3].x, world.col[3].y, world.col[3].z}};
+        screen_rect prim_rect;
+        if (!renderer_internal_project_sphere(view_proj, center, radius * node->scale + margin, &prim_rect))
+            return renderer_internal_full_screen_rect();
+
+        rect = renderer_internal_rect_union(rect, prim_rect);
+    }
+    return rect;
+}
+
+// Picks this frame's redraw mode, before the async compute and frame graph decisions that depend on it
+static void renderer_internal_plan_scene_redraw(const SDF_Scene* scene)
+{
+    redraw_state* redraw      = &s_RendererSDFInternalState.redraw;
+    uint32_t      full_pixels = s_RendererSDFInternalState.width * s_RendererSDFInternalState.height;
+
+    redraw->mode = SCENE_REDRAW_FULL;
+    redraw->rect = renderer_internal_full_screen_rect();
+
+    // debug views and counters want every pixel of every frame
+    if (redraw->enabled && renderer_internal_march_debug_flags() == 0) {
+        const SDF_NodeGPUData* nodes      = sdf_scene_get_scene_nodes_gpu_data(scene);
+        uint32_t               node_count = scene->current_node_head;
+        mat4s                  view_proj  = renderer_internal_scene_view_proj();
+
+        // a moved camera or a changed node list changes every rect
+        bool relayout = node_count != redraw->marched_node_count || memcmp(&view_proj, &redraw->marched_view_proj, sizeof(mat4s)) != 0;
+
+        int32_t     dispatch_nodes[MAX_SDF_NODES];
+        uint32_t    dispatch_count = renderer_internal_gather_scene_dispatches(scene, dispatch_nodes);
+        screen_rect dirty          = {0};
+        for (uint32_t i = 0; i < dispatch_count; i++) {
+            int32_t root = dispatch_nodes[i];
+            if (root < 0)
+                continue;
+
+            int32_t  subtree[SDF_MAX_SUBTREE_NODES];
+            bool     smooth[SDF_MAX_SUBTREE_NODES];
+            uint32_t count = renderer_internal_collect_subtree(nodes, node_count, root, subtree, smooth);
+
+            bool changed = relayout || count == UINT32_MAX;
+            for (uint32_t n = 0; !changed && n < count; n++)
+                changed = memcmp(&nodes[subtree[n]], &redraw->marched_nodes[subtree[n]], sizeof(SDF_NodeGPUData)) != 0;
+            if (!changed)
+                continue;
+
+            screen_rect rect = renderer_internal_node_screen_rect(nodes, subtree, smooth, count, view_proj);
+            if (!relayout)
+                dirty = renderer_internal_rect_union(dirty, renderer_internal_rect_union(redraw->marched_rects[root], rect));
+            redraw->marched_rects[root] = rect;
+        }
+
+        memcpy(redraw->marched_nodes, nodes, node_count * sizeof(SDF_NodeGPUData));
+        redraw->marched_node_count = node_count;
+        redraw->marched_view_proj  = view_proj;
+
+        uint32_t dirty_pixels = renderer_internal_rect_area(dirty);
+        if (relayout || dirty_pixels > (uint32_t) (SDF_PARTIAL_REDRAW_MAX_COVERAGE * (float) full_pixels)) {
+            redraw->mode = SCENE_REDRAW_FULL;
+        } else if (!redraw->history_valid) {
+            redraw->mode = SCENE_REDRAW_HISTORY;
+        } else if (dirty_pixels == 0) {
+            redraw->mode = SCENE_REDRAW_SKIP;
+            redraw->rect = (screen_rect){0};
+        } else {
+            redraw->mode = SCENE_REDRAW_PARTIAL;
+            redraw->rect = dirty;
+        }
+    }
+
+    // a full frame only leaves history behind when it was marched into the scene texture on the gfx queue
+    redraw->history_valid = redraw->enabled && renderer_internal_march_debug_flags() == 0 && !renderer_internal_is_drawing_to_backbuffer() && !renderer_internal_use_async_compute();
+
+    renderer_sdf_redraw_stats* stats = &redraw->stats;
+    stats->last_marched_pixels       = renderer_internal_rect_area(redraw->rect);
+    stats->marched_pixels += stats->last_marched_pixels;
+    if (redraw->mode == SCENE_REDRAW_SKIP)
+        stats->skipped_frames++;
+    else if (redraw->mode == SCENE_REDRAW_PARTIAL)
+        stats->partial_frames++;
+    else
+        stats->full_frames++;
+}
+
+// Secondaries don't inherit any state, so every chunk binds everything again
+static void renderer_internal_record_scene_dispatches(gfx_cmd_buf* cmd_buff, const scene_record_job* job, uint32_t first, uint32_t last)
+{
+    g_rhi.bind_root_signature(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.root_sig, GFX_PIPELINE_TYPE_COMPUTE);
+    g_rhi.bind_compute_pipeline(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.pipeline);
+
+    g_rhi.bind_descriptor_heaps(cmd_buff, &s_RendererSDFInternalState.generic_heap, 1);
+    g_rhi.bind_descriptor_tables(cmd_buff, job->table, 1, GFX_PIPELINE_TYPE_COMPUTE);
+
+    SDFPushConstant   pc_data = job->pc_data;
+    gfx_root_constant pc =
+        {(gfx_root_constant_range){
+             .stage  = GFX_SHADER_STAGE_CS,
+             .size   = sizeof(SDFPushConstant),
+             .offset = 0,
+         },
+            .data = &pc_data};
+
+    // the heatmap is only ever added to atomically, so it is cleared by a separate dispatch first.
+    // The barrier orders that clear before the node dispatches, which also take over the color clear
+    bool clear_heatmap = first == 0 && job->dispatch_nodes[0] >= 0 && (pc_data.debug_flags & (SDF_DEBUG_FLAG_HEATMAP_STEPS | SDF_DEBUG_FLAG_HEATMAP_NODES));
+    if (clear_heatmap) {
+        pc_data.clear_on_miss      = true;
+        pc_data.curr_draw_node_idx = -1;
+        g_rhi.bind_root_constant(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.root_sig, pc);
+        g_rhi.dispatch(cmd_buff, (job->dispatch_extent[0] + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, (job->dispatch_extent[1] + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, 1);
+        g_rhi.insert_shader_write_barrier(cmd_buff);
+    }
 
-        g_rhi.bind_descriptor_heaps(cmd_buff, &s_RendererSDFInternalState.generic_heap, 1);
-        g_rhi.bind_descriptor_tables(cmd_buff, s_RendererSDFInternalState.clear_tex_resources.tables, 1, GFX_PIPELINE_TYPE_COMPUTE);
+    for (uint32_t i = first; i < last; ++i) {
+        // only the first dispatch of the pass writes the clear color, hits only from there on
+        pc_data.clear_on_miss      = i == 0 && !clear_heatmap;
+        pc_data.curr_draw_node_idx = job->dispatch_nodes[i];
+        g_rhi.bind_root_constant(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.root_sig, pc);
 
-        g_rhi.dispatch(cmd_buff, (s_RendererSDFInternalState.width + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, (s_RendererSDFInternalState.height + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, 1);
+        g_rhi.dispatch(cmd_buff, (job->dispatch_extent[0] + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, (job->dispatch_extent[1] + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, 1);
     }
-    g_rhi.end_render_pass(cmd_buff, scene_clear_pass);
 }
 
-static void renderer_internal_scene_draw_pass(gfx_cmd_buf* cmd_buff)
+static void renderer_internal_record_scene_chunk(void* arg, uint32_t chunk_idx)
+{
+    const scene_record_job* job        = (const scene_record_job*) arg;
+    gfx_thread_cmd*         thread_cmd = &s_RendererSDFInternalState.gfxcontext.thread_cmds[chunk_idx];
+    gfx_cmd_pool*           cmd_pool   = &thread_cmd->pool[job->frame_idx];
+    gfx_cmd_buf*            cmd_buff   = &thread_cmd->cmds[job->frame_idx];
+
+    // contiguous ranges executed in chunk order keep the original dispatch order
+    uint32_t first = (uint32_t) ((uint64_t) job->dispatch_count * chunk_idx / job->chunk_count);
+    uint32_t last  = (uint32_t) ((uint64_t) job->dispatch_count * (chunk_idx + 1) / job->chunk_count);
+
+    // the frame slot was waited on before the fork, nothing recorded from this pool is in flight
+    g_rhi.reset_gfx_cmd_pool(cmd_pool);
+    g_rhi.begin_secondary_gfx_cmd_recording(cmd_pool, cmd_buff);
+    renderer_internal_record_scene_dispatches(cmd_buff, job, first, last);
+    g_rhi.end_gfx_cmd_recording(cmd_buff);
+}
+
+// Records job->chunk_count secondaries in parallel and returns them in execution order
+static void renderer_internal_record_scene_chunks(const scene_record_job* job, gfx_cmd_buf* secondaries)
+{
+    job_system_parallel_for(renderer_internal_record_scene_chunk, (void*) job, job->chunk_count);
+
+    for (uint32_t i = 0; i < job->chunk_count; i++)
+        secondaries[i] = s_RendererSDFInternalState.gfxcontext.thread_cmds[i].cmds[job->frame_idx];
+}
+
+static uint32_t renderer_internal_scene_record_chunk_count(uint32_t dispatch_count)
+{
+    uint32_t chunk_count = s_RendererSDFInternalState.cmd_record.threads;
+
+    uint32_t max_chunks = dispatch_count / SDF_MIN_DISPATCHES_PER_RECORD_THREAD;
+    if (chunk_count > max_chunks)
+        chunk_count = max_chunks;
+
+    return chunk_count > 1 ? chunk_count : 1;
+}
+
+// Renders into either the scene texture or the current backbuffer, the first dispatch writes the clear color on miss
+// The per-thread pools belong to the gfx queue family, so async compute always records inline
+static void renderer_internal_scene_draw_pass(gfx_cmd_buf* cmd_buff, const gfx_descriptor_table* table, gfx_queue_type queue)
 {
     const SDF_Scene* scene = s_RendererSDFInternalState.scene;
 
     if (!scene)
         return;
 
+    uint64_t record_start = timer_now_ns();
+
+    // full screen unless the frame only re-marches the dirty rect
+    screen_rect rect = s_RendererSDFInternalState.redraw.rect;
+
     gfx_render_pass scene_draw_pass = {.is_compute_pass = true};
     g_rhi.begin_render_pass(cmd_buff, scene_draw_pass, s_RendererSDFInternalState.gfxcontext.swapchain.current_backbuffer_idx);
     {
-        g_rhi.bind_root_signature(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.root_sig, GFX_PIPELINE_TYPE_COMPUTE);
-        g_rhi.bind_compute_pipeline(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.pipeline);
-
-        g_rhi.bind_descriptor_heaps(cmd_buff, &s_RendererSDFInternalState.generic_heap, 1);
-        g_rhi.bind_descriptor_tables(cmd_buff, s_RendererSDFInternalState.sdfscene_resources.tables, ARRAY_SIZE(s_RendererSDFInternalState.sdfscene_resources.tables), GFX_PIPELINE_TYPE_COMPUTE);
-
-        const Camera camera     = gamestate_get_global_instance()->camera;
-        mat4s        projection = glms_perspective(camera.fov, (float) s_RendererSDFInternalState.width / (float) s_RendererSDFInternalState.height, camera.near_plane, camera.far_plane);
-
-        s_RendererSDFInternalState.sdfscene_resources.pc_data.view_proj     = glms_mul(projection, camera.lookAt);
-        s_RendererSDFInternalState.sdfscene_resources.pc_data.resolution[0] = s_RendererSDFInternalState.width;
-        s_RendererSDFInternalState.sdfscene_resources.pc_data.resolution[1] = s_RendererSDFInternalState.height;
-        s_RendererSDFInternalState.sdfscene_resources.pc_data.dir_light_pos = (vec3s){{1.0f, 1.0f, 1.0f}};
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.view_proj          = renderer_internal_scene_view_proj();
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.resolution[0]      = s_RendererSDFInternalState.width;
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.resolution[1]      = s_RendererSDFInternalState.height;
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.dir_light_pos      = (vec3s){{1.0f, 1.0f, 1.0f}};
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.debug_flags        = renderer_internal_march_debug_flags();
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.counters_slot      = (int) s_RendererSDFInternalState.gfxcontext.inflight_frame_idx;
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.dispatch_offset[0] = (int) rect.x0;
+        s_RendererSDFInternalState.sdfscene_resources.pc_data.dispatch_offset[1] = (int) rect.y0;
 
         void* scene_node_update_data = sdf_scene_get_scene_nodes_gpu_data(scene);
         g_rhi.update_uniform_buffer(&s_RendererSDFInternalState.sdfscene_resources.scene_nodes_uniform_buffer, MAX_GPU_NODES_SIZE, 0, scene_node_update_data);
 
-        for (uint32_t i = 0; i < scene->current_node_head; ++i) {
-            if (scene->nodes[i].is_ref_node) continue;
-
-            s_RendererSDFInternalState.sdfscene_resources.pc_data.curr_draw_node_idx = i;
-            gfx_root_constant pc =
-                {(gfx_root_constant_range){
-                     .stage  = GFX_SHADER_STAGE_CS,
-                     .size   = sizeof(SDFPushConstant),
-                     .offset = 0,
-                 },
-                    .data = &s_RendererSDFInternalState.sdfscene_resources.pc_data};
-            g_rhi.bind_root_constant(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.root_sig, pc);
-
-            g_rhi.dispatch(cmd_buff, (s_RendererSDFInternalState.width + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, (s_RendererSDFInternalState.height + DISPATCH_LOCAL_DIM) / DISPATCH_LOCAL_DIM, 1);
+        int32_t          dispatch_nodes[MAX_SDF_NODES];
+        scene_record_job job = {
+            .pc_data         = s_RendererSDFInternalState.sdfscene_resources.pc_data,
+            .table           = table,
+            .dispatch_nodes  = dispatch_nodes,
+            .dispatch_count  = renderer_internal_gather_scene_dispatches(scene, dispatch_nodes),
+            .frame_idx       = s_RendererSDFInternalState.gfxcontext.inflight_frame_idx,
+            .dispatch_extent = {rect.x1 - rect.x0, rect.y1 - rect.y0},
+        };
+        job.chunk_count = queue == GFX_QUEUE_TYPE_GRAPHICS ? renderer_internal_scene_record_chunk_count(job.dispatch_count) : 1;
+
+        if (job.chunk_count > 1) {
+            gfx_cmd_buf secondaries[MAX_RECORD_THREADS];
+            renderer_internal_record_scene_chunks(&job, secondaries);
+            g_rhi.execute_secondary_gfx_cmds(cmd_buff, secondaries, job.chunk_count);
+            renderer_internal_bind_bindless_heap(cmd_buff);
+        } else {
+            renderer_internal_record_scene_dispatches(cmd_buff, &job, 0, job.dispatch_count);
         }
+
+        s_RendererSDFInternalState.cmd_record.stats.threads    = job.chunk_count;
+        s_RendererSDFInternalState.cmd_record.stats.dispatches = job.dispatch_count;
     }
     g_rhi.end_render_pass(cmd_buff, scene_draw_pass);
+
+    if (s_RendererSDFInternalState.sdfscene_resources.pc_data.debug_flags & SDF_DEBUG_FLAG_COUNTERS)
+        g_rhi.insert_host_read_barrier(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.counters_buffer);
+
+    s_RendererSDFInternalState.cmd_record.stats.record_ms = timer_elapsed_ms(record_start);
 }
 
-static void renderer_internal_sdf_screen_quad_pass(gfx_cmd_buf* cmd_buff)
+// scene_table is set 0, scene_texture its bindless index, the scene texture and heatmap transitions are done by the frame graph
+static void renderer_internal_sdf_screen_quad_pass(gfx_cmd_buf* cmd_buff, const gfx_descriptor_table* scene_table, uint32_t scene_texture)
 {
-    g_rhi.insert_image_layout_barrier(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.scene_texture, GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_SHADER_READ_ONLY);
-
     color_rgba      clear_color       = {{{1.0f, (float) sin(0.0025f * (float) s_RendererSDFInternalState.frameCount), 1.0f, 1.0f}}};
     gfx_render_pass clear_screen_pass = {
         .is_swap_pass            = true,
@@ -596,9 +1693,30 @@ static void renderer_internal_sdf_screen_quad_pass(gfx_cmd_buf* cmd_buff)
         g_rhi.bind_root_signature(cmd_buff, &s_RendererSDFInternalState.screen_quad_resources.root_sig, GFX_PIPELINE_TYPE_GRAPHICS);
         g_rhi.bind_gfx_pipeline(cmd_buff, &s_RendererSDFInternalState.screen_quad_resources.pipeline);
 
-        gfx_descriptor_heap heaps[2] = {s_RendererSDFInternalState.generic_heap, s_RendererSDFInternalState.samplers_heap};
-        g_rhi.bind_descriptor_heaps(cmd_buff, heaps, 2);
-        g_rhi.bind_descriptor_tables(cmd_buff, s_RendererSDFInternalState.screen_quad_resources.tables, ARRAY_SIZE(s_RendererSDFInternalState.screen_quad_resources.tables), GFX_PIPELINE_TYPE_GRAPHICS);
+        uint32_t pc_size = sizeof(ScreenQuadPushConstant);
+        if (!renderer_internal_use_bindless()) {
+            gfx_descriptor_heap  heaps[2]  = {s_RendererSDFInternalState.generic_heap, s_RendererSDFInternalState.samplers_heap};
+            gfx_descriptor_table tables[2] = {*scene_table, s_RendererSDFInternalState.screen_quad_resources.tables[1]};
+            g_rhi.bind_descriptor_heaps(cmd_buff, heaps, 2);
+            g_rhi.bind_descriptor_tables(cmd_buff, tables, ARRAY_SIZE(tables), GFX_PIPELINE_TYPE_GRAPHICS);
+            pc_size = offsetof(ScreenQuadPushConstant, scene_texture);
+        }
+
+        ScreenQuadPushConstant pc_data = {
+            .debug_view    = (int) s_RendererSDFInternalState.march_debug.view,
+            .heatmap_scale = s_RendererSDFInternalState.march_debug.heatmap_scale,
+            .scene_texture = scene_texture,
+            .heatmap       = s_RendererSDFInternalState.screen_quad_resources.heatmap_slot.index,
+            .scene_sampler = s_RendererSDFInternalState.screen_quad_resources.sampler_slot.index,
+        };
+        gfx_root_constant pc = {
+            (gfx_root_constant_range){
+                .stage  = GFX_SHADER_STAGE_PS,
+                .size   = pc_size,
+                .offset = 0,
+            },
+            .data = &pc_data};
+        g_rhi.bind_root_constant(cmd_buff, &s_RendererSDFInternalState.screen_quad_resources.root_sig, pc);
 
         g_rhi.set_viewport(cmd_buff, (gfx_viewport){.x = 0, .y = 0, .width = s_RendererSDFInternalState.width, .height = s_RendererSDFInternalState.height, .min_depth = 0, .max_depth = 1});
         g_rhi.set_scissor(cmd_buff, (gfx_scissor){.x = 0, .y = 0, .width = s_RendererSDFInternalState.width, .height = s_RendererSDFInternalState.height});
@@ -606,8 +1724,6 @@ static void renderer_internal_sdf_screen_quad_pass(gfx_cmd_buf* cmd_buff)
         g_rhi.draw(cmd_buff, 3, 1, 0, 0);
     }
     g_rhi.end_render_pass(cmd_buff, clear_screen_pass);
-
-    g_rhi.insert_image_layout_barrier(cmd_buff, &s_RendererSDFInternalState.sdfscene_resources.scene_texture, GFX_IMAGE_LAYOUT_SHADER_READ_ONLY, GFX_IMAGE_LAYOUT_GENERAL);
 }
 #else
 
@@ -642,6 +1758,219 @@ static void renderer_internal_clear_screen_no_rendering(gfx_cmd_buf* cmd_buff)
 }
 #endif
 
+static const char* s_GPUPassNames[SDF_GPU_PASS_COUNT] = {
+    "frame",
+    "scene_draw",
+    "screen_quad",
+};
+
+// Delivers the copy recorded in this slot MAX_FRAMES_INFLIGHT frames ago, the slot must have been waited on
+static void renderer_internal_resolve_frame_capture(uint32_t frame_idx)
+{
+    frame_capture_state* capture = &s_RendererSDFInternalState.frame_capture;
+    if (!capture->ring.backend)
+        return;
+
+    gfx_texture_readback frame = {0};
+    if (g_rhi.resolve_readback(&capture->ring, frame_idx, &frame) != Success || !capture->callback)
+        return;
+
+    capture->callback(&frame, capture->slot_frame[frame_idx], capture->user_data);
+    capture->frames_delivered++;
+}
+
+// Delivers every pending copy oldest first, the GPU must be idle
+static void renderer_internal_drain_frame_captures(void)
+{
+    // next slot to be reused holds the oldest pending copy
+    uint32_t frame_idx = s_RendererSDFInternalState.gfxcontext.inflight_frame_idx;
+    for (uint32_t i = 0; i < g_gfxConfig.frame_queue_depth; i++) {
+        renderer_internal_resolve_frame_capture(frame_idx);
+        frame_idx = (frame_idx + 1) % g_gfxConfig.frame_queue_depth;
+    }
+}
+
+static void renderer_internal_record_frame_capture(gfx_cmd_buf* cmd_buff)
+{
+    frame_capture_state* capture = &s_RendererSDFInternalState.frame_capture;
+    if (!capture->callback || !capture->ring.backend)
+        return;
+
+    uint32_t frame_idx = s_RendererSDFInternalState.gfxcontext.inflight_frame_idx;
+    if (g_rhi.record_swapchain_readback(cmd_buff, &capture->ring, &s_RendererSDFInternalState.gfxcontext.swapchain, frame_idx) == Success)
+        capture->slot_frame[frame_idx] = s_RendererSDFInternalState.frameCount;
+}
+
+static bool renderer_internal_gpu_timings_enabled(void)
+{
+    return !uuid_is_null(&s_RendererSDFInternalState.gpu_timings.query_pool.uuid);
+}
+
+static void renderer_internal_begin_gpu_zone(gfx_cmd_buf* cmd_buff, renderer_sdf_gpu_pass pass)
+{
+    if (renderer_internal_gpu_timings_enabled())
+        g_rhi.begin_gpu_zone(cmd_buff, &s_RendererSDFInternalState.gpu_timings.query_pool, s_RendererSDFInternalState.gfxcontext.inflight_frame_idx, pass);
+}
+
+static void renderer_internal_end_gpu_zone(gfx_cmd_buf* cmd_buff, renderer_sdf_gpu_pass pass)
+{
+    if (renderer_internal_gpu_timings_enabled())
+        g_rhi.end_gpu_zone(cmd_buff, &s_RendererSDFInternalState.gpu_timings.query_pool, s_RendererSDFInternalState.gfxcontext.inflight_frame_idx, pass);
+}
+
+// Reads back the zones written the last time this in-flight slot was used, frame_begin has already waited on its fence
+static void renderer_internal_resolve_gpu_timings(void)
+{
+    if (!renderer_internal_gpu_timings_enabled())
+        return;
+
+    gpu_timings_state* gpu = &s_RendererSDFInternalState.gpu_timings;
+
+    double          ms[SDF_GPU_PASS_COUNT] = {0};
+    rhi_error_codes res                    = g_rhi.resolve_timestamp_queries(&gpu->query_pool, s_RendererSDFInternalState.gfxcontext.inflight_frame_idx, ms, SDF_GPU_PASS_COUNT);
+    if (res != Success)
+        return;
+
+    double* slot = gpu->history[gpu->history_head];
+    for (uint32_t p = 0; p < SDF_GPU_PASS_COUNT; p++) {
+        if (gpu->history_count == SDF_GPU_TIMINGS_WINDOW)
+            gpu->history_sum[p] -= slot[p];
+        slot[p] = ms[p];
+        gpu->history_sum[p] += ms[p];
+    }
+    gpu->history_head = (gpu->history_head + 1) % SDF_GPU_TIMINGS_WINDOW;
+    if (gpu->history_count < SDF_GPU_TIMINGS_WINDOW)
+        gpu->history_count++;
+
+    for (uint32_t p = 0; p < SDF_GPU_PASS_COUNT; p++) {
+        gpu->timings.last_ms[p] = ms[p];
+        gpu->timings.avg_ms[p]  = gpu->history_sum[p] / (double) gpu->history_count;
+    }
+    gpu->timings.frames_resolved++;
+
+    if (gpu->csv) {
+        fprintf(gpu->csv, "%llu", (unsigned long long) gpu->timings.frames_resolved);
+        for (uint32_t p = 0; p < SDF_GPU_PASS_COUNT; p++)
+            fprintf(gpu->csv, ",%.4f", ms[p]);
+        fprintf(gpu->csv, "\n");
+    }
+
+    if (gpu->log && gpu->timings.frames_resolved % SDF_GPU_TIMINGS_WINDOW == 0) {
+        LOG_INFO("[GPU] avg over %u frames: %s %.3f ms | %s %.3f ms | %s %.3f ms", gpu->history_count, s_GPUPassNames[SDF_GPU_PASS_FRAME], gpu->timings.avg_ms[SDF_GPU_PASS_FRAME], s_GPUPassNames[SDF_GPU_PASS_SCENE_DRAW], gpu->timings.avg_ms[SDF_GPU_PASS_SCENE_DRAW], s_GPUPassNames[SDF_GPU_PASS_SCREEN_QUAD], gpu->timings.avg_ms[SDF_GPU_PASS_SCREEN_QUAD]);
+    }
+}
+
+#if !TRIANGLE_TEST
+static void renderer_internal_graph_scene_draw(gfx_cmd_buf* cmd_buff, const render_graph* graph, void* user_data)
+{
+    (void) graph;
+    const frame_graph_data* data = user_data;
+
+    renderer_internal_begin_gpu_zone(cmd_buff, SDF_GPU_PASS_SCENE_DRAW);
+    renderer_internal_scene_draw_pass(cmd_buff, data->scene_table, GFX_QUEUE_TYPE_GRAPHICS);
+    renderer_internal_end_gpu_zone(cmd_buff, SDF_GPU_PASS_SCENE_DRAW);
+}
+
+static void renderer_internal_graph_screen_quad(gfx_cmd_buf* cmd_buff, const render_graph* graph, void* user_data)
+{
+    (void) graph;
+    const frame_graph_data* data = user_data;
+
+    renderer_internal_begin_gpu_zone(cmd_buff, SDF_GPU_PASS_SCREEN_QUAD);
+    renderer_internal_sdf_screen_quad_pass(cmd_buff, data->screen_quad_table, data->screen_quad_scene_texture);
+    renderer_internal_end_gpu_zone(cmd_buff, SDF_GPU_PASS_SCREEN_QUAD);
+}
+
+// Pass_0 raymarches into the backbuffer or the scene texture, Pass_1 draws the scene texture to a screen quad
+// With async compute Pass_0 already ran on the compute queue and only the screen quad is left
+static void renderer_internal_build_frame_graph(bool async_scene_draw)
+{
+    render_graph*     graph = &s_RendererSDFInternalState.frame_graph;
+    frame_graph_data* data  = &s_RendererSDFInternalState.frame_graph_data;
+    sdf_resources*    res   = &s_RendererSDFInternalState.sdfscene_resources;
+    uint32_t          slot  = s_RendererSDFInternalState.gfxcontext.inflight_frame_idx;
+
+    render_graph_begin(graph);
+
+    const gfx_swapchain*  swapchain  = &s_RendererSDFInternalState.gfxcontext.swapchain;
+    render_graph_resource backbuffer = render_graph_import_swapchain(graph, "backbuffer", swapchain, GFX_IMAGE_LAYOUT_PRESENTATION, GFX_IMAGE_LAYOUT_PRESENTATION);
+    render_graph_resource heatmap    = render_graph_import_texture(graph, "heatmap", &res->heatmap_texture, GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_GENERAL);
+
+    bool debug_view = s_RendererSDFInternalState.march_debug.view != SDF_DEBUG_VIEW_NONE;
+
+    if (renderer_internal_is_drawing_to_backbuffer()) {
+        data->scene_table = &res->backbuffer_tables[swapchain->current_backbuffer_idx];
+
+        uint32_t scene_draw = render_graph_add_pass(graph, "scene_draw", renderer_internal_graph_scene_draw, data);
+        render_graph_pass_write(graph, scene_draw, backbuffer, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+        // counters are read back by the CPU, nothing in the graph consumes them
+        if (renderer_internal_march_counters_enabled())
+            render_graph_pass_set_side_effects(graph, scene_draw);
+        return;
+    }
+
+    render_graph_resource scene_texture = RENDER_GRAPH_INVALID_RESOURCE;
+    if (async_scene_draw) {
+        // the acquire barrier already left it in SHADER_READ_ONLY, the next raymarch discards it
+        scene_texture           = render_graph_import_texture(graph, "scene_texture", &s_RendererSDFInternalState.async_compute.scene_textures[slot], GFX_IMAGE_LAYOUT_SHADER_READ_ONLY, GFX_IMAGE_LAYOUT_UNDEFINED);
+        data->screen_quad_table = &s_RendererSDFInternalState.async_compute.screen_quad_tables[slot];
+
+        data->screen_quad_scene_texture = s_RendererSDFInternalState.async_compute.screen_quad_slots[slot].index;
+    } else {
+        scene_texture           = render_graph_import_texture(graph, "scene_texture", &res->scene_texture, GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_GENERAL);
+        data->scene_table       = res->tables;
+        data->screen_quad_table = &s_RendererSDFInternalState.screen_quad_resources.tables[0];
+
+        data->screen_quad_scene_texture = s_RendererSDFInternalState.screen_quad_resources.scene_texture_slot.index;
+
+        // nothing changed since last frame, the screen quad re-presents it
+        if (s_RendererSDFInternalState.redraw.mode != SCENE_REDRAW_SKIP) {
+            uint32_t scene_draw = render_graph_add_pass(graph, "scene_draw", renderer_internal_graph_scene_draw, data);
+            render_graph_pass_write(graph, scene_draw, scene_texture, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+            if (debug_view)
+                render_graph_pass_write(graph, scene_draw, heatmap, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+            if (renderer_internal_march_counters_enabled())
+                render_graph_pass_set_side_effects(graph, scene_draw);
+        }
+    }
+
+    uint32_t screen_quad = render_graph_add_pass(graph, "screen_quad", renderer_internal_graph_screen_quad, data);
+    render_graph_pass_read(graph, screen_quad, scene_texture, RENDER_GRAPH_ACCESS_SAMPLED);
+    render_graph_pass_read(graph, screen_quad, heatmap, RENDER_GRAPH_ACCESS_STORAGE_READ);
+    render_graph_pass_write(graph, screen_quad, backbuffer, RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT);
+}
+
+// Raymarches into this slot's scene texture on the compute queue and hands it over to the gfx queue,
+// the gfx submit of this frame waits on it while the previous frame can still be presenting
+static void renderer_internal_submit_async_scene_draw(uint32_t slot)
+{
+    gfx_context*  ctx       = &s_RendererSDFInternalState.gfxcontext;
+    gfx_cmd_buf*  ccmd_buff = &ctx->compute_cmds[slot];
+    gfx_resource* scene_tex = &s_RendererSDFInternalState.async_compute.scene_textures[slot];
+
+    // frame_begin waited on this slot and its gfx submit waited on the compute one, so the pool is idle
+    g_rhi.reset_gfx_cmd_pool(&ctx->compute_cmds_pool[slot]);
+    g_rhi.begin_gfx_cmd_recording(&ctx->compute_cmds_pool[slot], ccmd_buff);
+
+    // recorded first on the GPU timeline, the gfx submit waits on this one
+    if (renderer_internal_gpu_timings_enabled())
+        g_rhi.reset_timestamp_queries(ccmd_buff, &s_RendererSDFInternalState.gpu_timings.query_pool, slot);
+
+    // contents are fully rewritten, the previous frame's layout can be discarded
+    g_rhi.insert_queue_image_barrier(ccmd_buff, scene_tex, GFX_IMAGE_LAYOUT_UNDEFINED, GFX_IMAGE_LAYOUT_GENERAL, GFX_QUEUE_TYPE_ASYNC_COMPUTE, GFX_QUEUE_TYPE_ASYNC_COMPUTE, false);
+
+    renderer_internal_begin_gpu_zone(ccmd_buff, SDF_GPU_PASS_SCENE_DRAW);
+    renderer_internal_scene_draw_pass(ccmd_buff, &s_RendererSDFInternalState.async_compute.scene_tables[slot], GFX_QUEUE_TYPE_ASYNC_COMPUTE);
+    renderer_internal_end_gpu_zone(ccmd_buff, SDF_GPU_PASS_SCENE_DRAW);
+
+    // release half of the ownership transfer, acquired by the screen quad pass
+    g_rhi.insert_queue_image_barrier(ccmd_buff, scene_tex, GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_SHADER_READ_ONLY, GFX_QUEUE_TYPE_ASYNC_COMPUTE, GFX_QUEUE_TYPE_GRAPHICS, false);
+
+    g_rhi.end_gfx_cmd_recording(ccmd_buff);
+    g_rhi.submit_async_compute(ctx, ccmd_buff);
+}
+#endif
+
 //----------------------------------------------------------------
 
 bool renderer_sdf_init(renderer_desc desc)
@@ -655,12 +1984,44 @@ bool renderer_sdf_init(renderer_desc desc)
     s_RendererSDFInternalState.window        = desc.window;
     s_RendererSDFInternalState.frameCount    = 0;
 
-    glfwSetWindowSizeCallback(s_RendererSDFInternalState.window, renderer_internal_sdf_resize);
+    s_RendererSDFInternalState.writeToBackbuffer     = desc.write_to_backbuffer;
+    s_RendererSDFInternalState.backbufferTablesBuilt = false;
+
+    s_RendererSDFInternalState.march_debug.heatmap_scale = SDF_MAX_MARCH_STEPS;
+#if !TRIANGLE_TEST
+    s_RendererSDFInternalState.redraw.enabled = true;
+#endif
+
+    // headless has no window, the offscreen backbuffers keep the size they were created with
+    if (s_RendererSDFInternalState.window)
+        glfwSetWindowSizeCallback(s_RendererSDFInternalState.window, renderer_internal_sdf_resize);
+
+    // no watcher only means hot reload is manual (SPACE)
+    file_watcher_init(&s_RendererSDFInternalState.shader_reload.watcher, "./game/shaders_built");
+
+    uint64_t start   = timer_now_ns();
+    bool     success = render_internal_sdf_init_gfx_ctx(desc.width, desc.height);
 
-    bool success = render_internal_sdf_init_gfx_ctx(desc.width, desc.height);
+    s_RendererSDFInternalState.startup_timings.context_ms           = timer_elapsed_ms(start);
+    s_RendererSDFInternalState.startup_timings.pipeline_cache_bytes = s_RendererSDFInternalState.gfxcontext.pipeline_cache_loaded_bytes;
 
-    if (success)
+    if (success) {
+        start = timer_now_ns();
+#if !TRIANGLE_TEST
+        render_graph_init(&s_RendererSDFInternalState.frame_graph);
+#endif
         renderer_internal_create_sdf_pass_resources();
+        s_RendererSDFInternalState.startup_timings.pass_resources_ms = timer_elapsed_ms(start);
+
+        // null pool when the queue can't write timestamps, zones are skipped then
+        if (s_RendererSDFInternalState.gfxcontext.supports.timestamps)
+            s_RendererSDFInternalState.gpu_timings.query_pool = g_rhi.create_timestamp_query_pool(SDF_GPU_PASS_COUNT);
+
+        gfx_memory_stats memory = {0};
+        if (s_RendererSDFInternalState.gfxcontext.supports.memory_stats)
+            memory = g_rhi.get_memory_stats();
+        LOG_INFO("[Renderer] GPU memory: %.2f/%.2f MB used in %u blocks + %u dedicated, %.1f%% fragmented", (double) memory.bytes_used / (1024.0 * 1024.0), (double) memory.bytes_reserved / (1024.0 * 1024.0), memory.blocks, memory.dedicated_allocations, (double) memory.fragmentation * 100.0);
+    }
 
     return success;
 }
@@ -671,7 +2032,20 @@ void renderer_sdf_destroy(void)
 
     free(s_RendererSDFInternalState.lastSwapchainReadback.pixels);
 
+    renderer_sdf_set_gpu_timings_csv(NULL);
+    if (renderer_internal_gpu_timings_enabled())
+        g_rhi.destroy_timestamp_query_pool(&s_RendererSDFInternalState.gpu_timings.query_pool);
+
+    renderer_internal_destroy_shader_reload();
+
+    if (s_RendererSDFInternalState.frame_capture.ring.backend)
+        g_rhi.destroy_readback_ring(&s_RendererSDFInternalState.frame_capture.ring);
+    s_RendererSDFInternalState.frame_capture = (frame_capture_state){0};
+
     // clean up
+#if !TRIANGLE_TEST
+    render_graph_destroy(&s_RendererSDFInternalState.frame_graph);
+#endif
     renderer_internal_destroy_sdf_pass_resources();
 
     renderer_internal_sdf_destroy_gfx_ctx();
@@ -681,20 +2055,23 @@ void renderer_sdf_destroy(void)
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
-    glfwTerminate();
+    if (s_RendererSDFInternalState.window)
+        glfwTerminate();
 }
 
 void renderer_sdf_render(void)
 {
+    // events were polled right after the wait, polling again would only move the resize out of this frame
+    bool late_latched = s_RendererSDFInternalState.frameBegun;
+
     s_RendererSDFInternalState.frameCount++;
 
     const GameState* game_state = gamestate_get_global_instance();
 
-    if (game_state->keycodes[GLFW_KEY_ESCAPE] == GLFW_PRESS)
+    if (s_RendererSDFInternalState.window && game_state->keycodes[GLFW_KEY_ESCAPE] == GLFW_PRESS)
         glfwSetWindowShouldClose(s_RendererSDFInternalState.window, true);
 
-    if (game_state->keycodes[GLFW_KEY_SPACE] == GLFW_PRESS)
-        renderer_internal_hot_reload_shaders();
+    renderer_internal_update_shader_reload();
 
     // Scene Culling is done before any rendering begins (might move it to update part of engine loop)
 
@@ -702,7 +2079,71 @@ void renderer_sdf_render(void)
 
     renderer_sdf_draw_scene(s_RendererSDFInternalState.scene);
 
-    glfwPollEvents();
+    if (s_RendererSDFInternalState.window && !late_latched)
+        glfwPollEvents();
+
+    if (s_RendererSDFInternalState.resizePending)
+        renderer_internal_sdf_resize(s_RendererSDFInternalState.window, (int) s_RendererSDFInternalState.width, (int) s_RendererSDFInternalState.height);
+}
+
+void renderer_sdf_begin_frame(void)
+{
+    // an acquired backbuffer has to be submitted and there is nothing to submit without a scene
+    if (s_RendererSDFInternalState.frameBegun || !s_RendererSDFInternalState.scene)
+        return;
+
+    g_rhi.frame_begin(&s_RendererSDFInternalState.gfxcontext);
+    s_RendererSDFInternalState.frameBegun = true;
+
+    if (s_RendererSDFInternalState.window)
+        glfwPollEvents();
+}
+
+const renderer_sdf_frame_pacing* renderer_sdf_get_frame_pacing(void)
+{
+    return &s_RendererSDFInternalState.frame_pacing;
+}
+
+void renderer_sdf_set_present_mode(gfx_present_mode mode)
+{
+    if (mode == g_gfxConfig.present_mode)
+        return;
+
+    g_gfxConfig.present_mode = mode;
+
+    // headless never presents, the backends only read the mode at swapchain creation and present
+    if (s_RendererSDFInternalState.window)
+        renderer_internal_sdf_resize(s_RendererSDFInternalState.window, (int) s_RendererSDFInternalState.width, (int) s_RendererSDFInternalState.height);
+}
+
+void renderer_sdf_set_frame_queue_depth(uint32_t depth)
+{
+    if (depth < 1)
+        depth = 1;
+    if (depth > MAX_FRAMES_INFLIGHT)
+        depth = MAX_FRAMES_INFLIGHT;
+
+    if (depth == g_gfxConfig.frame_queue_depth)
+        return;
+
+    if (s_RendererSDFInternalState.frameBegun) {
+        LOG_WARN("[Renderer] frame queue depth can't change between renderer_sdf_begin_frame and renderer_sdf_render");
+        return;
+    }
+
+    // every slot is idle after the flush, pending copies go out in the old ring order before the slots are renumbered
+    g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
+    renderer_internal_drain_frame_captures();
+
+    g_gfxConfig.frame_queue_depth                            = depth;
+    s_RendererSDFInternalState.gfxcontext.inflight_frame_idx = 0;
+
+    LOG_INFO("[Renderer] frame queue depth: %u", depth);
+}
+
+uint32_t renderer_sdf_get_frame_queue_depth(void)
+{
+    return g_gfxConfig.frame_queue_depth;
 }
 
 const SDF_Scene* renderer_sdf_get_scene(void)
@@ -713,6 +2154,9 @@ const SDF_Scene* renderer_sdf_get_scene(void)
 void renderer_sdf_set_scene(const SDF_Scene* scene)
 {
     s_RendererSDFInternalState.scene = scene;
+#if !TRIANGLE_TEST
+    s_RendererSDFInternalState.redraw.history_valid = false;
+#endif
 }
 
 void renderer_sdf_draw_scene(const SDF_Scene* scene)
@@ -720,30 +2164,50 @@ void renderer_sdf_draw_scene(const SDF_Scene* scene)
     if (!scene)
         return;
 
-    g_rhi.frame_begin(&s_RendererSDFInternalState.gfxcontext);
+    if (!s_RendererSDFInternalState.frameBegun)
+        g_rhi.frame_begin(&s_RendererSDFInternalState.gfxcontext);
+    s_RendererSDFInternalState.frameBegun = true;
     {
         gfx_cmd_pool* cmd_pool = &s_RendererSDFInternalState.gfxcontext.draw_cmds_pool[s_RendererSDFInternalState.gfxcontext.inflight_frame_idx];
         gfx_cmd_buf*  cmd_buff = &s_RendererSDFInternalState.gfxcontext.draw_cmds[s_RendererSDFInternalState.gfxcontext.inflight_frame_idx];
 
+        renderer_internal_resolve_gpu_timings();
+        // frame_begin just waited on this slot
+        renderer_internal_resolve_frame_capture(s_RendererSDFInternalState.gfxcontext.inflight_frame_idx);
+        bool async_scene_draw = false;
+#if !TRIANGLE_TEST
+        renderer_internal_resolve_march_counters();
+        renderer_internal_plan_scene_redraw(scene);
+
+        async_scene_draw = renderer_internal_use_async_compute();
+        if (async_scene_draw)
+            renderer_internal_submit_async_scene_draw(s_RendererSDFInternalState.gfxcontext.inflight_frame_idx);
+#endif
+
         g_rhi.begin_gfx_cmd_recording(cmd_pool, cmd_buff);
+        renderer_internal_bind_bindless_heap(cmd_buff);
 
-        {
-            g_rhi.insert_swapchain_layout_barrier(cmd_buff, &s_RendererSDFInternalState.gfxcontext.swapchain, GFX_IMAGE_LAYOUT_PRESENTATION, GFX_IMAGE_LAYOUT_COLOR_ATTACHMENT);
+        // the async compute submit already reset them
+        if (renderer_internal_gpu_timings_enabled() && !async_scene_draw)
+            g_rhi.reset_timestamp_queries(cmd_buff, &s_RendererSDFInternalState.gpu_timings.query_pool, s_RendererSDFInternalState.gfxcontext.inflight_frame_idx);
+        renderer_internal_begin_gpu_zone(cmd_buff, SDF_GPU_PASS_FRAME);
 
 #if !TRIANGLE_TEST
-            // Pass_0: SDF Scene Texture clear
-            renderer_internal_scene_clear_pass(cmd_buff);
+        // Pass_0 ran on the compute queue, acquire half of its ownership transfer
+        if (async_scene_draw)
+            g_rhi.insert_queue_image_barrier(cmd_buff, &s_RendererSDFInternalState.async_compute.scene_textures[s_RendererSDFInternalState.gfxcontext.inflight_frame_idx], GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_SHADER_READ_ONLY, GFX_QUEUE_TYPE_ASYNC_COMPUTE, GFX_QUEUE_TYPE_GRAPHICS, true);
 
-            // Pass_1: SDF CS rendering
-            renderer_internal_scene_draw_pass(cmd_buff);
-
-            // Pass_2: draw the sdf scene texture to screen quad
-            renderer_internal_sdf_screen_quad_pass(cmd_buff);
+        renderer_internal_build_frame_graph(async_scene_draw);
+        render_graph_execute(&s_RendererSDFInternalState.frame_graph, cmd_buff);
 #else
-            renderer_internal_clear_screen_no_rendering(cmd_buff);
+        // does its own swapchain transitions
+        renderer_internal_clear_screen_no_rendering(cmd_buff);
 #endif
-            g_rhi.insert_swapchain_layout_barrier(cmd_buff, &s_RendererSDFInternalState.gfxcontext.swapchain, GFX_IMAGE_LAYOUT_COLOR_ATTACHMENT, GFX_IMAGE_LAYOUT_PRESENTATION);
-        }
+
+        renderer_internal_end_gpu_zone(cmd_buff, SDF_GPU_PASS_FRAME);
+
+        // backbuffer is back in present layout here, outside the frame zone so capture cost isn't timed
+        renderer_internal_record_frame_capture(cmd_buff);
 
         g_rhi.end_gfx_cmd_recording(cmd_buff);
 
@@ -754,12 +2218,62 @@ void renderer_sdf_draw_scene(const SDF_Scene* scene)
 
 #if !TRIANGLE_TEST
         if (s_RendererSDFInternalState.captureSwapchain) {
+            free(s_RendererSDFInternalState.lastSwapchainReadback.pixels);
             s_RendererSDFInternalState.lastSwapchainReadback = g_rhi.readback_swapchain(&s_RendererSDFInternalState.gfxcontext.swapchain);
             s_RendererSDFInternalState.captureSwapchain      = false;
         }
 #endif
     }
     g_rhi.frame_end(&s_RendererSDFInternalState.gfxcontext);
+    s_RendererSDFInternalState.frameBegun = false;
+
+    renderer_sdf_frame_pacing* pacing = &s_RendererSDFInternalState.frame_pacing;
+    pacing->cpu_wait_ms               = s_RendererSDFInternalState.gfxcontext.frame_waits.cpu_wait_ms;
+    pacing->present_wait_ms           = s_RendererSDFInternalState.gfxcontext.frame_waits.present_wait_ms;
+    pacing->gpu_ms                    = s_RendererSDFInternalState.gpu_timings.timings.last_ms[SDF_GPU_PASS_FRAME];
+}
+
+bool renderer_sdf_set_async_compute(bool enable)
+{
+#if !TRIANGLE_TEST
+    if (!s_RendererSDFInternalState.async_compute.created)
+        return false;
+
+    s_RendererSDFInternalState.async_compute.enabled = enable;
+    return true;
+#else
+    (void) enable;
+    return false;
+#endif
+}
+
+bool renderer_sdf_is_async_compute_active(void)
+{
+#if !TRIANGLE_TEST
+    return renderer_internal_use_async_compute();
+#else
+    return false;
+#endif
+}
+
+void renderer_sdf_set_incremental_redraw(bool enable)
+{
+#if !TRIANGLE_TEST
+    s_RendererSDFInternalState.redraw.enabled       = enable;
+    s_RendererSDFInternalState.redraw.history_valid = false;
+#else
+    (void) enable;
+#endif
+}
+
+const renderer_sdf_redraw_stats* renderer_sdf_get_redraw_stats(void)
+{
+#if !TRIANGLE_TEST
+    return &s_RendererSDFInternalState.redraw.stats;
+#else
+    static const renderer_sdf_redraw_stats no_stats = {0};
+    return &no_stats;
+#endif
 }
 
 void renderer_sdf_set_capture_swapchain_ready(void)
@@ -771,3 +2285,190 @@ const gfx_texture_readback* renderer_sdf_get_last_swapchain_readback(void)
 {
     return &s_RendererSDFInternalState.lastSwapchainReadback;
 }
+
+const renderer_sdf_gpu_timings* renderer_sdf_get_gpu_timings(void)
+{
+    return &s_RendererSDFInternalState.gpu_timings.timings;
+}
+
+const char* renderer_sdf_get_gpu_pass_name(renderer_sdf_gpu_pass pass)
+{
+    if (pass >= SDF_GPU_PASS_COUNT)
+        return "unknown";
+    return s_GPUPassNames[pass];
+}
+
+void renderer_sdf_set_gpu_timings_logging(bool enable)
+{
+    s_RendererSDFInternalState.gpu_timings.log = enable;
+}
+
+bool renderer_sdf_set_gpu_timings_csv(const char* path)
+{
+    gpu_timings_state* gpu = &s_RendererSDFInternalState.gpu_timings;
+
+    if (gpu->csv) {
+        fclose(gpu->csv);
+        gpu->csv = NULL;
+    }
+
+    if (!path)
+        return true;
+
+    gpu->csv = fopen(path, "w");
+    if (!gpu->csv) {
+        LOG_ERROR("[GPU] failed to open timings csv: %s", path);
+        return false;
+    }
+
+    fprintf(gpu->csv, "frame");
+    for (uint32_t p = 0; p < SDF_GPU_PASS_COUNT; p++)
+        fprintf(gpu->csv, ",%s_ms", s_GPUPassNames[p]);
+    fprintf(gpu->csv, "\n");
+    return true;
+}
+
+void renderer_sdf_set_march_counters(bool enable)
+{
+    s_RendererSDFInternalState.march_debug.counters_enabled = enable;
+}
+
+const renderer_sdf_march_stats* renderer_sdf_get_march_stats(void)
+{
+    if (!s_RendererSDFInternalState.march_debug.stats_valid)
+        return NULL;
+    return &s_RendererSDFInternalState.march_debug.stats;
+}
+
+void renderer_sdf_set_debug_view(renderer_sdf_debug_view view)
+{
+    if (view >= SDF_DEBUG_VIEW_COUNT)
+        view = SDF_DEBUG_VIEW_NONE;
+    s_RendererSDFInternalState.march_debug.view = view;
+}
+
+void renderer_sdf_set_heatmap_scale(uint32_t value)
+{
+    s_RendererSDFInternalState.march_debug.heatmap_scale = value ? value : 1;
+}
+
+const renderer_sdf_startup_timings* renderer_sdf_get_startup_timings(void)
+{
+    return &s_RendererSDFInternalState.startup_timings;
+}
+
+void renderer_sdf_set_frame_capture(renderer_sdf_frame_capture_fn callback, void* user_data)
+{
+    frame_capture_state* capture = &s_RendererSDFInternalState.frame_capture;
+
+    // ring outlives the callback, copies still in flight are resolved and dropped
+    if (callback && !capture->ring.backend)
+        capture->ring = g_rhi.create_readback_ring(s_RendererSDFInternalState.gfxcontext.swapchain.width, s_RendererSDFInternalState.gfxcontext.swapchain.height);
+
+    capture->callback  = callback;
+    capture->user_data = user_data;
+}
+
+uint64_t renderer_sdf_get_captured_frame_count(void)
+{
+    return s_RendererSDFInternalState.frame_capture.frames_delivered;
+}
+
+uint64_t renderer_sdf_render_frames(uint32_t frame_count, renderer_sdf_frame_capture_fn callback, void* user_data)
+{
+    frame_capture_state* capture          = &s_RendererSDFInternalState.frame_capture;
+    uint64_t             delivered_before = capture->frames_delivered;
+
+    renderer_sdf_set_frame_capture(callback, user_data);
+
+    for (uint32_t i = 0; i < frame_count; i++)
+        renderer_sdf_render();
+
+    // the last MAX_FRAMES_INFLIGHT copies are still in flight, wait for them instead of rendering extra frames
+    g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
+
+    renderer_internal_drain_frame_captures();
+
+    renderer_sdf_set_frame_capture(NULL, NULL);
+
+    return capture->frames_delivered - delivered_before;
+}
+
+const renderer_sdf_record_stats* renderer_sdf_get_record_stats(void)
+{
+    return &s_RendererSDFInternalState.cmd_record.stats;
+}
+
+void renderer_sdf_set_record_threads(uint32_t count)
+{
+    if (count > MAX_RECORD_THREADS)
+        count = MAX_RECORD_THREADS;
+
+    // every chunk, the caller's included, records into its own secondary
+    uint32_t threads = count;
+    if (threads > 1) {
+        uint32_t created = renderer_internal_create_thread_cmds(count);
+        if (created < count) {
+            LOG_WARN("[Renderer] only %u of %u record threads have secondary command buffers", created, count);
+            threads = created;
+        }
+    }
+
+    s_RendererSDFInternalState.cmd_record.threads = threads > 1 ? threads : 1;
+}
+
+uint32_t renderer_sdf_get_record_threads(void)
+{
+    return s_RendererSDFInternalState.cmd_record.threads;
+}
+
+double renderer_sdf_measure_scene_recording(uint32_t dispatch_count, uint32_t threads)
+{
+#if !TRIANGLE_TEST
+    const SDF_Scene* scene = s_RendererSDFInternalState.scene;
+    if (!scene || dispatch_count == 0)
+        return -1.0;
+
+    if (threads > MAX_RECORD_THREADS)
+        threads = MAX_RECORD_THREADS;
+    if (threads == 0 || renderer_internal_create_thread_cmds(threads) < threads)
+        return -1.0;
+
+    // every slot is idle after this, the recorded secondaries are simply reset by the next frame
+    g_rhi.flush_gpu_work(&s_RendererSDFInternalState.gfxcontext);
+
+    int32_t  scene_nodes[MAX_SDF_NODES];
+    uint32_t scene_dispatches = renderer_internal_gather_scene_dispatches(scene, scene_nodes);
+    // nothing to replay, e.g. an empty scene
+    if (scene_dispatches == 0)
+        return -1.0;
+
+    int32_t* dispatch_nodes = malloc(sizeof(int32_t) * dispatch_count);
+    if (!dispatch_nodes)
+        return -1.0;
+    for (uint32_t i = 0; i < dispatch_count; i++)
+        dispatch_nodes[i] = scene_nodes[i % scene_dispatches];
+
+    scene_record_job job = {
+        .pc_data         = s_RendererSDFInternalState.sdfscene_resources.pc_data,
+        .table           = s_RendererSDFInternalState.sdfscene_resources.tables,
+        .dispatch_nodes  = dispatch_nodes,
+        .dispatch_count  = dispatch_count,
+        .chunk_count     = threads > dispatch_count ? dispatch_count : threads,
+        .frame_idx       = s_RendererSDFInternalState.gfxcontext.inflight_frame_idx,
+        .dispatch_extent = {s_RendererSDFInternalState.width, s_RendererSDFInternalState.height},
+    };
+
+    gfx_cmd_buf secondaries[MAX_RECORD_THREADS];
+    uint64_t    start = timer_now_ns();
+    renderer_internal_record_scene_chunks(&job, secondaries);
+    double record_ms = timer_elapsed_ms(start);
+
+    free(dispatch_nodes);
+    return record_ms;
+#else
+    (void) dispatch_count;
+    (void) threads;
+    return -1.0;
+#endif
+}
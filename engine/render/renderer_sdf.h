@@ -14,6 +14,8 @@ typedef struct renderer_desc
     uint32_t           width;
     uint32_t           height;
     struct GLFWwindow* window;
+    // raymarch straight into the swapchain when it supports storage usage, falls back to the scene texture + screen quad
+    bool               write_to_backbuffer;
 } renderer_desc;
 
 bool renderer_sdf_init(renderer_desc desc);
@@ -27,7 +29,191 @@ void             renderer_sdf_set_scene(const SDF_Scene* scene);
 
 void renderer_sdf_draw_scene(const SDF_Scene* scene);
 
+// One-off blocking capture of the next frame, see renderer_sdf_set_frame_capture for streaming
 void                        renderer_sdf_set_capture_swapchain_ready(void);
 const gfx_texture_readback* renderer_sdf_get_last_swapchain_readback(void);
 
+// frame->pixels points into mapped staging memory and is only valid during the callback
+typedef void (*renderer_sdf_frame_capture_fn)(const gfx_texture_readback* frame, uint64_t frame_index, void* user_data);
+
+// Streams every presented frame back without stalling, delivered MAX_FRAMES_INFLIGHT frames late
+// NULL stops capturing, copies still in flight are dropped
+void     renderer_sdf_set_frame_capture(renderer_sdf_frame_capture_fn callback, void* user_data);
+uint64_t renderer_sdf_get_captured_frame_count(void);
+
+// Renders the current scene frame_count times and blocks until every frame was delivered to callback
+// Meant for headless batch rendering (thumbnails, golden images, benchmarks), returns the frames delivered
+uint64_t renderer_sdf_render_frames(uint32_t frame_count, renderer_sdf_frame_capture_fn callback, void* user_data);
+
+// Filled by renderer_sdf_init, shader/pipeline times are also refreshed by hot reload
+typedef struct renderer_sdf_startup_timings
+{
+    double   context_ms;           // device, swapchain, command pools and heaps
+    double   pass_resources_ms;    // everything below plus textures, buffers and descriptor tables
+    double   shaders_ms;           // summed over the pipeline jobs, CPU time not wall time
+    double   pipelines_ms;         // same as shaders_ms
+    double   shaders_pipelines_wall_ms;
+    uint32_t pipeline_jobs;
+    uint32_t _pad0;
+    uint64_t pipeline_cache_bytes;    // loaded from g_gfxConfig.pipeline_cache_path, 0 on a cold start
+} renderer_sdf_startup_timings;
+
+const renderer_sdf_startup_timings* renderer_sdf_get_startup_timings(void);
+
+//---------------------------------------------------------
+// Command recording
+//---------------------------------------------------------
+
+// Below this many dispatches per thread the scene draw pass is recorded inline, forking costs more than it saves
+#define SDF_MIN_DISPATCHES_PER_RECORD_THREAD 32
+
+typedef struct renderer_sdf_record_stats
+{
+    double   record_ms;    // CPU time of the last scene draw pass recording, fork-join included
+    uint32_t threads;      // 1 when recorded inline into the frame's command buffer
+    uint32_t dispatches;
+} renderer_sdf_record_stats;
+
+const renderer_sdf_record_stats* renderer_sdf_get_record_stats(void);
+
+// Scene draw dispatches are split into contiguous chunks recorded on the job system, one secondary command buffer per chunk
+// Clamped to MAX_RECORD_THREADS, stays at 1 when the backend has no secondary command buffers
+void     renderer_sdf_set_record_threads(uint32_t count);
+uint32_t renderer_sdf_get_record_threads(void);
+
+// Benchmark hook: records dispatch_count scene dispatches (cycling over the scene nodes) in threads chunks without submitting them
+// Flushes the GPU first, returns the CPU time in ms or a negative value when there's no scene, nothing to dispatch or no secondaries
+double renderer_sdf_measure_scene_recording(uint32_t dispatch_count, uint32_t threads);
+
+//---------------------------------------------------------
+// Async compute
+//---------------------------------------------------------
+
+// With a dedicated compute queue the scene texture path raymarches there while the gfx queue
+// finishes the previous frame, the screen quad waits on it. Enabled by default when supported
+// and preferred over renderer_desc.write_to_backbuffer, the march debug views stay on the gfx queue.
+// Returns false when the backend has no separate compute queue
+bool renderer_sdf_set_async_compute(bool enable);
+// True when the next frame's scene draw goes to the compute queue
+bool renderer_sdf_is_async_compute_active(void);
+
+//---------------------------------------------------------
+// Frame pacing
+//---------------------------------------------------------
+
+// Optional, waits for the frame slot, acquires the backbuffer and then polls window events.
+// Sampling input between this and renderer_sdf_render (late latch) keeps the wait out of the
+// input-to-display latency. renderer_sdf_render begins the frame itself otherwise, no-op without a scene
+void renderer_sdf_begin_frame(void);
+
+// CPU time the last frame spent blocked, in milliseconds
+typedef struct renderer_sdf_frame_pacing
+{
+    double cpu_wait_ms;        // waiting for the GPU to retire the in-flight slot being reused
+    double gpu_ms;             // GPU frame zone, resolved frame_queue_depth frames late, 0 without timestamp queries
+    double present_wait_ms;    // backbuffer acquire + present, FIFO blocks here once its queue is full
+} renderer_sdf_frame_pacing;
+
+const renderer_sdf_frame_pacing* renderer_sdf_get_frame_pacing(void);
+
+// Recreates the swapchain, modes the surface doesn't support fall back to FIFO
+void renderer_sdf_set_present_mode(gfx_present_mode mode);
+// Frames the CPU may queue ahead of the GPU, clamped to [1, MAX_FRAMES_INFLIGHT]. Flushes the GPU,
+// lower depths trade throughput for latency
+void     renderer_sdf_set_frame_queue_depth(uint32_t depth);
+uint32_t renderer_sdf_get_frame_queue_depth(void);
+
+//---------------------------------------------------------
+// Incremental redraw
+//---------------------------------------------------------
+
+// Dirty rects covering more of the screen than this re-march everything
+#define SDF_PARTIAL_REDRAW_MAX_COVERAGE 0.5f
+
+typedef struct renderer_sdf_redraw_stats
+{
+    uint64_t full_frames;
+    uint64_t partial_frames;         // only the union of the changed nodes' old and new screen rects
+    uint64_t skipped_frames;         // camera and scene unchanged, last frame's scene texture re-presented
+    uint64_t marched_pixels;         // summed over every frame
+    uint64_t last_marched_pixels;
+} renderer_sdf_redraw_stats;
+
+// Keeps last frame's scene texture around and only re-marches what changed, enabled by default.
+// Forces the scene texture path on the gfx queue while it pays off, debug views always march everything
+void                             renderer_sdf_set_incremental_redraw(bool enable);
+const renderer_sdf_redraw_stats* renderer_sdf_get_redraw_stats(void);
+
+//---------------------------------------------------------
+// GPU pass timings
+//---------------------------------------------------------
+
+#define SDF_GPU_TIMINGS_WINDOW 128    // frames in the rolling average
+
+typedef enum renderer_sdf_gpu_pass
+{
+    SDF_GPU_PASS_FRAME,
+    SDF_GPU_PASS_SCENE_DRAW,    // also clears the target on miss
+    SDF_GPU_PASS_SCREEN_QUAD,    // 0 when raymarching straight into the backbuffer
+    SDF_GPU_PASS_COUNT
+} renderer_sdf_gpu_pass;
+
+typedef struct renderer_sdf_gpu_timings
+{
+    double   last_ms[SDF_GPU_PASS_COUNT];
+    double   avg_ms[SDF_GPU_PASS_COUNT];
+    uint64_t frames_resolved;
+} renderer_sdf_gpu_timings;
+
+// Timings lag MAX_FRAMES_INFLIGHT frames behind, they are read back once the frame slot is reused
+const renderer_sdf_gpu_timings* renderer_sdf_get_gpu_timings(void);
+const char*                     renderer_sdf_get_gpu_pass_name(renderer_sdf_gpu_pass pass);
+
+// Logs the rolling averages every SDF_GPU_TIMINGS_WINDOW frames
+void renderer_sdf_set_gpu_timings_logging(bool enable);
+// Appends every resolved frame to a CSV file, NULL closes the current one
+bool renderer_sdf_set_gpu_timings_csv(const char* path);
+
+//---------------------------------------------------------
+// Raymarch telemetry
+//---------------------------------------------------------
+
+// keep in sync with raymarch_sdf_scene.comp
+#define SDF_MAX_MARCH_STEPS         128
+#define SDF_MARCH_HISTOGRAM_BUCKETS 16
+
+typedef enum renderer_sdf_debug_view
+{
+    SDF_DEBUG_VIEW_NONE,
+    SDF_DEBUG_VIEW_STEP_HEATMAP,    // march steps per pixel, summed over all node dispatches
+    SDF_DEBUG_VIEW_NODE_HEATMAP,    // primitive evaluations per pixel, includes normal estimation
+    SDF_DEBUG_VIEW_COUNT
+} renderer_sdf_debug_view;
+
+// A ray is one pixel of one node dispatch
+typedef struct renderer_sdf_march_stats
+{
+    uint64_t frame;    // renderer frame the counters were recorded in
+    uint64_t rays;
+    uint64_t total_steps;
+    uint64_t total_node_evals;
+    double   mean_steps;
+    double   mean_node_evals;
+    uint32_t min_steps;
+    uint32_t max_steps;
+    int32_t  max_steps_node;    // scene node index of the ray that took max_steps
+    uint32_t _pad0;
+    // bucket i counts rays with i * (SDF_MAX_MARCH_STEPS + 1) / SDF_MARCH_HISTOGRAM_BUCKETS steps and up
+    uint32_t histogram[SDF_MARCH_HISTOGRAM_BUCKETS];
+} renderer_sdf_march_stats;
+
+// Counters are read back MAX_FRAMES_INFLIGHT frames late without stalling
+void                            renderer_sdf_set_march_counters(bool enable);
+const renderer_sdf_march_stats* renderer_sdf_get_march_stats(void);    // NULL until the first readback
+
+// False color in the screen quad, forces the scene texture path while enabled
+void renderer_sdf_set_debug_view(renderer_sdf_debug_view view);
+// Heatmap value drawn as the hottest color, defaults to SDF_MAX_MARCH_STEPS
+void renderer_sdf_set_heatmap_scale(uint32_t value);
+
 #endif
\ No newline at end of file
@@ -11,35 +11,51 @@
 
 #include <limits.h>
 
+// Scripts may despawn objects, even their own. A despawn swaps the last object into the freed
+// slot, so after a callback slot i either still holds the object that just ran or one that
+// hasn't run yet this frame
+static bool scripting_internal_slot_holds(uint32_t i, gameobject_handle handle)
+{
+    if (i >= game_registry_get_num_objects())
+        return false;
+    GameObject* go = game_registry_get_objects()[i];
+    return go->handle.index == handle.index && go->handle.generation == handle.generation;
+}
+
 void gameobjects_start(void)
 {
-    hash_map_t* registry = game_registry_get_instance();
-
-    for (size_t i = 0; i < registry->capacity; i++) {
-        hash_map_pair_t pair = registry->entries[i];
-        if (!uuid_is_null(&pair.key) && pair.value) {
-            GameObject* go = (GameObject*) pair.value;
-            go->startFn(&go->uuid);
-        }
+    GameObject** objects = game_registry_get_objects();
+
+    // a start function may spawn more objects, they're appended and started too
+    for (uint32_t i = 0; i < game_registry_get_num_objects();) {
+        gameobject_handle handle = objects[i]->handle;
+        objects[i]->startFn(&objects[i]->uuid);
+
+        if (scripting_internal_slot_holds(i, handle))
+            i++;
     }
 }
 
 void gameobjects_update(float dt)
 {
     (void) dt;
-    hash_map_t* registry = game_registry_get_instance();
+    GameObject** objects = game_registry_get_objects();
 
     const SDF_Scene* scene = renderer_sdf_get_scene();
 
-    for (size_t i = 0; i < registry->capacity; i++) {
-        hash_map_pair_t pair = registry->entries[i];
-        if (!uuid_is_null(&pair.key) && pair.value) {
-            GameObject* go = (GameObject*) pair.value;
-            if (go->updateFn)
-                go->updateFn(&go->uuid, dt);
+    // re-read the count, an update may spawn or despawn. Despawning an already updated object
+    // moves the last one into a visited slot, it then skips a frame
+    for (uint32_t i = 0; i < game_registry_get_num_objects();) {
+        gameobject_handle handle = objects[i]->handle;
+        if (objects[i]->updateFn)
+            objects[i]->updateFn(&objects[i]->uuid, dt);
+
+        // NULL when the update despawned its own object, its pool block may already be reused
+        GameObject* go = game_registry_get_gameobject(handle);
+        if (go && go->sdfNodeIdx != UINT_MAX && go->isRenderable)
+            scene->nodes[go->sdfNodeIdx].primitive.transform = go->transform;
 
-            if (go->sdfNodeIdx != UINT_MAX && go->isRenderable)
-                scene->nodes[go->sdfNodeIdx].primitive.transform = go->transform;
-        }
+        if (scripting_internal_slot_holds(i, handle))
+            i++;
     }
 }
@@ -19,9 +19,29 @@ layout(location = 0) in vec2 inUV;
 layout(location = 0) out vec4 outColorRenderTarget;
 
 layout(binding = 0, set = 0) uniform texture2D sceneTexture;
+layout(binding = 1, set = 0, r32ui) readonly uniform uimage2D heatmap;
 layout(binding = 0, set = 1) uniform sampler sceneSampler;
 
+layout (push_constant) uniform PushConstant {
+    int  debug_view;     // renderer_sdf_debug_view, 0 shows the scene
+    uint heatmap_scale;  // value mapped to the hottest color
+}pc_data;
+
+// blue -> cyan -> green -> yellow -> red
+vec3 falseColor(float t) {
+    t = clamp(t, 0.0, 1.0);
+    return clamp(vec3(4.0 * t - 2.0, 4.0 * t < 2.0 ? 4.0 * t : 4.0 - 4.0 * t, 2.0 - 4.0 * t), 0.0, 1.0);
+}
+
 void main() {
+    if (pc_data.debug_view != 0) {
+        ivec2 size  = imageSize(heatmap);
+        ivec2 px    = min(ivec2(inUV * vec2(size)), size - 1);
+        uint  value = imageLoad(heatmap, px).r;
+        outColorRenderTarget = vec4(falseColor(float(value) / float(max(pc_data.heatmap_scale, 1u))), 1.0);
+        return;
+    }
+
     outColorRenderTarget = texture(sampler2D(sceneTexture, sceneSampler), inUV);
 }
 	
\ No newline at end of file
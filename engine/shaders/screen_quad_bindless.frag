@@ -0,0 +1,39 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// screen_quad.frag on the bindless heap, the pass only pushes indices
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColorRenderTarget;
+
+// gfx_bindless_range: set 0 binding 0 sampled images, binding 1 storage images, set 1 samplers
+layout(binding = 0, set = 0) uniform texture2D sampledImages[];
+layout(binding = 1, set = 0, r32ui) readonly uniform uimage2D storageImagesR32UI[];
+layout(binding = 0, set = 1) uniform sampler samplers[];
+
+layout (push_constant) uniform PushConstant {
+    int  debug_view;     // renderer_sdf_debug_view, 0 shows the scene
+    uint heatmap_scale;  // value mapped to the hottest color
+    uint scene_texture;  // sampledImages
+    uint heatmap;        // storageImagesR32UI
+    uint scene_sampler;  // samplers
+}pc_data;
+
+// blue -> cyan -> green -> yellow -> red
+vec3 falseColor(float t) {
+    t = clamp(t, 0.0, 1.0);
+    return clamp(vec3(4.0 * t - 2.0, 4.0 * t < 2.0 ? 4.0 * t : 4.0 - 4.0 * t, 2.0 - 4.0 * t), 0.0, 1.0);
+}
+
+void main() {
+    if (pc_data.debug_view != 0) {
+        ivec2 size  = imageSize(storageImagesR32UI[pc_data.heatmap]);
+        ivec2 px    = min(ivec2(inUV * vec2(size)), size - 1);
+        uint  value = imageLoad(storageImagesR32UI[pc_data.heatmap], px).r;
+        outColorRenderTarget = vec4(falseColor(float(value) / float(max(pc_data.heatmap_scale, 1u))), 1.0);
+        return;
+    }
+
+    outColorRenderTarget = texture(sampler2D(sampledImages[pc_data.scene_texture], samplers[pc_data.scene_sampler]), inUV);
+}
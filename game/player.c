@@ -12,6 +12,9 @@
 
 static int PLAYER_SPEED = 10;
 
+// resolved once in start, update moves the player every frame without a uuid lookup
+static gameobject_handle s_PlayerHandle = {UINT32_MAX, 0};
+
 void Player_Start(random_uuid_t* uuid)
 {
     (void) uuid;
@@ -21,6 +24,7 @@ void Player_Start(random_uuid_t* uuid)
     // gameobject_set_scale(*uuid, newScale);
 
     Camera_set_player_uuid(*uuid);
+    s_PlayerHandle = gameobject_get_handle(*uuid);
 
     //gameobject_set_rotation_euler( *uuid, (vec3){glm_rad(0.0f), glm_rad(0.0f), -glm_rad(45.0f/ 2.0f)});
 }
@@ -32,13 +36,13 @@ void Player_Update(random_uuid_t* uuid, float dt)
 
     GameState* gameState      = gamestate_get_global_instance();
     vec3s      playerPosition = {0};
-    gameobject_get_position(*uuid, &playerPosition.raw);
+    gameobject_handle_get_position(s_PlayerHandle, &playerPosition.raw);
 
     if (gameState->keycodes[GLFW_KEY_UP])
         playerPosition.z -= PLAYER_SPEED * dt;
     if (gameState->keycodes[GLFW_KEY_DOWN])
         playerPosition.z += PLAYER_SPEED * dt;
 
-    gameobject_set_position(*uuid, playerPosition.raw);
+    gameobject_handle_set_position(s_PlayerHandle, playerPosition.raw);
     //gameobject_set_rotation_euler(*uuid, (vec3){glm_rad(0.0f), glm_rad(0.0f), glm_rad(45.0f)});
 }
\ No newline at end of file
@@ -35,21 +35,40 @@ struct blend_node
     float4x4 transform;
 };
 
+struct MarchCounters
+{
+    uint rays;
+    uint steps_lo;
+    uint steps_hi;
+    uint node_evals_lo;
+    uint node_evals_hi;
+    uint min_steps;
+    uint max_steps_node;
+    uint _pad0;
+    uint histogram[16];
+};
+
 static const uint3 gl_WorkGroupSize = uint3(8u, 8u, 1u);
 
 cbuffer SDFScene : register(b0, space0)
 {
-    SDF_Node _1341_nodes[100] : packoffset(c0);
+    SDF_Node _1353_nodes[100] : packoffset(c0);
 };
 
+RWByteAddressBuffer _1798 : register(u2, space0);
 cbuffer PushConstant
 {
     row_major float4x4 pc_data_view_proj : packoffset(c0);
     int2 pc_data_resolution : packoffset(c4);
+    int pc_data_clear_on_miss : packoffset(c4.z);
     float3 pc_data_dir_light_pos : packoffset(c5);
     int pc_data_curr_draw_node_idx : packoffset(c5.w);
+    int pc_data_debug_flags : packoffset(c6);
+    int pc_data_counters_slot : packoffset(c6.y);
+    int2 pc_data_dispatch_offset : packoffset(c6.z);
 };
 
+RWTexture2D<uint> outHeatmap : register(u3, space0);
 RWTexture2D<float4> outColorRenderTarget : register(u1, space0);
 
 static uint3 gl_GlobalInvocationID;
@@ -58,6 +77,8 @@ struct SPIRV_Cross_Input
     uint3 gl_GlobalInvocationID : SV_DispatchThreadID;
 };
 
+static uint g_node_evals;
+
 // Returns the determinant of a 2x2 matrix.
 float spvDet2x2(float a1, float a2, float b1, float b2)
 {
@@ -193,16 +214,16 @@ float CappedTorus_get_radiusB(float4 packed1, float4 packed2)
 float cappedTorusSDF(inout float3 p, float2 sc, float ra, float rb)
 {
     p.x = abs(p.x);
-    float _600;
+    float _612;
     if ((sc.y * p.x) > (sc.x * p.y))
     {
-        _600 = dot(p.xy, sc);
+        _612 = dot(p.xy, sc);
     }
     else
     {
-        _600 = length(p.xy);
+        _612 = length(p.xy);
     }
-    float k = _600;
+    float k = _612;
     return sqrt((dot(p, p) + (ra * ra)) - ((2.0f * ra) * k)) - rb;
 }
 
@@ -302,11 +323,11 @@ float2 HexagonalPrism_get_radius(float4 packed1, float4 packed2)
 float hexPrismSDF(inout float3 p, float2 h)
 {
     p = abs(p);
-    float3 _752 = p;
-    float3 _758 = p;
-    float2 _760 = _758.xy - (float2(-0.866025388240814208984375f, 0.5f) * (2.0f * min(dot(float2(-0.866025388240814208984375f, 0.5f), _752.xy), 0.0f)));
-    p.x = _760.x;
-    p.y = _760.y;
+    float3 _764 = p;
+    float3 _770 = p;
+    float2 _772 = _770.xy - (float2(-0.866025388240814208984375f, 0.5f) * (2.0f * min(dot(float2(-0.866025388240814208984375f, 0.5f), _764.xy), 0.0f)));
+    p.x = _772.x;
+    p.y = _772.y;
     float2 d = float2(length(p.xy - float2(clamp(p.x, (-0.57735002040863037109375f) * h.x, 0.57735002040863037109375f * h.x), h.x)) * sign(p.y - h.x), p.z - h.y);
     return min(max(d.x, d.y), 0.0f) + length(max(d, 0.0f.xx));
 }
@@ -372,17 +393,17 @@ float cappedConeSDF(float3 p, float h, float r1, float r2)
     float2 ca = float2(q.x - min(q.x, (q.y < 0.0f) ? r1 : r2), abs(q.y) - h);
     float2 param = k2;
     float2 cb = (q - k1) + (k2 * clamp(dot(k1 - q, k2) / dot2(param), 0.0f, 1.0f));
-    bool _918 = cb.x < 0.0f;
-    bool _924;
-    if (_918)
+    bool _930 = cb.x < 0.0f;
+    bool _936;
+    if (_930)
     {
-        _924 = ca.y < 0.0f;
+        _936 = ca.y < 0.0f;
     }
     else
     {
-        _924 = _918;
+        _936 = _930;
     }
-    float s = _924 ? (-1.0f) : 1.0f;
+    float s = _936 ? (-1.0f) : 1.0f;
     float2 param_1 = ca;
     float2 param_2 = cb;
     return s * sqrt(min(dot2(param_1), dot2(param_2)));
@@ -447,8 +468,8 @@ float getPrimitiveSDF(float3 local_p, int primType, float4 packed1, float4 packe
             float3 param_19 = local_p;
             float3 param_20 = BoxFrame_get_dimensions(param_15, param_16);
             float param_21 = BoxFrame_get_thickness(param_17, param_18);
-            float _1120 = boxFrameSDF(param_19, param_20, param_21);
-            d = _1120;
+            float _1132 = boxFrameSDF(param_19, param_20, param_21);
+            d = _1132;
             break;
         }
         case 4:
@@ -472,8 +493,8 @@ float getPrimitiveSDF(float3 local_p, int primType, float4 packed1, float4 packe
             float2 param_33 = CappedTorus_get_majorMinor(param_26, param_27);
             float param_34 = CappedTorus_get_radiusA(param_28, param_29);
             float param_35 = CappedTorus_get_radiusB(param_30, param_31);
-            float _1152 = cappedTorusSDF(param_32, param_33, param_34, param_35);
-            d = _1152;
+            float _1164 = cappedTorusSDF(param_32, param_33, param_34, param_35);
+            d = _1164;
             break;
         }
         case 6:
@@ -500,8 +521,8 @@ float getPrimitiveSDF(float3 local_p, int primType, float4 packed1, float4 packe
             float3 param_50 = local_p;
             float param_51 = VerticalCapsule_get_radius(param_46, param_47);
             float param_52 = VerticalCapsule_get_height(param_48, param_49);
-            float _1190 = verticalCapsuleSDF(param_50, param_51, param_52);
-            d = _1190;
+            float _1202 = verticalCapsuleSDF(param_50, param_51, param_52);
+            d = _1202;
             break;
         }
         case 8:
@@ -546,8 +567,8 @@ float getPrimitiveSDF(float3 local_p, int primType, float4 packed1, float4 packe
             float4 param_75 = packed2;
             float3 param_76 = local_p;
             float2 param_77 = HexagonalPrism_get_radius(param_74, param_75);
-            float _1248 = hexPrismSDF(param_76, param_77);
-            d = _1248;
+            float _1260 = hexPrismSDF(param_76, param_77);
+            d = _1260;
             break;
         }
         case 12:
@@ -651,46 +672,44 @@ hit_info sceneSDF(float3 p)
 {
     hit_info hit;
     hit.d = 100.0f;
-    SDF_Node _1353;
-    _1353.nodeType = _1341_nodes[pc_data_curr_draw_node_idx].nodeType;
-    _1353.primType = _1341_nodes[pc_data_curr_draw_node_idx].primType;
-    _1353.transform = _1341_nodes[pc_data_curr_draw_node_idx].transform;
-    _1353.scale = _1341_nodes[pc_data_curr_draw_node_idx].scale;
-    _1353.packed_params[0] = _1341_nodes[pc_data_curr_draw_node_idx].packed_params[0];
-    _1353.packed_params[1] = _1341_nodes[pc_data_curr_draw_node_idx].packed_params[1];
-    _1353.blend = _1341_nodes[pc_data_curr_draw_node_idx].blend;
-    _1353.prim_a = _1341_nodes[pc_data_curr_draw_node_idx].prim_a;
-    _1353.prim_b = _1341_nodes[pc_data_curr_draw_node_idx].prim_b;
-    _1353.material.diffuse = _1341_nodes[pc_data_curr_draw_node_idx].material.diffuse;
-    SDF_Node parent_node = _1353;
+    SDF_Node parent_node;
+    parent_node.nodeType = _1353_nodes[pc_data_curr_draw_node_idx].nodeType;
+    parent_node.primType = _1353_nodes[pc_data_curr_draw_node_idx].primType;
+    parent_node.transform = _1353_nodes[pc_data_curr_draw_node_idx].transform;
+    parent_node.scale = _1353_nodes[pc_data_curr_draw_node_idx].scale;
+    parent_node.packed_params[0] = _1353_nodes[pc_data_curr_draw_node_idx].packed_params[0];
+    parent_node.packed_params[1] = _1353_nodes[pc_data_curr_draw_node_idx].packed_params[1];
+    parent_node.blend = _1353_nodes[pc_data_curr_draw_node_idx].blend;
+    parent_node.prim_a = _1353_nodes[pc_data_curr_draw_node_idx].prim_a;
+    parent_node.prim_b = _1353_nodes[pc_data_curr_draw_node_idx].prim_b;
+    parent_node.material.diffuse = _1353_nodes[pc_data_curr_draw_node_idx].material.diffuse;
     int sp = 0;
-    int _1360 = sp;
-    sp = _1360 + 1;
-    blend_node _1368 = { 0, pc_data_curr_draw_node_idx, parent_node.transform };
+    int _1403 = sp;
+    sp = _1403 + 1;
+    blend_node _1409 = { 0, pc_data_curr_draw_node_idx, parent_node.transform };
     blend_node stack[32];
-    stack[_1360] = _1368;
+    stack[_1403] = _1409;
+    SDF_Node node;
     while (sp > 0)
     {
-        int _1379 = sp;
-        int _1380 = _1379 - 1;
-        sp = _1380;
-        blend_node curr_blend_node = stack[_1380];
+        int _1420 = sp;
+        int _1421 = _1420 - 1;
+        sp = _1421;
+        blend_node curr_blend_node = stack[_1421];
         if (curr_blend_node.node < 0)
         {
             continue;
         }
-        SDF_Node _1394;
-        _1394.nodeType = _1341_nodes[curr_blend_node.node].nodeType;
-        _1394.primType = _1341_nodes[curr_blend_node.node].primType;
-        _1394.transform = _1341_nodes[curr_blend_node.node].transform;
-        _1394.scale = _1341_nodes[curr_blend_node.node].scale;
-        _1394.packed_params[0] = _1341_nodes[curr_blend_node.node].packed_params[0];
-        _1394.packed_params[1] = _1341_nodes[curr_blend_node.node].packed_params[1];
-        _1394.blend = _1341_nodes[curr_blend_node.node].blend;
-        _1394.prim_a = _1341_nodes[curr_blend_node.node].prim_a;
-        _1394.prim_b = _1341_nodes[curr_blend_node.node].prim_b;
-        _1394.material.diffuse = _1341_nodes[curr_blend_node.node].material.diffuse;
-        SDF_Node node = _1394;
+        node.nodeType = _1353_nodes[curr_blend_node.node].nodeType;
+        node.primType = _1353_nodes[curr_blend_node.node].primType;
+        node.transform = _1353_nodes[curr_blend_node.node].transform;
+        node.scale = _1353_nodes[curr_blend_node.node].scale;
+        node.packed_params[0] = _1353_nodes[curr_blend_node.node].packed_params[0];
+        node.packed_params[1] = _1353_nodes[curr_blend_node.node].packed_params[1];
+        node.blend = _1353_nodes[curr_blend_node.node].blend;
+        node.prim_a = _1353_nodes[curr_blend_node.node].prim_a;
+        node.prim_b = _1353_nodes[curr_blend_node.node].prim_b;
+        node.material.diffuse = _1353_nodes[curr_blend_node.node].material.diffuse;
         hit.material = node.material;
         float d = 100.0f;
         if (node.nodeType == 0)
@@ -707,6 +726,7 @@ hit_info sceneSDF(float3 p)
             float4 param_4 = packed1;
             float4 param_5 = packed2;
             d = getPrimitiveSDF(param_2, param_3, param_4, param_5);
+            g_node_evals++;
             d *= SCALE;
             if (curr_blend_node.blend == 0)
             {
@@ -776,17 +796,17 @@ hit_info sceneSDF(float3 p)
                 float4x4 child_transform = curr_blend_node.transform;
                 if (node.prim_b >= 0)
                 {
-                    int _1547 = sp;
-                    sp = _1547 + 1;
-                    blend_node _1554 = { node.blend, node.prim_b, child_transform };
-                    stack[_1547] = _1554;
+                    int _1608 = sp;
+                    sp = _1608 + 1;
+                    blend_node _1615 = { node.blend, node.prim_b, child_transform };
+                    stack[_1608] = _1615;
                 }
                 if (node.prim_a >= 0)
                 {
-                    int _1562 = sp;
-                    sp = _1562 + 1;
-                    blend_node _1569 = { node.blend, node.prim_a, child_transform };
-                    stack[_1562] = _1569;
+                    int _1622 = sp;
+                    sp = _1622 + 1;
+                    blend_node _1629 = { node.blend, node.prim_a, child_transform };
+                    stack[_1622] = _1629;
                 }
             }
         }
@@ -794,28 +814,31 @@ hit_info sceneSDF(float3 p)
     return hit;
 }
 
-hit_info raymarch(Ray ray)
+hit_info raymarch(Ray ray, inout uint steps)
 {
     hit_info hit;
     hit.d = 0.0f;
+    steps = 0u;
     for (int i = 0; i < 128; i++)
     {
         float3 p = ray.ro + (ray.rd * hit.d);
         float3 param = p;
-        hit_info h = sceneSDF(param);
+        hit_info _1731 = sceneSDF(param);
+        hit_info h = _1731;
+        steps++;
         hit.d += h.d;
         hit.material = h.material;
-        bool _1683 = hit.d > 100.0f;
-        bool _1690;
-        if (!_1683)
+        bool _1745 = hit.d > 100.0f;
+        bool _1752;
+        if (!_1745)
         {
-            _1690 = hit.d < 0.00999999977648258209228515625f;
+            _1752 = hit.d < 0.00999999977648258209228515625f;
         }
         else
         {
-            _1690 = _1683;
+            _1752 = _1745;
         }
-        if (_1690)
+        if (_1752)
         {
             break;
         }
@@ -826,17 +849,77 @@ hit_info raymarch(Ray ray)
 float3 estimateNormal(float3 p)
 {
     float3 param = float3(p.x + 0.00999999977648258209228515625f, p.y, p.z);
+    hit_info _1644 = sceneSDF(param);
     float3 param_1 = float3(p.x - 0.00999999977648258209228515625f, p.y, p.z);
+    hit_info _1655 = sceneSDF(param_1);
     float3 param_2 = float3(p.x, p.y + 0.00999999977648258209228515625f, p.z);
+    hit_info _1667 = sceneSDF(param_2);
     float3 param_3 = float3(p.x, p.y - 0.00999999977648258209228515625f, p.z);
+    hit_info _1678 = sceneSDF(param_3);
     float3 param_4 = float3(p.x, p.y, p.z + 0.00999999977648258209228515625f);
+    hit_info _1690 = sceneSDF(param_4);
     float3 param_5 = float3(p.x, p.y, p.z - 0.00999999977648258209228515625f);
-    return normalize(float3(sceneSDF(param).d - sceneSDF(param_1).d, sceneSDF(param_2).d - sceneSDF(param_3).d, sceneSDF(param_4).d - sceneSDF(param_5).d));
+    hit_info _1701 = sceneSDF(param_5);
+    return normalize(float3(_1644.d - _1655.d, _1667.d - _1678.d, _1690.d - _1701.d));
+}
+
+void recordMarchStats(int2 px, uint steps, uint node_evals)
+{
+    if ((pc_data_debug_flags & 6) != 0)
+    {
+        uint value = ((pc_data_debug_flags & 4) != 0) ? node_evals : steps;
+        uint _1782;
+        InterlockedAdd(outHeatmap[px], value, _1782);
+    }
+    if ((pc_data_debug_flags & 1) != 0)
+    {
+        int slot = pc_data_counters_slot;
+        uint _1802;
+        _1798.InterlockedAdd(slot * 96 + 0, 1u, _1802);
+        uint _1807;
+        _1798.InterlockedAdd(slot * 96 + 4, steps, _1807);
+        uint prev_ = _1807;
+        if ((prev_ + steps) < prev_)
+        {
+            uint _1817;
+            _1798.InterlockedAdd(slot * 96 + 8, 1u, _1817);
+        }
+        uint _1822;
+        _1798.InterlockedAdd(slot * 96 + 12, node_evals, _1822);
+        uint prev_1 = _1822;
+        if ((prev_1 + node_evals) < prev_1)
+        {
+            uint _1832;
+            _1798.InterlockedAdd(slot * 96 + 16, 1u, _1832);
+        }
+        uint _1836;
+        _1798.InterlockedMin(slot * 96 + 20, steps, _1836);
+        uint _1846;
+        _1798.InterlockedMax(slot * 96 + 24, (steps << uint(16)) | uint(pc_data_curr_draw_node_idx), _1846);
+        uint bucket = min(((steps * 16u) / 129u), 15u);
+        uint _1857;
+        _1798.InterlockedAdd(slot * 96 + bucket * 4 + 32, 1u, _1857);
+    }
 }
 
 void comp_main()
 {
-    float2 uv = float2(gl_GlobalInvocationID.xy) / float2(pc_data_resolution);
+    g_node_evals = 0u;
+    int2 px = int2(gl_GlobalInvocationID.xy) + pc_data_dispatch_offset;
+    if (any(bool2(px.x >= pc_data_resolution.x, px.y >= pc_data_resolution.y)))
+    {
+        return;
+    }
+    if (pc_data_curr_draw_node_idx < 0)
+    {
+        outColorRenderTarget[px] = 0.0f.xxxx;
+        if ((pc_data_debug_flags & 6) != 0)
+        {
+            outHeatmap[px] = uint4(0u, 0u, 0u, 0u).x;
+        }
+        return;
+    }
+    float2 uv = float2(px) / float2(pc_data_resolution);
     float2 ndcPos = ((uv * 2.0f) - 1.0f.xx) * float2(1.0f, -1.0f);
     float4 nearp = mul(float4(ndcPos, -1.0f, 1.0f), spvInverse(pc_data_view_proj));
     float4 farp = mul(float4(ndcPos, 1.0f, 1.0f), spvInverse(pc_data_view_proj));
@@ -845,14 +928,18 @@ void comp_main()
     ray.rd = normalize((farp.xyz / farp.w.xxx) - ray.ro);
     float4 FragColor = float4(1.0f, 0.0f, 1.0f, 0.0f);
     Ray param = ray;
-    hit_info hit = raymarch(param);
+    uint param_1;
+    hit_info _1960 = raymarch(param, param_1);
+    uint steps = param_1;
+    hit_info hit = _1960;
     if (hit.d < 100.0f)
     {
         float3 lightPos = float3(2.0f, 5.0f, 5.0f);
         float3 p = ray.ro + (ray.rd * hit.d);
         float3 l = normalize(lightPos - p);
-        float3 param_1 = p;
-        float3 n = normalize(estimateNormal(param_1));
+        float3 param_2 = p;
+        float3 _1987 = estimateNormal(param_2);
+        float3 n = normalize(_1987);
         float3 r = reflect(-l, n);
         float3 v = normalize(ray.ro - p);
         float3 h = normalize(l + v);
@@ -861,8 +948,21 @@ void comp_main()
         float3 specular = hit.material.diffuse.xyz * spec;
         float3 diffuseColor = hit.material.diffuse.xyz * diffuse;
         FragColor = float4(diffuseColor + (specular * 10.0f), 1.0f);
-        outColorRenderTarget[int2(gl_GlobalInvocationID.xy)] = FragColor;
-        return;
+        outColorRenderTarget[px] = FragColor;
+    }
+    else
+    {
+        if (pc_data_clear_on_miss != 0)
+        {
+            outColorRenderTarget[px] = 0.0f.xxxx;
+        }
+    }
+    if (pc_data_debug_flags != 0)
+    {
+        int2 param_3 = px;
+        uint param_4 = steps;
+        uint param_5 = g_node_evals;
+        recordMarchStats(param_3, param_4, param_5);
     }
 }
 
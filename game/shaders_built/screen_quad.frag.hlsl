@@ -1,8 +1,15 @@
+cbuffer PushConstant
+{
+    int pc_data_debug_view : packoffset(c0);
+    uint pc_data_heatmap_scale : packoffset(c0.y);
+};
+
+RWTexture2D<uint> heatmap : register(u1, space0);
 Texture2D<float4> sceneTexture : register(t0, space0);
 SamplerState sceneSampler : register(s0, space1);
 
-static float4 outColorRenderTarget;
 static float2 inUV;
+static float4 outColorRenderTarget;
 
 struct SPIRV_Cross_Input
 {
@@ -14,8 +21,42 @@ struct SPIRV_Cross_Output
     float4 outColorRenderTarget : SV_Target0;
 };
 
+uint2 spvImageSize(RWTexture2D<uint> Tex, out uint Param)
+{
+    uint2 ret;
+    Tex.GetDimensions(ret.x, ret.y);
+    Param = 0u;
+    return ret;
+}
+
+float3 falseColor(inout float t)
+{
+    t = clamp(t, 0.0f, 1.0f);
+    float _26;
+    if ((4.0f * t) < 2.0f)
+    {
+        _26 = 4.0f * t;
+    }
+    else
+    {
+        _26 = 4.0f - (4.0f * t);
+    }
+    return clamp(float3((4.0f * t) - 2.0f, _26, 2.0f - (4.0f * t)), 0.0f.xxx, 1.0f.xxx);
+}
+
 void frag_main()
 {
+    if (pc_data_debug_view != 0)
+    {
+        uint _64_dummy_parameter;
+        int2 size = int2(spvImageSize(heatmap, _64_dummy_parameter));
+        int2 px = min(int2(inUV * float2(size)), (size - int2(1, 1)));
+        uint value = heatmap[px].xxxx.x;
+        float param = float(value) / float(max(pc_data_heatmap_scale, 1u));
+        float3 _100 = falseColor(param);
+        outColorRenderTarget = float4(_100, 1.0f);
+        return;
+    }
     outColorRenderTarget = sceneTexture.Sample(sceneSampler, inUV);
 }
 
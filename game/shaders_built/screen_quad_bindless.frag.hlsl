@@ -0,0 +1,73 @@
+cbuffer PushConstant
+{
+    int pc_data_debug_view : packoffset(c0);
+    uint pc_data_heatmap_scale : packoffset(c0.y);
+    uint pc_data_scene_texture : packoffset(c0.z);
+    uint pc_data_heatmap : packoffset(c0.w);
+    uint pc_data_scene_sampler : packoffset(c1);
+};
+
+RWTexture2D<uint> storageImagesR32UI[] : register(u1, space0);
+Texture2D<float4> sampledImages[] : register(t0, space0);
+SamplerState samplers[] : register(s0, space1);
+
+static float2 inUV;
+static float4 outColorRenderTarget;
+
+struct SPIRV_Cross_Input
+{
+    float2 inUV : TEXCOORD0;
+};
+
+struct SPIRV_Cross_Output
+{
+    float4 outColorRenderTarget : SV_Target0;
+};
+
+uint2 spvImageSize(RWTexture2D<uint> Tex, out uint Param)
+{
+    uint2 ret;
+    Tex.GetDimensions(ret.x, ret.y);
+    Param = 0u;
+    return ret;
+}
+
+float3 falseColor(inout float t)
+{
+    t = clamp(t, 0.0f, 1.0f);
+    float _26;
+    if ((4.0f * t) < 2.0f)
+    {
+        _26 = 4.0f * t;
+    }
+    else
+    {
+        _26 = 4.0f - (4.0f * t);
+    }
+    return clamp(float3((4.0f * t) - 2.0f, _26, 2.0f - (4.0f * t)), 0.0f.xxx, 1.0f.xxx);
+}
+
+void frag_main()
+{
+    if (pc_data_debug_view != 0)
+    {
+        uint _71_dummy_parameter;
+        int2 size = int2(spvImageSize(storageImagesR32UI[pc_data_heatmap], _71_dummy_parameter));
+        int2 px = min(int2(inUV * float2(size)), (size - int2(1, 1)));
+        uint value = storageImagesR32UI[pc_data_heatmap][px].xxxx.x;
+        float param = float(value) / float(max(pc_data_heatmap_scale, 1u));
+        float3 _109 = falseColor(param);
+        outColorRenderTarget = float4(_109, 1.0f);
+        return;
+    }
+    outColorRenderTarget = sampledImages[pc_data_scene_texture].Sample(samplers[pc_data_scene_sampler], inUV);
+}
+
+SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+{
+    inUV = stage_input.inUV;
+    frag_main();
+    SPIRV_Cross_Output stage_output;
+    stage_output.outColorRenderTarget = outColorRenderTarget;
+    return stage_output;
+}
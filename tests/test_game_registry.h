@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+#include <engine/core/game_registry.h>
+#include <engine/core/gameobject.h>
+#include <engine/core/memory/heap_stats.h>
+
+static void test_game_registry_start(random_uuid_t* uuid)
+{
+    (void) uuid;
+}
+
+static void test_game_registry_update(random_uuid_t* uuid, float dt)
+{
+    (void) uuid;
+    (void) dt;
+}
+
+// counts its updates in its gameobject data
+static void test_game_registry_count_update(random_uuid_t* uuid, float dt)
+{
+    (void) dt;
+    (*(uint32_t*) game_registry_get_gameobject_by_uuid(*uuid)->gameObjectData)++;
+}
+
+static void test_game_registry_despawn_update(random_uuid_t* uuid, float dt)
+{
+    (void) dt;
+    UNREGISTER_GAME_OBJECT(*uuid);
+}
+
+void test_game_registry(void)
+{
+    const char* test_case = "test_game_registry";
+
+    game_registry_init();
+
+    // Handles resolve to the same object as the uuid
+    {
+        TEST_START();
+        random_uuid_t     uuid   = game_registry_register_gameobject_type(sizeof(uint32_t), test_game_registry_start, test_game_registry_update);
+        gameobject_handle handle = gameobject_get_handle(uuid);
+
+        gameobject_handle_set_position(handle, (vec3) {1.0f, 2.0f, 3.0f});
+        vec3 position = {0};
+        gameobject_get_position(uuid, &position);
+        TEST_END();
+        ASSERT_CON(game_registry_get_gameobject(handle) == game_registry_get_gameobject_by_uuid(uuid) && position[1] == 2.0f, test_case, "Handle and uuid should access the same gameobject.");
+        UNREGISTER_GAME_OBJECT(uuid);
+    }
+
+    // Removed objects leave their handles stale, even once the slot is reused
+    {
+        TEST_START();
+        gameobject_handle first = game_registry_spawn_gameobject(0, test_game_registry_start, test_game_registry_update);
+        UNREGISTER_GAME_OBJECT(gameobject_handle_get_uuid(first));
+        gameobject_handle second = game_registry_spawn_gameobject(0, test_game_registry_start, test_game_registry_update);
+        TEST_END();
+        ASSERT_CON(first.index == second.index && !gameobject_handle_is_valid(first) && gameobject_handle_is_valid(second), test_case, "Reused slots should not resolve stale handles.");
+        UNREGISTER_GAME_OBJECT(gameobject_handle_get_uuid(second));
+    }
+
+    // Despawns swap the last object into the hole and keep registryIdx in sync
+    {
+        TEST_START();
+        random_uuid_t uuids[5];
+        for (uint32_t i = 0; i < 5; i++)
+            uuids[i] = game_registry_register_gameobject_type(0, test_game_registry_start, test_game_registry_update);
+        UNREGISTER_GAME_OBJECT(uuids[1]);
+        UNREGISTER_GAME_OBJECT(uuids[4]);
+
+        GameObject** objects = game_registry_get_objects();
+        bool         packed  = game_registry_get_num_objects() == 3 && objects[1] == game_registry_get_gameobject_by_uuid(uuids[3]);
+        for (uint32_t i = 0; i < game_registry_get_num_objects(); i++)
+            packed = packed && objects[i]->registryIdx == i;
+        TEST_END();
+        ASSERT_CON(packed, test_case, "Despawns should keep the object array packed with matching registry indices.");
+
+        UNREGISTER_GAME_OBJECT(uuids[0]);
+        UNREGISTER_GAME_OBJECT(uuids[2]);
+        UNREGISTER_GAME_OBJECT(uuids[3]);
+    }
+
+    // An update despawning its own object doesn't make the loop skip the one moved into its slot
+    {
+        TEST_START();
+        REGISTER_GAME_OBJECT(uint32_t, test_game_registry_start, test_game_registry_despawn_update);
+        random_uuid_t first  = REGISTER_GAME_OBJECT(uint32_t, test_game_registry_start, test_game_registry_count_update);
+        random_uuid_t second = REGISTER_GAME_OBJECT(uint32_t, test_game_registry_start, test_game_registry_count_update);
+        gameobjects_update(0.016f);
+
+        uint32_t first_updates  = *(uint32_t*) game_registry_get_gameobject_by_uuid(first)->gameObjectData;
+        uint32_t second_updates = *(uint32_t*) game_registry_get_gameobject_by_uuid(second)->gameObjectData;
+        TEST_END();
+        ASSERT_CON(game_registry_get_num_objects() == 2 && first_updates == 1 && second_updates == 1, test_case, "Every surviving object should be updated once per frame.");
+
+        UNREGISTER_GAME_OBJECT(first);
+        UNREGISTER_GAME_OBJECT(second);
+    }
+
+    // Spawn/despawn churn reuses pool blocks and the pre-sized uuid map, no heap calls once warm
+    {
+        gameobject_handle live[MAX_OBJECTS / 2];
+        for (uint32_t i = 0; i < MAX_OBJECTS / 2; i++)
+            live[i] = game_registry_spawn_gameobject(sizeof(uint32_t), test_game_registry_start, test_game_registry_update);
+
+        TEST_START();
+        uint32_t heap_before = heap_stats_get_alloc_count();
+        for (uint32_t op = 0; op < 20000; op++) {
+            uint32_t victim = (op * 7919) % (MAX_OBJECTS / 2);
+            UNREGISTER_GAME_OBJECT(gameobject_handle_get_uuid(live[victim]));
+            live[victim] = game_registry_spawn_gameobject(sizeof(uint32_t), test_game_registry_start, test_game_registry_update);
+        }
+        uint32_t heap_allocs = heap_stats_get_alloc_count() - heap_before;
+        TEST_END();
+
+        // only counted in BYOE_COUNT_HEAP_ALLOCS builds, a resize of the uuid map would show up here
+        ASSERT_EQ(0u, heap_allocs, "%u", test_case, "Spawn/despawn churn should make no heap allocations.");
+
+        for (uint32_t i = 0; i < MAX_OBJECTS / 2; i++)
+            UNREGISTER_GAME_OBJECT(gameobject_handle_get_uuid(live[i]));
+    }
+
+    // Invalid handles and registry restarts
+    {
+        TEST_START();
+        gameobject_handle handle = game_registry_spawn_gameobject(0, test_game_registry_start, test_game_registry_update);
+        game_registry_destroy();
+        game_registry_init();
+        gameobject_handle fresh = game_registry_spawn_gameobject(0, test_game_registry_start, test_game_registry_update);
+        TEST_END();
+        ASSERT_CON(!gameobject_handle_is_valid(GAMEOBJECT_INVALID_HANDLE) && !gameobject_handle_is_valid(handle) && gameobject_handle_is_valid(fresh), test_case, "Handles from before a registry restart should be stale.");
+    }
+
+    game_registry_destroy();
+}
@@ -3,10 +3,48 @@
 
 #include "test.h"
 
+#include <engine/core/containers/concurrent_hash_map.h>
 #include <engine/core/containers/hash_map.h>
+#include <engine/core/containers/typed_hash_map.h>
 #include <engine/core/logging/log.h>
+#include <engine/core/threads/threads.h>
 #include <engine/core/uuid/uuid.h>
 
+typedef struct test_hash_map_value
+{
+    uint64_t id;
+    float    weight[3];
+    uint32_t _pad0;
+} test_hash_map_value;
+
+TYPED_HASH_MAP(test_u64_map, uint64_t, test_hash_map_value, hash_map_hash_u64, hash_map_equal_u64)
+TYPED_HASH_MAP(test_name_map, const char*, uint32_t, hash_map_hash_cstring, hash_map_equal_cstring)
+
+// Writers insert and remove their own keys while readers check the keys inserted up front
+typedef struct test_concurrent_hash_map_worker
+{
+    concurrent_hash_map_t* map;
+    random_uuid_t*         keys;
+    size_t                 count;
+    size_t                 found;
+    bool                   writer;
+    bool                   _pad0[7];
+} test_concurrent_hash_map_worker;
+
+static void test_concurrent_hash_map_worker_proc(void* arg)
+{
+    test_concurrent_hash_map_worker* worker = arg;
+    for (size_t i = 0; i < worker->count; i++) {
+        if (worker->writer) {
+            concurrent_hash_map_set_key_value(worker->map, worker->keys[i], &worker->keys[i]);
+            if (i % 2)
+                concurrent_hash_map_remove_entry(worker->map, worker->keys[i - 1]);
+        } else {
+            worker->found += concurrent_hash_map_get_value(worker->map, worker->keys[i]) == &worker->keys[i];
+        }
+    }
+}
+
 // Test function
 void test_hash_map(void)
 {
@@ -91,4 +129,287 @@ void test_hash_map(void)
     // Clean up
     hash_map_destroy(map);
     map = NULL;
+
+    // Fill both modes past their growth thresholds, remove half and check every key once more
+    hash_map_mode modes[] = {HASH_MAP_MODE_GROUPED, HASH_MAP_MODE_QUADRATIC};
+    for (size_t m = 0; m < ARRAY_SIZE(modes); m++) {
+        const size_t   count = 1000;
+        random_uuid_t* keys  = malloc(count * sizeof(random_uuid_t));
+
+        TEST_START();
+        map = hash_map_create_with_mode(64, modes[m]);
+        for (size_t i = 0; i < count; i++) {
+            uuid_generate(&keys[i]);
+            hash_map_set_key_value(map, keys[i], &keys[i]);
+        }
+
+        size_t found = 0;
+        for (size_t i = 0; i < count; i++)
+            found += hash_map_get_value(map, keys[i]) == &keys[i];
+        TEST_END();
+        ASSERT_EQ(count, found, "%zu", test_case, "Every inserted key should map to its value after growing.");
+
+        // odd count so the last window is partial, one miss in the middle
+        void**        batch  = malloc(count * sizeof(void*));
+        random_uuid_t missed = keys[count / 2];
+        uuid_generate(&keys[count / 2]);
+        hash_map_get_values_batch(map, keys, count - 1, batch);
+        keys[count / 2] = missed;
+
+        size_t matches = 0;
+        for (size_t i = 0; i < count - 1; i++)
+            matches += batch[i] == (i == count / 2 ? NULL : &keys[i]);
+        ASSERT_EQ(count - 1, matches, "%zu", test_case, "Batched lookups should agree with single lookups.");
+        free(batch);
+
+        {
+            for (size_t i = 0; i < count; i += 2)
+                hash_map_remove_entry(map, keys[i]);
+
+            size_t kept = 0, removed = 0;
+            for (size_t i = 0; i < count; i++) {
+                void* value = hash_map_get_value(map, keys[i]);
+                if (i % 2)
+                    kept += value == &keys[i];
+                else
+                    removed += value == NULL;
+            }
+            ASSERT_EQ(count / 2, kept, "%zu", test_case, "Keys probed past a removed slot should still be found.");
+            ASSERT_EQ(count / 2, removed, "%zu", test_case, "Removed keys should miss.");
+            ASSERT_EQ(count / 2, hash_map_get_length(map), "%zu", test_case, "Length should be exact after removes.");
+
+            // lookups don't touch the length, removing a missing key neither
+            hash_map_iterator(map, keys[1]);
+            hash_map_remove_entry(map, keys[0]);
+            ASSERT_EQ(count / 2, hash_map_get_length(map), "%zu", test_case, "Only removing a present key should change the length.");
+
+            size_t grown_capacity = map->capacity;
+            for (size_t i = 1; i < count - 8; i += 2)
+                hash_map_remove_entry(map, keys[i]);
+            ASSERT_CON(map->capacity < grown_capacity, test_case, "The table should shrink once occupancy drops.");
+
+            hash_map_shrink_to_fit(map);
+            size_t left = 0;
+            for (size_t i = count - 8; i < count; i++)
+                left += hash_map_get_value(map, keys[i]) == (i % 2 ? &keys[i] : NULL);
+            ASSERT_EQ((size_t) 8, left, "%zu", test_case, "Shrinking should keep every remaining key.");
+            ASSERT_EQ((size_t) HASH_MAP_GROUP_WIDTH, map->capacity, "%zu", test_case, "Shrink to fit should go down to the smallest table.");
+        }
+
+        hash_map_destroy(map);
+        map = NULL;
+        free(keys);
+    }
+
+    // Incremental resize: keys have to stay reachable while they're spread over both tables
+    {
+        const size_t   count = 5000;
+        random_uuid_t* keys  = malloc(count * sizeof(random_uuid_t));
+
+        TEST_START();
+        map = hash_map_create(16);
+        hash_map_set_incremental_resize(map, true);
+
+        size_t found = 0, resizing_inserts = 0;
+        for (size_t i = 0; i < count; i++) {
+            uuid_generate(&keys[i]);
+            hash_map_set_key_value(map, keys[i], &keys[i]);
+            resizing_inserts += hash_map_is_resizing(map);
+
+            // remove every third key right away, some of them before they were moved over
+            if (i % 3 == 0 && i > 0)
+                hash_map_remove_entry(map, keys[i - 1]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            void* value = hash_map_get_value(map, keys[i]);
+            found += (i % 3 == 2 && i + 1 < count) ? value == NULL : value == &keys[i];
+        }
+
+        size_t              iterated = 0;
+        hash_map_iterator_t iter     = hash_map_iterator_begin(map);
+        while (hash_map_parse_next(&iter))
+            iterated++;
+        TEST_END();
+
+        ASSERT_CON(resizing_inserts > 0, test_case, "Some inserts should land while a resize is in flight.");
+        ASSERT_EQ(count, found, "%zu", test_case, "Every key should be found, removed ones should miss, across both tables.");
+        ASSERT_EQ(hash_map_get_length(map), iterated, "%zu", test_case, "Iterating both tables should visit every entry once.");
+
+        hash_map_destroy(map);
+        map = NULL;
+        free(keys);
+    }
+
+    // Destroying mid resize releases the keys still waiting in the old table too
+    {
+        TEST_START();
+        map = hash_map_create(16);
+        hash_map_set_incremental_resize(map, true);
+        for (uint32_t i = 0; i < 1000 && !hash_map_is_resizing(map); i++) {
+            random_uuid_t key;
+            uuid_generate(&key);
+            hash_map_set_key_value(map, key, map);
+        }
+        bool resizing = hash_map_is_resizing(map);
+        hash_map_destroy(map);
+        map = NULL;
+        TEST_END();
+
+        ASSERT_CON(resizing, test_case, "Map should be destroyed while a resize is in flight.");
+    }
+
+    // Stats: capacity is the slot count, every entry lands in the probe histogram
+    {
+        TEST_START();
+        map = hash_map_create(16);
+        for (size_t i = 0; i < 1000; i++) {
+            random_uuid_t key;
+            uuid_generate(&key);
+            hash_map_set_key_value(map, key, map);
+        }
+
+        hash_map_stats_t stats;
+        hash_map_stats(map, &stats);
+        size_t histogram_total = 0;
+        for (size_t i = 0; i < HASH_MAP_PROBE_HISTOGRAM_BUCKETS; i++)
+            histogram_total += stats.probe_histogram[i];
+        TEST_END();
+
+        ASSERT_EQ(map->capacity, hash_map_get_capacity(map), "%zu", test_case, "hash_map_get_capacity should return the slot count, not the length.");
+        ASSERT_EQ((size_t) 1000, histogram_total, "%zu", test_case, "Every entry should be counted in the probe histogram.");
+        ASSERT_CON(stats.resize_count > 0 && stats.avg_probe_length >= 1.0f && stats.max_probe_length >= 1, test_case, "Stats should report the growth and probe lengths.");
+        ASSERT_CON(stats.load_factor > 0.0f && stats.load_factor <= (float) HASH_MAP_GROUP_MAX_LOAD_NUM / HASH_MAP_GROUP_MAX_LOAD_DEN, test_case, "Load factor should stay under the max load.");
+
+        hash_map_destroy(map);
+        map = NULL;
+    }
+
+    // Tombstone cleanups at the same capacity rehash in place: keys all homed in the first group
+    // fill it and overflow into the next one, removes from the full group leave tombstones
+    {
+        random_uuid_t keys[24];
+        for (size_t i = 0; i < 24; i++) {
+            do
+                uuid_generate(&keys[i]);
+            while ((hash_map_h1(hash_map_hash_uuid(&keys[i])) & 3) != 0);
+        }
+
+        TEST_START();
+        map = hash_map_create(64);
+        for (size_t i = 0; i < 24; i++)
+            hash_map_set_key_value(map, keys[i], &keys[i]);
+        for (size_t i = 0; i < 7; i++)
+            hash_map_remove_entry(map, keys[i]);
+
+        hash_map_pair_t* entries   = map->entries;
+        size_t           tombstone = map->deleted;
+        size_t           resizes   = map->resize_count;
+        hash_map_shrink_to_fit(map);
+
+        size_t found = 0;
+        for (size_t i = 0; i < 24; i++)
+            found += hash_map_get_value(map, keys[i]) == (i < 7 ? NULL : &keys[i]);
+        TEST_END();
+
+        ASSERT_CON(tombstone > 0 && map->deleted == 0 && map->resize_count == resizes + 1, test_case, "Cleanup should drop the tombstones left in the full group.");
+        ASSERT_CON(map->entries == entries && map->capacity == 64, test_case, "Cleanup at the same capacity should keep the table.");
+        ASSERT_EQ((size_t) 24, found, "%zu", test_case, "Every kept key should be found after the in place rehash, removed ones should miss.");
+
+        hash_map_destroy(map);
+        map = NULL;
+    }
+
+    // Typed map: values live in the table, growth and removes keep them intact
+    {
+        const uint64_t count = 20000;
+        test_u64_map   typed;
+
+        TEST_START();
+        test_u64_map_init(&typed, 0);
+        for (uint64_t i = 0; i < count; i++)
+            test_u64_map_set(&typed, i * 2654435761u, (test_hash_map_value){.id = i, .weight = {(float) i, 0.0f, 1.0f}});
+        for (uint64_t i = 0; i < count; i += 2)
+            test_u64_map_remove(&typed, i * 2654435761u);
+
+        size_t found = 0, iterated = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            const test_hash_map_value* value = test_u64_map_get(&typed, i * 2654435761u);
+            found += (i % 2 == 0) ? value == NULL : (value && value->id == i && value->weight[0] == (float) i);
+        }
+        for (size_t slot = test_u64_map_next(&typed, 0); slot < typed.capacity; slot = test_u64_map_next(&typed, slot + 1))
+            iterated++;
+
+        bool                 inserted = false;
+        test_hash_map_value* existing = test_u64_map_get_or_insert(&typed, 1 * 2654435761u, &inserted);
+        TEST_END();
+
+        ASSERT_EQ((size_t) count, found, "%zu", test_case, "Typed map should find every kept key with its inline value and miss removed ones.");
+        ASSERT_EQ((size_t) (count / 2), typed.length, "%zu", test_case, "Typed map length should count only live keys.");
+        ASSERT_EQ(typed.length, iterated, "%zu", test_case, "Walking the typed map should visit every live slot once.");
+        ASSERT_CON(!inserted && existing->id == 1, test_case, "get_or_insert should return the existing value.");
+
+        test_u64_map_destroy(&typed);
+    }
+
+    // String keys compare by content, not by pointer
+    {
+        test_name_map names;
+        char          name[] = "sphere";
+
+        TEST_START();
+        test_name_map_init(&names, 4);
+        test_name_map_set(&names, "sphere", 1);
+        test_name_map_set(&names, "cube", 2);
+        const uint32_t* value = test_name_map_get(&names, name);
+        TEST_END();
+
+        ASSERT_CON(value && *value == 1, test_case, "Typed map should find C string keys by content.");
+        ASSERT_CON(test_name_map_get(&names, "torus") == NULL, test_case, "Typed map should miss unknown C string keys.");
+
+        test_name_map_destroy(&names);
+    }
+
+    // Concurrent map: lookups of stable keys never miss while other threads grow the table
+    {
+        const size_t   count = 20000;
+        random_uuid_t* keys  = malloc(4 * count * sizeof(random_uuid_t));
+        for (size_t i = 0; i < 4 * count; i++)
+            uuid_generate(&keys[i]);
+
+        TEST_START();
+        concurrent_hash_map_t* concurrent = concurrent_hash_map_create(0);
+        for (size_t i = 0; i < count; i++)
+            concurrent_hash_map_set_key_value(concurrent, keys[i], &keys[i]);
+        // no lookup ran during these resizes, each one freed the table it replaced
+        bool reclaimed_single = concurrent->retired == NULL;
+
+        test_concurrent_hash_map_worker workers[4];
+        thread_t                        threads[4];
+        for (size_t t = 0; t < 4; t++) {
+            bool writer = t >= 2;
+            workers[t]  = (test_concurrent_hash_map_worker){.map = concurrent, .keys = writer ? &keys[t * count] : keys, .count = count, .writer = writer};
+            thread_create(&threads[t], test_concurrent_hash_map_worker_proc, &workers[t]);
+        }
+        for (size_t t = 0; t < 4; t++)
+            thread_join(&threads[t]);
+        concurrent_hash_map_reclaim(concurrent);
+        bool reclaimed_threaded = concurrent->retired == NULL;
+
+        size_t found = 0;
+        for (size_t i = 0; i < count; i++)
+            found += concurrent_hash_map_get_value(concurrent, keys[i]) == &keys[i];
+        for (size_t i = 2 * count; i < 4 * count; i++)
+            found += concurrent_hash_map_get_value(concurrent, keys[i]) == (i % 2 ? &keys[i] : NULL);
+        bool removed = concurrent_hash_map_remove_entry(concurrent, keys[0]) && concurrent_hash_map_get_value(concurrent, keys[0]) == NULL;
+        TEST_END();
+
+        ASSERT_EQ(2 * count, workers[0].found + workers[1].found, "%zu", test_case, "Readers should find every stable key while writers resize.");
+        ASSERT_EQ(3 * count, found, "%zu", test_case, "Concurrent map should hold the stable keys and every writer's last state.");
+        ASSERT_EQ((uint32_t) (2 * count), concurrent_hash_map_get_length(concurrent) + 1, "%u", test_case, "Concurrent map length should count live keys only.");
+        ASSERT_CON(removed, test_case, "Concurrent remove should hide the key.");
+        ASSERT_CON(reclaimed_single && reclaimed_threaded, test_case, "Retired tables should be freed once no lookup is in flight.");
+
+        concurrent_hash_map_destroy(concurrent);
+        free(keys);
+    }
 }
@@ -0,0 +1,55 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+#include <engine/engine.h>
+
+#include <GLFW/glfw3.h>
+
+// steady-state frames stepped after the engine's warm-up
+#define HEAP_STATS_TEST_FRAMES 120
+
+static void test_heap_stats_start(random_uuid_t* uuid)
+{
+    (void) uuid;
+}
+
+// ends engine_run once enough steady-state frames went by
+static void test_heap_stats_update(random_uuid_t* uuid, float dt)
+{
+    (void) uuid;
+    (void) dt;
+    if (engine_get_frame_heap_stats().steady_state_frames >= HEAP_STATS_TEST_FRAMES)
+        engine_request_quit();
+}
+
+// Uses the game_main from test_sdf_scene.h, only meaningful in BYOE_COUNT_HEAP_ALLOCS builds
+void test_heap_stats(void)
+{
+    const char* test_case = "test_heap_stats";
+
+    if (!heap_stats_is_enabled()) {
+        printf(COLOR_YELLOW "[Test Case] Skipped : %s : heap allocations aren't counted, needs -DBYOE_COUNT_HEAP_ALLOCS=ON and a linker with --wrap\n" COLOR_RESET, test_case);
+        return;
+    }
+
+    // Frames after the warm-up make no heap allocations
+    {
+        TEST_START();
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+        game_registry_register_gameobject_type(0, test_heap_stats_start, test_heap_stats_update);
+        engine_run();
+        engine_frame_heap_stats stats = engine_get_frame_heap_stats();
+        engine_destroy();
+
+        TEST_END();
+
+        printf("[Heap] %" PRIu64 " allocations over %" PRIu64 " steady-state frames, worst frame %u\n", stats.steady_state_allocs, stats.steady_state_frames, stats.max_frame_allocs);
+
+        ASSERT_CON(stats.steady_state_frames >= HEAP_STATS_TEST_FRAMES && stats.steady_state_allocs == 0, test_case, "Steady-state frames make no heap allocations");
+    }
+}
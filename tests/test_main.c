@@ -1,7 +1,12 @@
 #include "test_hash_map.h"
 #include "test_uuid.h"
 #include "test_rng.h"
+#include "test_game_registry.h"
+#include "test_pool_allocator.h"
 #include "test_sdf_scene.h"
+#include "test_render_graph.h"
+#include "test_startup.h"
+#include "test_heap_stats.h"
 
 int main(int argc, char** argv) {
     (void)argc;
@@ -11,7 +16,12 @@ int main(int argc, char** argv) {
     test_hash_map();
     test_uuid();
     test_rng();
+    test_game_registry();
+    test_pool_allocator();
     test_sdf_scene();
+    test_render_graph();
+    test_startup();
+    test_heap_stats();
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
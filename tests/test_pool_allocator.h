@@ -0,0 +1,98 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "test.h"
+
+#include <engine/core/memory/heap_stats.h>
+#include <engine/core/memory/pool_allocator.h>
+
+void test_pool_allocator(void)
+{
+    const char* test_case = "test_pool_allocator";
+
+    // Powers of two up to a cache line, whole cache lines above that
+    {
+        TEST_START();
+        bool classes = pool_allocator_size_class(1) == 16 && pool_allocator_size_class(16) == 16 &&
+                       pool_allocator_size_class(17) == 32 && pool_allocator_size_class(33) == 64 &&
+                       pool_allocator_size_class(64) == 64 && pool_allocator_size_class(65) == 128 &&
+                       pool_allocator_size_class(1000) == 1024;
+        TEST_END();
+        ASSERT_CON(classes, test_case, "Block sizes should round up to their size class.");
+    }
+
+    // Blocks are aligned to their size class, capped at a cache line
+    {
+        TEST_START();
+        size_t sizes[] = {16, 24, 48, 200};
+        bool   aligned = true;
+        for (size_t s = 0; s < ARRAY_SIZE(sizes); s++) {
+            pool_allocator pool;
+            pool_allocator_init(&pool, sizes[s], 8);
+            size_t alignment = pool.block_size < POOL_ALLOCATOR_CACHE_LINE ? pool.block_size : POOL_ALLOCATOR_CACHE_LINE;
+            // spans two slabs
+            for (uint32_t i = 0; i < 12; i++)
+                aligned = aligned && ((uintptr_t) pool_allocator_alloc(&pool) % alignment) == 0;
+            pool_allocator_destroy(&pool);
+        }
+        TEST_END();
+        ASSERT_CON(aligned, test_case, "Blocks should be aligned to their size up to a cache line.");
+    }
+
+    // Freed blocks are handed out again first
+    {
+        TEST_START();
+        pool_allocator pool;
+        pool_allocator_init(&pool, 32, 4);
+        void* a = pool_allocator_alloc(&pool);
+        void* b = pool_allocator_alloc(&pool);
+        pool_allocator_free(&pool, a);
+        pool_allocator_free(&pool, NULL);
+        void* c = pool_allocator_alloc(&pool);
+        TEST_END();
+        ASSERT_CON(c == a && b != a && pool.live == 2, test_case, "Allocations should reuse the most recently freed block.");
+        pool_allocator_destroy(&pool);
+    }
+
+    // Reserve allocates one slab for the missing blocks, a full pool grows by blocks_per_slab
+    {
+        TEST_START();
+        pool_allocator pool;
+        pool_allocator_init(&pool, 16, 4);
+        pool_allocator_alloc(&pool);
+        pool_allocator_alloc(&pool);
+
+        // the 2 blocks left in the first slab count towards the reservation
+        bool     reserved    = pool_allocator_reserve(&pool, 10);
+        uint32_t slabs       = pool.slab_count;
+        uint32_t heap_before = heap_stats_get_alloc_count();
+        for (uint32_t i = 0; i < 10; i++)
+            pool_allocator_alloc(&pool);
+        uint32_t heap_allocs  = heap_stats_get_alloc_count() - heap_before;
+        uint32_t slabs_before = pool.slab_count;
+        pool_allocator_alloc(&pool);
+        TEST_END();
+        ASSERT_CON(reserved && slabs == 2 && slabs_before == 2 && heap_allocs == 0 && pool.slab_count == 3 && pool.capacity == 16 && pool.live == 13,
+            test_case,
+            "Reserved blocks should be allocated without touching the heap, then the pool should grow by a slab.");
+        pool_allocator_destroy(&pool);
+    }
+
+    // Blocks larger than a cache line round up to whole cache lines and don't overlap
+    {
+        TEST_START();
+        pool_allocator pool;
+        pool_allocator_init(&pool, 1000, 2);
+        uint8_t* a = pool_allocator_alloc(&pool);
+        uint8_t* b = pool_allocator_alloc(&pool);
+        uint8_t* c = pool_allocator_alloc(&pool);
+        memset(a, 0xAA, 1000);
+        memset(b, 0xBB, 1000);
+        memset(c, 0xCC, 1000);
+        TEST_END();
+        ASSERT_CON(pool.block_size == 1024 && a[999] == 0xAA && b[0] == 0xBB && b[999] == 0xBB && c[0] == 0xCC && pool.slab_count == 2,
+            test_case,
+            "Oversized blocks should get whole cache lines of their own.");
+        pool_allocator_destroy(&pool);
+    }
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+#include <engine/render/frontend/render_graph.h>
+
+// No device needed, the graph only reaches the backend through these
+static uint32_t s_RenderGraphTestImageBarriers;
+static uint32_t s_RenderGraphTestSwapchainBarriers;
+static uint32_t s_RenderGraphTestTexturesCreated;
+
+static gfx_resource render_graph_test_create_texture(gfx_texture_create_info desc)
+{
+    (void) desc;
+    s_RenderGraphTestTexturesCreated++;
+    return (gfx_resource){0};
+}
+
+static void render_graph_test_destroy_texture(gfx_resource* texture)
+{
+    (void) texture;
+}
+
+static rhi_error_codes render_graph_test_image_barrier(const gfx_cmd_buf* cmd_buff, const gfx_resource* texture, gfx_image_layout old_layout, gfx_image_layout new_layout)
+{
+    (void) cmd_buff;
+    (void) texture;
+    (void) old_layout;
+    (void) new_layout;
+    s_RenderGraphTestImageBarriers++;
+    return Success;
+}
+
+static rhi_error_codes render_graph_test_swapchain_barrier(const gfx_cmd_buf* cmd_buff, const gfx_swapchain* swapchain, gfx_image_layout old_layout, gfx_image_layout new_layout)
+{
+    (void) cmd_buff;
+    (void) swapchain;
+    (void) old_layout;
+    (void) new_layout;
+    s_RenderGraphTestSwapchainBarriers++;
+    return Success;
+}
+
+static void render_graph_test_pass(gfx_cmd_buf* cmd_buff, const render_graph* graph, void* user_data)
+{
+    (void) cmd_buff;
+    (void) graph;
+    (*(uint32_t*) user_data)++;
+}
+
+void test_render_graph(void)
+{
+    const char* test_case = "test_render_graph";
+
+    rhi_jumptable saved_rhi               = g_rhi;
+    g_rhi.create_texture_resource         = render_graph_test_create_texture;
+    g_rhi.destroy_texture_resource        = render_graph_test_destroy_texture;
+    g_rhi.insert_image_layout_barrier     = render_graph_test_image_barrier;
+    g_rhi.insert_swapchain_layout_barrier = render_graph_test_swapchain_barrier;
+
+    // static, the graph is too big for the stack
+    static render_graph     graph;
+    gfx_swapchain           swapchain = {0};
+    gfx_resource            scene_tex = {0};
+    gfx_cmd_buf             cmd_buff  = {0};
+    gfx_texture_create_info desc      = {.width = 64, .height = 64, .depth = 1, .format = GFX_FORMAT_RGBAUNORM, .tex_type = GFX_TEXTURE_TYPE_2D, .res_type = GFX_RESOURCE_TYPE_STORAGE_IMAGE};
+
+    render_graph_init(&graph);
+
+    // Same transitions the SDF renderer used to insert by hand around the screen quad
+    {
+        s_RenderGraphTestImageBarriers     = 0;
+        s_RenderGraphTestSwapchainBarriers = 0;
+
+        TEST_START();
+        render_graph_begin(&graph);
+        render_graph_resource backbuffer = render_graph_import_swapchain(&graph, "backbuffer", &swapchain, GFX_IMAGE_LAYOUT_PRESENTATION, GFX_IMAGE_LAYOUT_PRESENTATION);
+        render_graph_resource scene      = render_graph_import_texture(&graph, "scene", &scene_tex, GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_GENERAL);
+
+        uint32_t executed   = 0;
+        uint32_t scene_draw = render_graph_add_pass(&graph, "scene_draw", render_graph_test_pass, &executed);
+        render_graph_pass_write(&graph, scene_draw, scene, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+        uint32_t screen_quad = render_graph_add_pass(&graph, "screen_quad", render_graph_test_pass, &executed);
+        render_graph_pass_read(&graph, screen_quad, scene, RENDER_GRAPH_ACCESS_SAMPLED);
+        render_graph_pass_write(&graph, screen_quad, backbuffer, RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT);
+
+        render_graph_execute(&graph, &cmd_buff);
+        TEST_END();
+
+        ASSERT_EQ(2u, executed, "%u", test_case, "Both passes should run.");
+        ASSERT_EQ(3u, s_RenderGraphTestImageBarriers, "%u", test_case, "Scene texture: GENERAL -> GENERAL against earlier writes, then -> SHADER_READ_ONLY -> GENERAL.");
+        ASSERT_EQ(2u, s_RenderGraphTestSwapchainBarriers, "%u", test_case, "Backbuffer: PRESENTATION -> COLOR_ATTACHMENT -> PRESENTATION.");
+        ASSERT_EQ(5u, render_graph_get_stats(&graph)->barriers, "%u", test_case, "Stats should count every barrier.");
+    }
+
+    // Back to back storage writes in GENERAL still need ordering
+    {
+        s_RenderGraphTestImageBarriers = 0;
+
+        TEST_START();
+        render_graph_begin(&graph);
+        render_graph_resource scene = render_graph_import_texture(&graph, "scene", &scene_tex, GFX_IMAGE_LAYOUT_GENERAL, GFX_IMAGE_LAYOUT_UNDEFINED);
+        render_graph_mark_output(&graph, scene);
+
+        uint32_t executed = 0;
+        uint32_t first    = render_graph_add_pass(&graph, "first", render_graph_test_pass, &executed);
+        render_graph_pass_write(&graph, first, scene, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+        uint32_t second = render_graph_add_pass(&graph, "second", render_graph_test_pass, &executed);
+        render_graph_pass_read(&graph, second, scene, RENDER_GRAPH_ACCESS_STORAGE_READ);
+        render_graph_pass_write(&graph, second, scene, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+
+        render_graph_execute(&graph, &cmd_buff);
+        TEST_END();
+
+        ASSERT_EQ(2u, s_RenderGraphTestImageBarriers, "%u", test_case, "GENERAL -> GENERAL before the first write and between the writes, none inside the read-write pass.");
+    }
+
+    // Passes whose writes nobody consumes are culled
+    {
+        s_RenderGraphTestImageBarriers = 0;
+
+        TEST_START();
+        render_graph_begin(&graph);
+        render_graph_resource backbuffer = render_graph_import_swapchain(&graph, "backbuffer", &swapchain, GFX_IMAGE_LAYOUT_PRESENTATION, GFX_IMAGE_LAYOUT_PRESENTATION);
+        render_graph_resource unused     = render_graph_create_texture(&graph, "unused", desc);
+
+        uint32_t executed = 0;
+        uint32_t dead     = render_graph_add_pass(&graph, "dead", render_graph_test_pass, &executed);
+        render_graph_pass_write(&graph, dead, unused, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+        uint32_t alive = render_graph_add_pass(&graph, "alive", render_graph_test_pass, &executed);
+        render_graph_pass_write(&graph, alive, backbuffer, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+
+        render_graph_execute(&graph, &cmd_buff);
+        TEST_END();
+
+        ASSERT_EQ(1u, render_graph_get_stats(&graph)->culled_passes, "%u", test_case, "The pass writing an unread transient should be culled.");
+        ASSERT_EQ(1u, executed, "%u", test_case, "Only the pass writing the backbuffer should run.");
+        ASSERT_EQ(0u, render_graph_get_stats(&graph)->transient_textures, "%u", test_case, "Culled transients get no memory.");
+        ASSERT_EQ(0u, s_RenderGraphTestImageBarriers, "%u", test_case, "Culled passes get no barriers.");
+    }
+
+    // A -> B -> C chain: A is dead once B read it, so C can alias it
+    {
+        s_RenderGraphTestTexturesCreated = 0;
+
+        TEST_START();
+        render_graph_resource a = RENDER_GRAPH_INVALID_RESOURCE;
+        render_graph_resource b = RENDER_GRAPH_INVALID_RESOURCE;
+        render_graph_resource c = RENDER_GRAPH_INVALID_RESOURCE;
+
+        uint32_t created_first_frame = 0;
+        for (uint32_t frame = 0; frame < 2; frame++) {
+            render_graph_begin(&graph);
+            render_graph_resource backbuffer = render_graph_import_swapchain(&graph, "backbuffer", &swapchain, GFX_IMAGE_LAYOUT_PRESENTATION, GFX_IMAGE_LAYOUT_PRESENTATION);
+            a                                = render_graph_create_texture(&graph, "a", desc);
+            b                                = render_graph_create_texture(&graph, "b", desc);
+            c                                = render_graph_create_texture(&graph, "c", desc);
+
+            uint32_t executed = 0;
+            uint32_t pass_a   = render_graph_add_pass(&graph, "write_a", render_graph_test_pass, &executed);
+            render_graph_pass_write(&graph, pass_a, a, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+            uint32_t pass_b = render_graph_add_pass(&graph, "a_to_b", render_graph_test_pass, &executed);
+            render_graph_pass_read(&graph, pass_b, a, RENDER_GRAPH_ACCESS_SAMPLED);
+            render_graph_pass_write(&graph, pass_b, b, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+            uint32_t pass_c = render_graph_add_pass(&graph, "b_to_c", render_graph_test_pass, &executed);
+            render_graph_pass_read(&graph, pass_c, b, RENDER_GRAPH_ACCESS_SAMPLED);
+            render_graph_pass_write(&graph, pass_c, c, RENDER_GRAPH_ACCESS_STORAGE_WRITE);
+            uint32_t present = render_graph_add_pass(&graph, "c_to_backbuffer", render_graph_test_pass, &executed);
+            render_graph_pass_read(&graph, present, c, RENDER_GRAPH_ACCESS_SAMPLED);
+            render_graph_pass_write(&graph, present, backbuffer, RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT);
+
+            render_graph_execute(&graph, &cmd_buff);
+
+            if (frame == 0)
+                created_first_frame = s_RenderGraphTestTexturesCreated;
+        }
+        TEST_END();
+
+        ASSERT_EQ(3u, render_graph_get_stats(&graph)->transient_textures, "%u", test_case, "Three transients should be declared.");
+        ASSERT_EQ(2u, render_graph_get_stats(&graph)->physical_textures, "%u", test_case, "a and c should share one physical texture.");
+        ASSERT_CON(render_graph_get_texture(&graph, a) == render_graph_get_texture(&graph, c), test_case, "a and c should resolve to the same texture.");
+        ASSERT_CON(render_graph_get_texture(&graph, a) != render_graph_get_texture(&graph, b), test_case, "a and b overlap and can't alias.");
+        ASSERT_EQ(2u, created_first_frame, "%u", test_case, "Only two textures should be created.");
+        ASSERT_EQ(3ull * 64 * 64 * 4, (unsigned long long) render_graph_get_stats(&graph)->transient_bytes, "%llu", test_case, "Three 64x64 RGBA8 transients without aliasing.");
+        ASSERT_EQ(2ull * 64 * 64 * 4, (unsigned long long) render_graph_get_stats(&graph)->physical_bytes, "%llu", test_case, "Aliasing a and c should save a third of the memory.");
+        ASSERT_EQ(created_first_frame, s_RenderGraphTestTexturesCreated, "%u", test_case, "The next frame should reuse the pool.");
+    }
+
+    render_graph_destroy(&graph);
+    g_rhi = saved_rhi;
+}
@@ -332,6 +332,29 @@ float compare_ppm_similarity(const char* file1, const char* file2)
     return (((float) matching_pixels) / (float) total_pixels) * 100.0f;
 }
 
+typedef struct test_frame_capture
+{
+    gfx_texture_readback last;
+    uint64_t             last_frame_index;
+    uint32_t             frames;
+} test_frame_capture;
+
+static void test_sdf_scene_on_frame_captured(const gfx_texture_readback* frame, uint64_t frame_index, void* user_data)
+{
+    test_frame_capture* capture = user_data;
+    size_t              size    = (size_t) frame->width * frame->height * (frame->bits_per_pixel / 8);
+
+    if (!capture->last.pixels)
+        capture->last.pixels = malloc(size);
+    memcpy(capture->last.pixels, frame->pixels, size);
+
+    capture->last.width          = frame->width;
+    capture->last.height         = frame->height;
+    capture->last.bits_per_pixel = frame->bits_per_pixel;
+    capture->last_frame_index    = frame_index;
+    capture->frames++;
+}
+
 // Test function
 void test_sdf_scene(void)
 {
@@ -344,9 +367,12 @@ void test_sdf_scene(void)
         GLFWwindow* testGameWindow = NULL;
         engine_init(&testGameWindow, 800, 600);
 
-        char windowTitle[250];
-        sprintf(windowTitle, "[TEST] BYOE SDF test scene");
-        glfwSetWindowTitle(testGameWindow, windowTitle);
+        // NULL when running headless (BYOE_HEADLESS=1)
+        if (testGameWindow) {
+            char windowTitle[250];
+            sprintf(windowTitle, "[TEST] BYOE SDF test scene");
+            glfwSetWindowTitle(testGameWindow, windowTitle);
+        }
 
         renderer_sdf_set_capture_swapchain_ready();
 
@@ -363,4 +389,88 @@ void test_sdf_scene(void)
 
         ASSERT_CON(compare_ppm_similarity("./tests/test_sdf_scene_golden_image.ppm", "./tests/test_sdf_scene.ppm") > 95.0f, test_case, "Screenshot testing SDF test scene + Engine Ignition/Shutdown flow test");
     }
+
+    // Streaming capture: every frame comes back MAX_FRAMES_INFLIGHT frames later, no blocking readback
+    {
+        const uint32_t     frames_rendered = MAX_FRAMES_INFLIGHT + 4;
+        test_frame_capture capture         = {0};
+
+        TEST_START();
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+
+        renderer_sdf_set_frame_capture(test_sdf_scene_on_frame_captured, &capture);
+        for (uint32_t i = 0; i < frames_rendered; i++)
+            renderer_sdf_render();
+        renderer_sdf_set_frame_capture(NULL, NULL);
+
+        write_texture_readback_to_ppm(&capture.last, "./tests/test_sdf_scene_stream.ppm");
+
+        engine_destroy();
+
+        TEST_END();
+
+        free(capture.last.pixels);
+
+        ASSERT_EQ(frames_rendered - MAX_FRAMES_INFLIGHT, capture.frames, "%u", test_case, "Streaming capture delivers every frame once its in-flight slot retires");
+        ASSERT_CON(capture.last_frame_index == frames_rendered - MAX_FRAMES_INFLIGHT, test_case, "Streaming capture delivers frames in order");
+        ASSERT_CON(compare_ppm_similarity("./tests/test_sdf_scene_golden_image.ppm", "./tests/test_sdf_scene_stream.ppm") > 95.0f, test_case, "Streamed frame matches the golden image");
+    }
+
+    // Batch render: N frames to memory, the in-flight tail is drained before returning
+    {
+        const uint32_t     frames_rendered = 4;
+        test_frame_capture capture         = {0};
+
+        TEST_START();
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+
+        uint64_t delivered = renderer_sdf_render_frames(frames_rendered, test_sdf_scene_on_frame_captured, &capture);
+
+        write_texture_readback_to_ppm(&capture.last, "./tests/test_sdf_scene_batch.ppm");
+
+        engine_destroy();
+
+        TEST_END();
+
+        free(capture.last.pixels);
+
+        ASSERT_EQ(frames_rendered, (uint32_t) delivered, "%u", test_case, "Batch render delivers every requested frame");
+        ASSERT_CON(capture.last_frame_index == frames_rendered, test_case, "Batch render delivers the last frame");
+        ASSERT_CON(compare_ppm_similarity("./tests/test_sdf_scene_golden_image.ppm", "./tests/test_sdf_scene_batch.ppm") > 95.0f, test_case, "Batch rendered frame matches the golden image");
+    }
+
+    // Async compute: the engine asks for the backbuffer path, a compute queue takes precedence over it
+    {
+        const uint32_t     frames_rendered = MAX_FRAMES_INFLIGHT + 2;
+        test_frame_capture capture         = {0};
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+
+        if (!renderer_sdf_set_async_compute(true)) {
+            printf(COLOR_YELLOW "[Test Case] Skipped : %s : the device has no separate compute queue family\n" COLOR_RESET, test_case);
+            engine_destroy();
+            return;
+        }
+
+        TEST_START();
+        renderer_sdf_set_frame_capture(test_sdf_scene_on_frame_captured, &capture);
+        for (uint32_t i = 0; i < frames_rendered; i++)
+            renderer_sdf_render();
+        renderer_sdf_set_frame_capture(NULL, NULL);
+        bool async_active = renderer_sdf_is_async_compute_active();
+
+        write_texture_readback_to_ppm(&capture.last, "./tests/test_sdf_scene_async.ppm");
+        TEST_END();
+
+        engine_destroy();
+        free(capture.last.pixels);
+
+        ASSERT_CON(async_active, test_case, "Async compute should replace the backbuffer raymarch when a compute queue exists");
+        ASSERT_CON(compare_ppm_similarity("./tests/test_sdf_scene_golden_image.ppm", "./tests/test_sdf_scene_async.ppm") > 95.0f, test_case, "Async compute frame matches the golden image");
+    }
 }
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+#include <engine/engine.h>
+
+#include <GLFW/glfw3.h>
+
+static void print_startup_timings(const char* label, engine_startup_timings timings)
+{
+    printf("[Startup] %s: total %.2f ms | window %.2f ms | context %.2f ms | shaders %.2f ms | pipelines %.2f ms | shaders+pipelines wall %.2f ms | game_main %.2f ms\n",
+        label,
+        timings.total_ms,
+        timings.window_ms,
+        timings.context_ms,
+        timings.shaders_ms,
+        timings.pipelines_ms,
+        timings.shaders_pipelines_wall_ms,
+        timings.game_main_ms);
+}
+
+static bool startup_file_exists(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    fclose(file);
+    return true;
+}
+
+// Header plus the size of the blob behind it, false if the file is missing or shorter than a header
+static bool startup_read_cache_header(const char* path, gfx_pipeline_cache_file_header* header, long* blob_bytes)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    bool read = fread(header, sizeof(*header), 1, file) == 1;
+    fseek(file, 0, SEEK_END);
+    *blob_bytes = ftell(file) - (long) sizeof(*header);
+    fclose(file);
+    return read;
+}
+
+static bool startup_write_cache_header(const char* path, const gfx_pipeline_cache_file_header* header)
+{
+    FILE* file = fopen(path, "r+b");
+    if (!file)
+        return false;
+
+    bool written = fwrite(header, sizeof(*header), 1, file) == 1;
+    fclose(file);
+    return written;
+}
+
+// Uses the game_main from test_sdf_scene.h
+void test_startup(void)
+{
+    const char* test_case  = "test_startup";
+    const char* cache_path = g_gfxConfig.pipeline_cache_path;
+
+    // Cold start: no pipeline cache on disk, engine_destroy writes one
+    {
+        if (cache_path)
+            remove(cache_path);
+
+        TEST_START();
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+        engine_startup_timings cold = engine_get_startup_timings();
+        engine_destroy();
+
+        TEST_END();
+
+        print_startup_timings("cold", cold);
+
+        ASSERT_CON(cold.total_ms > 0.0 && cold.shaders_pipelines_wall_ms <= cold.total_ms, test_case, "Cold startup timings are recorded");
+        ASSERT_EQ(0ull, (unsigned long long) cold.pipeline_cache_bytes, "%llu", test_case, "Cold start loads no pipeline cache");
+        if (cache_path) {
+            ASSERT_CON(startup_file_exists(cache_path), test_case, "Pipeline cache is saved on shutdown");
+        }
+    }
+
+    gfx_pipeline_cache_file_header header     = {0};
+    long                           blob_bytes = 0;
+    if (cache_path) {
+        TEST_START();
+        bool has_header = startup_read_cache_header(cache_path, &header, &blob_bytes);
+        TEST_END();
+        ASSERT_CON(has_header && header.magic == GFX_PIPELINE_CACHE_FILE_MAGIC, test_case, "Saved pipeline cache starts with the cache file header");
+        ASSERT_CON(header.data_size > 0 && (long) header.data_size == blob_bytes, test_case, "Header data_size matches the blob written behind it");
+    }
+
+    // Warm start: pipelines come from the cache written above
+    {
+        TEST_START();
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+        engine_startup_timings warm = engine_get_startup_timings();
+        engine_destroy();
+
+        TEST_END();
+
+        print_startup_timings("warm", warm);
+
+        ASSERT_CON(warm.total_ms > 0.0 && warm.shaders_pipelines_wall_ms <= warm.total_ms, test_case, "Warm startup timings are recorded");
+        // the loader checks magic, vendor, device, driver and UUID against the device, so this is the header round-tripping
+        if (cache_path) {
+            ASSERT_EQ((unsigned long long) header.data_size, (unsigned long long) warm.pipeline_cache_bytes, "%llu", test_case, "Warm start loads the whole cached blob");
+        }
+    }
+
+    // A header from another device is discarded instead of being handed to the driver
+    if (cache_path) {
+        gfx_pipeline_cache_file_header foreign = {0};
+        startup_read_cache_header(cache_path, &foreign, &blob_bytes);
+        foreign.device_id ^= 1u;
+        bool patched = startup_write_cache_header(cache_path, &foreign);
+
+        TEST_START();
+
+        GLFWwindow* testGameWindow = NULL;
+        engine_init(&testGameWindow, 800, 600);
+        engine_startup_timings mismatched = engine_get_startup_timings();
+        engine_destroy();
+
+        TEST_END();
+
+        ASSERT_CON(patched && mismatched.pipeline_cache_bytes == 0, test_case, "Pipeline cache from a different device is discarded");
+
+        gfx_pipeline_cache_file_header rewritten = {0};
+        startup_read_cache_header(cache_path, &rewritten, &blob_bytes);
+        ASSERT_CON(rewritten.device_id == header.device_id && memcmp(rewritten.pipeline_cache_uuid, header.pipeline_cache_uuid, sizeof(header.pipeline_cache_uuid)) == 0, test_case, "Shutdown rewrites the cache for the current device");
+    }
+}